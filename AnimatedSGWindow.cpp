@@ -35,6 +35,32 @@ AnimatedSGWindow::AnimatedSGWindow(int x, int y, int w, int h, const char* label
 	this->interpolateB->selection_color(FL_GREEN);
 	this->interpolateB->hide();
 
+	/* Toggle for rendering out without the window on every core. */
+	this->offlineB = new Fl_Light_Button(this->animateB->x()+120, 
+		this->animateB->y(), 100, 30, "Offline");
+	this->offlineB->box(FL_PLASTIC_UP_BOX);
+	this->offlineB->selection_color(FL_GREEN);
+	this->offlineB->hide();
+
+	/* Choice of what the animation is rendered out to. */
+	this->outputChoice = new Fl_Choice(this->offlineB->x()+120, 
+		this->offlineB->y(), 120, 30, "Output");
+	this->outputChoice->add("JPEG frames");
+	this->outputChoice->add("JPEG frames 4:4:4");
+	this->outputChoice->add("PNG frames");
+	this->outputChoice->add("Y4M stream");
+	this->outputChoice->add("Raw RGB stream");
+	this->outputChoice->value(0);
+	this->outputChoice->align(Fl_Align(FL_ALIGN_TOP));
+	this->outputChoice->hide();
+
+	/* Named pipe or file the streams are written to, stdout if empty. */
+	this->streamPathInput = new Fl_Input(this->outputChoice->x()+130, 
+		this->outputChoice->y(), 110, 30);
+	this->streamPathInput->tooltip("Named pipe or file to stream to, "
+		"stdout if empty");
+	this->streamPathInput->hide();
+
 	/* Create the timeline and controls then hide them. */
 	this->frameControlG = this->makeFrameControlG(80, h-35);
 	this->frameControlG->hide();
@@ -43,6 +69,10 @@ AnimatedSGWindow::AnimatedSGWindow(int x, int y, int w, int h, const char* label
 	this->timelineG = this->makeTimelineG(15, h-130);
 	this->timelineG->hide();
 
+	/* Create the render range controls then hide them. */
+	this->renderRangeG = this->makeRenderRangeG(15, h-125);
+	this->renderRangeG->hide();
+
 	/* Set the animation playing to be false */
 	this->isPlaying = false;
 	
@@ -58,9 +88,13 @@ AnimatedSGWindow::~AnimatedSGWindow()
 	delete this->animateB;
 	delete this->renderB;
 	delete this->interpolateB;
+	delete this->offlineB;
+	delete this->outputChoice;
+	delete this->streamPathInput;
 	/* Deletes the children as well. */
 	delete this->timelineG;
 	delete this->frameControlG;
+	delete this->renderRangeG;
 }
 
 /* Creates the group for the timeline and its controls and returns it. */
@@ -106,7 +140,7 @@ Fl_Group* AnimatedSGWindow::makeTimelineG(const int x, const int y)
 /* Creates the group for the timeline and its controls and returns it. */
 Fl_Group* AnimatedSGWindow::makeFrameControlG(const int x, const int y)
 {
-	Fl_Group* frameControlG = new Fl_Group(x, y, 200, 50);
+	Fl_Group* frameControlG = new Fl_Group(x, y, 250, 50);
 	
 	/* Create the frame rate spinner. */
 	this->framerateSpinner = new Fl_Spinner(x, y, 50, 25, "Frame rate");
@@ -122,11 +156,53 @@ Fl_Group* AnimatedSGWindow::makeFrameControlG(const int x, const int y)
 	this->numFramesSpinner->value(20);
 	this->numFramesSpinner->align(Fl_Align(FL_ALIGN_TOP));
 	this->numFramesSpinner->callback(AnimatedSGWindow::numFramesCB, this);
+
+	/* Create the JPEG quality spinner. */
+	this->jpegQualitySpinner = new Fl_Spinner(x+190, y, 50, 25, "Quality");
+	this->jpegQualitySpinner->box(FL_UP_BOX);
+	this->jpegQualitySpinner->minimum(1);
+	this->jpegQualitySpinner->maximum(100);
+	this->jpegQualitySpinner->value(JPEG_QUALITY);
+	this->jpegQualitySpinner->align(Fl_Align(FL_ALIGN_TOP));
 	
 	frameControlG->end();
 	return frameControlG;
 }
 
+/* Creates the group for the frames to render out and returns it. */
+Fl_Group* AnimatedSGWindow::makeRenderRangeG(const int x, const int y)
+{
+	Fl_Group* renderRangeG = new Fl_Group(x, y, 140, 20);
+
+	/* Create the first frame spinner. */
+	this->firstFrameSpinner = new Fl_Spinner(x, y, 45, 20, "First");
+	this->firstFrameSpinner->box(FL_UP_BOX);
+	this->firstFrameSpinner->maximum(998);
+	this->firstFrameSpinner->value(0);
+	this->firstFrameSpinner->align(Fl_Align(FL_ALIGN_TOP));
+	this->firstFrameSpinner->tooltip("First frame to render out");
+
+	/* Create the last frame spinner. */
+	this->lastFrameSpinner = new Fl_Spinner(x+48, y, 45, 20, "Last");
+	this->lastFrameSpinner->box(FL_UP_BOX);
+	this->lastFrameSpinner->maximum(this->numFramesSpinner->value()-1);
+	this->lastFrameSpinner->value(this->numFramesSpinner->value()-1);
+	this->lastFrameSpinner->align(Fl_Align(FL_ALIGN_TOP));
+	this->lastFrameSpinner->tooltip("Last frame to render out");
+
+	/* Create the frame stride spinner. */
+	this->frameStrideSpinner = new Fl_Spinner(x+96, y, 45, 20, "Stride");
+	this->frameStrideSpinner->box(FL_UP_BOX);
+	this->frameStrideSpinner->minimum(1);
+	this->frameStrideSpinner->maximum(999);
+	this->frameStrideSpinner->value(1);
+	this->frameStrideSpinner->align(Fl_Align(FL_ALIGN_TOP));
+	this->frameStrideSpinner->tooltip("Render out every this many frames");
+
+	renderRangeG->end();
+	return renderRangeG;
+}
+
 /* Callback function for the animate button. */
 void AnimatedSGWindow::animateCB(Fl_Widget *w, void *data)
 {
@@ -141,12 +217,17 @@ void AnimatedSGWindow::animateCB(Fl_Widget *w, void *data)
 	/* Show the animation widgets */
 	aSGWin->renderB->show();
 	aSGWin->interpolateB->show();
+	aSGWin->offlineB->show();
+	aSGWin->outputChoice->show();
+	aSGWin->streamPathInput->show();
 	aSGWin->timelineG->show();
 	aSGWin->frameControlG->show();
+	aSGWin->renderRangeG->show();
 	
 	/* Expand out the frames  */
 	aSGWin->sceneGraph->expandTransforms(0, (unsigned int)(aSGWin->
 		numFramesSpinner->value()));
+	aSGWin->history->clear();
 	
 	/* Change the callbacks of the transformation group to multipleTransformsCB */
 	aSGWin->translateXSlider->callback(AnimatedSGWindow::multipleTransformsCB, 
@@ -162,86 +243,177 @@ void AnimatedSGWindow::animateCB(Fl_Widget *w, void *data)
 	aSGWin->redraw();
 }
 
+/* Makes the sink for the chosen output, JPEG or PNG frames in the anim   */
+/* directory or a stream to the named pipe or stdout.                     */
+FrameSink* AnimatedSGWindow::makeFrameSink() const
+{
+	int quality = (int)(this->jpegQualitySpinner->value());
+	switch (this->outputChoice->value())
+	{
+		case 1:
+			return new JPEGSequenceSink("anim\\testing_", quality, 
+				FrameWriter::SUBSAMPLE_444);
+		case 2:
+			return new PNGSequenceSink("anim\\testing_");
+		case 3:
+			return new Y4MSink(this->streamPathInput->value());
+		case 4:
+			return new RawRGBSink(this->streamPathInput->value());
+		default:
+			return new JPEGSequenceSink("anim\\testing_", quality, 
+				FrameWriter::SUBSAMPLE_420);
+	}
+}
+
+/* Replaces the scene graph with the given one, keeping at least as many */
+/* frames as it has.                                                     */
+void AnimatedSGWindow::setSceneGraph(Node* newSceneGraph)
+{
+	SceneGraphWindow::setSceneGraph(newSceneGraph);
+
+	/* Match the timeline to the new scene graph, then expand it to the */
+	/* number of frames if it is shorter                                */
+	unsigned int length = newSceneGraph->getTrack()->getLength();
+	if(length > this->numFramesSpinner->maximum())
+	{
+		this->numFramesSpinner->maximum(length);
+	}
+	if(length > this->numFramesSpinner->value())
+	{
+		this->numFramesSpinner->value(length);
+	}
+	this->timeline->maximum(length - 1);
+	this->timeline->value(0);
+	AnimatedSGWindow::numFramesCB(this->numFramesSpinner, this);
+}
+
+/* Turns rendering out off while a scene is being opened, as well as the */
+/* widgets that change the scene graph.                                  */
+void AnimatedSGWindow::setLoading(bool loading)
+{
+	SceneGraphWindow::setLoading(loading);
+	if(loading)
+	{
+		this->renderB->deactivate();
+	}
+	else
+	{
+		this->renderB->activate();
+	}
+}
+
 /* Callback function for the render out button. */
 void AnimatedSGWindow::renderCB(Fl_Widget *w, void *data)
 {
 	VOID_TO_ASGWIN(data);
-	std::cout << "Rendering out animation to local directory." << std::endl;
 
-	aSGWin->timeline->value(0);
-	AnimatedSGWindow::timelineCB(aSGWin->timeline, data);
-	Fl::flush();
+	unsigned int lastFrame = (unsigned int)(std::min(aSGWin->
+		lastFrameSpinner->value(), aSGWin->timeline->maximum()));
+	int width = aSGWin->glWin->w(); int height = aSGWin->glWin->h();
+
+	FrameSink* sink = aSGWin->makeFrameSink();
+	if (!sink->open(width, height, aSGWin->framerateSpinner->value()))
+	{
+		std::cout << "Error opening the render output." << std::endl;
+		delete sink;
+		return;
+	}
+
+	/* Leave out the frames an earlier render already wrote out */
+	RenderJob job((unsigned int)(aSGWin->firstFrameSpinner->value()),
+		lastFrame, (unsigned int)(aSGWin->frameStrideSpinner->value()));
+	if (!job.prepare(aSGWin->sceneGraph, *sink, width, height))
+	{
+		std::cout << "Error opening the render manifest." << std::endl;
+		delete sink;
+		return;
+	}
+	std::cout << "Rendering out " << job.size() << " frames to " << 
+		aSGWin->outputChoice->text() << ", skipping " <<
+		job.getNumFinished() << " already rendered." << std::endl;
 
-	for (int count = 0; count <= aSGWin->timeline->maximum(); count++)
+	if (aSGWin->offlineB->value())
 	{
-		//////////////////////////////////////////////////////////
-		// Code for outputing FL_GL_Window to a jpeg file!!!
-		std::string s;
-		std::stringstream out;	// a stream for outputing to a string
-		out << count;			// make the current count into a string
-		s = out.str();
-		std::string filename = "anim\\testing_" + s + ".jpg";	// compose the file name
-
-		// Make the BYTE array, factor of 3 because it's RBG.
-		int width = aSGWin->glWin->w(); int height = aSGWin->glWin->h();
-		BYTE* pixels = new BYTE[3 * width * height];
-
-		glReadPixels(0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, pixels);
-		struct jpeg_compress_struct cinfo;
-		struct jpeg_error_mgr jerr;
-
-		/* this is a pointer to one row of image data */
-		JSAMPROW row_pointer[1];
-		FILE *outfile = NULL;
-		fopen_s(&outfile, filename.c_str(), "wb");
-
-		if (!outfile)
+		/* Render every frame in the background on all of the cores */
+		OfflineRenderer renderer(aSGWin->sceneGraph, width, height);
+		if (!renderer.render(&job, sink) || !sink->close())
 		{
-			std::cout << "Error opening output jpeg file:" << filename << std::endl;
-			return;
+			std::cout << "Error writing out frames." << std::endl;
 		}
-		cinfo.err = jpeg_std_error(&jerr);
-		jpeg_create_compress(&cinfo);
-		jpeg_stdio_dest(&cinfo, outfile);
-
-		/* Setting the parameters of the output file here */
-		cinfo.image_width = width;
-		cinfo.image_height = height;
-		cinfo.input_components = 3;		// bytes_per_pixel;
-		cinfo.in_color_space = JCS_RGB; // color_space;
-		/* default compression parameters, we shouldn't be worried about these */
-		jpeg_set_defaults(&cinfo);
-		/* Now do the compression .. */
-		jpeg_start_compress(&cinfo, TRUE);
-		/* like reading a file, this time write one row at a time */
-		std::list<JDIMENSION> lines; // switch the image to right side up
-		unsigned int cnt = 0;
-		while (cnt < cinfo.image_height)
+		delete sink;
+		renderer.printStats(std::cout);
+		std::cout << "Rendering out complete." << std::endl;
+		return;
+	}
+
+	/* Encode and write in the background while the next frames are drawn, */
+	/* leaving a core for drawing.                                         */
+	FramePipeline pipeline(sink, &job, width, height,
+		std::max(std::thread::hardware_concurrency(), 2u) - 1);
+
+	/* Read frames back into pixel buffer objects when there are any, */
+	/* so a frame is copied out while the ones after it draw.         */
+	aSGWin->glWin->make_current();
+	FrameReadback readback(width, height);
+	std::cout << (readback.isAsync() ? "Reading back frames asynchronously." :
+		"Pixel buffer objects unavailable, reading back frames directly.") <<
+		std::endl;
+
+	// Make the BYTE array, factor of 3 because it's RBG. Each submit swaps
+	// it for a free buffer from the pipeline's preallocated ring.
+	std::vector<BYTE> pixels(3 * width * height);
+	unsigned int numSubmitted = 0;
+	bool failed = false;
+
+	for (unsigned int i = 0; i < job.size() && !failed; i++)
+	{
+		if (job.isRepeated(i))
 		{
-			lines.push_front(cnt);
-			cnt++;
+			/* Hand over the frames still being read first, the pipeline */
+			/* only lets a frame get so far ahead of the one written.    */
+			aSGWin->glWin->make_current();
+			while (!failed && readback.takeFrame(pixels))
+			{
+				failed = !pipeline.submit(numSubmitted++, pixels);
+			}
+			if (!failed)
+			{
+				failed = !pipeline.submitRepeat(numSubmitted++);
+			}
 		}
-		std::list<JDIMENSION>::iterator it;
-
-		for (it = lines.begin(); it != lines.end(); ++it){
-			row_pointer[0] = &pixels[(*it) * cinfo.image_width *  cinfo.input_components];
-			jpeg_write_scanlines(&cinfo, row_pointer, 1);
+		else
+		{
+			/* Move the animation to the frame and force out the redraw */
+			aSGWin->timeline->value(job.getFrameNum(i));
+			AnimatedSGWindow::timelineCB(aSGWin->timeline, data);
+			Fl::flush();
+
+			/* Start reading back the frame in the window */
+			aSGWin->glWin->make_current();
+			readback.readFrame();
+
+			/* Hand over the oldest frame once every buffer is in use */
+			if (!readback.canRead())
+			{
+				readback.takeFrame(pixels);
+				failed = !pipeline.submit(numSubmitted++, pixels);
+			}
 		}
+	}
 
-		/* similar to read file, clean up after we're done compressing */
-		jpeg_finish_compress(&cinfo);
-		jpeg_destroy_compress(&cinfo);
-		fclose(outfile);
-		
-		delete[] pixels;
-		/////////////////////////////////////////////////////////////////////
-
-		/* Move the animation forwards */
-		AnimatedSGWindow::forwardCB(aSGWin->forwardB, data);
-		/* Forces out the redraw */
-		Fl::flush();
-
+	/* Hand over the frames still being read */
+	aSGWin->glWin->make_current();
+	while (!failed && readback.takeFrame(pixels))
+	{
+		failed = !pipeline.submit(numSubmitted++, pixels);
+	}
+	if (!pipeline.finish() || !sink->close())
+	{
+		std::cout << "Error writing out frames." << std::endl;
 	}
+	delete sink;
+	pipeline.printStats(std::cout);
+
 	aSGWin->timeline->value(0);
 	AnimatedSGWindow::timelineCB(aSGWin->timeline, data);
 	std::cout << "Rendering out complete." << std::endl;
@@ -344,14 +516,20 @@ void AnimatedSGWindow::multipleTransformsCB(Fl_Widget *w, void *data)
 		(float)(aSGWin->translateYSlider->value()));
 	
 	/* Set the transformation mat3 of the current frame. */
+	aSGWin->recordUndo(aSGWin->activeNode,
+		(unsigned int)(aSGWin->timeline->value()), w);
 	aSGWin->activeNode->setTransformation(scale, rotate, translate, 
 		(unsigned int)(aSGWin->timeline->value()));
+	aSGWin->recordEdit(aSGWin->activeNode,
+		(unsigned int)(aSGWin->timeline->value()));
 
-	/* Copy over the transforms to the subsequent frames. */
-	aSGWin->activeNode->copyTransforms((unsigned int)(aSGWin->timeline->value()));
+	/* Key the rest of the scene graph at this frame. Only the edited Node */
+	/* re-interpolates, and only the segments next to the keyframe.        */
+	aSGWin->recordUndoMakeKeyframe((unsigned int)(aSGWin->timeline->value()),
+		w);
 	aSGWin->sceneGraph->makeKeyframe((unsigned int)(aSGWin->timeline->value()));
-	if(aSGWin->interpolateB->value())
-		aSGWin->sceneGraph->linearlyInterpolate();
+	aSGWin->recordMakeKeyframe((unsigned int)(aSGWin->timeline->value()));
+	aSGWin->endUndoStep();
 	aSGWin->glWin->redraw();
 }
 
@@ -364,17 +542,22 @@ void AnimatedSGWindow::multipleColorCB(Fl_Widget *w, void *data)
 	if(aSGWin->activeNode != NULL)
 	{
 		/* Set the color of the current Nodes geometry. */
+		aSGWin->recordUndo(aSGWin->activeNode,
+			(unsigned int)(aSGWin->timeline->value()), w);
 		aSGWin->activeNode->setGeometryColor((float)(color->r()), 
 			(float)(color->g()), (float)(color->b()), (int)(aSGWin->
 			timeline->value()));
+		aSGWin->recordEdit(aSGWin->activeNode,
+			(unsigned int)(aSGWin->timeline->value()));
 	}
 
-	/* Copy over the transforms to the subsequent frames. */
-	aSGWin->activeNode->copyTransforms((unsigned int)(aSGWin->timeline->value()));
+	/* Key the rest of the scene graph at this frame. Only the edited Node */
+	/* re-interpolates, and only the segments next to the keyframe.        */
+	aSGWin->recordUndoMakeKeyframe((unsigned int)(aSGWin->timeline->value()),
+		w);
 	aSGWin->sceneGraph->makeKeyframe((unsigned int)(aSGWin->timeline->value()));
-	/* Automatically interpolate if the interpolateB is selected. */
-	if(aSGWin->interpolateB->value())
-		aSGWin->sceneGraph->linearlyInterpolate();
+	aSGWin->recordMakeKeyframe((unsigned int)(aSGWin->timeline->value()));
+	aSGWin->endUndoStep();
 	aSGWin->glWin->redraw();
 }
 
@@ -389,7 +572,7 @@ void AnimatedSGWindow::numFramesCB(Fl_Widget *w, void *data)
 	{
 		aSGWin->sceneGraph->expandTransforms((unsigned int)(aSGWin->
 			timeline->maximum()), (unsigned int)(aSGWin->numFramesSpinner->
-			value()-1));
+			value()));
 	}
 	/* Shrink the number of transformations if the value is less than */
 	/* the size.                                                      */
@@ -403,9 +586,24 @@ void AnimatedSGWindow::numFramesCB(Fl_Widget *w, void *data)
 		}
 	}
 	
+	/* The steps to undo are of the old number of frames */
+	if((aSGWin->numFramesSpinner->value()-1) != aSGWin->timeline->maximum())
+	{
+		aSGWin->history->clear();
+	}
 	aSGWin->timeline->maximum((aSGWin->numFramesSpinner->value())-1);
 	aSGWin->timeline->redraw();
 
+	/* Keep rendering out to the last frame if it was there already */
+	bool toLastFrame = aSGWin->lastFrameSpinner->value() >=
+		aSGWin->lastFrameSpinner->maximum();
+	aSGWin->lastFrameSpinner->maximum(aSGWin->timeline->maximum());
+	if(toLastFrame || aSGWin->lastFrameSpinner->value() >
+		aSGWin->timeline->maximum())
+	{
+		aSGWin->lastFrameSpinner->value(aSGWin->timeline->maximum());
+	}
+
 	AnimatedSGWindow::timelineCB(aSGWin->timeline, data);
 }
 
@@ -413,10 +611,8 @@ void AnimatedSGWindow::numFramesCB(Fl_Widget *w, void *data)
 void AnimatedSGWindow::interpolateCB(Fl_Widget *w, void *data)
 {
 	VOID_TO_ASGWIN(data);
-	if(aSGWin->interpolateB->value())
-		aSGWin->sceneGraph->linearlyInterpolate();
-	else
-		aSGWin->sceneGraph->unInterpolate();
+	/* Only switches how the frames are evaluated, nothing is rebaked. */
+	Node::setInterpolated(aSGWin->interpolateB->value() != 0);
 	aSGWin->glWin->redraw();
 }
 
@@ -460,3 +656,11 @@ void AnimatedSGWindow::setColorChooser()
 	}
 }
 
+/* Sets the transformation, color, and rename widgets to the active Node's */
+/* values at the current frame after an undo or redo.                      */
+void AnimatedSGWindow::setActiveNodeWidgets()
+{
+	this->setTransformationG();
+	this->setColorChooser();
+	this->setItemNameInput();
+}
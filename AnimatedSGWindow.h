@@ -17,11 +17,21 @@
 #include <Fl/Fl_Gl_Window.H>
 #include <Fl/Fl_Spinner.H>
 #include <Fl/Fl_Light_Button.H>
+#include <FL/Fl_Choice.H>
 #include <FL/Gl.H>
 #include <sstream>
 #include <iostream>
 #include <list>
-#include <jpeg/jpeglib.h>
+#include <thread>
+#include <algorithm> /* Included for max */
+#include "FramePipeline.h"
+#include "FrameReadback.h"
+#include "OfflineRenderer.h"
+#include "RenderJob.h"
+#include "JPEGSequenceSink.h"
+#include "PNGSequenceSink.h"
+#include "Y4MSink.h"
+#include "RawRGBSink.h"
 
 /* Macro for converting a void pointer to an AnimatedSGWindow pointer. */
 #define VOID_TO_ASGWIN(ptr) AnimatedSGWindow* aSGWin = (AnimatedSGWindow*)ptr
@@ -37,6 +47,12 @@ class AnimatedSGWindow : public SceneGraphWindow
 		Fl_Button* renderB;
 		/* Render button for rendering out the animation to the local directory. */
 		Fl_Light_Button* interpolateB;
+		/* Toggle for rendering out without the window on every core. */
+		Fl_Light_Button* offlineB;
+		/* Choice of what the animation is rendered out to. */
+		Fl_Choice* outputChoice;
+		/* Named pipe or file the streams are written to, stdout if empty. */
+		Fl_Input* streamPathInput;
 		/* A Pointer to the group of timeline and play controls. */
 		Fl_Group* timelineG;
 		/* A Pointer to the timeline slider */
@@ -47,7 +63,11 @@ class AnimatedSGWindow : public SceneGraphWindow
 		/* A Pointer to the group of frame controls. */
 		Fl_Group* frameControlG;
 		/* Pointers to the frame controls */
-		Fl_Spinner *framerateSpinner, *numFramesSpinner;
+		Fl_Spinner *framerateSpinner, *numFramesSpinner, *jpegQualitySpinner;
+		/* A Pointer to the group of frames to render out. */
+		Fl_Group* renderRangeG;
+		/* Pointers to the first and last frame and the step between frames */
+		Fl_Spinner *firstFrameSpinner, *lastFrameSpinner, *frameStrideSpinner;
 		/* Boolean for if the animation is playing. */
 		bool isPlaying;
 
@@ -55,6 +75,8 @@ class AnimatedSGWindow : public SceneGraphWindow
 		Fl_Group* makeTimelineG(const int x, const int y);		
 		/* Creates the group for the frame controls and returns it. */
 		Fl_Group* makeFrameControlG(const int x, const int y);	
+		/* Creates the group for the frames to render out and returns it. */
+		Fl_Group* makeRenderRangeG(const int x, const int y);
 		
 		/* Sets the values of the transformation widgets to */
 		/* the activeNode's values.                         */
@@ -62,6 +84,22 @@ class AnimatedSGWindow : public SceneGraphWindow
 		/* Sets the values of the color selection widgets to */
 		/* the activeNode's color values.                    */
 		void setColorChooser();
+		/* Sets the transformation, color, and rename widgets to the */
+		/* active Node's values at the current frame after an undo   */
+		/* or redo.                                                  */
+		virtual void setActiveNodeWidgets();
+
+		/* Makes the sink for the chosen output, JPEG or PNG frames in */
+		/* the anim directory or a stream to the named pipe or stdout. */
+		FrameSink* makeFrameSink() const;
+
+		/* Replaces the scene graph with the given one, keeping at least */
+		/* as many frames as it has.                                     */
+		virtual void setSceneGraph(Node* newSceneGraph);
+
+		/* Turns rendering out off while a scene is being opened, as */
+		/* well as the widgets that change the scene graph.          */
+		virtual void setLoading(bool loading);
 
 		/* Callback function for the animate button. */
 		static void animateCB(Fl_Widget *w, void *data);
@@ -0,0 +1,184 @@
+/*
+ * BatchOptions.cpp
+ * Created by Zachary Ferguson
+ * Source file for the BatchOptions class, the command line options of the
+ * batch renderer, read from the arguments and checked before anything is
+ * loaded or rendered.
+ */
+
+#include "BatchOptions.h"
+#include <cerrno>   /* Included for errno */
+#include <cstdlib>  /* Included for strtoul */
+#include "FrameWriter.h"
+#include "JPEGSequenceSink.h"
+#include "PNGSequenceSink.h"
+#include "Y4MSink.h"
+#include "RawRGBSink.h"
+
+/* Constructor for the default BatchOptions. */
+BatchOptions::BatchOptions()
+{
+	this->sceneName = "walk";
+	this->format = "jpeg";
+	this->hasOutput = false;
+	this->hasFrames = false;
+	this->hasLast = false;
+	this->interpolate = false;
+	this->numFrames = DEFAULT_NUM_FRAMES;
+	this->first = 0;
+	this->last = 0;
+	this->stride = 1;
+	this->width = DEFAULT_WIDTH;
+	this->height = DEFAULT_HEIGHT;
+	this->quality = JPEG_QUALITY;
+	this->framerate = DEFAULT_FRAMERATE;
+	this->numThreads = 0;
+}
+
+/* Reads the options from the command line arguments, after the program   */
+/* name. Stops at --help, or at the first option that is unknown, missing */
+/* its value, or has an invalid value, and sets error to say which.       */
+BatchOptions::Result BatchOptions::parse(int argc, const char* const argv[],
+	std::string& error)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		std::string option = argv[i];
+		if (option == "--help")
+		{
+			return HELP;
+		}
+		if (option == "--interpolate")
+		{
+			this->interpolate = true;
+			continue;
+		}
+		if (i + 1 >= argc)
+		{
+			error = "Unknown option or missing value: " + option;
+			return UNKNOWN_OPTION;
+		}
+
+		const char* value = argv[++i];
+		bool valid = true;
+		if (option == "--scene")
+		{
+			this->sceneName = value;
+		}
+		else if (option == "--format")
+		{
+			this->format = value;
+		}
+		else if (option == "--export")
+		{
+			this->exportPath = value;
+		}
+		else if (option == "--output")
+		{
+			this->output = value;
+			this->hasOutput = true;
+		}
+		else if (option == "--frames")
+		{
+			valid = parseNumber(value, this->numFrames) &&
+				this->numFrames > 0;
+			this->hasFrames = true;
+		}
+		else if (option == "--first")
+		{
+			valid = parseNumber(value, this->first);
+		}
+		else if (option == "--last")
+		{
+			valid = parseNumber(value, this->last);
+			this->hasLast = true;
+		}
+		else if (option == "--stride")
+		{
+			valid = parseNumber(value, this->stride) && this->stride > 0;
+		}
+		else if (option == "--width")
+		{
+			valid = parseNumber(value, this->width) && this->width > 0 &&
+				this->width <= MAX_FRAME_SIZE;
+		}
+		else if (option == "--height")
+		{
+			valid = parseNumber(value, this->height) && this->height > 0 &&
+				this->height <= MAX_FRAME_SIZE;
+		}
+		else if (option == "--quality")
+		{
+			valid = parseNumber(value, this->quality) &&
+				this->quality >= 1 && this->quality <= 100;
+		}
+		else if (option == "--framerate")
+		{
+			valid = parseNumber(value, this->framerate) &&
+				this->framerate > 0;
+		}
+		else if (option == "--threads")
+		{
+			valid = parseNumber(value, this->numThreads);
+		}
+		else
+		{
+			error = "Unknown option: " + option;
+			return UNKNOWN_OPTION;
+		}
+		if (!valid)
+		{
+			error = "Invalid value for " + option + ": " + value;
+			return INVALID_VALUE;
+		}
+	}
+	return PARSED;
+}
+
+/* Makes the sink for the format, or returns NULL if there is no such */
+/* format.                                                            */
+FrameSink* BatchOptions::makeFrameSink() const
+{
+	std::string prefix = this->hasOutput ? this->output :
+		std::string("frame_");
+	if (this->format == "jpeg")
+	{
+		return new JPEGSequenceSink(prefix, (int)(this->quality),
+			FrameWriter::SUBSAMPLE_420);
+	}
+	if (this->format == "jpeg444")
+	{
+		return new JPEGSequenceSink(prefix, (int)(this->quality),
+			FrameWriter::SUBSAMPLE_444);
+	}
+	if (this->format == "png")
+	{
+		return new PNGSequenceSink(prefix);
+	}
+	if (this->format == "y4m")
+	{
+		return new Y4MSink(this->output);
+	}
+	if (this->format == "rgb")
+	{
+		return new RawRGBSink(this->output);
+	}
+	return NULL;
+}
+
+/* Sets value to the whole number in text. Returns if text is one. */
+bool BatchOptions::parseNumber(const char* text, unsigned int& value)
+{
+	/* Where long is 32 bits, a number too large comes back as the */
+	/* largest one, with errno set                                 */
+	char* end;
+	errno = 0;
+	unsigned long number = strtoul(text, &end, 10);
+	if (*text < '0' || *text > '9' || *end != '\0' || errno == ERANGE ||
+		number > 0xFFFFFFFFUL)
+	{
+		return false;
+	}
+	value = (unsigned int)number;
+	return true;
+}
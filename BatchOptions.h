@@ -0,0 +1,65 @@
+/*
+ * BatchOptions.h
+ * Created by Zachary Ferguson
+ * Header file for the BatchOptions class, the command line options of the
+ * batch renderer, read from the arguments and checked before anything is
+ * loaded or rendered.
+ */
+
+#ifndef BATCHOPTIONS_H
+#define BATCHOPTIONS_H
+
+/* Include necessary types */
+#include <string>
+#include "FrameSink.h"
+
+/* Default size of the frames in pixels, the size of the GLWindow. */
+#define DEFAULT_WIDTH 400
+#define DEFAULT_HEIGHT 400
+
+/* Default number of frames and frame rate, the same as the editor. */
+#define DEFAULT_NUM_FRAMES 20
+#define DEFAULT_FRAMERATE 10
+
+/* Largest frame size in pixels, well past any display. */
+#define MAX_FRAME_SIZE 16384
+
+class BatchOptions
+{
+	public:
+
+		/* What reading the arguments found. */
+		enum Result {PARSED, HELP, UNKNOWN_OPTION, INVALID_VALUE};
+
+		/* The scene to render, the output format, where the output goes, */
+		/* and where to save the scene instead of rendering it, if set.   */
+		std::string sceneName, format, output, exportPath;
+
+		/* If the output, number of frames, and last frame were given. */
+		bool hasOutput, hasFrames, hasLast;
+
+		/* If in-between frames are interpolated instead of held. */
+		bool interpolate;
+
+		/* The frames to render, their size, and how they are written. */
+		unsigned int numFrames, first, last, stride, width, height;
+		unsigned int quality, framerate, numThreads;
+
+		/* Constructor for the default BatchOptions. */
+		BatchOptions();
+
+		/* Reads the options from the command line arguments, after the  */
+		/* program name. Stops at --help, or at the first option that is */
+		/* unknown, missing its value, or has an invalid value, and sets */
+		/* error to say which.                                           */
+		Result parse(int argc, const char* const argv[], std::string& error);
+
+		/* Makes the sink for the format, or returns NULL if there is no */
+		/* such format.                                                  */
+		FrameSink* makeFrameSink() const;
+
+		/* Sets value to the whole number in text. Returns if text is one. */
+		static bool parseNumber(const char* text, unsigned int& value);
+};
+
+#endif
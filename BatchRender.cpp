@@ -0,0 +1,204 @@
+/*
+ * BatchRender.cpp
+ * Created by Zachary Ferguson
+ * Main file for rendering out an animated scene graph from the command line,
+ * without a window or a GPU, so batch renders can be scripted and run on
+ * machines without a display.
+ */
+
+#include <iostream>
+#include <string>
+#include "BatchOptions.h"
+#include "SceneLibrary.h"
+#include "SceneFile.h"
+#include "SceneJSON.h"
+#include "OfflineRenderer.h"
+#include "RenderJob.h"
+
+/* Prints how to use the batch renderer. */
+static void printUsage(const char* program)
+{
+	std::cerr << "Usage: " << program << " [options]" << std::endl <<
+		"  --scene NAME      scene graph to render, animal, walk, or the " <<
+		std::endl <<
+		"                    path of a saved .asg or .json scene file " <<
+		std::endl <<
+		"                    (default walk)" << std::endl <<
+		"  --frames N        number of frames in the animation (default 20, " <<
+		std::endl <<
+		"                    or the length of a saved scene)" << std::endl <<
+		"  --first N         first frame to render (default 0)" <<
+		std::endl <<
+		"  --last N          last frame to render (default the last)" <<
+		std::endl <<
+		"  --stride N        render every Nth frame (default 1)" <<
+		std::endl <<
+		"  --width N         width of the frames in pixels (default 400)" <<
+		std::endl <<
+		"  --height N        height of the frames in pixels (default 400)" <<
+		std::endl <<
+		"  --format FORMAT   jpeg, jpeg444, png, y4m, or rgb (default jpeg)" <<
+		std::endl <<
+		"  --quality N       JPEG quality from 1 to 100 (default 75)" <<
+		std::endl <<
+		"  --framerate N     frames per second of streams (default 10)" <<
+		std::endl <<
+		"  --output PATH     file name prefix of image frames, or the file " <<
+		std::endl <<
+		"                    or named pipe streams are written to, stdout" <<
+		std::endl <<
+		"                    if empty or - (default frame_ or stdout)" <<
+		std::endl <<
+		"  --threads N       worker threads, 0 for one per core (default 0)" <<
+		std::endl <<
+		"  --interpolate     interpolate between keyframes instead of " <<
+		"holding them" << std::endl <<
+		"  --export PATH     save the scene to a .asg or .json file instead " <<
+		std::endl <<
+		"                    of rendering it" << std::endl;
+}
+
+/* Imports the JSON scene at the given path. Returns NULL, printing what */
+/* went wrong, if it could not be read.                                  */
+static Node* importJSONScene(const std::string& path)
+{
+	std::map<const Node*, std::string> labels;
+	std::string error;
+	Node* root = SceneJSON::load(path, labels, error);
+	if (root == NULL)
+	{
+		std::cerr << "Error reading " << path << ": " << error << std::endl;
+	}
+	return root;
+}
+
+/* Render an animated scene graph from the command line */
+int main(int argc, char* const argv[])
+{
+	BatchOptions options;
+	std::string error;
+
+	/***Read the options***/
+
+	switch (options.parse(argc, argv, error))
+	{
+		case BatchOptions::HELP:
+			printUsage(argv[0]);
+			return 0;
+		case BatchOptions::UNKNOWN_OPTION:
+			std::cerr << error << std::endl;
+			printUsage(argv[0]);
+			return 2;
+		case BatchOptions::INVALID_VALUE:
+			std::cerr << error << std::endl;
+			return 2;
+		default:
+			break;
+	}
+	std::string sceneName = options.sceneName;
+	unsigned int numFrames = options.numFrames;
+	unsigned int last = options.last;
+
+	/***Build the scene graph and the output***/
+
+	Node::setInterpolated(options.interpolate);
+	Node* root = SceneLibrary::createSceneGraph(sceneName, numFrames);
+	if (root == NULL)
+	{
+		/* Any other name is the path of a saved scene */
+		if (SceneJSON::isJSONPath(sceneName))
+		{
+			root = importJSONScene(sceneName);
+		}
+		else
+		{
+			root = SceneFile::load(sceneName);
+		}
+		if (root == NULL)
+		{
+			std::cerr << "Unknown scene or unreadable scene file: " <<
+				sceneName << std::endl;
+			return 2;
+		}
+		unsigned int length = root->getTrack()->getLength();
+		if (!(options.hasFrames))
+		{
+			numFrames = length;
+		}
+		else if (numFrames > length)
+		{
+			root->expandTransforms(length - 1, numFrames);
+		}
+		else if (numFrames < length)
+		{
+			root->shrinkTransforms(numFrames);
+		}
+	}
+
+	/* Save the scene instead of rendering it */
+	const std::string& exportPath = options.exportPath;
+	if (!exportPath.empty())
+	{
+		bool saved = SceneJSON::isJSONPath(exportPath) ?
+			SceneJSON::save(root, exportPath) :
+			SceneFile::save(root, exportPath);
+		delete root;
+		if (!saved)
+		{
+			std::cerr << "Error saving the scene to " << exportPath <<
+				std::endl;
+			return 1;
+		}
+		std::cout << "Saved the scene to " << exportPath << "." << std::endl;
+		return 0;
+	}
+
+	if (!(options.hasLast) || last >= numFrames)
+	{
+		last = numFrames - 1;
+	}
+	FrameSink* sink = options.makeFrameSink();
+	if (sink == NULL)
+	{
+		std::cerr << "Unknown format: " << options.format << std::endl;
+		delete root;
+		return 2;
+	}
+	if (!sink->open(options.width, options.height, options.framerate))
+	{
+		std::cerr << "Error opening the render output." << std::endl;
+		delete sink;
+		delete root;
+		return 1;
+	}
+
+	/***Render out the frames***/
+
+	/* Leave out the frames an earlier render already wrote out */
+	RenderJob job(options.first, last, options.stride);
+	if (!job.prepare(root, *sink, options.width, options.height))
+	{
+		std::cerr << "Error opening the render manifest." << std::endl;
+		delete sink;
+		delete root;
+		return 1;
+	}
+	std::cout << "Rendering out " << job.size() << " frames of " <<
+		sceneName << " to " << sink->getDescription() << ", skipping " <<
+		job.getNumFinished() << " already rendered." << std::endl;
+
+	OfflineRenderer renderer(root, options.width, options.height);
+	renderer.setNumThreads(options.numThreads);
+	bool rendered = renderer.render(&job, sink);
+	bool closed = sink->close();
+	renderer.printStats(std::cout);
+	delete sink;
+	delete root;
+	if (!rendered || !closed)
+	{
+		std::cerr << "Error writing out frames." << std::endl;
+		return 1;
+	}
+	std::cout << "Rendering out complete." << std::endl;
+	return 0;
+}
@@ -0,0 +1,122 @@
+/*
+ * BoundedQueue.h
+ * Created by Zachary Ferguson
+ * Header file for the BoundedQueue class, a fixed size first in first out
+ * queue for handing work from producer threads to consumer threads. Producers
+ * wait while it is full and consumers wait while it is empty.
+ */
+
+#ifndef BOUNDEDQUEUE_H
+#define BOUNDEDQUEUE_H
+
+/* Include necessary types */
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <algorithm> /* Included for swap */
+#include <assert.h>
+
+/* Items are swapped in and out of the queue instead of copied, so an item */
+/* holding a buffer hands the buffer over without copying it. T must be    */
+/* default constructible and swappable.                                    */
+template <typename T>
+class BoundedQueue
+{
+	private:
+
+		/* Ring of slots, head is the oldest item. */
+		std::vector<T> slots;
+		unsigned int head, count;
+
+		/* If no more items will be pushed. */
+		bool closed;
+
+		std::mutex mutex;
+		std::condition_variable notFull, notEmpty;
+
+	public:
+
+		/* Constructor for an empty BoundedQueue that holds at most the */
+		/* given number of items.                                       */
+		BoundedQueue(unsigned int capacity) : slots(capacity)
+		{
+			assert(capacity > 0);
+			this->head = 0;
+			this->count = 0;
+			this->closed = false;
+		}
+
+		/* Constructor for an empty BoundedQueue that holds at most the */
+		/* given number of items, with every slot starting as a copy of */
+		/* the prototype. Used to preallocate the buffers that are      */
+		/* swapped out of the queue.                                    */
+		BoundedQueue(unsigned int capacity, const T& prototype) :
+			slots(capacity, prototype)
+		{
+			assert(capacity > 0);
+			this->head = 0;
+			this->count = 0;
+			this->closed = false;
+		}
+
+		/* Destructor for the BoundedQueue */
+		virtual ~BoundedQueue(){}
+
+		/* Swaps the item into the back of the queue, waiting while the */
+		/* queue is full. Returns false without pushing if the queue is */
+		/* closed.                                                      */
+		bool push(T& item)
+		{
+			std::unique_lock<std::mutex> lock(this->mutex);
+			while (this->count == this->slots.size() && !(this->closed))
+			{
+				this->notFull.wait(lock);
+			}
+			if (this->closed)
+			{
+				return false;
+			}
+
+			using std::swap;
+			swap(this->slots[(this->head + this->count) % this->slots.size()],
+				item);
+			this->count++;
+			this->notEmpty.notify_one();
+			return true;
+		}
+
+		/* Swaps the item at the front of the queue out into item, waiting */
+		/* while the queue is empty. Returns false once the queue is       */
+		/* closed and empty.                                               */
+		bool pop(T& item)
+		{
+			std::unique_lock<std::mutex> lock(this->mutex);
+			while (this->count == 0 && !(this->closed))
+			{
+				this->notEmpty.wait(lock);
+			}
+			if (this->count == 0)
+			{
+				return false;
+			}
+
+			using std::swap;
+			swap(this->slots[this->head], item);
+			this->head = (this->head + 1) % this->slots.size();
+			this->count--;
+			this->notFull.notify_one();
+			return true;
+		}
+
+		/* Stops any more items from being pushed and wakes every waiting */
+		/* thread. Items already in the queue can still be popped.        */
+		void close()
+		{
+			std::lock_guard<std::mutex> lock(this->mutex);
+			this->closed = true;
+			this->notFull.notify_all();
+			this->notEmpty.notify_all();
+		}
+};
+
+#endif
@@ -0,0 +1,242 @@
+/*
+ * ColorConverter.cpp
+ * Created by Zachary Ferguson
+ * Source file for the ColorConverter class, a class for converting rendered
+ * RGB frames to the full range BT.601 YCbCr used by JPEG and YUV4MPEG2.
+ */
+
+#include "ColorConverter.h"
+#include <cstring>   /* Included for memset */
+#include <algorithm> /* Included for min */
+#ifdef COLORCONVERTER_SSE2
+	#include <emmintrin.h>
+#endif
+
+/* Number of pixels of a row converted at a time. Must be even. */
+#define CONVERT_CHUNK 64
+
+/* BT.601 full range coefficients scaled by 2^15. Each row sums to 2^15 */
+/* for Y and to 0 for Cb and Cr, so the results never leave 0 to 256.   */
+#define Y_R 9798
+#define Y_G 19235
+#define Y_B 3735
+#define CB_R -5529
+#define CB_G -10855
+#define CB_B 16384
+#define CR_R 16384
+#define CR_G -13720
+#define CR_B -2664
+/* Rounding for Y, and 128 plus rounding for Cb and Cr, as multiples of */
+/* 256 so they fit in 16 bits.                                          */
+#define Y_OFFSET 64
+#define C_OFFSET 16448
+
+/* Converts count RGB pixels to separate Y, Cb, and Cr values. */
+void ColorConverter::rgbToYCbCr(const unsigned char* rgb, unsigned int count,
+	unsigned char* luma, unsigned char* blue, unsigned char* red)
+{
+	unsigned int i = 0;
+
+#ifdef COLORCONVERTER_SSE2
+	/* Each pair of pixels becomes the 16-bit lanes (R, G, B, x) twice,   */
+	/* so one multiply-add against (cR, cG, cB, 0) gives two partial sums */
+	/* per pixel. The fourth lane is the next pixel's red, so it is left  */
+	/* out of the sum and the offset is added afterwards.                 */
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i lumaCoefs = _mm_setr_epi16(Y_R, Y_G, Y_B, 0,
+		Y_R, Y_G, Y_B, 0);
+	const __m128i blueCoefs = _mm_setr_epi16(CB_R, CB_G, CB_B, 0,
+		CB_R, CB_G, CB_B, 0);
+	const __m128i redCoefs = _mm_setr_epi16(CR_R, CR_G, CR_B, 0,
+		CR_R, CR_G, CR_B, 0);
+	const __m128i lumaOffset = _mm_set1_epi32(256 * Y_OFFSET);
+	const __m128i chromaOffset = _mm_set1_epi32(256 * C_OFFSET);
+
+	/* Eight pixels at a time from two 16 byte loads. The second load */
+	/* reads four bytes past the eighth pixel, so the last two pixels */
+	/* are left to the scalar code.                                   */
+	for (; i + 10 <= count; i += 8)
+	{
+		__m128i pixels[4];
+		for (int j = 0; j < 2; j++)
+		{
+			__m128i bytes = _mm_loadu_si128((const __m128i*)(rgb +
+				3 * (i + 4 * j)));
+			pixels[2 * j] = _mm_unpacklo_epi64(
+				_mm_unpacklo_epi8(bytes, zero),
+				_mm_unpacklo_epi8(_mm_srli_si128(bytes, 3), zero));
+			pixels[2 * j + 1] = _mm_unpacklo_epi64(
+				_mm_unpacklo_epi8(_mm_srli_si128(bytes, 6), zero),
+				_mm_unpacklo_epi8(_mm_srli_si128(bytes, 9), zero));
+		}
+
+		const __m128i* coefs[3] = {&lumaCoefs, &blueCoefs, &redCoefs};
+		const __m128i* offsets[3] = {&lumaOffset, &chromaOffset,
+			&chromaOffset};
+		unsigned char* outputs[3] = {luma + i, blue + i, red + i};
+		for (int c = 0; c < 3; c++)
+		{
+			/* Add each pixel's two partial sums, four pixels at a time */
+			__m128 sums[4];
+			for (int j = 0; j < 4; j++)
+			{
+				sums[j] = _mm_castsi128_ps(_mm_madd_epi16(pixels[j],
+					*(coefs[c])));
+			}
+			__m128i low = _mm_add_epi32(
+				_mm_castps_si128(_mm_shuffle_ps(sums[0], sums[1],
+				_MM_SHUFFLE(2, 0, 2, 0))),
+				_mm_castps_si128(_mm_shuffle_ps(sums[0], sums[1],
+				_MM_SHUFFLE(3, 1, 3, 1))));
+			__m128i high = _mm_add_epi32(
+				_mm_castps_si128(_mm_shuffle_ps(sums[2], sums[3],
+				_MM_SHUFFLE(2, 0, 2, 0))),
+				_mm_castps_si128(_mm_shuffle_ps(sums[2], sums[3],
+				_MM_SHUFFLE(3, 1, 3, 1))));
+			low = _mm_add_epi32(low, *(offsets[c]));
+			high = _mm_add_epi32(high, *(offsets[c]));
+
+			/* Scale back down and saturate 256 to 255 */
+			__m128i values = _mm_packs_epi32(_mm_srai_epi32(low, 15),
+				_mm_srai_epi32(high, 15));
+			_mm_storel_epi64((__m128i*)(outputs[c]),
+				_mm_packus_epi16(values, values));
+		}
+	}
+#endif
+
+	for (; i < count; i++)
+	{
+		int r = rgb[3 * i], g = rgb[3 * i + 1], b = rgb[3 * i + 2];
+		int cb = (CB_R * r + CB_G * g + CB_B * b + 256 * C_OFFSET) >> 15;
+		int cr = (CR_R * r + CR_G * g + CR_B * b + 256 * C_OFFSET) >> 15;
+		luma[i] = (unsigned char)((Y_R * r + Y_G * g + Y_B * b +
+			256 * Y_OFFSET) >> 15);
+		blue[i] = (unsigned char)(cb > 255 ? 255 : cb);
+		red[i] = (unsigned char)(cr > 255 ? 255 : cr);
+	}
+}
+
+/* Averages count values of the top and bottom rows of chroma over blocks */
+/* subsampleX wide, 1 or 2, into chroma. Every block is summed as four     */
+/* values, counting a value twice when the block is only one value wide or */
+/* the rows are the same, so one shift averages them. If count is odd the  */
+/* rows must have room for one more value.                                 */
+void ColorConverter::averageBlocks(const unsigned char* top,
+	const unsigned char* bottom, unsigned int count, unsigned int subsampleX,
+	unsigned char* chroma)
+{
+	unsigned int k = 0, left = 0;
+
+#ifdef COLORCONVERTER_SSE2
+	/* Sixteen values at a time into eight blocks */
+	if (subsampleX == 2)
+	{
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i ones = _mm_set1_epi16(1);
+		const __m128i rounding = _mm_set1_epi32(2);
+		for (; left + 16 <= count; k += 8, left += 16)
+		{
+			__m128i topValues = _mm_loadu_si128((const __m128i*)(top + left));
+			__m128i bottomValues = _mm_loadu_si128((const __m128i*)(bottom +
+				left));
+			__m128i low = _mm_madd_epi16(_mm_add_epi16(
+				_mm_unpacklo_epi8(topValues, zero),
+				_mm_unpacklo_epi8(bottomValues, zero)), ones);
+			__m128i high = _mm_madd_epi16(_mm_add_epi16(
+				_mm_unpackhi_epi8(topValues, zero),
+				_mm_unpackhi_epi8(bottomValues, zero)), ones);
+			__m128i values = _mm_packs_epi32(
+				_mm_srli_epi32(_mm_add_epi32(low, rounding), 2),
+				_mm_srli_epi32(_mm_add_epi32(high, rounding), 2));
+			_mm_storel_epi64((__m128i*)(chroma + k),
+				_mm_packus_epi16(values, values));
+		}
+	}
+#endif
+
+	const unsigned int right = subsampleX - 1;
+	for (; left < count; k++, left += subsampleX)
+	{
+		chroma[k] = (unsigned char)((top[left] + top[left + right] +
+			bottom[left] + bottom[left + right] + 2) >> 2);
+	}
+}
+
+/* Converts numRows rows of a frame, starting at firstRow from the top, into */
+/* Y, Cb, and Cr planes. The frame's RGB pixels start with the bottom row.   */
+/* Chroma is averaged over blocks of subsampleX by subsampleY pixels, each 1 */
+/* or 2, so the planes get numRows / subsampleY rows of chroma, rounded up.  */
+/* Rows and columns past the edge of the frame, up to the strides, repeat    */
+/* the last row and column.                                                  */
+void ColorConverter::frameToYCbCr(const unsigned char* pixels,
+	unsigned int width, unsigned int height, unsigned int firstRow,
+	unsigned int numRows, unsigned int subsampleX, unsigned int subsampleY,
+	unsigned char* luma, unsigned int lumaStride, unsigned char* blue,
+	unsigned char* red, unsigned int chromaStride)
+{
+	const unsigned int rowStride = 3 * width;
+	const unsigned int endRow = firstRow + numRows;
+	const unsigned int chromaWidth = (width + subsampleX - 1) / subsampleX;
+
+	/* Full resolution chroma of the rows being averaged, with room to  */
+	/* repeat the last column, and somewhere for the luma of rows past  */
+	/* the last one                                                     */
+	unsigned char fullBlue[2][CONVERT_CHUNK + 1];
+	unsigned char fullRed[2][CONVERT_CHUNK + 1];
+	unsigned char unusedLuma[CONVERT_CHUNK];
+
+	for (unsigned int chromaY = firstRow / subsampleY;
+		chromaY * subsampleY < endRow; chromaY++)
+	{
+		unsigned int chromaRow = chromaY - firstRow / subsampleY;
+		unsigned char* blueRow = blue + chromaRow * chromaStride;
+		unsigned char* redRow = red + chromaRow * chromaStride;
+
+		for (unsigned int x = 0; x < width; x += CONVERT_CHUNK)
+		{
+			unsigned int n = std::min((unsigned int)CONVERT_CHUNK, width - x);
+			for (unsigned int i = 0; i < subsampleY; i++)
+			{
+				/* The pixels start with the bottom row, walk them top down */
+				unsigned int y = chromaY * subsampleY + i;
+				unsigned int sourceY = std::min(y, height - 1);
+				unsigned char* lumaOut = (y < endRow) ?
+					luma + (y - firstRow) * lumaStride + x : unusedLuma;
+				ColorConverter::rgbToYCbCr(pixels + (height - 1 - sourceY) *
+					rowStride + 3 * x, n, lumaOut, fullBlue[i], fullRed[i]);
+			}
+
+			/* Average the chroma over each block, repeating the last */
+			/* column if it is cut off                                */
+			if (n % subsampleX != 0)
+			{
+				for (unsigned int i = 0; i < subsampleY; i++)
+				{
+					fullBlue[i][n] = fullBlue[i][n - 1];
+					fullRed[i][n] = fullRed[i][n - 1];
+				}
+			}
+			ColorConverter::averageBlocks(fullBlue[0],
+				fullBlue[subsampleY - 1], n, subsampleX,
+				blueRow + x / subsampleX);
+			ColorConverter::averageBlocks(fullRed[0], fullRed[subsampleY - 1],
+				n, subsampleX, redRow + x / subsampleX);
+		}
+
+		/* Repeat the last column out to the strides */
+		for (unsigned int i = 0; i < subsampleY; i++)
+		{
+			unsigned int y = chromaY * subsampleY + i;
+			if (y < endRow)
+			{
+				unsigned char* lumaRow = luma + (y - firstRow) * lumaStride;
+				memset(lumaRow + width, lumaRow[width - 1], lumaStride - width);
+			}
+		}
+		memset(blueRow + chromaWidth, blueRow[chromaWidth - 1],
+			chromaStride - chromaWidth);
+		memset(redRow + chromaWidth, redRow[chromaWidth - 1],
+			chromaStride - chromaWidth);
+	}
+}
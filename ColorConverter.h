@@ -0,0 +1,50 @@
+/*
+ * ColorConverter.h
+ * Created by Zachary Ferguson
+ * Header file for the ColorConverter class, a class for converting rendered
+ * RGB frames to the full range BT.601 YCbCr used by JPEG and YUV4MPEG2.
+ */
+
+#ifndef COLORCONVERTER_H
+#define COLORCONVERTER_H
+
+/* Use the SSE2 kernel when compiling for SSE2, otherwise fall back to */
+/* scalar code.                                                        */
+#if defined(__SSE2__) || defined(_M_X64) || \
+	(defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define COLORCONVERTER_SSE2
+#endif
+
+class ColorConverter
+{
+	private:
+
+		/* Averages count values of the top and bottom rows of chroma    */
+		/* over blocks subsampleX wide, 1 or 2, into chroma. If count is */
+		/* odd the rows must have room for one more value.               */
+		static void averageBlocks(const unsigned char* top,
+			const unsigned char* bottom, unsigned int count,
+			unsigned int subsampleX, unsigned char* chroma);
+
+	public:
+
+		/* Converts count RGB pixels to separate Y, Cb, and Cr values. */
+		static void rgbToYCbCr(const unsigned char* rgb, unsigned int count,
+			unsigned char* luma, unsigned char* blue, unsigned char* red);
+
+		/* Converts numRows rows of a frame, starting at firstRow from    */
+		/* the top, into Y, Cb, and Cr planes. The frame's RGB pixels     */
+		/* start with the bottom row. Chroma is averaged over blocks of   */
+		/* subsampleX by subsampleY pixels, each 1 or 2, so the planes    */
+		/* get numRows / subsampleY rows of chroma, rounded up. Rows and  */
+		/* columns past the edge of the frame, up to the strides, repeat  */
+		/* the last row and column.                                       */
+		static void frameToYCbCr(const unsigned char* pixels,
+			unsigned int width, unsigned int height, unsigned int firstRow,
+			unsigned int numRows, unsigned int subsampleX,
+			unsigned int subsampleY, unsigned char* luma,
+			unsigned int lumaStride, unsigned char* blue, unsigned char* red,
+			unsigned int chromaStride);
+};
+
+#endif
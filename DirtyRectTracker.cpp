@@ -0,0 +1,192 @@
+/*
+ * DirtyRectTracker.cpp
+ * Created by Zachary Ferguson
+ * Source file for the DirtyRectTracker class, a class for finding the part
+ * of a frame that changed since the frame before it, so a SoftwareRasterizer
+ * that kept the last frame only redraws that part.
+ */
+
+#include "DirtyRectTracker.h"
+#include <algorithm> /* Included for min and max        */
+#include <cmath>     /* Included for floor and isfinite */
+
+/* Returns if the rectangle has no pixels. */
+static bool isEmpty(const SoftwareRasterizer::Rect& rect)
+{
+	return rect.left >= rect.right || rect.bottom >= rect.top;
+}
+
+/* Returns the smallest rectangle around both rectangles. */
+static SoftwareRasterizer::Rect combine(const SoftwareRasterizer::Rect& r1,
+	const SoftwareRasterizer::Rect& r2)
+{
+	if (isEmpty(r1))
+	{
+		return r2;
+	}
+	if (isEmpty(r2))
+	{
+		return r1;
+	}
+	SoftwareRasterizer::Rect rect = {
+		std::min(r1.left, r2.left), std::min(r1.bottom, r2.bottom),
+		std::max(r1.right, r2.right), std::max(r1.top, r2.top)
+	};
+	return rect;
+}
+
+/* Constructor for a DirtyRectTracker for frames of the given size in */
+/* pixels, with no last frame.                                        */
+DirtyRectTracker::DirtyRectTracker(unsigned int width, unsigned int height)
+{
+	this->width = width;
+	this->height = height;
+	this->hasLastFrame = false;
+}
+
+/* Destructor for the DirtyRectTracker */
+DirtyRectTracker::~DirtyRectTracker()
+{
+
+}
+
+/* Forgets the last frame, so the next one is redrawn in full. */
+void DirtyRectTracker::reset()
+{
+	this->hasLastFrame = false;
+}
+
+/* Returns the pixels covered by the vertices of Node i in the batch, with */
+/* a pixel to spare on each side for lines.                                */
+SoftwareRasterizer::Rect DirtyRectTracker::findBounds(
+	const RenderBatch& batch, const std::vector<unsigned int>& firstVertices,
+	unsigned int i) const
+{
+	const unsigned int numTypes = RenderBatch::NUM_PRIMITIVE_TYPES;
+	float minX = 0.0f, minY = 0.0f, maxX = 0.0f, maxY = 0.0f;
+	bool found = false;
+	for (unsigned int type = 0; type < numTypes; type++)
+	{
+		const float* positions =
+			batch.getPositions((RenderBatch::PrimitiveType)type);
+		for (unsigned int v = firstVertices[numTypes * i + type];
+			v < firstVertices[numTypes * (i + 1) + type]; v++)
+		{
+			/* The rasterizer draws nothing with a vertex that is not */
+			/* finite, and it would not clamp                         */
+			float x = positions[2 * v], y = positions[2 * v + 1];
+			if (!std::isfinite(x) || !std::isfinite(y))
+			{
+				continue;
+			}
+			minX = found ? std::min(minX, x) : x;
+			maxX = found ? std::max(maxX, x) : x;
+			minY = found ? std::min(minY, y) : y;
+			maxY = found ? std::max(maxY, y) : y;
+			found = true;
+		}
+	}
+	if (!found)
+	{
+		SoftwareRasterizer::Rect none = {0, 0, 0, 0};
+		return none;
+	}
+
+	/* The same mapping as the rasterizer, kept inside the frame so the */
+	/* conversion to int can not overflow.                              */
+	float w = (float)(this->width), h = (float)(this->height);
+	float left = (minX - VIEW_LEFT) / (VIEW_RIGHT - VIEW_LEFT) * w;
+	float right = (maxX - VIEW_LEFT) / (VIEW_RIGHT - VIEW_LEFT) * w;
+	float bottom = (minY - VIEW_BOTTOM) / (VIEW_TOP - VIEW_BOTTOM) * h;
+	float top = (maxY - VIEW_BOTTOM) / (VIEW_TOP - VIEW_BOTTOM) * h;
+	SoftwareRasterizer::Rect rect = {
+		(int)floor(std::min(std::max(left, -1.0f), w + 1.0f)) - 1,
+		(int)floor(std::min(std::max(bottom, -1.0f), h + 1.0f)) - 1,
+		(int)floor(std::min(std::max(right, -1.0f), w + 1.0f)) + 2,
+		(int)floor(std::min(std::max(top, -1.0f), h + 1.0f)) + 2
+	};
+	return rect;
+}
+
+/* Compares the frame in the batch, appended by the evaluated FlatSceneGraph */
+/* along with firstVertices, against the last frame and remembers it as the  */
+/* new last frame. Sets dirty to the smallest rectangle around every Node    */
+/* whose transformation, color, or geometry changed, covering both where it  */
+/* was and where it is now. The whole frame is dirty the first time or if    */
+/* the tree changed. Returns if anything is dirty.                           */
+bool DirtyRectTracker::update(const FlatSceneGraph& flatSceneGraph,
+	const RenderBatch& batch, const std::vector<unsigned int>& firstVertices,
+	SoftwareRasterizer::Rect& dirty)
+{
+	const unsigned int numTypes = RenderBatch::NUM_PRIMITIVE_TYPES;
+	unsigned int numNodes = flatSceneGraph.size();
+	bool redrawAll = !(this->hasLastFrame) ||
+		this->transforms.size() != numNodes;
+	if (redrawAll)
+	{
+		this->transforms.resize(numNodes);
+		this->colors.resize(3 * numNodes);
+		this->vertexCounts.resize(numTypes * numNodes);
+		this->bounds.resize(numNodes);
+	}
+
+	SoftwareRasterizer::Rect none = {0, 0, 0, 0};
+	dirty = none;
+	for (unsigned int i = 0; i < numNodes; i++)
+	{
+		const affine2& transform = flatSceneGraph.getWorldTransformation(i);
+		bool changed = redrawAll || transform != this->transforms[i];
+
+		/* Every vertex of a Node has its color, so look at the first */
+		float color[3] = {0.0f, 0.0f, 0.0f};
+		bool colored = false;
+		for (unsigned int type = 0; type < numTypes; type++)
+		{
+			unsigned int first = firstVertices[numTypes * i + type];
+			unsigned int count = firstVertices[numTypes * (i + 1) + type] -
+				first;
+			if (count > 0 && !colored)
+			{
+				const float* vertexColor = batch.getColors(
+					(RenderBatch::PrimitiveType)type) + 3 * first;
+				color[0] = vertexColor[0];
+				color[1] = vertexColor[1];
+				color[2] = vertexColor[2];
+				colored = true;
+			}
+			changed = changed ||
+				count != this->vertexCounts[numTypes * i + type];
+			this->vertexCounts[numTypes * i + type] = count;
+		}
+		for (unsigned int c = 0; c < 3; c++)
+		{
+			changed = changed || color[c] != this->colors[3 * i + c];
+			this->colors[3 * i + c] = color[c];
+		}
+		if (!changed)
+		{
+			continue;
+		}
+
+		SoftwareRasterizer::Rect nodeBounds =
+			this->findBounds(batch, firstVertices, i);
+		dirty = combine(dirty, combine(this->bounds[i], nodeBounds));
+		this->transforms[i] = transform;
+		this->bounds[i] = nodeBounds;
+	}
+
+	if (redrawAll)
+	{
+		SoftwareRasterizer::Rect all = {0, 0, (int)(this->width),
+			(int)(this->height)};
+		dirty = all;
+	}
+	this->hasLastFrame = true;
+
+	/* Keep the rectangle inside the frame */
+	dirty.left = std::max(dirty.left, 0);
+	dirty.bottom = std::max(dirty.bottom, 0);
+	dirty.right = std::min(dirty.right, (int)(this->width));
+	dirty.top = std::min(dirty.top, (int)(this->height));
+	return !isEmpty(dirty);
+}
@@ -0,0 +1,70 @@
+/*
+ * DirtyRectTracker.h
+ * Created by Zachary Ferguson
+ * Header file for the DirtyRectTracker class, a class for finding the part
+ * of a frame that changed since the frame before it, so a SoftwareRasterizer
+ * that kept the last frame only redraws that part.
+ */
+
+#ifndef DIRTYRECTTRACKER_H
+#define DIRTYRECTTRACKER_H
+
+/* Include necessary types */
+#include <vector>
+#include "FlatSceneGraph.h"
+#include "RenderBatch.h"
+#include "SoftwareRasterizer.h"
+
+class DirtyRectTracker
+{
+	private:
+
+		/* Size of the frames in pixels. */
+		unsigned int width, height;
+
+		/* If there is a last frame to compare against. */
+		bool hasLastFrame;
+
+		/** Each Node as it was drawn in the last frame. **/
+		/* The accumulated transformation. */
+		std::vector<affine2> transforms;
+		/* The r, g, b color. */
+		std::vector<float> colors;
+		/* The number of vertices of each primitive type. */
+		std::vector<unsigned int> vertexCounts;
+		/* The pixels the geometry covers, empty if nothing was drawn. */
+		std::vector<SoftwareRasterizer::Rect> bounds;
+
+		/* Returns the pixels covered by the vertices of Node i in the */
+		/* batch, with a pixel to spare on each side for lines.        */
+		SoftwareRasterizer::Rect findBounds(const RenderBatch& batch,
+			const std::vector<unsigned int>& firstVertices,
+			unsigned int i) const;
+
+	public:
+
+		/* Constructor for a DirtyRectTracker for frames of the given */
+		/* size in pixels, with no last frame.                        */
+		DirtyRectTracker(unsigned int width, unsigned int height);
+
+		/* Destructor for the DirtyRectTracker */
+		virtual ~DirtyRectTracker();
+
+		/* Forgets the last frame, so the next one is redrawn in full. */
+		void reset();
+
+		/* Compares the frame in the batch, appended by the evaluated   */
+		/* FlatSceneGraph along with firstVertices, against the last    */
+		/* frame and remembers it as the new last frame. Sets dirty to  */
+		/* the smallest rectangle around every Node whose               */
+		/* transformation, color, or geometry changed, covering both    */
+		/* where it was and where it is now. The whole frame is dirty   */
+		/* the first time or if the tree changed. Returns if anything   */
+		/* is dirty.                                                    */
+		bool update(const FlatSceneGraph& flatSceneGraph,
+			const RenderBatch& batch,
+			const std::vector<unsigned int>& firstVertices,
+			SoftwareRasterizer::Rect& dirty);
+};
+
+#endif
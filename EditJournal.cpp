@@ -0,0 +1,444 @@
+/*
+ * EditJournal.cpp
+ * Created by Zachary Ferguson
+ * Source file for the EditJournal class, an autosave of the scene being
+ * edited kept as a snapshot scene file and a journal of the edits made since.
+ * Each transformation or color edit appends one small record to the journal,
+ * so autosaving costs the same however large the scene is. Every so often
+ * the journal is compacted into a new snapshot on a background thread. After
+ * a crash the scene is recovered by replaying the journal over the snapshot.
+ */
+
+/* Allows fopen, fopen_s is only available on Windows */
+#define _CRT_SECURE_NO_WARNINGS
+
+#include "EditJournal.h"
+#include <cstring> /* Included for memcpy, memcmp and memset */
+#include <zlib/zlib.h>
+#include "FlatSceneGraph.h"
+#include "FrameWriter.h"
+#include "SceneFile.h"
+
+/* Identifies a journal, the first eight bytes of every one. */
+#define JOURNAL_MAGIC "ASGJOURN"
+
+/* Written as a word so a journal of the other byte order is recognized. */
+#define JOURNAL_BYTE_ORDER 0x01020304
+
+/* Version of the journal written. */
+#define JOURNAL_VERSION 1
+
+static_assert(sizeof(float) == 4 && sizeof(unsigned int) == 4,
+	"Journals are written with 32-bit words");
+
+/* Returns the CRC-32 of the bytes. */
+static unsigned int checksumBytes(const void* bytes, size_t size)
+{
+	unsigned long crc = crc32(0L, Z_NULL, 0);
+	if (size > 0)
+	{
+		crc = crc32(crc, (const Bytef*)bytes, (uInt)size);
+	}
+	return (unsigned int)crc;
+}
+
+/* Constructor for an EditJournal kept in the snapshot at the given path and */
+/* the journal next to it.                                                   */
+EditJournal::EditJournal(const std::string& path) : writing(false),
+	writeFailed(false)
+{
+	this->path = path;
+	this->journalPath = path + ".journal";
+	this->oldJournalPath = path + ".journal.old";
+	this->file = NULL;
+	this->root = NULL;
+	this->structureRevision = 0;
+	this->length = 0;
+	this->numRecords = 0;
+}
+
+/* Destructor for the EditJournal, waits for the snapshot being written and */
+/* closes the journal. The files are kept.                                  */
+EditJournal::~EditJournal()
+{
+	this->waitForWriting();
+	if (this->file != NULL)
+	{
+		fclose(this->file);
+	}
+}
+
+/* Returns if the snapshot is of the given scene graph as it is. */
+bool EditJournal::isCurrent(const Node* root) const
+{
+	return this->file != NULL && root != NULL && root == this->root &&
+		root->getStructureRevision() == this->structureRevision &&
+		root->getTrack()->getLength() == this->length;
+}
+
+/* Starts an empty journal for the scene graph, whose snapshot is the given */
+/* scene file and whose Nodes are indexed. Returns if it was opened.        */
+bool EditJournal::startJournal(const Node* root,
+	const std::vector<unsigned char>& snapshot)
+{
+	if (this->file != NULL)
+	{
+		fclose(this->file);
+	}
+	this->root = NULL;
+	this->numRecords = 0;
+
+	Header header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, JOURNAL_MAGIC, sizeof(header.magic));
+	header.byteOrder = JOURNAL_BYTE_ORDER;
+	header.version = JOURNAL_VERSION;
+	header.snapshotChecksum = checksumBytes(&snapshot[0], snapshot.size());
+	header.numNodes = (unsigned int)(this->indices.size());
+	header.length = root->getTrack()->getLength();
+
+	this->file = fopen(this->journalPath.c_str(), "wb");
+	if (this->file == NULL)
+	{
+		return false;
+	}
+	if (fwrite(&header, sizeof(header), 1, this->file) != 1 ||
+		fflush(this->file) != 0)
+	{
+		fclose(this->file);
+		this->file = NULL;
+		return false;
+	}
+	this->root = root;
+	this->structureRevision = root->getStructureRevision();
+	this->length = header.length;
+	return true;
+}
+
+/* Appends the record to the journal, compacting the journal once it is */
+/* long enough.                                                         */
+void EditJournal::append(Record& record)
+{
+	record.checksum = EditJournal::checksum(record);
+
+	/* Flushed at once, so the edit survives the editor crashing */
+	if (fwrite(&record, sizeof(record), 1, this->file) != 1 ||
+		fflush(this->file) != 0)
+	{
+		/* Stop recording until the next snapshot */
+		fclose(this->file);
+		this->file = NULL;
+		return;
+	}
+	this->numRecords++;
+	if (this->numRecords >= JOURNAL_COMPACT_RECORDS)
+	{
+		this->compact(this->root);
+	}
+}
+
+/* Waits for the snapshot being written, if any. */
+void EditJournal::waitForWriting()
+{
+	if (this->worker.joinable())
+	{
+		this->worker.join();
+	}
+}
+
+/* Writes the snapshot and drops the old journal. Run by the background */
+/* thread.                                                              */
+void EditJournal::writeSnapshot(std::vector<unsigned char>* bytes)
+{
+	bool written = SceneFile::saveBytes(*bytes, this->path);
+	if (written)
+	{
+		/* The snapshot now holds the old journal's edits */
+		remove(this->oldJournalPath.c_str());
+	}
+	delete bytes;
+	this->writeFailed = !written;
+	this->writing = false;
+}
+
+/* Records the values of the given Node at the given frame after an edit to */
+/* its transformation or color.                                             */
+void EditJournal::recordKeyframe(const Node* root, const Node* node,
+	unsigned int frameNum)
+{
+	if (!(this->isCurrent(root)) && !(this->snapshot(root)))
+	{
+		return;
+	}
+	std::map<const Node*, unsigned int>::const_iterator index =
+		this->indices.find(node);
+	if (index == this->indices.end() || frameNum >= this->length)
+	{
+		return;
+	}
+
+	Record record;
+	memset(&record, 0, sizeof(record));
+	record.type = SET_KEYFRAME;
+	record.node = index->second;
+	record.frameNum = frameNum;
+	node->getTrack()->getValues(frameNum, Node::getInterpolated(),
+		record.values);
+	this->append(record);
+}
+
+/* Records keying the given Node's subtree at the given frame. */
+void EditJournal::recordMakeKeyframe(const Node* root, const Node* node,
+	unsigned int frameNum)
+{
+	if (!(this->isCurrent(root)) && !(this->snapshot(root)))
+	{
+		return;
+	}
+	std::map<const Node*, unsigned int>::const_iterator index =
+		this->indices.find(node);
+	if (index == this->indices.end() || frameNum >= this->length)
+	{
+		return;
+	}
+
+	Record record;
+	memset(&record, 0, sizeof(record));
+	record.type = MAKE_KEYFRAME;
+	record.node = index->second;
+	record.frameNum = frameNum;
+	record.interpolated = Node::getInterpolated() ? 1 : 0;
+	this->append(record);
+}
+
+/* Records removing the keyframe of the given Node at the given frame, when */
+/* an edit that made it is undone.                                          */
+void EditJournal::recordRemoveKeyframe(const Node* root, const Node* node,
+	unsigned int frameNum)
+{
+	if (!(this->isCurrent(root)) && !(this->snapshot(root)))
+	{
+		return;
+	}
+	std::map<const Node*, unsigned int>::const_iterator index =
+		this->indices.find(node);
+	if (index == this->indices.end() || frameNum >= this->length)
+	{
+		return;
+	}
+
+	Record record;
+	memset(&record, 0, sizeof(record));
+	record.type = REMOVE_KEYFRAME;
+	record.node = index->second;
+	record.frameNum = frameNum;
+	this->append(record);
+}
+
+/* Forgets the snapshot, so the next edit or compaction takes a new one. */
+/* Call when the scene graph is replaced.                                */
+void EditJournal::reset()
+{
+	this->root = NULL;
+	this->indices.clear();
+}
+
+/* Merges the journal into a new snapshot of the scene graph. The snapshot */
+/* is written in the background unless the structure or number of frames   */
+/* of the scene graph changed since the last one, as the journal's         */
+/* records would no longer fit it. Does nothing if there is nothing new to */
+/* save.                                                                   */
+void EditJournal::compact(const Node* root)
+{
+	if (this->writing || root == NULL)
+	{
+		return;
+	}
+	this->waitForWriting();
+
+	/* An old journal left by a failed write must be merged first */
+	if (!(this->isCurrent(root)) || this->writeFailed)
+	{
+		this->snapshot(root);
+		return;
+	}
+	if (this->numRecords == 0)
+	{
+		return;
+	}
+
+	/* Lay the snapshot out now, while the scene graph can not change */
+	std::vector<unsigned char>* bytes = new std::vector<unsigned char>();
+	if (!SceneFile::serialize(root, *bytes))
+	{
+		delete bytes;
+		return;
+	}
+
+	/* Keep the journal until the snapshot holding its edits is written, */
+	/* and start a new one for the edits made meanwhile                  */
+	fclose(this->file);
+	this->file = NULL;
+	if (!FrameWriter::replaceFile(this->journalPath, this->oldJournalPath) ||
+		!(this->startJournal(root, *bytes)))
+	{
+		delete bytes;
+		this->writeFailed = true;
+		return;
+	}
+	this->writing = true;
+	this->worker = std::thread(&EditJournal::writeSnapshot, this, bytes);
+}
+
+/* Takes a new snapshot of the scene graph and starts an empty journal, */
+/* waiting for the snapshot to be written. Returns if it was written.   */
+bool EditJournal::snapshot(const Node* root)
+{
+	this->waitForWriting();
+	if (this->file != NULL)
+	{
+		fclose(this->file);
+		this->file = NULL;
+	}
+	this->root = NULL;
+	std::vector<unsigned char> bytes;
+	if (root == NULL || !SceneFile::serialize(root, bytes) ||
+		!SceneFile::saveBytes(bytes, this->path))
+	{
+		return false;
+	}
+	remove(this->oldJournalPath.c_str());
+	this->writeFailed = false;
+
+	/* Records name Nodes by their place in the snapshot */
+	FlatSceneGraph flatSceneGraph;
+	flatSceneGraph.sync(root);
+	this->indices.clear();
+	for (unsigned int i = 0; i < flatSceneGraph.size(); i++)
+	{
+		this->indices[flatSceneGraph.getNode(i)] = i;
+	}
+	return this->startJournal(root, bytes);
+}
+
+/* Removes the snapshot and journals, after the editor closes normally. */
+void EditJournal::discard()
+{
+	this->waitForWriting();
+	if (this->file != NULL)
+	{
+		fclose(this->file);
+		this->file = NULL;
+	}
+	this->reset();
+	remove(this->journalPath.c_str());
+	remove(this->oldJournalPath.c_str());
+	remove(this->path.c_str());
+}
+
+/* Returns if there is an autosave at the given path to recover. */
+bool EditJournal::hasRecovery(const std::string& path)
+{
+	FILE* snapshotFile = fopen(path.c_str(), "rb");
+	if (snapshotFile == NULL)
+	{
+		return false;
+	}
+	fclose(snapshotFile);
+	return true;
+}
+
+/* Loads the snapshot at the given path and replays its journals over it. */
+/* Returns NULL if the snapshot could not be read.                        */
+Node* EditJournal::recover(const std::string& path)
+{
+	std::vector<unsigned char> bytes;
+	if (!FrameWriter::readFile(path, bytes) || bytes.empty())
+	{
+		return NULL;
+	}
+	unsigned int snapshotChecksum = checksumBytes(&bytes[0], bytes.size());
+	std::vector<unsigned char>().swap(bytes);
+	Node* root = SceneFile::load(path);
+	if (root == NULL)
+	{
+		return NULL;
+	}
+
+	/* The loaded scene graph is ours to change */
+	FlatSceneGraph flatSceneGraph;
+	flatSceneGraph.sync(root);
+	std::vector<Node*> nodes(flatSceneGraph.size());
+	for (unsigned int i = 0; i < flatSceneGraph.size(); i++)
+	{
+		nodes[i] = const_cast<Node*>(flatSceneGraph.getNode(i));
+	}
+
+	/* An old journal is only left while its snapshot was being written. */
+	/* If that snapshot never was, the old journal applies to this one   */
+	/* and the journal started with that snapshot follows it.            */
+	bool replayedOld = EditJournal::replay(path + ".journal.old", nodes,
+		snapshotChecksum, false);
+	EditJournal::replay(path + ".journal", nodes, snapshotChecksum,
+		replayedOld);
+	return root;
+}
+
+/* Replays the journal at the given path over the nodes of the snapshot  */
+/* in preorder, if it was started from the snapshot with the given       */
+/* checksum or follows on from one that was. Stops at the first record   */
+/* that can not be read. Returns if the journal applied to the snapshot. */
+bool EditJournal::replay(const std::string& path,
+	const std::vector<Node*>& nodes, unsigned int snapshotChecksum,
+	bool followsOn)
+{
+	FILE* journal = fopen(path.c_str(), "rb");
+	if (journal == NULL)
+	{
+		return false;
+	}
+	Header header;
+	unsigned int length = nodes[0]->getTrack()->getLength();
+	if (fread(&header, sizeof(header), 1, journal) != 1 ||
+		memcmp(header.magic, JOURNAL_MAGIC, sizeof(header.magic)) != 0 ||
+		header.byteOrder != JOURNAL_BYTE_ORDER ||
+		header.version != JOURNAL_VERSION ||
+		header.numNodes != nodes.size() || header.length != length ||
+		(header.snapshotChecksum != snapshotChecksum && !followsOn))
+	{
+		fclose(journal);
+		return false;
+	}
+
+	/* Edits are replayed with the interpolation they were made with */
+	bool interpolated = Node::getInterpolated();
+	Record record;
+	while (fread(&record, sizeof(record), 1, journal) == 1 &&
+		record.checksum == EditJournal::checksum(record) &&
+		record.node < nodes.size() && record.frameNum < length)
+	{
+		Node* node = nodes[record.node];
+		if (record.type == SET_KEYFRAME)
+		{
+			node->setKeyframe(record.frameNum, record.values);
+		}
+		else if (record.type == MAKE_KEYFRAME)
+		{
+			Node::setInterpolated(record.interpolated != 0);
+			node->makeKeyframe(record.frameNum);
+			Node::setInterpolated(interpolated);
+		}
+		else if (record.type == REMOVE_KEYFRAME && record.frameNum > 0)
+		{
+			node->removeKeyframe(record.frameNum);
+		}
+	}
+	fclose(journal);
+	return true;
+}
+
+/* Returns the checksum of the record. */
+unsigned int EditJournal::checksum(const Record& record)
+{
+	return checksumBytes(&record, sizeof(record) - sizeof(record.checksum));
+}
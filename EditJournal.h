@@ -0,0 +1,167 @@
+/*
+ * EditJournal.h
+ * Created by Zachary Ferguson
+ * Header file for the EditJournal class, an autosave of the scene being
+ * edited kept as a snapshot scene file and a journal of the edits made since.
+ * Each transformation or color edit appends one small record to the journal,
+ * so autosaving costs the same however large the scene is. Every so often
+ * the journal is compacted into a new snapshot on a background thread. After
+ * a crash the scene is recovered by replaying the journal over the snapshot.
+ */
+
+#ifndef EDITJOURNAL_H
+#define EDITJOURNAL_H
+
+/* Include necessary types */
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include "Node.h"
+
+/* Number of records after which the journal is compacted. */
+#define JOURNAL_COMPACT_RECORDS 4096
+
+class EditJournal
+{
+	private:
+
+		/* The kinds of edits recorded. */
+		enum RecordType {SET_KEYFRAME, MAKE_KEYFRAME, REMOVE_KEYFRAME};
+
+		/* Start of a journal, naming the snapshot it was started from */
+		/* by the checksum of its bytes, its number of nodes and its   */
+		/* number of frames.                                           */
+		struct Header
+		{
+			char magic[8];
+			unsigned int byteOrder;
+			unsigned int version;
+			unsigned int snapshotChecksum;
+			unsigned int numNodes;
+			unsigned int length;
+		};
+
+		/* One edit. SET_KEYFRAME stores the values of a keyframe of a  */
+		/* node, MAKE_KEYFRAME keys a node's subtree at a frame with    */
+		/* the given interpolation and REMOVE_KEYFRAME removes a        */
+		/* node's keyframe. The checksum covers the rest of the record, */
+		/* so one cut short by a crash is not replayed.                 */
+		struct Record
+		{
+			unsigned int type;
+			unsigned int node;
+			unsigned int frameNum;
+			unsigned int interpolated;
+			float values[KeyframeTrack::NUM_CHANNELS];
+			unsigned int checksum;
+		};
+
+		/* The snapshot, and the journal appended to. While a snapshot */
+		/* is written the journal before it is kept as the old one.    */
+		std::string path, journalPath, oldJournalPath;
+		FILE* file;
+
+		/* The scene graph the snapshot was taken of, its structure   */
+		/* revision and number of frames then, and the preorder index */
+		/* of each of its Nodes. Edits are only recorded while these  */
+		/* still match.                                               */
+		const Node* root;
+		unsigned int structureRevision, length;
+		std::map<const Node*, unsigned int> indices;
+
+		/* Number of records in the journal. */
+		unsigned int numRecords;
+
+		/* Writes snapshots in the background. */
+		std::thread worker;
+		std::atomic<bool> writing;
+		std::atomic<bool> writeFailed;
+
+		/* Returns if the snapshot is of the given scene graph as it is. */
+		bool isCurrent(const Node* root) const;
+
+		/* Starts an empty journal for the scene graph, whose snapshot */
+		/* is the given scene file and whose Nodes are indexed.        */
+		/* Returns if it was opened.                                   */
+		bool startJournal(const Node* root,
+			const std::vector<unsigned char>& snapshot);
+
+		/* Appends the record to the journal, compacting the journal */
+		/* once it is long enough.                                   */
+		void append(Record& record);
+
+		/* Waits for the snapshot being written, if any. */
+		void waitForWriting();
+
+		/* Writes the snapshot and drops the old journal. Run by the */
+		/* background thread.                                        */
+		void writeSnapshot(std::vector<unsigned char>* bytes);
+
+		/* Replays the journal at the given path over the nodes of the */
+		/* snapshot in preorder, if it was started from the snapshot   */
+		/* with the given checksum or follows on from one that was.    */
+		/* Stops at the first record that can not be read. Returns if  */
+		/* the journal applied to the snapshot.                        */
+		static bool replay(const std::string& path,
+			const std::vector<Node*>& nodes, unsigned int snapshotChecksum,
+			bool followsOn);
+
+		/* Returns the checksum of the record. */
+		static unsigned int checksum(const Record& record);
+
+	public:
+
+		/* Constructor for an EditJournal kept in the snapshot at the */
+		/* given path and the journal next to it.                     */
+		EditJournal(const std::string& path);
+
+		/* Destructor for the EditJournal, waits for the snapshot being */
+		/* written and closes the journal. The files are kept.          */
+		virtual ~EditJournal();
+
+		/* Records the values of the given Node at the given frame after */
+		/* an edit to its transformation or color.                       */
+		void recordKeyframe(const Node* root, const Node* node,
+			unsigned int frameNum);
+
+		/* Records keying the given Node's subtree at the given frame. */
+		void recordMakeKeyframe(const Node* root, const Node* node,
+			unsigned int frameNum);
+
+		/* Records removing the keyframe of the given Node at the given */
+		/* frame, when an edit that made it is undone.                  */
+		void recordRemoveKeyframe(const Node* root, const Node* node,
+			unsigned int frameNum);
+
+		/* Forgets the snapshot, so the next edit or compaction takes a */
+		/* new one. Call when the scene graph is replaced.              */
+		void reset();
+
+		/* Merges the journal into a new snapshot of the scene graph.   */
+		/* The snapshot is written in the background unless the         */
+		/* structure or number of frames of the scene graph changed     */
+		/* since the last one, as the journal's records would no longer */
+		/* fit it. Does nothing if there is nothing new to save.        */
+		void compact(const Node* root);
+
+		/* Takes a new snapshot of the scene graph and starts an empty */
+		/* journal, waiting for the snapshot to be written. Returns if */
+		/* it was written.                                             */
+		bool snapshot(const Node* root);
+
+		/* Removes the snapshot and journals, after the editor closes */
+		/* normally.                                                  */
+		void discard();
+
+		/* Returns if there is an autosave at the given path to recover. */
+		static bool hasRecovery(const std::string& path);
+
+		/* Loads the snapshot at the given path and replays its journals */
+		/* over it. Returns NULL if the snapshot could not be read.      */
+		static Node* recover(const std::string& path);
+};
+
+#endif
@@ -0,0 +1,320 @@
+/*
+ * FlatSceneGraph.cpp
+ * Created by Zachary Ferguson
+ * Source file for the FlatSceneGraph class, a class for holding a compact
+ * runtime copy of a Node tree's hierarchy in contiguous arrays so the whole
+ * scene graph can be evaluated in one linear pass.
+ */
+
+#include "FlatSceneGraph.h"
+#include <utility> /* Included for pair */
+
+/* Parameters of the 64-bit FNV-1a hash. */
+#define FNV_OFFSET_BASIS 14695981039346656037ULL
+#define FNV_PRIME 1099511628211ULL
+
+/* Constructor for an empty FlatSceneGraph. */
+FlatSceneGraph::FlatSceneGraph()
+{
+	this->root = NULL;
+	this->structureRevision = 0;
+	this->worldTransformsValid = false;
+	this->evaluatedFrameNum = 0;
+	this->evaluatedInterpolated = false;
+}
+
+/* Destructor for the FlatSceneGraph. */
+FlatSceneGraph::~FlatSceneGraph()
+{
+
+}
+
+/* Rebuilds the arrays if the given root or its structure changed since */
+/* they were last built. The root may be NULL.                          */
+void FlatSceneGraph::sync(const Node* root)
+{
+	if(root != this->root || (root != NULL &&
+		root->getStructureRevision() != this->structureRevision))
+	{
+		this->build(root);
+	}
+}
+
+/* Forgets the current tree, forcing a rebuild on the next sync. */
+void FlatSceneGraph::clear()
+{
+	this->root = NULL;
+	this->nodes.clear();
+	this->parents.clear();
+	this->subtreeSizes.clear();
+	this->worldTransforms.clear();
+	this->transformRevisions.clear();
+	this->subtreeTransformRevisions.clear();
+	this->worldTransformsValid = false;
+}
+
+/* Rebuilds the arrays from the given root Node. */
+void FlatSceneGraph::build(const Node* root)
+{
+	this->clear();
+	this->root = root;
+	if(root == NULL)
+	{
+		return;
+	}
+	this->structureRevision = root->getStructureRevision();
+
+	/* Walk the tree depth-first with an explicit stack of Nodes and */
+	/* their parent's index.                                         */
+	std::vector<std::pair<const Node*, int> > stack;
+	stack.push_back(std::make_pair(root, -1));
+	while(!stack.empty())
+	{
+		const Node* n = stack.back().first;
+		int parent = stack.back().second;
+		stack.pop_back();
+
+		int index = (int)(this->nodes.size());
+		this->nodes.push_back(n);
+		this->parents.push_back(parent);
+
+		/* Push the children in reverse so they are visited in order */
+		const std::list<Node*>* children = n->getChildren();
+		for (std::list<Node*>::const_reverse_iterator it =
+			children->crbegin(); it != children->crend(); ++it)
+		{
+			stack.push_back(std::make_pair(*it, index));
+		}
+	}
+
+	/* Children come after their parents, so accumulate the subtree */
+	/* sizes from the back.                                         */
+	this->subtreeSizes.assign(this->nodes.size(), 1);
+	for(unsigned int i = (unsigned int)(this->nodes.size()) - 1; i > 0; i--)
+	{
+		this->subtreeSizes[this->parents[i]] += this->subtreeSizes[i];
+	}
+
+	this->worldTransforms.resize(this->nodes.size());
+	this->transformRevisions.resize(this->nodes.size());
+	this->subtreeTransformRevisions.resize(this->nodes.size());
+}
+
+/* Returns the number of Nodes in the flattened tree. */
+unsigned int FlatSceneGraph::size() const
+{
+	return (unsigned int)(this->nodes.size());
+}
+
+/* Returns the Node at the given depth-first index. */
+const Node* FlatSceneGraph::getNode(unsigned int i) const
+{
+	assert(i < this->nodes.size());
+	return this->nodes[i];
+}
+
+/* Returns the parent index of the Node at the given index. */
+int FlatSceneGraph::getParent(unsigned int i) const
+{
+	assert(i < this->parents.size());
+	return this->parents[i];
+}
+
+/* Returns the size of the subtree rooted at the given index. */
+unsigned int FlatSceneGraph::getSubtreeSize(unsigned int i) const
+{
+	assert(i < this->subtreeSizes.size());
+	return this->subtreeSizes[i];
+}
+
+/* Returns the accumulated transformation of the Node at the given index */
+/* from the last evaluate.                                               */
+const affine2& FlatSceneGraph::getWorldTransformation(unsigned int i) const
+{
+	assert(i < this->worldTransforms.size());
+	return this->worldTransforms[i];
+}
+
+/* Recomputes the world transformations of the subtree rooted at the given */
+/* index.                                                                  */
+void FlatSceneGraph::evaluateSubtree(unsigned int i,
+	const affine2& transformation)
+{
+	unsigned int end = i + this->subtreeSizes[i];
+	for(; i < end; i++)
+	{
+		/* Parents are always evaluated before their children */
+		const affine2& parentTransformation = this->parents[i] < 0 ?
+			transformation : this->worldTransforms[this->parents[i]];
+		this->worldTransforms[i] = parentTransformation *
+			this->nodes[i]->evaluateTransformation(this->evaluatedFrameNum);
+		this->transformRevisions[i] = this->nodes[i]->getTransformRevision();
+		this->subtreeTransformRevisions[i] =
+			this->nodes[i]->getSubtreeTransformRevision();
+	}
+}
+
+/* Computes the accumulated transformation of every Node at the given frame, */
+/* starting from the given transform. If only some Nodes changed since the   */
+/* last evaluate of the same frame, only their subtrees are recomputed.      */
+/* Returns the number of world transformations recomputed.                   */
+unsigned int FlatSceneGraph::evaluate(unsigned int frameNum,
+	const affine2& transformation)
+{
+	if(this->nodes.empty())
+	{
+		return 0;
+	}
+
+	/* A different frame or mode changes every Node */
+	if(!this->worldTransformsValid || frameNum != this->evaluatedFrameNum ||
+		Node::getInterpolated() != this->evaluatedInterpolated ||
+		transformation != this->evaluatedTransformation)
+	{
+		this->evaluatedFrameNum = frameNum;
+		this->evaluatedInterpolated = Node::getInterpolated();
+		this->evaluatedTransformation = transformation;
+		this->worldTransformsValid = true;
+		this->evaluateSubtree(0, transformation);
+		return this->size();
+	}
+
+	/* Walk down only the subtrees with changes, recomputing the subtree */
+	/* of every Node whose own transformations changed.                  */
+	unsigned int recomputed = 0;
+	unsigned int i = 0;
+	while(i < this->nodes.size())
+	{
+		const Node* n = this->nodes[i];
+		if(n->getSubtreeTransformRevision() ==
+			this->subtreeTransformRevisions[i])
+		{
+			/* Nothing below this Node changed */
+			i += this->subtreeSizes[i];
+		}
+		else if(n->getTransformRevision() != this->transformRevisions[i])
+		{
+			this->evaluateSubtree(i, transformation);
+			recomputed += this->subtreeSizes[i];
+			i += this->subtreeSizes[i];
+		}
+		else
+		{
+			/* Something below changed, so check the children */
+			this->subtreeTransformRevisions[i] =
+				n->getSubtreeTransformRevision();
+			i++;
+		}
+	}
+	return recomputed;
+}
+
+/* Adds the geometry of every Node to the RenderBatch with the */
+/* transformations from the last evaluate.                     */
+void FlatSceneGraph::appendTo(RenderBatch& batch, unsigned int frameNum) const
+{
+	for(unsigned int i = 0; i < this->nodes.size(); i++)
+	{
+		this->nodes[i]->appendTo(batch, this->worldTransforms[i], frameNum);
+	}
+}
+
+/* Adds the geometry of every Node to the RenderBatch like the other        */
+/* appendTo, and sets firstVertices to where each Node's vertices start.    */
+/* Entry NUM_PRIMITIVE_TYPES * i + type is the number of vertices of that   */
+/* type in the batch before Node i, and the entries after the last Node     */
+/* hold the totals.                                                         */
+void FlatSceneGraph::appendTo(RenderBatch& batch, unsigned int frameNum,
+	std::vector<unsigned int>& firstVertices) const
+{
+	const unsigned int numTypes = RenderBatch::NUM_PRIMITIVE_TYPES;
+	firstVertices.resize(numTypes * (this->nodes.size() + 1));
+	for(unsigned int i = 0; i <= this->nodes.size(); i++)
+	{
+		for(unsigned int type = 0; type < numTypes; type++)
+		{
+			firstVertices[numTypes * i + type] =
+				batch.getNumVertices((RenderBatch::PrimitiveType)type);
+		}
+		if(i < this->nodes.size())
+		{
+			this->nodes[i]->appendTo(batch, this->worldTransforms[i],
+				frameNum);
+		}
+	}
+}
+
+/* Adds size bytes of data to the 64-bit FNV-1a hash. */
+static unsigned long long hashBytes(unsigned long long hash, const void* data,
+	size_t size)
+{
+	const unsigned char* bytes = (const unsigned char*)data;
+	for(size_t i = 0; i < size; i++)
+	{
+		hash = (hash ^ bytes[i]) * FNV_PRIME;
+	}
+	return hash;
+}
+
+/* Returns a hash of the world transformations from the last evaluate and  */
+/* the color of every Node at the evaluated frame, what changes from frame */
+/* to frame. Frames of the same scene with the same hash draw the same     */
+/* image.                                                                  */
+unsigned long long FlatSceneGraph::hashEvaluated() const
+{
+	unsigned long long hash = FNV_OFFSET_BASIS;
+	for(unsigned int i = 0; i < this->nodes.size(); i++)
+	{
+		/* The top two rows of the transformation and the color */
+		float values[9] = {0};
+		for(unsigned int row = 0; row < 2; row++)
+		{
+			for(unsigned int column = 0; column < 3; column++)
+			{
+				values[3 * row + column] =
+					this->worldTransforms[i](row, column);
+			}
+		}
+		if(this->nodes[i]->getGeometry() != NULL)
+		{
+			/* Read the channels straight from the track, as appendTo  */
+			/* does, instead of allocating a vector of the colors      */
+			float channels[KeyframeTrack::NUM_CHANNELS];
+			this->nodes[i]->getTrack()->getValues(this->evaluatedFrameNum,
+				this->evaluatedInterpolated, channels);
+			values[6] = channels[KeyframeTrack::RED];
+			values[7] = channels[KeyframeTrack::GREEN];
+			values[8] = channels[KeyframeTrack::BLUE];
+		}
+		hash = hashBytes(hash, values, sizeof(values));
+	}
+	return hash;
+}
+
+/* Returns a hash of the kind of geometry, the vertices, and the parent  */
+/* index of every Node, what the frames share. Only changes when the     */
+/* scene is edited, so it is worked out once for a whole render.         */
+unsigned long long FlatSceneGraph::hashContent() const
+{
+	unsigned long long hash = FNV_OFFSET_BASIS;
+	for(unsigned int i = 0; i < this->nodes.size(); i++)
+	{
+		/* Nodes without geometry are a kind of their own */
+		const polyline* geometry = this->nodes[i]->getGeometry();
+		int header[3] = {this->parents[i], -1, 0};
+		if(geometry != NULL)
+		{
+			header[1] = (int)(geometry->getType());
+			header[2] = (int)(geometry->getNumVertices());
+		}
+		hash = hashBytes(hash, header, sizeof(header));
+		if(geometry != NULL)
+		{
+			hash = hashBytes(hash, geometry->getVertexX(),
+				header[2] * sizeof(float));
+			hash = hashBytes(hash, geometry->getVertexY(),
+				header[2] * sizeof(float));
+		}
+	}
+	return hash;
+}
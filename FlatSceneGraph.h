@@ -0,0 +1,128 @@
+/*
+ * FlatSceneGraph.h
+ * Created by Zachary Ferguson
+ * Header file for the FlatSceneGraph class, a class for holding a compact
+ * runtime copy of a Node tree's hierarchy in contiguous arrays so the whole
+ * scene graph can be evaluated in one linear pass.
+ */
+
+#ifndef FLATSCENEGRAPH_H
+#define FLATSCENEGRAPH_H
+
+/* Include necessary types */
+#include <vector>
+#include "Node.h"
+
+class FlatSceneGraph
+{
+	private:
+
+		/* The root Node the arrays were built from. */
+		const Node* root;
+
+		/* The structure revision of the root when the arrays were built. */
+		unsigned int structureRevision;
+
+		/* The Nodes of the tree in depth-first order. */
+		std::vector<const Node*> nodes;
+
+		/* Index of each Node's parent, -1 for the root. A parent always */
+		/* comes before its children.                                    */
+		std::vector<int> parents;
+
+		/* Number of Nodes in the subtree rooted at each Node, including */
+		/* the Node itself. The subtree of Node i is the index range     */
+		/* [i, i + subtreeSizes[i]).                                     */
+		std::vector<unsigned int> subtreeSizes;
+
+		/* The accumulated transformation of each Node, cached from the */
+		/* last evaluate.                                               */
+		std::vector<affine2> worldTransforms;
+
+		/* The transform and subtree transform revisions of each Node */
+		/* when its world transformation was last computed.           */
+		std::vector<unsigned int> transformRevisions;
+		std::vector<unsigned int> subtreeTransformRevisions;
+
+		/* The frame, interpolation mode, and starting transformation the  */
+		/* cached world transformations were computed for.                 */
+		bool worldTransformsValid;
+		unsigned int evaluatedFrameNum;
+		bool evaluatedInterpolated;
+		affine2 evaluatedTransformation;
+
+		/* Recomputes the world transformations of the subtree rooted at */
+		/* the given index.                                              */
+		void evaluateSubtree(unsigned int i, const affine2& transformation);
+
+		/* Rebuilds the arrays from the given root Node. */
+		void build(const Node* root);
+
+	public:
+
+		/* Constructor for an empty FlatSceneGraph. */
+		FlatSceneGraph();
+
+		/* Destructor for the FlatSceneGraph. */
+		virtual ~FlatSceneGraph();
+
+		/* Rebuilds the arrays if the given root or its structure changed */
+		/* since they were last built. The root may be NULL.              */
+		void sync(const Node* root);
+
+		/* Forgets the current tree, forcing a rebuild on the next sync. */
+		/* Must be called before the old root is deleted.                */
+		void clear();
+
+		/* Returns the number of Nodes in the flattened tree. */
+		unsigned int size() const;
+
+		/* Returns the Node at the given depth-first index. */
+		const Node* getNode(unsigned int i) const;
+
+		/* Returns the parent index of the Node at the given index. */
+		int getParent(unsigned int i) const;
+
+		/* Returns the size of the subtree rooted at the given index. */
+		unsigned int getSubtreeSize(unsigned int i) const;
+
+		/* Returns the accumulated transformation of the Node at the */
+		/* given index from the last evaluate.                       */
+		const affine2& getWorldTransformation(unsigned int i) const;
+
+		/* Computes the accumulated transformation of every Node at the   */
+		/* given frame, starting from the given transform. If only some   */
+		/* Nodes changed since the last evaluate of the same frame, only  */
+		/* their subtrees are recomputed. Returns the number of world     */
+		/* transformations recomputed. Several FlatSceneGraphs may        */
+		/* evaluate the same tree from different threads while it is not  */
+		/* being edited.                                                  */
+		unsigned int evaluate(unsigned int frameNum,
+			const affine2& transformation);
+
+		/* Adds the geometry of every Node to the RenderBatch with the */
+		/* transformations from the last evaluate.                     */
+		void appendTo(RenderBatch& batch, unsigned int frameNum) const;
+
+		/* Adds the geometry of every Node to the RenderBatch like the    */
+		/* other appendTo, and sets firstVertices to where each Node's    */
+		/* vertices start. Entry NUM_PRIMITIVE_TYPES * i + type is the    */
+		/* number of vertices of that type in the batch before Node i,    */
+		/* and the entries after the last Node hold the totals.           */
+		void appendTo(RenderBatch& batch, unsigned int frameNum,
+			std::vector<unsigned int>& firstVertices) const;
+
+		/* Returns a hash of the world transformations from the last    */
+		/* evaluate and the color of every Node at the evaluated frame, */
+		/* what changes from frame to frame. Frames of the same scene   */
+		/* with the same hash draw the same image.                      */
+		unsigned long long hashEvaluated() const;
+
+		/* Returns a hash of the kind of geometry, the vertices, and the */
+		/* parent index of every Node, what the frames share. Only       */
+		/* changes when the scene is edited, so it is worked out once    */
+		/* for a whole render.                                           */
+		unsigned long long hashContent() const;
+};
+
+#endif
@@ -27,7 +27,8 @@ Frame::Frame(mat3 scale, mat3 rotation, mat3 translation, float red, float green
 Frame::Frame(mat3 scale, mat3 rotation, mat3 translation, float red, float green,
 	float blue, bool isKeyframe)
 {
-	this->transformation =  translation * rotation * scale;
+	this->transformation = affine2(translation) * affine2(rotation) * 
+		affine2(scale);
 	this->extractTransformValues(scale, rotation, translation);
 	this->isKeyframe = isKeyframe;
 	this->color[0] = red;
@@ -35,14 +36,36 @@ Frame::Frame(mat3 scale, mat3 rotation, mat3 translation, float red, float green
 	this->color[2] = blue;
 }
 
+/* Constructor for a Frame that takes the individual transformation values, */
+/* the RGB values for the color of the frame, and a boolean for if this     */
+/* frame is a keyframe.                                                     */
+Frame::Frame(float scaleX, float scaleY, float rotationAngle, 
+	float translationX, float translationY, float red, float green, 
+	float blue, bool isKeyframe)
+{
+	/* Build translation * rotation * scale directly from the values. */
+	this->transformation = affine2::fromValues(scaleX, scaleY, rotationAngle,
+		translationX, translationY);
+
+	this->scaleX = scaleX;
+	this->scaleY = scaleY;
+	this->rotationAngle = rotationAngle;
+	this->translationX = translationX;
+	this->translationY = translationY;
+	this->isKeyframe = isKeyframe;
+	this->color[0] = red;
+	this->color[1] = green;
+	this->color[2] = blue;
+}
+
 /* Destructor for the Frame */
 Frame::~Frame()
 {
 	
 }
 
-/* Returns the mat3 transformation used for this frame. */
-const mat3 Frame::getTransformation() const
+/* Returns the affine transformation used for this frame. */
+const affine2& Frame::getTransformation() const
 {
 	return this->transformation;
 }
@@ -53,7 +76,8 @@ const mat3 Frame::getTransformation() const
 /* that order, for the new transformation.                           */
 void Frame::setTransformation(mat3 scale, mat3 rotation, mat3 translation)
 {
-	this->transformation =  translation * rotation * scale;
+	this->transformation = affine2(translation) * affine2(rotation) * 
+		affine2(scale);
 	this->extractTransformValues(scale, rotation, translation);
 }
 
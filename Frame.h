@@ -9,6 +9,7 @@
 
 /* Include necessary types */
 #include "mat3.h"
+#include "affine2.h"
 #include <vector>
 #include <cmath> /* Included for atan2 function */
 
@@ -18,8 +19,8 @@ class Frame
 {
 	private:
 	
-		/* The 3x3 matrix for this frames transformation */
-		mat3 transformation;
+		/* The affine matrix for this frames transformation */
+		affine2 transformation;
 		
 		/* Boolean value for if this frame is a key frame */
 		bool isKeyframe;
@@ -55,11 +56,18 @@ class Frame
 		Frame(mat3 scale, mat3 rotation, mat3 translation, float red, float green,
 			float blue, bool isKeyframe);
 
+		/* Constructor for a Frame that takes the individual transformation */
+		/* values, the RGB values for the color of the frame, and a boolean */
+		/* for if this frame is a keyframe.                                 */
+		Frame(float scaleX, float scaleY, float rotationAngle, 
+			float translationX, float translationY, float red, float green, 
+			float blue, bool isKeyframe);
+
 		/* Destructor for the Frame */
 		virtual ~Frame();
 
-		/* Returns the mat3 transformation used for this frame. */
-		const mat3 getTransformation() const;
+		/* Returns the affine transformation used for this frame. */
+		const affine2& getTransformation() const;
 		
 		/* Sets this frames transformation mat3 to the product of the three  */
 		/* different transformation mat3's given.                            */
@@ -0,0 +1,268 @@
+/*
+ * FramePipeline.cpp
+ * Created by Zachary Ferguson
+ * Source file for the FramePipeline class, a class for encoding and writing
+ * out rendered frames on background threads. Rendered frames are handed to a
+ * pool of encoder threads through a bounded queue, and a writer thread writes
+ * the encoded frames out in order to a FrameSink.
+ */
+
+#include "FramePipeline.h"
+#include <algorithm> /* Included for max */
+
+/* Constructor for a FramePipeline that takes the open sink to write to,  */
+/* the prepared job whose frames are written, the size of the frames, and */
+/* the number of encoder threads. Each frame written is recorded in the   */
+/* job's manifest. The sink is not deleted or closed.                     */
+FramePipeline::FramePipeline(FrameSink* sink, const RenderJob* job,
+	unsigned int width, unsigned int height, unsigned int numEncoders) :
+	rawFrames(std::max(numEncoders, 1u) * FRAMES_QUEUED_PER_ENCODER,
+		RawFrame(3 * width * height)),
+	encodedFrames(std::max(numEncoders, 1u) * FRAMES_QUEUED_PER_ENCODER)
+{
+	numEncoders = std::max(numEncoders, 1u);
+	this->width = width;
+	this->height = height;
+	this->sink = sink;
+	this->job = job;
+	this->nextToWrite = 0;
+	this->maxFramesAhead = numEncoders * FRAMES_AHEAD_PER_ENCODER;
+	this->failed = false;
+	this->finished = false;
+
+	StageStats none = {0, 0.0, 0.0};
+	this->rendered = this->encoded = this->written = none;
+	this->repeatedFrames = 0;
+	this->renderWaitSeconds = 0.0;
+	this->encodedBytes = 0.0;
+	this->start = std::chrono::steady_clock::now();
+
+	for (unsigned int i = 0; i < numEncoders; i++)
+	{
+		this->encoders.push_back(std::thread(&FramePipeline::encode, this));
+	}
+	this->writer = std::thread(&FramePipeline::write, this);
+}
+
+/* Destructor for the FramePipeline, finishes the frames left. */
+FramePipeline::~FramePipeline()
+{
+	this->finish();
+}
+
+/* Returns the seconds since the pipeline started. */
+double FramePipeline::secondsSinceStart() const
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+		this->start).count();
+}
+
+/* Waits until the frame at the given index is close enough to the frame */
+/* being written to be handed over. Returns false if a frame could not   */
+/* be written.                                                           */
+bool FramePipeline::waitToSubmit(unsigned int index)
+{
+	/* Do not get too far ahead of the frame being written, so frames */
+	/* finished out of order can not pile up.                         */
+	std::unique_lock<std::mutex> lock(this->mutex);
+	while (!(this->failed) &&
+		index >= this->nextToWrite + this->maxFramesAhead)
+	{
+		this->frameWritten.wait(lock);
+	}
+	return !(this->failed);
+}
+
+/* Hands over the RGB pixels of the rendered frame at the given index in   */
+/* the job, starting with the bottom row. The pixels are swapped with a    */
+/* preallocated buffer no longer in use, which the next frame can be       */
+/* captured into without allocating. Waits while the encoders are behind.  */
+/* Safe to call from several threads at once. Returns false if a frame     */
+/* could not be written, in which case the rest of the frames are dropped. */
+bool FramePipeline::submit(unsigned int index,
+	std::vector<unsigned char>& pixels)
+{
+	double waitStart = this->secondsSinceStart();
+	if (!(this->waitToSubmit(index)))
+	{
+		return false;
+	}
+
+	RawFrame frame;
+	frame.index = index;
+	frame.pixels.swap(pixels);
+	this->rawFrames.push(frame);
+	/* Take back the buffer that was in the queue's slot */
+	pixels.swap(frame.pixels);
+
+	double now = this->secondsSinceStart();
+	std::lock_guard<std::mutex> lock(this->mutex);
+	this->rendered.frames++;
+	this->rendered.lastSeconds = now;
+	this->renderWaitSeconds += now - waitStart;
+	return !(this->failed);
+}
+
+/* Hands over the frame at the given index in the job, which draws the same */
+/* as the frame before it. The sink repeats it from the last encoded frame  */
+/* without it being rendered or encoded. Must not be the first frame. Waits */
+/* and returns like submit.                                                 */
+bool FramePipeline::submitRepeat(unsigned int index)
+{
+	if (!(this->waitToSubmit(index)))
+	{
+		return false;
+	}
+
+	/* Straight to the writer, there is nothing to encode */
+	EncodedFrame frame;
+	frame.index = index;
+	frame.repeated = true;
+	this->encodedFrames.push(frame);
+
+	std::lock_guard<std::mutex> lock(this->mutex);
+	this->repeatedFrames++;
+	return !(this->failed);
+}
+
+/* Encodes frames until the queue is closed. Run by every encoder thread. */
+void FramePipeline::encode()
+{
+	/* Swapped with the queue, so this buffer joins the capture ring */
+	RawFrame raw(3 * this->width * this->height);
+	EncodedFrame frame;
+	while (this->rawFrames.pop(raw))
+	{
+		double encodeStart = this->secondsSinceStart();
+		this->sink->encode(&(raw.pixels[0]), this->width, this->height,
+			frame.bytes);
+		frame.index = raw.index;
+		frame.repeated = false;
+		double now = this->secondsSinceStart();
+		{
+			std::lock_guard<std::mutex> lock(this->mutex);
+			this->encoded.frames++;
+			this->encoded.busySeconds += now - encodeStart;
+			this->encoded.lastSeconds = now;
+			this->encodedBytes += frame.bytes.size();
+		}
+		this->encodedFrames.push(frame);
+	}
+}
+
+/* Writes out the encoded frames in order until the queue is closed. Run by */
+/* the writer thread. Frames are held back in a ring of maxFramesAhead      */
+/* slots until it is their turn.                                            */
+void FramePipeline::write()
+{
+	/* submit keeps every frame within maxFramesAhead of nextToWrite, so */
+	/* each waiting frame has a slot of its own.                         */
+	std::vector<EncodedFrame> waiting(this->maxFramesAhead);
+	std::vector<bool> isWaiting(this->maxFramesAhead, false);
+	EncodedFrame frame;
+	/* The last frame with bytes of its own, for the repeated frames */
+	EncodedFrame last;
+	while (this->encodedFrames.pop(frame))
+	{
+		if (this->failed)
+		{
+			/* Drop the frames already on their way */
+			continue;
+		}
+		unsigned int slot = frame.index % this->maxFramesAhead;
+		swap(waiting[slot], frame);
+		isWaiting[slot] = true;
+
+		/* Write out every frame that is next in order */
+		while (isWaiting[slot = this->nextToWrite % this->maxFramesAhead])
+		{
+			double writeStart = this->secondsSinceStart();
+			unsigned int frameNum = this->job->getFrameNum(this->nextToWrite);
+			bool wasWritten;
+			if (waiting[slot].repeated)
+			{
+				wasWritten = this->sink->repeat(frameNum,
+					this->job->getFrameNum(last.index), last.bytes);
+			}
+			else
+			{
+				wasWritten = this->sink->write(frameNum, waiting[slot].bytes);
+				swap(last, waiting[slot]);
+			}
+			isWaiting[slot] = false;
+
+			/* Only once the frame is written out, so a render stopped */
+			/* part way through never skips a frame it did not finish  */
+			RenderManifest* manifest = this->job->getManifest();
+			if (wasWritten && manifest != NULL)
+			{
+				wasWritten = manifest->record(frameNum,
+					this->job->getFrameHash(this->nextToWrite), last.bytes);
+			}
+			double now = this->secondsSinceStart();
+
+			std::lock_guard<std::mutex> lock(this->mutex);
+			this->failed = !wasWritten;
+			this->written.frames++;
+			this->written.busySeconds += now - writeStart;
+			this->written.lastSeconds = now;
+			this->nextToWrite++;
+			this->frameWritten.notify_all();
+			if (this->failed)
+			{
+				break;
+			}
+		}
+	}
+}
+
+/* Waits until every submitted frame is written. Returns false if a frame */
+/* could not be written.                                                  */
+bool FramePipeline::finish()
+{
+	if (!(this->finished))
+	{
+		this->finished = true;
+
+		/* Let each stage drain before closing the next */
+		this->rawFrames.close();
+		for (unsigned int i = 0; i < this->encoders.size(); i++)
+		{
+			this->encoders[i].join();
+		}
+		this->encodedFrames.close();
+		this->writer.join();
+	}
+	return !(this->failed);
+}
+
+/* Prints the frames per second of each stage, how long the renderers     */
+/* waited, how busy the other stages were, and the time and size of each  */
+/* frame in the sink.                                                     */
+void FramePipeline::printStats(std::ostream& out) const
+{
+	std::lock_guard<std::mutex> lock(this->mutex);
+	double elapsed = std::max(this->written.lastSeconds, 1e-9);
+	double encodedFrames = std::max(this->encoded.frames, 1u);
+	double writtenFrames = std::max(this->written.frames, 1u);
+
+	out << "Output: " << this->sink->getDescription() << std::endl;
+	out << "Rendered " << this->rendered.frames << " frames, " <<
+		this->rendered.frames / std::max(this->rendered.lastSeconds, 1e-9) <<
+		" frames/s, waited " << this->renderWaitSeconds <<
+		" s for the encoders" << std::endl;
+	out << "Repeated " << this->repeatedFrames <<
+		" unchanged frames without rendering or encoding them" << std::endl;
+	out << "Encoded " << this->encoded.frames << " frames, " <<
+		this->encoded.frames / std::max(this->encoded.lastSeconds, 1e-9) <<
+		" frames/s, " << this->encoders.size() << " encoders busy " <<
+		(int)(100 * this->encoded.busySeconds / this->encoders.size() /
+		elapsed) << "% of the time, " << 1000 * this->encoded.busySeconds /
+		encodedFrames << " ms and " << this->encodedBytes / 1024 /
+		encodedFrames << " KB per frame" << std::endl;
+	out << "Written " << this->written.frames << " frames, " <<
+		this->written.frames / elapsed << " frames/s, busy " <<
+		(int)(100 * this->written.busySeconds / elapsed) <<
+		"% of the time, " << 1000 * this->written.busySeconds /
+		writtenFrames << " ms per frame" << std::endl;
+}
@@ -0,0 +1,181 @@
+/*
+ * FramePipeline.h
+ * Created by Zachary Ferguson
+ * Header file for the FramePipeline class, a class for encoding and writing
+ * out rendered frames on background threads. Rendered frames are handed to a
+ * pool of encoder threads through a bounded queue, and a writer thread writes
+ * the encoded frames out in order to a FrameSink.
+ */
+
+#ifndef FRAMEPIPELINE_H
+#define FRAMEPIPELINE_H
+
+/* Include necessary types */
+#include <vector>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <ostream>
+#include "BoundedQueue.h"
+#include "FrameSink.h"
+#include "RenderJob.h"
+
+/* Number of queued frames per encoder thread. */
+#define FRAMES_QUEUED_PER_ENCODER 2
+
+/* Number of frames per encoder thread that may be submitted ahead of the */
+/* frame being written.                                                   */
+#define FRAMES_AHEAD_PER_ENCODER 6
+
+class FramePipeline
+{
+	private:
+
+		/* A rendered frame waiting to be encoded, and its index in the */
+		/* job.                                                         */
+		struct RawFrame
+		{
+			unsigned int index;
+			std::vector<unsigned char> pixels;
+
+			RawFrame() : index(0){}
+			/* Preallocates the pixels of a frame of the given size */
+			RawFrame(unsigned int size) : index(0), pixels(size){}
+
+			friend void swap(RawFrame& f1, RawFrame& f2)
+			{
+				std::swap(f1.index, f2.index);
+				f1.pixels.swap(f2.pixels);
+			}
+		};
+
+		/* An encoded frame waiting to be written, and its index in the */
+		/* job. A repeated frame has no bytes of its own, it is the     */
+		/* same as the frame before it.                                 */
+		struct EncodedFrame
+		{
+			unsigned int index;
+			bool repeated;
+			std::vector<unsigned char> bytes;
+
+			EncodedFrame() : index(0), repeated(false){}
+
+			friend void swap(EncodedFrame& f1, EncodedFrame& f2)
+			{
+				std::swap(f1.index, f2.index);
+				std::swap(f1.repeated, f2.repeated);
+				f1.bytes.swap(f2.bytes);
+			}
+		};
+
+		/* Counters for one stage of the pipeline. */
+		struct StageStats
+		{
+			unsigned int frames;
+			/* Seconds spent working, summed over the stage's threads. */
+			/* Not counted for rendering, which is done by the caller. */
+			double busySeconds;
+			/* Seconds from the start until the last frame. */
+			double lastSeconds;
+		};
+
+		/* Size of the frames in pixels. */
+		unsigned int width, height;
+
+		/* Where the frames are encoded and written to. */
+		FrameSink* sink;
+
+		/* The frames to write, in order. */
+		const RenderJob* job;
+
+		/* Queues between the stages. The slots of rawFrames are the ring */
+		/* of capture buffers, preallocated to the size of a frame.       */
+		BoundedQueue<RawFrame> rawFrames;
+		BoundedQueue<EncodedFrame> encodedFrames;
+
+		/* The stage threads. */
+		std::vector<std::thread> encoders;
+		std::thread writer;
+
+		/** State shared by the threads, guarded by the mutex. **/
+		mutable std::mutex mutex;
+		/* Signalled whenever a frame is written. */
+		std::condition_variable frameWritten;
+		/* Index in the job of the next frame to write. */
+		unsigned int nextToWrite;
+		/* Maximum number of frames submitted but not yet written. */
+		unsigned int maxFramesAhead;
+		/* If a frame could not be written. */
+		bool failed;
+		/* If finish has been called. */
+		bool finished;
+		/* Counters for rendering, encoding, and writing. */
+		StageStats rendered, encoded, written;
+		/* Number of repeated frames, which skip rendering and encoding. */
+		unsigned int repeatedFrames;
+		/* Seconds the renderers spent waiting in submit. */
+		double renderWaitSeconds;
+		/* Total size of the encoded frames. */
+		double encodedBytes;
+		std::chrono::steady_clock::time_point start;
+
+		/* Returns the seconds since the pipeline started. */
+		double secondsSinceStart() const;
+
+		/* Waits until the frame at the given index is close enough to  */
+		/* the frame being written to be handed over. Returns false if  */
+		/* a frame could not be written.                                */
+		bool waitToSubmit(unsigned int index);
+
+		/* Encodes frames until the queue is closed. Run by every encoder */
+		/* thread.                                                        */
+		void encode();
+
+		/* Writes out the encoded frames in order until the queue is */
+		/* closed. Run by the writer thread. Frames are held back in */
+		/* a ring of maxFramesAhead slots until it is their turn.    */
+		void write();
+
+	public:
+
+		/* Constructor for a FramePipeline that takes the open sink to   */
+		/* write to, the prepared job whose frames are written, the size */
+		/* of the frames, and the number of encoder threads. Each frame  */
+		/* written is recorded in the job's manifest. The sink is not    */
+		/* deleted or closed.                                            */
+		FramePipeline(FrameSink* sink, const RenderJob* job,
+			unsigned int width, unsigned int height,
+			unsigned int numEncoders);
+
+		/* Destructor for the FramePipeline, finishes the frames left. */
+		virtual ~FramePipeline();
+
+		/* Hands over the RGB pixels of the rendered frame at the given  */
+		/* index in the job, starting with the bottom row. The pixels    */
+		/* are swapped with a preallocated buffer no longer in use,      */
+		/* which the next frame can be captured into without allocating. */
+		/* Waits while the encoders are behind. Safe to call from        */
+		/* several threads at once. Returns false if a frame could not   */
+		/* be written, in which case the rest of the frames are dropped. */
+		bool submit(unsigned int index, std::vector<unsigned char>& pixels);
+
+		/* Hands over the frame at the given index in the job, which     */
+		/* draws the same as the frame before it. The sink repeats it    */
+		/* from the last encoded frame without it being rendered or      */
+		/* encoded. Must not be the first frame. Waits and returns like  */
+		/* submit.                                                       */
+		bool submitRepeat(unsigned int index);
+
+		/* Waits until every submitted frame is written. Returns false if */
+		/* a frame could not be written.                                  */
+		bool finish();
+
+		/* Prints the frames per second of each stage, how long the */
+		/* renderers waited, how busy the other stages were, and    */
+		/* the time and size of each frame in the sink.             */
+		void printStats(std::ostream& out) const;
+};
+
+#endif
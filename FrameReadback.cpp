@@ -0,0 +1,199 @@
+/*
+ * FrameReadback.cpp
+ * Created by Zachary Ferguson
+ * Source file for the FrameReadback class, a class for reading rendered
+ * frames back from OpenGL without waiting on each one. Frames are read into
+ * a ring of pixel buffer objects, so a frame is copied out while the next
+ * ones draw. Falls back to reading each frame directly when pixel buffer
+ * objects are not available.
+ */
+
+#include "FrameReadback.h"
+#include <cstring> /* Included for memcpy and strstr */
+#include <cstdlib> /* Included for atof */
+#include <stddef.h> /* Included for ptrdiff_t */
+#if !defined(_WIN32) && !defined(__APPLE__)
+#include <GL/glx.h>
+#endif
+
+/* Pixel buffer objects are OpenGL 2.1, newer than the headers on Windows */
+#ifndef GL_PIXEL_PACK_BUFFER
+#define GL_PIXEL_PACK_BUFFER 0x88EB
+#endif
+#ifndef GL_STREAM_READ
+#define GL_STREAM_READ 0x88E1
+#endif
+#ifndef GL_READ_ONLY
+#define GL_READ_ONLY 0x88B8
+#endif
+#ifndef APIENTRY
+#define APIENTRY
+#endif
+
+/* The buffer object functions, loaded once a context is current. */
+typedef void (APIENTRY *GenBuffersFunc)(GLsizei n, GLuint* buffers);
+typedef void (APIENTRY *DeleteBuffersFunc)(GLsizei n, const GLuint* buffers);
+typedef void (APIENTRY *BindBufferFunc)(GLenum target, GLuint buffer);
+typedef void (APIENTRY *BufferDataFunc)(GLenum target, ptrdiff_t size,
+	const void* data, GLenum usage);
+typedef void* (APIENTRY *MapBufferFunc)(GLenum target, GLenum access);
+typedef GLboolean (APIENTRY *UnmapBufferFunc)(GLenum target);
+
+static GenBuffersFunc genBuffers = NULL;
+static DeleteBuffersFunc deleteBuffers = NULL;
+static BindBufferFunc bindBuffer = NULL;
+static BufferDataFunc bufferData = NULL;
+static MapBufferFunc mapBuffer = NULL;
+static UnmapBufferFunc unmapBuffer = NULL;
+
+/* Returns the address of the OpenGL function with the given name, or NULL */
+/* if it is not available.                                                 */
+static void* getProcAddress(const char* name)
+{
+#if defined(_WIN32)
+	return (void*)wglGetProcAddress(name);
+#elif defined(__APPLE__)
+	return NULL;
+#else
+	return (void*)glXGetProcAddress((const GLubyte*)name);
+#endif
+}
+
+/* Loads the buffer object functions and returns if pixel buffer objects */
+/* can be used in the current context.                                   */
+static bool loadPixelBufferObjects()
+{
+	/* Pixel buffer objects are core in OpenGL 2.1 and an extension before */
+	const char* version = (const char*)glGetString(GL_VERSION);
+	const char* extensions = (const char*)glGetString(GL_EXTENSIONS);
+	bool supported = (version != NULL && atof(version) >= 2.1) ||
+		(extensions != NULL && (strstr(extensions,
+		"GL_ARB_pixel_buffer_object") != NULL || strstr(extensions,
+		"GL_EXT_pixel_buffer_object") != NULL));
+	if (!supported)
+	{
+		return false;
+	}
+
+	genBuffers = (GenBuffersFunc)getProcAddress("glGenBuffers");
+	deleteBuffers = (DeleteBuffersFunc)getProcAddress("glDeleteBuffers");
+	bindBuffer = (BindBufferFunc)getProcAddress("glBindBuffer");
+	bufferData = (BufferDataFunc)getProcAddress("glBufferData");
+	mapBuffer = (MapBufferFunc)getProcAddress("glMapBuffer");
+	unmapBuffer = (UnmapBufferFunc)getProcAddress("glUnmapBuffer");
+	return genBuffers != NULL && deleteBuffers != NULL &&
+		bindBuffer != NULL && bufferData != NULL && mapBuffer != NULL &&
+		unmapBuffer != NULL;
+}
+
+/* Constructor for a FrameReadback that takes the size of the frames in */
+/* pixels. The OpenGL context the frames are read from must be current. */
+FrameReadback::FrameReadback(unsigned int width, unsigned int height)
+{
+	this->width = width;
+	this->height = height;
+	this->oldest = 0;
+	this->numPending = 0;
+	this->async = loadPixelBufferObjects();
+
+	if (this->async)
+	{
+		/* Clear out any earlier errors so only the buffers are checked */
+		while (glGetError() != GL_NO_ERROR){}
+
+		genBuffers(READBACK_BUFFERS, this->buffers);
+		for (int i = 0; i < READBACK_BUFFERS; i++)
+		{
+			bindBuffer(GL_PIXEL_PACK_BUFFER, this->buffers[i]);
+			bufferData(GL_PIXEL_PACK_BUFFER, 3 * width * height, NULL,
+				GL_STREAM_READ);
+		}
+		bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+		if (glGetError() != GL_NO_ERROR)
+		{
+			deleteBuffers(READBACK_BUFFERS, this->buffers);
+			this->async = false;
+		}
+	}
+
+	if (!(this->async))
+	{
+		this->pixels.resize(3 * width * height);
+	}
+}
+
+/* Destructor for the FrameReadback, the OpenGL context must be current. */
+FrameReadback::~FrameReadback()
+{
+	if (this->async)
+	{
+		deleteBuffers(READBACK_BUFFERS, this->buffers);
+	}
+}
+
+/* Returns if frames are read without waiting on them. */
+bool FrameReadback::isAsync() const
+{
+	return this->async;
+}
+
+/* Returns if another frame can be read before takeFrame is called. */
+bool FrameReadback::canRead() const
+{
+	return this->numPending < (this->async ? READBACK_BUFFERS : 1u);
+}
+
+/* Starts reading back the frame drawn in the current OpenGL context. Must */
+/* not be called unless canRead.                                           */
+void FrameReadback::readFrame()
+{
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+	if (this->async)
+	{
+		/* Returns right away, the copy into the buffer is queued */
+		bindBuffer(GL_PIXEL_PACK_BUFFER, this->buffers[(this->oldest +
+			this->numPending) % READBACK_BUFFERS]);
+		glReadPixels(0, 0, this->width, this->height, GL_RGB,
+			GL_UNSIGNED_BYTE, NULL);
+		bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+	}
+	else
+	{
+		glReadPixels(0, 0, this->width, this->height, GL_RGB,
+			GL_UNSIGNED_BYTE, &(this->pixels[0]));
+	}
+	this->numPending++;
+}
+
+/* Puts the RGB pixels of the oldest frame read, starting with the bottom */
+/* row, into pixels. Waits for the frame if it is still being read.       */
+/* Returns false if there are no frames left to take.                     */
+bool FrameReadback::takeFrame(std::vector<unsigned char>& pixels)
+{
+	if (this->numPending == 0)
+	{
+		return false;
+	}
+	this->numPending--;
+
+	if (!(this->async))
+	{
+		/* Hand over the frame and read the next into the old buffer */
+		this->pixels.swap(pixels);
+		this->pixels.resize(3 * this->width * this->height);
+		return true;
+	}
+
+	pixels.resize(3 * this->width * this->height);
+	bindBuffer(GL_PIXEL_PACK_BUFFER, this->buffers[this->oldest]);
+	const void* mapped = mapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
+	if (mapped != NULL)
+	{
+		memcpy(&(pixels[0]), mapped, pixels.size());
+		unmapBuffer(GL_PIXEL_PACK_BUFFER);
+	}
+	bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+	this->oldest = (this->oldest + 1) % READBACK_BUFFERS;
+	return true;
+}
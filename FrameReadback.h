@@ -0,0 +1,69 @@
+/*
+ * FrameReadback.h
+ * Created by Zachary Ferguson
+ * Header file for the FrameReadback class, a class for reading rendered
+ * frames back from OpenGL without waiting on each one. Frames are read into
+ * a ring of pixel buffer objects, so a frame is copied out while the next
+ * ones draw. Falls back to reading each frame directly when pixel buffer
+ * objects are not available.
+ */
+
+#ifndef FRAMEREADBACK_H
+#define FRAMEREADBACK_H
+
+/* Include necessary types */
+#include <FL/Gl.H>
+#include <vector>
+
+/* Number of pixel buffer objects frames are read into. */
+#define READBACK_BUFFERS 3
+
+class FrameReadback
+{
+	private:
+
+		/* Size of the frames in pixels. */
+		unsigned int width, height;
+
+		/* If frames are read into pixel buffer objects. */
+		bool async;
+
+		/* The pixel buffer objects, empty if not async. */
+		GLuint buffers[READBACK_BUFFERS];
+
+		/* Buffer the oldest frame is in and number of frames being read. */
+		unsigned int oldest, numPending;
+
+		/* Frame read directly when not async. */
+		std::vector<unsigned char> pixels;
+
+	public:
+
+		/* Constructor for a FrameReadback that takes the size of the     */
+		/* frames in pixels. The OpenGL context the frames are read from  */
+		/* must be current.                                               */
+		FrameReadback(unsigned int width, unsigned int height);
+
+		/* Destructor for the FrameReadback, the OpenGL context must be */
+		/* current.                                                     */
+		virtual ~FrameReadback();
+
+		/* Returns if frames are read without waiting on them. */
+		bool isAsync() const;
+
+		/* Returns if another frame can be read before takeFrame is */
+		/* called.                                                  */
+		bool canRead() const;
+
+		/* Starts reading back the frame drawn in the current OpenGL */
+		/* context. Must not be called unless canRead.               */
+		void readFrame();
+
+		/* Puts the RGB pixels of the oldest frame read, starting with */
+		/* the bottom row, into pixels. Waits for the frame if it is   */
+		/* still being read. Returns false if there are no frames left */
+		/* to take.                                                    */
+		bool takeFrame(std::vector<unsigned char>& pixels);
+};
+
+#endif
@@ -0,0 +1,73 @@
+/*
+ * FrameSink.h
+ * Created by Zachary Ferguson
+ * Header file for the FrameSink class, the base class for the outputs
+ * rendered frames are written to. Frames are encoded into bytes, possibly on
+ * several threads at once, and then written in order.
+ */
+
+#ifndef FRAMESINK_H
+#define FRAMESINK_H
+
+/* Include necessary types */
+#include <vector>
+#include <string>
+
+class FrameSink
+{
+	public:
+
+		/* Destructor for the FrameSink */
+		virtual ~FrameSink(){}
+
+		/* Opens the sink for frames of the given size in pixels played  */
+		/* at the given frames per second. Returns if it was opened.     */
+		virtual bool open(unsigned int width, unsigned int height,
+			double framerate) = 0;
+
+		/* Encodes the RGB pixels of a frame, starting with the bottom   */
+		/* row, into bytes to write. Safe to call from several threads   */
+		/* at once.                                                      */
+		virtual void encode(const unsigned char* pixels, unsigned int width,
+			unsigned int height, std::vector<unsigned char>& bytes) const = 0;
+
+		/* Writes out an encoded frame. Frames are written one at a time */
+		/* and in order. Returns if the frame was written.               */
+		virtual bool write(unsigned int frameNum,
+			const std::vector<unsigned char>& bytes) = 0;
+
+		/* Writes out a frame that is the same as an earlier one, given   */
+		/* the earlier frame's number and encoded bytes, without it being */
+		/* encoded again. Called in order along with write. Writes the    */
+		/* bytes again unless the sink has something cheaper.             */
+		virtual bool repeat(unsigned int frameNum, unsigned int sourceFrameNum,
+			const std::vector<unsigned char>& bytes)
+		{
+			return this->write(frameNum, bytes);
+		}
+
+		/* Sets bytes to the encoded frame already written out for the */
+		/* given frame, so a render can check it and pick up where it  */
+		/* left off. Returns false if the frame can not be read back,  */
+		/* which streams never can.                                    */
+		virtual bool readFrame(unsigned int frameNum,
+			std::vector<unsigned char>& bytes) const
+		{
+			return false;
+		}
+
+		/* Returns the file the frames written out are recorded in, or */
+		/* an empty string if the sink can not resume a render.        */
+		virtual std::string getManifestPath() const
+		{
+			return std::string();
+		}
+
+		/* Finishes writing frames. Returns if everything was written. */
+		virtual bool close() = 0;
+
+		/* Returns a short description of the output and its settings. */
+		virtual std::string getDescription() const = 0;
+};
+
+#endif
@@ -0,0 +1,370 @@
+/*
+ * FrameWriter.cpp
+ * Created by Zachary Ferguson
+ * Source file for the FrameWriter class, a class for encoding rendered frames
+ * as JPEG or PNG images and writing them out to files.
+ */
+
+/* Allows fopen, fopen_s is only available on Windows */
+#define _CRT_SECURE_NO_WARNINGS
+
+#include "FrameWriter.h"
+#include <cstdio>  /* Included for FILE, sprintf, and remove */
+#include <cstring> /* Included for memset */
+#include <jpeg/jpeglib.h>
+#include <zlib/zlib.h>
+#include "ColorConverter.h"
+#if defined(_WIN32)
+	#include <windows.h> /* Included for CreateHardLink and MoveFileEx */
+#else
+	#include <unistd.h>  /* Included for link */
+#endif
+
+/* libjpeg-turbo converts and subsamples RGB with its own SIMD code, which */
+/* beats handing it planes from ColorConverter. FLTK's bundled libjpeg     */
+/* does not, so it gets the planes.                                        */
+#ifndef LIBJPEG_TURBO_VERSION
+	#define FRAMEWRITER_RAW_JPEG
+#endif
+
+/* Size of the block of output libjpeg fills before it is appended. */
+#define JPEG_BLOCK_SIZE 16384
+
+/* Size of the block files are read in. */
+#define READ_BLOCK_SIZE 16384
+
+/* PNG row filter types. */
+#define PNG_FILTER_SUB 1
+#define PNG_FILTER_UP 2
+
+/* libjpeg destination that appends the compressed data to a vector. */
+struct VectorDestination
+{
+	struct jpeg_destination_mgr manager;
+	std::vector<unsigned char>* jpeg;
+	JOCTET block[JPEG_BLOCK_SIZE];
+};
+
+/* Called by libjpeg before any data is written. */
+static void initDestination(j_compress_ptr cinfo)
+{
+	VectorDestination* destination = (VectorDestination*)(cinfo->dest);
+	destination->manager.next_output_byte = destination->block;
+	destination->manager.free_in_buffer = JPEG_BLOCK_SIZE;
+}
+
+/* Called by libjpeg whenever the block is full. */
+static boolean emptyOutputBuffer(j_compress_ptr cinfo)
+{
+	VectorDestination* destination = (VectorDestination*)(cinfo->dest);
+	destination->jpeg->insert(destination->jpeg->end(), destination->block,
+		destination->block + JPEG_BLOCK_SIZE);
+	destination->manager.next_output_byte = destination->block;
+	destination->manager.free_in_buffer = JPEG_BLOCK_SIZE;
+	return TRUE;
+}
+
+/* Called by libjpeg after the last data is written. */
+static void termDestination(j_compress_ptr cinfo)
+{
+	VectorDestination* destination = (VectorDestination*)(cinfo->dest);
+	destination->jpeg->insert(destination->jpeg->end(), destination->block,
+		destination->block + (JPEG_BLOCK_SIZE -
+		destination->manager.free_in_buffer));
+}
+
+/* Encodes the RGB pixels as a JPEG image into the given vector with the  */
+/* given quality, from 0 to 100, and chroma subsampling. The pixels start */
+/* with the bottom row, like glReadPixels, and the image is flipped right */
+/* side up. Safe to call from several threads at once.                    */
+void FrameWriter::encodeJPEG(const unsigned char* pixels, unsigned int width,
+	unsigned int height, int quality, Subsampling subsampling,
+	std::vector<unsigned char>& jpeg)
+{
+	std::vector<unsigned char> band;
+	FrameWriter::encodeJPEG(pixels, width, height, quality, subsampling, jpeg,
+		band);
+}
+
+/* Encodes the pixels as a JPEG image like encodeJPEG above, using band as */
+/* working space. band is kept between calls so nothing is allocated once  */
+/* it is large enough for frames of this size. Safe to call from several   */
+/* threads at once, each with a band of its own.                           */
+void FrameWriter::encodeJPEG(const unsigned char* pixels, unsigned int width,
+	unsigned int height, int quality, Subsampling subsampling,
+	std::vector<unsigned char>& jpeg, std::vector<unsigned char>& band)
+{
+	struct jpeg_compress_struct cinfo;
+	struct jpeg_error_mgr jerr;
+	VectorDestination destination;
+
+	jpeg.clear();
+	cinfo.err = jpeg_std_error(&jerr);
+	jpeg_create_compress(&cinfo);
+
+	destination.manager.init_destination = initDestination;
+	destination.manager.empty_output_buffer = emptyOutputBuffer;
+	destination.manager.term_destination = termDestination;
+	destination.jpeg = &jpeg;
+	cinfo.dest = &(destination.manager);
+
+	const unsigned int subsampleX = (subsampling == SUBSAMPLE_444) ? 1 : 2;
+	const unsigned int subsampleY = (subsampling == SUBSAMPLE_420) ? 2 : 1;
+	cinfo.image_width = width;
+	cinfo.image_height = height;
+	cinfo.input_components = 3;
+#ifdef FRAMEWRITER_RAW_JPEG
+	/* The frame is converted to YCbCr and subsampled here instead of by */
+	/* libjpeg, so it is handed over as raw planes.                      */
+	cinfo.in_color_space = JCS_YCbCr;
+	jpeg_set_defaults(&cinfo);
+	cinfo.raw_data_in = TRUE;
+#else
+	cinfo.in_color_space = JCS_RGB;
+	jpeg_set_defaults(&cinfo);
+#endif
+	jpeg_set_quality(&cinfo, quality, TRUE);
+	cinfo.comp_info[0].h_samp_factor = subsampleX;
+	cinfo.comp_info[0].v_samp_factor = subsampleY;
+	for (int i = 1; i < 3; i++)
+	{
+		cinfo.comp_info[i].h_samp_factor = 1;
+		cinfo.comp_info[i].v_samp_factor = 1;
+	}
+	jpeg_start_compress(&cinfo, TRUE);
+
+#ifdef FRAMEWRITER_RAW_JPEG
+	/* Planes for one row of blocks, padded out to whole blocks */
+	const unsigned int bandRows = subsampleY * DCTSIZE;
+	const unsigned int lumaStride = (width + subsampleX * DCTSIZE - 1) /
+		(subsampleX * DCTSIZE) * subsampleX * DCTSIZE;
+	const unsigned int chromaStride = lumaStride / subsampleX;
+	band.resize(lumaStride * bandRows + 2 * chromaStride * DCTSIZE);
+	unsigned char* luma = &(band[0]);
+	unsigned char* blue = luma + lumaStride * bandRows;
+	unsigned char* red = blue + chromaStride * DCTSIZE;
+
+	JSAMPROW lumaRows[2 * DCTSIZE], blueRows[DCTSIZE], redRows[DCTSIZE];
+	for (unsigned int i = 0; i < bandRows; i++)
+	{
+		lumaRows[i] = luma + i * lumaStride;
+	}
+	for (unsigned int i = 0; i < DCTSIZE; i++)
+	{
+		blueRows[i] = blue + i * chromaStride;
+		redRows[i] = red + i * chromaStride;
+	}
+	JSAMPARRAY planes[3] = {lumaRows, blueRows, redRows};
+
+	while (cinfo.next_scanline < cinfo.image_height)
+	{
+		ColorConverter::frameToYCbCr(pixels, width, height,
+			cinfo.next_scanline, bandRows, subsampleX, subsampleY, luma,
+			lumaStride, blue, red, chromaStride);
+		jpeg_write_raw_data(&cinfo, planes, bandRows);
+	}
+#else
+	/* Write the rows from the top down to switch the image right side up, */
+	/* stepping back one row at a time.                                    */
+	const unsigned int rowStride = 3 * width;
+	JSAMPROW row_pointer[1];
+	row_pointer[0] = (JSAMPROW)(pixels + (height - 1) * rowStride);
+	while (cinfo.next_scanline < cinfo.image_height)
+	{
+		jpeg_write_scanlines(&cinfo, row_pointer, 1);
+		row_pointer[0] -= rowStride;
+	}
+#endif
+
+	jpeg_finish_compress(&cinfo);
+	jpeg_destroy_compress(&cinfo);
+}
+
+/* Appends a 32-bit big endian value to the bytes. */
+static void appendUInt32(std::vector<unsigned char>& bytes,
+	unsigned long value)
+{
+	bytes.push_back((unsigned char)(value >> 24));
+	bytes.push_back((unsigned char)(value >> 16));
+	bytes.push_back((unsigned char)(value >> 8));
+	bytes.push_back((unsigned char)value);
+}
+
+/* Appends the start of a PNG chunk of the given type, with its length left */
+/* as 0 until setChunkLength. Returns where the chunk starts.               */
+static size_t startChunk(std::vector<unsigned char>& png, const char* type)
+{
+	size_t start = png.size();
+	appendUInt32(png, 0);
+	png.insert(png.end(), type, type + 4);
+	return start;
+}
+
+/* Fills in the length of the chunk starting at start, which ends at the */
+/* end of the bytes, and appends its CRC.                                */
+static void endChunk(std::vector<unsigned char>& png, size_t start)
+{
+	unsigned long length = (unsigned long)(png.size() - start - 8);
+	for (int i = 0; i < 4; i++)
+	{
+		png[start + i] = (unsigned char)(length >> (24 - 8 * i));
+	}
+	/* The CRC covers the type and the data */
+	appendUInt32(png, crc32(crc32(0L, Z_NULL, 0), &(png[start + 4]),
+		(uInt)(length + 4)));
+}
+
+/* Encodes the RGB pixels as a PNG image into the given vector. The pixels */
+/* start with the bottom row, like glReadPixels, and the image is flipped  */
+/* right side up. Safe to call from several threads at once.               */
+void FrameWriter::encodePNG(const unsigned char* pixels, unsigned int width,
+	unsigned int height, std::vector<unsigned char>& png)
+{
+	static const unsigned char signature[8] = {137, 80, 78, 71, 13, 10, 26,
+		10};
+	png.assign(signature, signature + 8);
+
+	/* 8-bit RGB, no interlacing */
+	size_t header = startChunk(png, "IHDR");
+	appendUInt32(png, width);
+	appendUInt32(png, height);
+	png.push_back(8);
+	png.push_back(2);
+	png.push_back(0);
+	png.push_back(0);
+	png.push_back(0);
+	endChunk(png, header);
+
+	/* Every row starts with the type of filter used on it */
+	const unsigned int rowStride = 3 * width;
+	z_stream stream;
+	memset(&stream, 0, sizeof(stream));
+	deflateInit(&stream, PNG_COMPRESSION_LEVEL);
+
+	/* Deflate straight into the vector */
+	size_t data = startChunk(png, "IDAT");
+	size_t dataStart = png.size();
+	png.resize(dataStart + deflateBound(&stream, (1 + rowStride) * height));
+	stream.next_out = &(png[dataStart]);
+	stream.avail_out = (uInt)(png.size() - dataStart);
+
+	std::vector<unsigned char> filtered(2 * (1 + rowStride));
+	unsigned char* sub = &(filtered[0]);
+	unsigned char* up = sub + 1 + rowStride;
+	sub[0] = PNG_FILTER_SUB;
+	up[0] = PNG_FILTER_UP;
+	for (unsigned int y = 0; y < height; y++)
+	{
+		/* The pixels start with the bottom row, walk them top down */
+		const unsigned char* row = pixels + (height - 1 - y) * rowStride;
+		const unsigned char* above = row + rowStride;
+
+		/* Flat shading leaves runs of repeated pixels and rows, which */
+		/* both filters turn into zeros. Use the one with more zeros.  */
+		unsigned int subZeros = 0, upZeros = 0;
+		for (unsigned int i = 0; i < rowStride; i++)
+		{
+			sub[1 + i] = row[i] - ((i < 3) ? 0 : row[i - 3]);
+			subZeros += (sub[1 + i] == 0);
+		}
+		if (y > 0)
+		{
+			for (unsigned int i = 0; i < rowStride; i++)
+			{
+				up[1 + i] = row[i] - above[i];
+				upZeros += (up[1 + i] == 0);
+			}
+		}
+
+		stream.next_in = (upZeros > subZeros) ? up : sub;
+		stream.avail_in = 1 + rowStride;
+		deflate(&stream, (y + 1 == height) ? Z_FINISH : Z_NO_FLUSH);
+	}
+	png.resize(dataStart + stream.total_out);
+	deflateEnd(&stream);
+	endChunk(png, data);
+
+	size_t end = startChunk(png, "IEND");
+	endChunk(png, end);
+}
+
+/* Writes the bytes to the file with the given name, replacing any file    */
+/* already there instead of writing through a hard link to it. Returns if  */
+/* the file was written.                                                   */
+bool FrameWriter::writeFile(const std::string& filename,
+	const std::vector<unsigned char>& bytes)
+{
+	/* A repeated frame of an earlier render may share its file */
+	remove(filename.c_str());
+	FILE *outfile = fopen(filename.c_str(), "wb");
+	if (!outfile)
+	{
+		return false;
+	}
+	bool written = bytes.empty() ||
+		fwrite(&bytes[0], 1, bytes.size(), outfile) == bytes.size();
+	return fclose(outfile) == 0 && written;
+}
+
+/* Sets bytes to the contents of the file with the given name. Returns if */
+/* the whole file was read.                                               */
+bool FrameWriter::readFile(const std::string& filename,
+	std::vector<unsigned char>& bytes)
+{
+	bytes.clear();
+	FILE *infile = fopen(filename.c_str(), "rb");
+	if (!infile)
+	{
+		return false;
+	}
+	unsigned char block[READ_BLOCK_SIZE];
+	size_t count;
+	while ((count = fread(block, 1, sizeof(block), infile)) > 0)
+	{
+		bytes.insert(bytes.end(), block, block + count);
+	}
+	bool read = !ferror(infile);
+	fclose(infile);
+	return read;
+}
+
+/* Moves the file with the new name over the file with the given name,    */
+/* replacing it in one step, so a crash leaves one file or the other.     */
+/* Returns if it was moved. The new file is left in place if not.         */
+bool FrameWriter::replaceFile(const std::string& newFilename,
+	const std::string& filename)
+{
+#if defined(_WIN32)
+	/* rename will not replace an existing file on Windows */
+	return MoveFileExA(newFilename.c_str(), filename.c_str(),
+		MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+	return rename(newFilename.c_str(), filename.c_str()) == 0;
+#endif
+}
+
+/* Makes the file with the given name a hard link to an existing file,   */
+/* replacing any file already there. Returns if the link was made, which */
+/* fails on file systems without hard links.                             */
+bool FrameWriter::linkFile(const std::string& existing,
+	const std::string& filename)
+{
+	remove(filename.c_str());
+#if defined(_WIN32)
+	return CreateHardLinkA(filename.c_str(), existing.c_str(), NULL) != 0;
+#else
+	return link(existing.c_str(), filename.c_str()) == 0;
+#endif
+}
+
+/* Sets filename to the file name of the given frame, the prefix followed */
+/* by the frame number and the extension, reusing its storage.            */
+void FrameWriter::frameFilename(const std::string& prefix,
+	unsigned int frameNum, const char* extension, std::string& filename)
+{
+	char number[16];
+	sprintf(number, "%u", frameNum);
+	filename.assign(prefix);
+	filename.append(number);
+	filename.append(extension);
+}
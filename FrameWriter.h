@@ -0,0 +1,88 @@
+/*
+ * FrameWriter.h
+ * Created by Zachary Ferguson
+ * Header file for the FrameWriter class, a class for encoding rendered frames
+ * as JPEG or PNG images and writing them out to files.
+ */
+
+#ifndef FRAMEWRITER_H
+#define FRAMEWRITER_H
+
+/* Include necessary types */
+#include <vector>
+#include <string>
+
+/* Default quality used for encoding JPEG frames, the libjpeg default. */
+#define JPEG_QUALITY 75
+
+/* zlib compression level of PNG frames. Flat shaded frames compress well */
+/* at the faster levels.                                                  */
+#define PNG_COMPRESSION_LEVEL 3
+
+class FrameWriter
+{
+	public:
+
+		/* Chroma subsampling of JPEG frames, either full resolution,   */
+		/* half horizontally, or half in both directions.               */
+		enum Subsampling {SUBSAMPLE_444, SUBSAMPLE_422, SUBSAMPLE_420};
+
+		/* Encodes the RGB pixels as a JPEG image into the given vector  */
+		/* with the given quality, from 0 to 100, and chroma             */
+		/* subsampling. The pixels start with the bottom row, like       */
+		/* glReadPixels, and the image is flipped right side up. Safe to */
+		/* call from several threads at once.                            */
+		static void encodeJPEG(const unsigned char* pixels, unsigned int width,
+			unsigned int height, int quality, Subsampling subsampling,
+			std::vector<unsigned char>& jpeg);
+
+		/* Encodes the pixels as a JPEG image like encodeJPEG above,     */
+		/* using band as working space. band is kept between calls so    */
+		/* nothing is allocated once it is large enough for frames of    */
+		/* this size. Safe to call from several threads at once, each    */
+		/* with a band of its own.                                       */
+		static void encodeJPEG(const unsigned char* pixels, unsigned int width,
+			unsigned int height, int quality, Subsampling subsampling,
+			std::vector<unsigned char>& jpeg,
+			std::vector<unsigned char>& band);
+
+		/* Encodes the RGB pixels as a PNG image into the given vector.  */
+		/* The pixels start with the bottom row, like glReadPixels, and  */
+		/* the image is flipped right side up. Safe to call from several */
+		/* threads at once.                                              */
+		static void encodePNG(const unsigned char* pixels, unsigned int width,
+			unsigned int height, std::vector<unsigned char>& png);
+
+		/* Writes the bytes to the file with the given name, replacing   */
+		/* any file already there instead of writing through a hard link */
+		/* to it. Returns if the file was written.                       */
+		static bool writeFile(const std::string& filename,
+			const std::vector<unsigned char>& bytes);
+
+		/* Sets bytes to the contents of the file with the given name. */
+		/* Returns if the whole file was read.                         */
+		static bool readFile(const std::string& filename,
+			std::vector<unsigned char>& bytes);
+
+		/* Makes the file with the given name a hard link to an existing */
+		/* file, replacing any file already there. Returns if the link   */
+		/* was made, which fails on file systems without hard links.     */
+		static bool linkFile(const std::string& existing,
+			const std::string& filename);
+
+		/* Moves the file with the new name over the file with the given */
+		/* name, replacing it in one step, so a crash leaves one file or */
+		/* the other. Returns if it was moved. The new file is left in   */
+		/* place if not.                                                 */
+		static bool replaceFile(const std::string& newFilename,
+			const std::string& filename);
+
+		/* Sets filename to the file name of the given frame, the prefix */
+		/* followed by the frame number and the extension, reusing its   */
+		/* storage.                                                      */
+		static void frameFilename(const std::string& prefix,
+			unsigned int frameNum, const char* extension,
+			std::string& filename);
+};
+
+#endif
@@ -12,6 +12,7 @@ GLWindow::GLWindow(int x, int y, int w, int h, const char* c)
 	: Fl_Gl_Window(x, y, w, h, c)
 {
 	this->root = NULL;
+	this->transformNum = 0;
 }
 
 /* Constructor for a GLWindow that takes the int aspects and the root Node */
@@ -19,6 +20,7 @@ GLWindow::GLWindow(int x, int y, int w, int h, const char* c, Node* root)
 	: Fl_Gl_Window(x, y, w, h, c)
 {
 	this->root = root;
+	this->transformNum = 0;
 }
 
 /* Destructor for this GLWindow, deletes the root. */
@@ -35,6 +37,7 @@ void GLWindow::setSceneGraph(Node* newRoot)
 	if ((this->root) != NULL)
 	{
 		/* Free memory */
+		this->flatSceneGraph.clear();
 		delete this->root;
 	}
 	/* Assign new root */
@@ -55,15 +58,42 @@ void GLWindow::draw()
 
 		/* glOrtho describes a transformation that produces a */
 		/* parallel projection.                               */
-		glOrtho(-10, 10, -10, 10, -1, 1);
+		glOrtho(VIEW_LEFT, VIEW_RIGHT, VIEW_BOTTOM, VIEW_TOP, -1, 1);
 	}
 
 	/* Clear the GLWindow first before drawing */
 	glClearColor(0.0f, 0.0f, 0.0f, 1.0f );
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-	/* Traverse the scene graph */
-	Node::traverseSceneGraph(*(this -> root), mat3::identity(), this->transformNum);
+	/* Evaluate and draw the flattened scene graph. Only the subtrees of */
+	/* Nodes edited since the last redraw of this frame are recomputed.  */
+	this->flatSceneGraph.sync(this->root);
+	this->flatSceneGraph.evaluate(this->transformNum, affine2::identity());
+
+	/* Collect every vertex of the frame, then draw them all at once */
+	this->batch.clear();
+	this->flatSceneGraph.appendTo(this->batch, this->transformNum);
+	this->drawBatch();
+}
+
+/* Draws each run of primitives of one type in the batch with one draw  */
+/* call, in the order the scene graph was walked.                       */
+void GLWindow::drawBatch() const
+{
+	/* Shapes later in the walk are drawn over earlier ones, whatever type */
+	static const GLenum modes[] = { GL_LINES, GL_TRIANGLES };
+
+	glEnableClientState(GL_VERTEX_ARRAY);
+	glEnableClientState(GL_COLOR_ARRAY);
+	for (unsigned int i = 0; i < this->batch.getNumRuns(); i++)
+	{
+		const RenderBatch::Run& run = this->batch.getRun(i);
+		glVertexPointer(2, GL_FLOAT, 0, this->batch.getPositions(run.type));
+		glColorPointer(3, GL_FLOAT, 0, this->batch.getColors(run.type));
+		glDrawArrays(modes[run.type], run.first, run.count);
+	}
+	glDisableClientState(GL_COLOR_ARRAY);
+	glDisableClientState(GL_VERTEX_ARRAY);
 }
 
 /* Get the transform "frame" number. */
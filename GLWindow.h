@@ -8,7 +8,11 @@
 #define GLWINDOW_H
 
 /* Include necessary types */
-#include "Node.h"
+#include <FL/Fl.H>
+#include <FL/Gl.H>
+#include <Fl/Fl_Gl_Window.H>
+#include "FlatSceneGraph.h"
+#include "RenderBatch.h"
 
 /* Child class of FL_GL_Window */
 class GLWindow : public Fl_Gl_Window
@@ -21,6 +25,17 @@ class GLWindow : public Fl_Gl_Window
 		/* The SceneGrpah that will be drawn */
 		Node *root;
 
+		/* Flattened copy of the scene graph's hierarchy used for drawing */
+		FlatSceneGraph flatSceneGraph;
+
+		/* Vertex and color buffers of the frame being drawn, kept between */
+		/* draws so they do not need to be reallocated.                    */
+		RenderBatch batch;
+
+		/* Draws each run of primitives of one type in the batch with one */
+		/* draw call, in the order the scene graph was walked.            */
+		void drawBatch() const;
+
 		/* Method in FL_GL_Window class for drawing the window */
 		/* Draws this scene graph out to the screen            */
 		void draw();
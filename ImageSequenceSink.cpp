@@ -0,0 +1,78 @@
+/*
+ * ImageSequenceSink.cpp
+ * Created by Zachary Ferguson
+ * Source file for the ImageSequenceSink class, the base class for the
+ * FrameSinks that write every frame to its own numbered image file. The files
+ * can be read back, so a render to one can be resumed.
+ */
+
+#include "ImageSequenceSink.h"
+#include "FrameWriter.h"
+
+/* Constructor for an ImageSequenceSink that writes frame n to the file */
+/* prefix + n + extension.                                              */
+ImageSequenceSink::ImageSequenceSink(const std::string& filenamePrefix,
+	const std::string& extension)
+{
+	this->filenamePrefix = filenamePrefix;
+	this->extension = extension;
+}
+
+/* Destructor for the ImageSequenceSink */
+ImageSequenceSink::~ImageSequenceSink()
+{
+
+}
+
+/* Opens the sink, there is nothing to open. */
+bool ImageSequenceSink::open(unsigned int width, unsigned int height,
+	double framerate)
+{
+	return true;
+}
+
+/* Writes the image to the frame's file. */
+bool ImageSequenceSink::write(unsigned int frameNum,
+	const std::vector<unsigned char>& bytes)
+{
+	FrameWriter::frameFilename(this->filenamePrefix, frameNum,
+		this->extension.c_str(), this->filename);
+	return FrameWriter::writeFile(this->filename, bytes);
+}
+
+/* Hard links the frame's file to the earlier frame's file, falling back */
+/* to writing the image again.                                           */
+bool ImageSequenceSink::repeat(unsigned int frameNum,
+	unsigned int sourceFrameNum, const std::vector<unsigned char>& bytes)
+{
+	std::string sourceFilename;
+	FrameWriter::frameFilename(this->filenamePrefix, sourceFrameNum,
+		this->extension.c_str(), sourceFilename);
+	FrameWriter::frameFilename(this->filenamePrefix, frameNum,
+		this->extension.c_str(), this->filename);
+	return FrameWriter::linkFile(sourceFilename, this->filename) ||
+		FrameWriter::writeFile(this->filename, bytes);
+}
+
+/* Reads the image back from the frame's file. */
+bool ImageSequenceSink::readFrame(unsigned int frameNum,
+	std::vector<unsigned char>& bytes) const
+{
+	std::string frameFilename;
+	FrameWriter::frameFilename(this->filenamePrefix, frameNum,
+		this->extension.c_str(), frameFilename);
+	return FrameWriter::readFile(frameFilename, bytes);
+}
+
+/* Returns the manifest file next to the frames, the prefix + */
+/* "manifest.txt".                                            */
+std::string ImageSequenceSink::getManifestPath() const
+{
+	return this->filenamePrefix + "manifest.txt";
+}
+
+/* Closes the sink, every file is already closed. */
+bool ImageSequenceSink::close()
+{
+	return true;
+}
@@ -0,0 +1,62 @@
+/*
+ * ImageSequenceSink.h
+ * Created by Zachary Ferguson
+ * Header file for the ImageSequenceSink class, the base class for the
+ * FrameSinks that write every frame to its own numbered image file. The files
+ * can be read back, so a render to one can be resumed.
+ */
+
+#ifndef IMAGESEQUENCESINK_H
+#define IMAGESEQUENCESINK_H
+
+/* Include necessary types */
+#include <string>
+#include "FrameSink.h"
+
+class ImageSequenceSink : public FrameSink
+{
+	private:
+
+		/* File name prefix and extension of the frames. */
+		std::string filenamePrefix, extension;
+
+		/* File name of the frame being written, kept to reuse its */
+		/* storage.                                                */
+		std::string filename;
+
+	public:
+
+		/* Constructor for an ImageSequenceSink that writes frame n to */
+		/* the file prefix + n + extension.                            */
+		ImageSequenceSink(const std::string& filenamePrefix,
+			const std::string& extension);
+
+		/* Destructor for the ImageSequenceSink */
+		virtual ~ImageSequenceSink();
+
+		/* Opens the sink, there is nothing to open. */
+		virtual bool open(unsigned int width, unsigned int height,
+			double framerate);
+
+		/* Writes the image to the frame's file. */
+		virtual bool write(unsigned int frameNum,
+			const std::vector<unsigned char>& bytes);
+
+		/* Hard links the frame's file to the earlier frame's file,   */
+		/* falling back to writing the image again.                   */
+		virtual bool repeat(unsigned int frameNum, unsigned int sourceFrameNum,
+			const std::vector<unsigned char>& bytes);
+
+		/* Reads the image back from the frame's file. */
+		virtual bool readFrame(unsigned int frameNum,
+			std::vector<unsigned char>& bytes) const;
+
+		/* Returns the manifest file next to the frames, the prefix + */
+		/* "manifest.txt".                                            */
+		virtual std::string getManifestPath() const;
+
+		/* Closes the sink, every file is already closed. */
+		virtual bool close();
+};
+
+#endif
@@ -0,0 +1,57 @@
+/*
+ * JPEGSequenceSink.cpp
+ * Created by Zachary Ferguson
+ * Source file for the JPEGSequenceSink class, a FrameSink that writes every
+ * frame to its own numbered JPEG file.
+ */
+
+#include "JPEGSequenceSink.h"
+#include <sstream> /* Included for building the description */
+
+/* Constructor for a JPEGSequenceSink that writes frame n to the file      */
+/* prefix + n + ".jpg" with the given quality, from 0 to 100, and chroma   */
+/* subsampling.                                                            */
+JPEGSequenceSink::JPEGSequenceSink(const std::string& filenamePrefix,
+	int quality, FrameWriter::Subsampling subsampling) :
+	ImageSequenceSink(filenamePrefix, ".jpg")
+{
+	this->quality = quality;
+	this->subsampling = subsampling;
+}
+
+/* Destructor for the JPEGSequenceSink */
+JPEGSequenceSink::~JPEGSequenceSink()
+{
+
+}
+
+/* Encodes the frame as a JPEG image. */
+void JPEGSequenceSink::encode(const unsigned char* pixels, unsigned int width,
+	unsigned int height, std::vector<unsigned char>& bytes) const
+{
+	/* Take a spare band, if there is one, and give it back after */
+	std::vector<unsigned char> band;
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		if (!(this->spareBands.empty()))
+		{
+			band.swap(this->spareBands.back());
+			this->spareBands.pop_back();
+		}
+	}
+	FrameWriter::encodeJPEG(pixels, width, height, this->quality,
+		this->subsampling, bytes, band);
+	std::lock_guard<std::mutex> lock(this->mutex);
+	this->spareBands.push_back(std::vector<unsigned char>());
+	this->spareBands.back().swap(band);
+}
+
+/* Returns the quality and subsampling of the frames. */
+std::string JPEGSequenceSink::getDescription() const
+{
+	const char* subsamplings[] = {"4:4:4", "4:2:2", "4:2:0"};
+	std::stringstream out;
+	out << "JPEG frames, quality " << this->quality << ", " <<
+		subsamplings[this->subsampling];
+	return out.str();
+}
@@ -0,0 +1,51 @@
+/*
+ * JPEGSequenceSink.h
+ * Created by Zachary Ferguson
+ * Header file for the JPEGSequenceSink class, a FrameSink that writes every
+ * frame to its own numbered JPEG file.
+ */
+
+#ifndef JPEGSEQUENCESINK_H
+#define JPEGSEQUENCESINK_H
+
+/* Include necessary types */
+#include <string>
+#include <vector>
+#include <mutex>
+#include "ImageSequenceSink.h"
+#include "FrameWriter.h"
+
+class JPEGSequenceSink : public ImageSequenceSink
+{
+	private:
+
+		/* Quality, from 0 to 100, and chroma subsampling of the frames. */
+		int quality;
+		FrameWriter::Subsampling subsampling;
+
+		/* Working space of the encoders not using it, so each frame is */
+		/* encoded without allocating. Grows to one for every encoder   */
+		/* thread, guarded by the mutex.                                */
+		mutable std::vector<std::vector<unsigned char> > spareBands;
+		mutable std::mutex mutex;
+
+	public:
+
+		/* Constructor for a JPEGSequenceSink that writes frame n to the */
+		/* file prefix + n + ".jpg" with the given quality, from 0 to    */
+		/* 100, and chroma subsampling.                                  */
+		JPEGSequenceSink(const std::string& filenamePrefix, int quality,
+			FrameWriter::Subsampling subsampling);
+
+		/* Destructor for the JPEGSequenceSink */
+		virtual ~JPEGSequenceSink();
+
+		/* Encodes the frame as a JPEG image. */
+		virtual void encode(const unsigned char* pixels, unsigned int width,
+			unsigned int height, std::vector<unsigned char>& bytes) const;
+
+		/* Returns the quality and subsampling of the frames. */
+		virtual std::string getDescription() const;
+};
+
+#endif
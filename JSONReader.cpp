@@ -0,0 +1,641 @@
+/*
+ * JSONReader.cpp
+ * Created by Zachary Ferguson
+ * Source file for the JSONReader class, a streaming pull parser for JSON. The
+ * file is read a block at a time and handed out one token at a time, so files
+ * of any size are read without building the whole document in memory. The
+ * grammar is checked as the tokens are read.
+ */
+
+/* Allows fopen and sprintf, the _s versions are only available on Windows */
+#define _CRT_SECURE_NO_WARNINGS
+
+#include "JSONReader.h"
+#include <cstdlib> /* Included for strtod */
+#include <cfloat>  /* Included for DBL_MAX */
+
+/* Longest number read, in characters. */
+#define JSON_MAX_NUMBER_LENGTH 64
+
+/* Most significant digits of a number converted without strtod. */
+#define FAST_NUMBER_DIGITS 19
+
+/* Powers of ten that are exact as doubles. */
+static const double POWERS_OF_TEN[] =
+{
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12,
+	1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+#define MAX_EXACT_POWER 22
+
+/* Largest integer every smaller one of which is exact as a double. */
+#define MAX_EXACT_INTEGER 9007199254740992ULL
+
+/* Returns if the byte is a decimal digit. */
+static bool isDigit(int c)
+{
+	return c >= '0' && c <= '9';
+}
+
+/* Constructor for a JSONReader with no file open. */
+JSONReader::JSONReader()
+{
+	this->file = NULL;
+	this->block = new char[JSON_READ_BLOCK_SIZE];
+	this->position = 0;
+	this->size = 0;
+	this->offset = 0;
+	this->line = 1;
+	this->expect = EXPECT_VALUE;
+	this->number = 0;
+}
+
+/* Destructor for the JSONReader, closes the file. */
+JSONReader::~JSONReader()
+{
+	this->close();
+	delete[] this->block;
+}
+
+/* Opens the file at the given path. Returns if it was opened. */
+bool JSONReader::open(const std::string& path)
+{
+	this->close();
+	this->file = fopen(path.c_str(), "rb");
+	return this->file != NULL;
+}
+
+/* Closes the file. */
+void JSONReader::close()
+{
+	if (this->file != NULL)
+	{
+		fclose(this->file);
+		this->file = NULL;
+	}
+	this->position = 0;
+	this->size = 0;
+	this->offset = 0;
+	this->line = 1;
+	this->containers.clear();
+	this->expect = EXPECT_VALUE;
+	this->text.clear();
+	this->number = 0;
+	this->error.clear();
+}
+
+/* Reads in the next block. Returns if any bytes were read. */
+bool JSONReader::fill()
+{
+	this->offset += this->size;
+	this->position = 0;
+	this->size = (this->file == NULL) ? 0 :
+		fread(this->block, 1, JSON_READ_BLOCK_SIZE, this->file);
+	if (this->size == 0 && this->file != NULL && ferror(this->file))
+	{
+		this->fail("Could not read the file");
+	}
+	return this->size > 0;
+}
+
+/* Returns the next byte without taking it, or -1 at the end of the file. */
+int JSONReader::peek()
+{
+	if (this->position == this->size && !(this->fill()))
+	{
+		return -1;
+	}
+	return (unsigned char)(this->block[this->position]);
+}
+
+/* Takes the next byte, or returns -1 at the end of the file. */
+int JSONReader::take()
+{
+	if (this->position == this->size && !(this->fill()))
+	{
+		return -1;
+	}
+	return (unsigned char)(this->block[this->position++]);
+}
+
+/* Skips spaces, tabs and line breaks. */
+void JSONReader::skipSpace()
+{
+	for (;;)
+	{
+		if (this->position == this->size && !(this->fill()))
+		{
+			return;
+		}
+		char c = this->block[this->position];
+		if (c == '\n')
+		{
+			this->line++;
+		}
+		else if (c != ' ' && c != '\t' && c != '\r')
+		{
+			return;
+		}
+		this->position++;
+	}
+}
+
+/* Records the error, if it is the first, and returns ERROR. */
+JSONReader::Token JSONReader::fail(const char* message)
+{
+	if (this->error.empty())
+	{
+		char lineText[32];
+		sprintf(lineText, "Line %u: ", this->line);
+		this->error = std::string(lineText) + message;
+	}
+	return ERROR;
+}
+
+/* Sets what comes next after a whole value. */
+void JSONReader::endValue()
+{
+	this->expect = this->containers.empty() ? EXPECT_END : EXPECT_COMMA_OR_END;
+}
+
+/* Reads four hex digits of a \u escape into code. */
+bool JSONReader::readHex(unsigned int& code)
+{
+	code = 0;
+	for (int i = 0; i < 4; i++)
+	{
+		int c = this->take();
+		code <<= 4;
+		if (isDigit(c))
+		{
+			code |= c - '0';
+		}
+		else if (c >= 'a' && c <= 'f')
+		{
+			code |= c - 'a' + 10;
+		}
+		else if (c >= 'A' && c <= 'F')
+		{
+			code |= c - 'A' + 10;
+		}
+		else
+		{
+			this->fail("Bad \\u escape in a string");
+			return false;
+		}
+	}
+	return true;
+}
+
+/* Reads a string into text after its opening quote. */
+bool JSONReader::readString()
+{
+	this->text.clear();
+	for (;;)
+	{
+		if (this->position == this->size && !(this->fill()))
+		{
+			this->fail("Unterminated string");
+			return false;
+		}
+
+		/* Copy the plain characters a run at a time */
+		size_t start = this->position;
+		while (this->position < this->size)
+		{
+			unsigned char c = (unsigned char)(this->block[this->position]);
+			if (c == '"' || c == '\\' || c < 0x20)
+			{
+				break;
+			}
+			this->position++;
+		}
+		this->text.append(this->block + start, this->position - start);
+		if (this->position == this->size)
+		{
+			continue;
+		}
+
+		unsigned char c = (unsigned char)(this->block[this->position++]);
+		if (c == '"')
+		{
+			return true;
+		}
+		if (c < 0x20)
+		{
+			this->fail("Control character in a string");
+			return false;
+		}
+
+		/* Escape sequences */
+		unsigned int code;
+		switch (this->take())
+		{
+			case '"': this->text += '"'; break;
+			case '\\': this->text += '\\'; break;
+			case '/': this->text += '/'; break;
+			case 'b': this->text += '\b'; break;
+			case 'f': this->text += '\f'; break;
+			case 'n': this->text += '\n'; break;
+			case 'r': this->text += '\r'; break;
+			case 't': this->text += '\t'; break;
+			case 'u':
+				if (!(this->readHex(code)))
+				{
+					return false;
+				}
+
+				/* Join a surrogate pair into one code point */
+				if (code >= 0xD800 && code <= 0xDBFF)
+				{
+					unsigned int low;
+					if (this->take() != '\\' || this->take() != 'u' ||
+						!(this->readHex(low)) || low < 0xDC00 || low > 0xDFFF)
+					{
+						this->fail("Unpaired surrogate in a string");
+						return false;
+					}
+					code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+				}
+				else if (code >= 0xDC00 && code <= 0xDFFF)
+				{
+					this->fail("Unpaired surrogate in a string");
+					return false;
+				}
+
+				/* Write the code point as UTF-8 */
+				if (code < 0x80)
+				{
+					this->text += (char)code;
+				}
+				else if (code < 0x800)
+				{
+					this->text += (char)(0xC0 | (code >> 6));
+					this->text += (char)(0x80 | (code & 0x3F));
+				}
+				else if (code < 0x10000)
+				{
+					this->text += (char)(0xE0 | (code >> 12));
+					this->text += (char)(0x80 | ((code >> 6) & 0x3F));
+					this->text += (char)(0x80 | (code & 0x3F));
+				}
+				else
+				{
+					this->text += (char)(0xF0 | (code >> 18));
+					this->text += (char)(0x80 | ((code >> 12) & 0x3F));
+					this->text += (char)(0x80 | ((code >> 6) & 0x3F));
+					this->text += (char)(0x80 | (code & 0x3F));
+				}
+				break;
+			default:
+				this->fail("Bad escape in a string");
+				return false;
+		}
+	}
+}
+
+/* Reads a number into number, starting with the given byte. */
+bool JSONReader::readNumber(int first)
+{
+	/* Gather the characters that can be part of a number */
+	char characters[JSON_MAX_NUMBER_LENGTH + 1];
+	unsigned int length = 0;
+	characters[length++] = (char)first;
+	for (;;)
+	{
+		int c = this->peek();
+		if (!isDigit(c) && c != '.' && c != 'e' && c != 'E' && c != '+' &&
+			c != '-')
+		{
+			break;
+		}
+		if (length == JSON_MAX_NUMBER_LENGTH)
+		{
+			this->fail("Number too long");
+			return false;
+		}
+		characters[length++] = (char)c;
+		this->position++;
+	}
+	characters[length] = '\0';
+
+	/* Check the grammar, keeping the leading significant digits as an */
+	/* integer and a power of ten                                      */
+	const char* c = characters;
+	bool negative = (*c == '-');
+	if (negative)
+	{
+		c++;
+	}
+	unsigned long long mantissa = 0;
+	int numDigits = 0, exponent = 0;
+	bool exact = true;
+	if (!isDigit(*c))
+	{
+		this->fail("Bad number");
+		return false;
+	}
+	if (*c == '0')
+	{
+		/* No digits may follow a leading zero */
+		c++;
+	}
+	else
+	{
+		for (; isDigit(*c); c++)
+		{
+			if (numDigits < FAST_NUMBER_DIGITS)
+			{
+				mantissa = mantissa * 10 + (*c - '0');
+				numDigits += (mantissa != 0);
+			}
+			else
+			{
+				exponent++;
+				exact = false;
+			}
+		}
+	}
+	if (*c == '.')
+	{
+		c++;
+		if (!isDigit(*c))
+		{
+			this->fail("Bad number");
+			return false;
+		}
+		for (; isDigit(*c); c++)
+		{
+			if (numDigits < FAST_NUMBER_DIGITS)
+			{
+				mantissa = mantissa * 10 + (*c - '0');
+				numDigits += (mantissa != 0);
+				exponent--;
+			}
+			else
+			{
+				exact = false;
+			}
+		}
+	}
+	if (*c == 'e' || *c == 'E')
+	{
+		c++;
+		bool negativeExponent = (*c == '-');
+		if (*c == '-' || *c == '+')
+		{
+			c++;
+		}
+		if (!isDigit(*c))
+		{
+			this->fail("Bad number");
+			return false;
+		}
+		int value = 0;
+		for (; isDigit(*c); c++)
+		{
+			if (value < 100000)
+			{
+				value = value * 10 + (*c - '0');
+			}
+		}
+		exponent += negativeExponent ? -value : value;
+	}
+	if (*c != '\0')
+	{
+		this->fail("Bad number");
+		return false;
+	}
+
+	/* Small enough numbers are converted exactly with one multiply or */
+	/* divide, the rest by strtod                                      */
+	if (exact && mantissa <= MAX_EXACT_INTEGER &&
+		exponent >= -MAX_EXACT_POWER && exponent <= MAX_EXACT_POWER)
+	{
+		this->number = (exponent < 0) ?
+			(double)mantissa / POWERS_OF_TEN[-exponent] :
+			(double)mantissa * POWERS_OF_TEN[exponent];
+		if (negative)
+		{
+			this->number = -(this->number);
+		}
+	}
+	else
+	{
+		/* Numbers too large for a double come back as infinities */
+		this->number = strtod(characters, NULL);
+		if (!(this->number >= -DBL_MAX && this->number <= DBL_MAX))
+		{
+			this->fail("Number out of range");
+			return false;
+		}
+	}
+	return true;
+}
+
+/* Takes the rest of the given literal after its first letter. */
+bool JSONReader::readLiteral(const char* rest)
+{
+	for (; *rest != '\0'; rest++)
+	{
+		if (this->take() != *rest)
+		{
+			this->fail("Unexpected word");
+			return false;
+		}
+	}
+	return true;
+}
+
+/* Reads the value starting with the given byte. */
+JSONReader::Token JSONReader::readValue(int c)
+{
+	switch (c)
+	{
+		case '{':
+		case '[':
+			if (this->containers.size() >= JSON_MAX_DEPTH)
+			{
+				return this->fail("Nested too deeply");
+			}
+			this->containers.push_back((char)c);
+			this->expect = (c == '{') ? EXPECT_NAME_OR_END :
+				EXPECT_VALUE_OR_END;
+			return (c == '{') ? BEGIN_OBJECT : BEGIN_ARRAY;
+		case '"':
+			if (!(this->readString()))
+			{
+				return ERROR;
+			}
+			this->endValue();
+			return STRING;
+		case 't':
+			if (!(this->readLiteral("rue")))
+			{
+				return ERROR;
+			}
+			this->endValue();
+			return TRUE_VALUE;
+		case 'f':
+			if (!(this->readLiteral("alse")))
+			{
+				return ERROR;
+			}
+			this->endValue();
+			return FALSE_VALUE;
+		case 'n':
+			if (!(this->readLiteral("ull")))
+			{
+				return ERROR;
+			}
+			this->endValue();
+			return NULL_VALUE;
+		case -1:
+			return this->fail("Unexpected end of file");
+		default:
+			if (c != '-' && !isDigit(c))
+			{
+				return this->fail("Unexpected character");
+			}
+			if (!(this->readNumber(c)))
+			{
+				return ERROR;
+			}
+			this->endValue();
+			return NUMBER;
+	}
+}
+
+/* Reads and returns the next token. */
+JSONReader::Token JSONReader::next()
+{
+	if (!(this->error.empty()))
+	{
+		return ERROR;
+	}
+	this->skipSpace();
+	int c = this->take();
+	switch (this->expect)
+	{
+		case EXPECT_END:
+			if (c == -1)
+			{
+				return this->error.empty() ? END : ERROR;
+			}
+			return this->fail("Text after the end of the document");
+
+		case EXPECT_NAME_OR_END:
+		case EXPECT_NAME:
+			if (c == '}' && this->expect == EXPECT_NAME_OR_END)
+			{
+				this->containers.pop_back();
+				this->endValue();
+				return END_OBJECT;
+			}
+			if (c != '"')
+			{
+				return this->fail("Expected a name in quotes");
+			}
+			if (!(this->readString()))
+			{
+				return ERROR;
+			}
+			this->skipSpace();
+			if (this->take() != ':')
+			{
+				return this->fail("Expected ':' after a name");
+			}
+			this->expect = EXPECT_VALUE;
+			return NAME;
+
+		case EXPECT_VALUE_OR_END:
+			if (c == ']')
+			{
+				this->containers.pop_back();
+				this->endValue();
+				return END_ARRAY;
+			}
+			return this->readValue(c);
+
+		case EXPECT_COMMA_OR_END:
+			if (c == ',')
+			{
+				this->expect = (this->containers.back() == '{') ?
+					EXPECT_NAME : EXPECT_VALUE;
+				return this->next();
+			}
+			if (c == (this->containers.back() == '{' ? '}' : ']'))
+			{
+				bool object = (this->containers.back() == '{');
+				this->containers.pop_back();
+				this->endValue();
+				return object ? END_OBJECT : END_ARRAY;
+			}
+			return this->fail("Expected ',' or a closing bracket");
+
+		default:
+			return this->readValue(c);
+	}
+}
+
+/* Skips the rest of the value started by the given token, which was just */
+/* read. Returns false on an error.                                       */
+bool JSONReader::skipValue(Token token)
+{
+	if (token != BEGIN_OBJECT && token != BEGIN_ARRAY)
+	{
+		return token == STRING || token == NUMBER || token == TRUE_VALUE ||
+			token == FALSE_VALUE || token == NULL_VALUE;
+	}
+	unsigned int depth = 1;
+	while (depth > 0)
+	{
+		switch (this->next())
+		{
+			case BEGIN_OBJECT:
+			case BEGIN_ARRAY:
+				depth++;
+				break;
+			case END_OBJECT:
+			case END_ARRAY:
+				depth--;
+				break;
+			case END:
+			case ERROR:
+				return false;
+			default:
+				break;
+		}
+	}
+	return true;
+}
+
+/* Returns the text of the last NAME or STRING token. */
+const std::string& JSONReader::getText() const
+{
+	return this->text;
+}
+
+/* Returns the value of the last NUMBER token. */
+double JSONReader::getNumber() const
+{
+	return this->number;
+}
+
+/* Returns the line being read, starting at 1. */
+unsigned int JSONReader::getLine() const
+{
+	return this->line;
+}
+
+/* Returns the number of bytes read so far. */
+unsigned long long JSONReader::getBytesRead() const
+{
+	return this->offset + this->position;
+}
+
+/* Returns a description of the error after an ERROR token. */
+const std::string& JSONReader::getError() const
+{
+	return this->error;
+}
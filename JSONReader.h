@@ -0,0 +1,136 @@
+/*
+ * JSONReader.h
+ * Created by Zachary Ferguson
+ * Header file for the JSONReader class, a streaming pull parser for JSON. The
+ * file is read a block at a time and handed out one token at a time, so files
+ * of any size are read without building the whole document in memory. The
+ * grammar is checked as the tokens are read.
+ */
+
+#ifndef JSONREADER_H
+#define JSONREADER_H
+
+/* Include necessary types */
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/* Number of bytes read from the file at a time. */
+#define JSON_READ_BLOCK_SIZE 65536
+
+/* Deepest nesting of objects and arrays allowed. */
+#define JSON_MAX_DEPTH 256
+
+class JSONReader
+{
+	public:
+
+		/* The kinds of tokens. NAME is the name of a member of an object. */
+		/* END is the end of the file after the value, ERROR is malformed  */
+		/* JSON or a read error, and every token after it is ERROR too.    */
+		enum Token
+		{
+			BEGIN_OBJECT, END_OBJECT, BEGIN_ARRAY, END_ARRAY, NAME, STRING,
+			NUMBER, TRUE_VALUE, FALSE_VALUE, NULL_VALUE, END, ERROR
+		};
+
+	private:
+
+		/* The file being read and the block of it read in. */
+		FILE* file;
+		char* block;
+		size_t position, size;
+
+		/* Number of bytes before the block, and the line being read. */
+		unsigned long long offset;
+		unsigned int line;
+
+		/* The open objects and arrays, '{' or '[', innermost last. */
+		std::vector<char> containers;
+
+		/* What comes next in the innermost container or at the top. */
+		enum Expect
+		{
+			EXPECT_VALUE, EXPECT_VALUE_OR_END, EXPECT_NAME,
+			EXPECT_NAME_OR_END, EXPECT_COMMA_OR_END, EXPECT_END
+		};
+		Expect expect;
+
+		/* The text of the last string or name, the value of the last */
+		/* number, and a description of the error, if any.            */
+		std::string text;
+		double number;
+		std::string error;
+
+		/* Returns the next byte without taking it, or -1 at the end of */
+		/* the file.                                                    */
+		int peek();
+
+		/* Takes the next byte, or returns -1 at the end of the file. */
+		int take();
+
+		/* Reads in the next block. Returns if any bytes were read. */
+		bool fill();
+
+		/* Skips spaces, tabs and line breaks. */
+		void skipSpace();
+
+		/* Reads a string into text after its opening quote. */
+		bool readString();
+
+		/* Reads four hex digits of a \u escape into code. */
+		bool readHex(unsigned int& code);
+
+		/* Reads a number into number, starting with the given byte. */
+		bool readNumber(int first);
+
+		/* Takes the rest of the given literal after its first letter. */
+		bool readLiteral(const char* rest);
+
+		/* Records the error, if it is the first, and returns ERROR. */
+		Token fail(const char* message);
+
+		/* Sets what comes next after a whole value. */
+		void endValue();
+
+		/* Reads the value starting with the given byte. */
+		Token readValue(int c);
+
+	public:
+
+		/* Constructor for a JSONReader with no file open. */
+		JSONReader();
+
+		/* Destructor for the JSONReader, closes the file. */
+		virtual ~JSONReader();
+
+		/* Opens the file at the given path. Returns if it was opened. */
+		bool open(const std::string& path);
+
+		/* Closes the file. */
+		void close();
+
+		/* Reads and returns the next token. */
+		Token next();
+
+		/* Skips the rest of the value started by the given token, which */
+		/* was just read. Returns false on an error.                     */
+		bool skipValue(Token token);
+
+		/* Returns the text of the last NAME or STRING token. */
+		const std::string& getText() const;
+
+		/* Returns the value of the last NUMBER token. */
+		double getNumber() const;
+
+		/* Returns the line being read, starting at 1. */
+		unsigned int getLine() const;
+
+		/* Returns the number of bytes read so far. */
+		unsigned long long getBytesRead() const;
+
+		/* Returns a description of the error after an ERROR token. */
+		const std::string& getError() const;
+};
+
+#endif
@@ -0,0 +1,413 @@
+/*
+ * KeyframeTrack.cpp
+ * Created by Zachary Ferguson
+ * Source file for the KeyframeTrack class, a class for storing only the key
+ * frames of a Node's animation and working out the in-between frames on
+ * request.
+ */
+
+#include "KeyframeTrack.h"
+#include <algorithm> /* Included for upper_bound, lower_bound, and fill */
+
+/* Returns the number of words in the bitset of keyframes of a timeline of */
+/* the given length, worked out in 64 bits so no length wraps to zero.     */
+static size_t numKeyWords(unsigned int length)
+{
+	return (size_t)(((unsigned long long)length + 31) >> 5);
+}
+
+/* Constructor for a KeyframeTrack of one frame that takes the Frame to use */
+/* as the keyframe at frame 0.                                              */
+KeyframeTrack::KeyframeTrack(const Frame& first)
+{
+	this->length = 1;
+	this->cacheClock = 0;
+	this->keyBits.push_back(0);
+	this->setKeyframe(0, first);
+}
+
+/* Destructor for the KeyframeTrack */
+KeyframeTrack::~KeyframeTrack()
+{
+
+}
+
+/* Compares if two given tracks have the same keyframes */
+bool operator==(const KeyframeTrack& t1, const KeyframeTrack& t2)
+{
+	if(t1.length != t2.length || t1.times != t2.times)
+	{
+		return false;
+	}
+
+	/* Compare the keyframe values */
+	for(int c = 0; c < KeyframeTrack::NUM_CHANNELS; c++)
+	{
+		if(t1.channels[c] != t2.channels[c])
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/* Returns the index of the last keyframe at or before frameNum. */
+unsigned int KeyframeTrack::findKeyIndex(unsigned int frameNum) const
+{
+	/* Frame 0 is always a keyframe so there is always one at or before. */
+	return (unsigned int)(std::upper_bound(this->times.begin(),
+		this->times.end(), frameNum) - this->times.begin()) - 1;
+}
+
+/* Re-interpolates the two segments on either side of the keyframe at the */
+/* given index.                                                           */
+void KeyframeTrack::reinterpolateSegments(unsigned int keyIndex)
+{
+	unsigned int first = keyIndex > 0 ? keyIndex - 1 : 0;
+	unsigned int last = std::min(keyIndex + 1,
+		(unsigned int)(this->times.size()) - 1);
+
+	for(unsigned int k = first; k < last; k++)
+	{
+		float indexDifference = (float)(this->times[k+1] - this->times[k]);
+		for(int c = 0; c < NUM_CHANNELS; c++)
+		{
+			this->slopes[c][k] = (this->channels[c][k+1] -
+				this->channels[c][k]) / indexDifference;
+		}
+	}
+}
+
+/* Drops the cached Frames from first to last, inclusive. */
+void KeyframeTrack::invalidateCache(unsigned int first, unsigned int last)
+{
+	for(unsigned int i = 0; i < this->cachedFrames.size(); i++)
+	{
+		if(this->cachedFrameNums[i] >= first && this->cachedFrameNums[i] <= last)
+		{
+			/* Least recently used, so it is replaced first */
+			this->cachedFrameNums[i] = (unsigned int)(-1);
+			this->cacheLastUsed[i] = 0;
+		}
+	}
+}
+
+/* Returns the number of frames covered by this track. */
+unsigned int KeyframeTrack::getLength() const
+{
+	return this->length;
+}
+
+/* Sets the number of frames covered by this track, at most              */
+/* MAX_TRACK_LENGTH. Keyframes at or after the new length are removed.   */
+void KeyframeTrack::setLength(unsigned int newLength)
+{
+	assert(newLength > 0 && newLength <= MAX_TRACK_LENGTH);
+
+	/* Remove the keyframes that fall off the end of the timeline. */
+	unsigned int keep = (unsigned int)(std::lower_bound(this->times.begin(),
+		this->times.end(), newLength) - this->times.begin());
+	for(unsigned int k = keep; k < this->times.size(); k++)
+	{
+		this->keyBits[this->times[k] >> 5] &= ~(1u << (this->times[k] & 31));
+	}
+	this->times.resize(keep);
+	for(int c = 0; c < NUM_CHANNELS; c++)
+	{
+		this->channels[c].resize(keep);
+		this->slopes[c].resize(keep - 1);
+	}
+
+	this->keyBits.resize(numKeyWords(newLength), 0);
+	this->length = newLength;
+
+	/* Frames after the last keyframe may have changed */
+	this->invalidateCache(this->times.back(), (unsigned int)(-1));
+}
+
+/* Returns the number of keyframes stored. */
+unsigned int KeyframeTrack::getNumKeyframes() const
+{
+	return (unsigned int)(this->times.size());
+}
+
+/* Returns if the given frame is a keyframe. */
+bool KeyframeTrack::getIsKeyframe(unsigned int frameNum) const
+{
+	assert(frameNum < this->length);
+	return (this->keyBits[frameNum >> 5] >> (frameNum & 31)) & 1;
+}
+
+/* Stores the given channel values as the keyframe at frameNum, replacing */
+/* any keyframe already there.                                            */
+void KeyframeTrack::setKeyframe(unsigned int frameNum,
+	const float values[NUM_CHANNELS])
+{
+	assert(frameNum < this->length);
+
+	unsigned int k;
+	if(this->getIsKeyframe(frameNum))
+	{
+		k = this->findKeyIndex(frameNum);
+		for(int c = 0; c < NUM_CHANNELS; c++)
+		{
+			this->channels[c][k] = values[c];
+		}
+	}
+	else
+	{
+		/* Insert the new keyframe after the previous one, splitting the */
+		/* segment it falls in.                                          */
+		k = (unsigned int)(std::upper_bound(this->times.begin(),
+			this->times.end(), frameNum) - this->times.begin());
+		this->times.insert(this->times.begin() + k, frameNum);
+		for(int c = 0; c < NUM_CHANNELS; c++)
+		{
+			this->channels[c].insert(this->channels[c].begin() + k,
+				values[c]);
+			if(this->times.size() > 1)
+			{
+				this->slopes[c].insert(this->slopes[c].begin() +
+					std::min(k, (unsigned int)(this->slopes[c].size())), 0.0f);
+			}
+		}
+		this->keyBits[frameNum >> 5] |= 1u << (frameNum & 31);
+	}
+
+	/* Only the segments next to the keyframe change */
+	this->reinterpolateSegments(k);
+	this->invalidateCache(k > 0 ? this->times[k-1] : 0, 
+		k + 1 < this->times.size() ? this->times[k+1] : (unsigned int)(-1));
+}
+
+/* Stores the given Frame as the keyframe at frameNum, replacing any */
+/* keyframe already there.                                           */
+void KeyframeTrack::setKeyframe(unsigned int frameNum, const Frame& frame)
+{
+	std::vector<float> colors = frame.getColors();
+	const float values[NUM_CHANNELS] = {
+		frame.getScaleX(), frame.getScaleY(), frame.getRotation(),
+		frame.getTranslationX(), frame.getTranslationY(),
+		colors[0], colors[1], colors[2]
+	};
+	this->setKeyframe(frameNum, values);
+}
+
+/* Removes the keyframe at frameNum, if there is one, so the frame is worked */
+/* out from the keyframes around it. Frame 0 is always a keyframe and can    */
+/* not be removed.                                                           */
+void KeyframeTrack::removeKeyframe(unsigned int frameNum)
+{
+	assert(frameNum > 0 && frameNum < this->length);
+	if(!this->getIsKeyframe(frameNum))
+	{
+		return;
+	}
+
+	/* The segments on either side of the keyframe join into one */
+	unsigned int k = this->findKeyIndex(frameNum);
+	this->times.erase(this->times.begin() + k);
+	for(int c = 0; c < NUM_CHANNELS; c++)
+	{
+		this->channels[c].erase(this->channels[c].begin() + k);
+		this->slopes[c].erase(this->slopes[c].begin() +
+			std::min(k, (unsigned int)(this->slopes[c].size()) - 1));
+	}
+	this->keyBits[frameNum >> 5] &= ~(1u << (frameNum & 31));
+
+	this->reinterpolateSegments(k - 1);
+	this->invalidateCache(this->times[k-1],
+		k < this->times.size() ? this->times[k] : (unsigned int)(-1));
+}
+
+/* Returns the frame numbers of the keyframes, in increasing order. */
+const std::vector<unsigned int>& KeyframeTrack::getKeyframeTimes() const
+{
+	return this->times;
+}
+
+/* Returns the value of the given channel at each keyframe. */
+const std::vector<float>& KeyframeTrack::getKeyframeValues(Channel channel)
+	const
+{
+	return this->channels[channel];
+}
+
+/* Replaces every keyframe and the length of the track, at most            */
+/* MAX_TRACK_LENGTH, at once. Takes count frame numbers in increasing      */
+/* order, starting with 0 and all less than the length, and an array of    */
+/* count values for each channel.                                          */
+void KeyframeTrack::setKeyframes(unsigned int newLength,
+	const unsigned int* times, unsigned int count,
+	const float* const values[NUM_CHANNELS])
+{
+	assert(newLength > 0 && newLength <= MAX_TRACK_LENGTH && count > 0 &&
+		times[0] == 0 && times[count-1] < newLength);
+
+	this->length = newLength;
+	this->times.assign(times, times + count);
+	this->keyBits.assign(numKeyWords(newLength), 0);
+	for(unsigned int k = 0; k < count; k++)
+	{
+		this->keyBits[times[k] >> 5] |= 1u << (times[k] & 31);
+	}
+
+	/* Work out the slope of every segment */
+	for(int c = 0; c < NUM_CHANNELS; c++)
+	{
+		this->channels[c].assign(values[c], values[c] + count);
+		this->slopes[c].resize(count - 1);
+		for(unsigned int k = 0; k + 1 < count; k++)
+		{
+			this->slopes[c][k] = (values[c][k+1] - values[c][k]) /
+				(float)(times[k+1] - times[k]);
+		}
+	}
+
+	this->invalidateCache(0, (unsigned int)(-1));
+}
+
+/* Makes the given frame a keyframe with its current values. Must send if */
+/* the in-between frames are interpolated.                                */
+void KeyframeTrack::makeKeyframe(unsigned int frameNum, bool interpolated)
+{
+	if(!this->getIsKeyframe(frameNum))
+	{
+		float values[NUM_CHANNELS];
+		this->getValues(frameNum, interpolated, values);
+		this->setKeyframe(frameNum, values);
+	}
+}
+
+/* Returns the value of one channel at the given frame number. */
+float KeyframeTrack::getValue(Channel channel, unsigned int frameNum,
+	bool interpolated) const
+{
+	assert(frameNum < this->length);
+
+	unsigned int k = this->findKeyIndex(frameNum);
+	const std::vector<float>& values = this->channels[channel];
+
+	/* Keyframes, flip book frames, and frames after the last keyframe */
+	/* hold the previous keyframe's value.                             */
+	if(!interpolated || k + 1 == this->times.size())
+	{
+		return values[k];
+	}
+
+	/* Linearly interpolate between the surrounding keyframes */
+	return values[k] + this->slopes[channel][k] * (frameNum - this->times[k]);
+}
+
+/* Fills values with every channel at the given frame number. */
+void KeyframeTrack::getValues(unsigned int frameNum, bool interpolated,
+	float values[NUM_CHANNELS]) const
+{
+	float* const out[NUM_CHANNELS] = {
+		&values[0], &values[1], &values[2], &values[3],
+		&values[4], &values[5], &values[6], &values[7]
+	};
+	this->sampleRange(frameNum, 1, interpolated, out);
+}
+
+/* Samples count frames starting at first into the given arrays, one */
+/* contiguous array of count floats per channel.                     */
+void KeyframeTrack::sampleRange(unsigned int first, unsigned int count,
+	bool interpolated, float* const out[NUM_CHANNELS]) const
+{
+	assert(first + count <= this->length);
+
+	unsigned int end = first + count;
+	unsigned int k = this->findKeyIndex(first);
+	unsigned int numKeys = (unsigned int)(this->times.size());
+
+	/* Fill one segment between two keyframes at a time */
+	for(unsigned int n = first; n < end; k++)
+	{
+		bool lastKey = (k + 1 == numKeys);
+		unsigned int segmentEnd = lastKey ? end : std::min(this->times[k+1],
+			end);
+		unsigned int offset = n - first, size = segmentEnd - n;
+
+		if(!interpolated || lastKey)
+		{
+			/* Hold the keyframe over the segment */
+			for(int c = 0; c < NUM_CHANNELS; c++)
+			{
+				std::fill(out[c] + offset, out[c] + offset + size,
+					this->channels[c][k]);
+			}
+		}
+		else
+		{
+			/* Linearly interpolate over the segment */
+			unsigned int start = n - this->times[k];
+			for(int c = 0; c < NUM_CHANNELS; c++)
+			{
+				const float initial = this->channels[c][k];
+				const float conversionFactor = this->slopes[c][k];
+				float* values = out[c] + offset;
+				for(unsigned int i = 0; i < size; i++)
+				{
+					values[i] = initial + conversionFactor * (float)(start + i);
+				}
+			}
+		}
+
+		n = segmentEnd;
+	}
+}
+
+/* Returns the Frame at the given frame number. Frames are only evaluated  */
+/* when first asked for and then kept in a small cache, so the reference is */
+/* valid until the next call on this track.                                 */
+const Frame& KeyframeTrack::getFrame(unsigned int frameNum, 
+	bool interpolated) const
+{
+	assert(frameNum < this->length);
+	this->cacheClock++;
+
+	/* Look for the frame in the cache, keeping track of the least */
+	/* recently used entry.                                        */
+	unsigned int oldest = 0;
+	for(unsigned int i = 0; i < this->cachedFrames.size(); i++)
+	{
+		if(this->cachedFrameNums[i] == frameNum && 
+			this->cachedInterpolated[i] == interpolated)
+		{
+			this->cacheLastUsed[i] = this->cacheClock;
+			return this->cachedFrames[i];
+		}
+		if(this->cacheLastUsed[i] < this->cacheLastUsed[oldest])
+		{
+			oldest = i;
+		}
+	}
+
+	/* Evaluate the frame from the surrounding keyframes */
+	float values[NUM_CHANNELS];
+	this->getValues(frameNum, interpolated, values);
+	Frame frame(
+		values[SCALE_X], values[SCALE_Y], values[ROTATION],
+		values[TRANSLATION_X], values[TRANSLATION_Y],
+		values[RED], values[GREEN], values[BLUE],
+		this->getIsKeyframe(frameNum)
+	);
+
+	/* Fill an empty entry or replace the least recently used one */
+	if(this->cachedFrames.size() < FRAME_CACHE_SIZE)
+	{
+		oldest = (unsigned int)(this->cachedFrames.size());
+		this->cachedFrames.push_back(frame);
+	}
+	else
+	{
+		this->cachedFrames[oldest] = frame;
+	}
+	this->cachedFrameNums[oldest] = frameNum;
+	this->cachedInterpolated[oldest] = interpolated;
+	this->cacheLastUsed[oldest] = this->cacheClock;
+
+	return this->cachedFrames[oldest];
+}
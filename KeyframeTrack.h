@@ -0,0 +1,159 @@
+/*
+ * KeyframeTrack.h
+ * Created by Zachary Ferguson
+ * Header file for the KeyframeTrack class, a class for storing only the key
+ * frames of a Node's animation and working out the in-between frames on
+ * request.
+ */
+
+#ifndef KEYFRAMETRACK_H
+#define KEYFRAMETRACK_H
+
+/* Include necessary types */
+#include <vector>
+#include <assert.h>
+#include "Frame.h"
+
+/* Number of evaluated frames cached by each track. */
+#define FRAME_CACHE_SIZE 4
+
+/* Most frames a track may cover, so its bitset of keyframes stays small. */
+/* Files that give a longer length are rejected.                          */
+#define MAX_TRACK_LENGTH 0x1000000
+
+class KeyframeTrack
+{
+	public:
+
+		/* The animated channels of a track. */
+		enum Channel
+		{
+			SCALE_X, SCALE_Y, ROTATION, TRANSLATION_X, TRANSLATION_Y,
+			RED, GREEN, BLUE,
+			NUM_CHANNELS
+		};
+
+	private:
+
+		/* Frame numbers of the keyframes, sorted in increasing order. */
+		/* Frame 0 is always a keyframe.                               */
+		std::vector<unsigned int> times;
+
+		/* Contiguous array of keyframe values for each channel,      */
+		/* channels[c][i] is the value of channel c at frame times[i]. */
+		std::vector<float> channels[NUM_CHANNELS];
+
+		/* Cached rate of change per frame of each channel over each     */
+		/* segment, slopes[c][i] is for the segment from keyframe i to   */
+		/* keyframe i+1. Only the segments next to an edited keyframe    */
+		/* are re-interpolated.                                          */
+		std::vector<float> slopes[NUM_CHANNELS];
+
+		/* Bitset over the timeline of which frames are keyframes. */
+		std::vector<unsigned int> keyBits;
+
+		/* Number of frames on the timeline covered by this track. */
+		unsigned int length;
+
+		/* Small least recently used cache of evaluated Frames, keyed by */
+		/* frame number and interpolation mode.                          */
+		mutable std::vector<Frame> cachedFrames;
+		mutable unsigned int cachedFrameNums[FRAME_CACHE_SIZE];
+		mutable bool cachedInterpolated[FRAME_CACHE_SIZE];
+		mutable unsigned int cacheLastUsed[FRAME_CACHE_SIZE];
+		mutable unsigned int cacheClock;
+
+		/* Returns the index of the last keyframe at or before frameNum. */
+		unsigned int findKeyIndex(unsigned int frameNum) const;
+
+		/* Re-interpolates the two segments on either side of the */
+		/* keyframe at the given index.                            */
+		void reinterpolateSegments(unsigned int keyIndex);
+
+		/* Drops the cached Frames from first to last, inclusive. */
+		void invalidateCache(unsigned int first, unsigned int last);
+
+	public:
+
+		/* Constructor for a KeyframeTrack of one frame that takes the */
+		/* Frame to use as the keyframe at frame 0.                    */
+		KeyframeTrack(const Frame& first);
+
+		/* Destructor for the KeyframeTrack */
+		virtual ~KeyframeTrack();
+
+		/* Compares if two given tracks have the same keyframes */
+		friend bool operator==(const KeyframeTrack& t1,
+			const KeyframeTrack& t2);
+
+		/* Returns the number of frames covered by this track. */
+		unsigned int getLength() const;
+
+		/* Sets the number of frames covered by this track, at most      */
+		/* MAX_TRACK_LENGTH. Keyframes at or after the new length are    */
+		/* removed.                                                      */
+		void setLength(unsigned int newLength);
+
+		/* Returns the number of keyframes stored. */
+		unsigned int getNumKeyframes() const;
+
+		/* Returns if the given frame is a keyframe. */
+		bool getIsKeyframe(unsigned int frameNum) const;
+
+		/* Stores the given channel values as the keyframe at frameNum, */
+		/* replacing any keyframe already there.                        */
+		void setKeyframe(unsigned int frameNum,
+			const float values[NUM_CHANNELS]);
+
+		/* Stores the given Frame as the keyframe at frameNum, replacing */
+		/* any keyframe already there.                                   */
+		void setKeyframe(unsigned int frameNum, const Frame& frame);
+
+		/* Removes the keyframe at frameNum, if there is one, so the */
+		/* frame is worked out from the keyframes around it. Frame 0 */
+		/* is always a keyframe and can not be removed.              */
+		void removeKeyframe(unsigned int frameNum);
+
+		/* Returns the frame numbers of the keyframes, in increasing */
+		/* order.                                                    */
+		const std::vector<unsigned int>& getKeyframeTimes() const;
+
+		/* Returns the value of the given channel at each keyframe. */
+		const std::vector<float>& getKeyframeValues(Channel channel) const;
+
+		/* Replaces every keyframe and the length of the track, at most   */
+		/* MAX_TRACK_LENGTH, at once. Takes count frame numbers in        */
+		/* increasing order, starting with 0 and all less than the        */
+		/* length, and an array of count values for each channel.         */
+		void setKeyframes(unsigned int newLength, const unsigned int* times,
+			unsigned int count, const float* const values[NUM_CHANNELS]);
+
+		/* Makes the given frame a keyframe with its current values. */
+		/* Must send if the in-between frames are interpolated.      */
+		void makeKeyframe(unsigned int frameNum, bool interpolated);
+
+		/** Methods for evaluating frames. In-between frames are linearly **/
+		/** interpolated if interpolated is true, otherwise they hold the **/
+		/** previous keyframe (flip book).                                **/
+
+		/* Returns the value of one channel at the given frame number. */
+		float getValue(Channel channel, unsigned int frameNum,
+			bool interpolated) const;
+
+		/* Fills values with every channel at the given frame number. */
+		void getValues(unsigned int frameNum, bool interpolated,
+			float values[NUM_CHANNELS]) const;
+
+		/* Samples count frames starting at first into the given arrays, */
+		/* one contiguous array of count floats per channel.             */
+		void sampleRange(unsigned int first, unsigned int count,
+			bool interpolated, float* const out[NUM_CHANNELS]) const;
+
+		/* Returns the Frame at the given frame number. Frames are only   */
+		/* evaluated when first asked for and then kept in a small cache, */
+		/* so the reference is valid until the next call on this track.   */
+		/* Not safe to call from more than one thread at a time.          */
+		const Frame& getFrame(unsigned int frameNum, bool interpolated) const;
+};
+
+#endif
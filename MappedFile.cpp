@@ -0,0 +1,161 @@
+/*
+ * MappedFile.cpp
+ * Created by Zachary Ferguson
+ * Source file for the MappedFile class, a read-only view of a whole file in
+ * memory. The file is memory mapped where the system allows it, so its pages
+ * are only read in when they are used, and otherwise read into a buffer.
+ */
+
+#include "MappedFile.h"
+#include "FrameWriter.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+/* Constructor for a MappedFile with no file open. */
+MappedFile::MappedFile()
+{
+	this->data = NULL;
+	this->size = 0;
+	#ifdef _WIN32
+	this->fileHandle = NULL;
+	this->mappingHandle = NULL;
+	#else
+	this->fileDescriptor = -1;
+	#endif
+}
+
+/* Destructor for the MappedFile, closes the file. */
+MappedFile::~MappedFile()
+{
+	this->close();
+}
+
+/* Maps the file at the given path. Returns if it was mapped. */
+bool MappedFile::map(const std::string& path)
+{
+	#ifdef _WIN32
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ,
+		NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart <= 0 ||
+		(unsigned long long)(fileSize.QuadPart) > (size_t)(-1))
+	{
+		CloseHandle(file);
+		return false;
+	}
+	HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0,
+		NULL);
+	if (mapping == NULL)
+	{
+		CloseHandle(file);
+		return false;
+	}
+	void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (view == NULL)
+	{
+		CloseHandle(mapping);
+		CloseHandle(file);
+		return false;
+	}
+	this->fileHandle = file;
+	this->mappingHandle = mapping;
+	this->data = (const unsigned char*)view;
+	this->size = (size_t)(fileSize.QuadPart);
+	return true;
+	#else
+	int file = ::open(path.c_str(), O_RDONLY);
+	if (file < 0)
+	{
+		return false;
+	}
+	struct stat status;
+	if (fstat(file, &status) != 0 || !S_ISREG(status.st_mode) ||
+		status.st_size <= 0 ||
+		(unsigned long long)(status.st_size) > (size_t)(-1))
+	{
+		::close(file);
+		return false;
+	}
+	void* view = mmap(NULL, (size_t)(status.st_size), PROT_READ, MAP_PRIVATE,
+		file, 0);
+	if (view == MAP_FAILED)
+	{
+		::close(file);
+		return false;
+	}
+	this->fileDescriptor = file;
+	this->data = (const unsigned char*)view;
+	this->size = (size_t)(status.st_size);
+	return true;
+	#endif
+}
+
+/* Opens the file at the given path, closing any file already open. */
+/* Returns if the file could be opened.                             */
+bool MappedFile::open(const std::string& path)
+{
+	this->close();
+	if (this->map(path))
+	{
+		return true;
+	}
+
+	/* Empty files, pipes, and files on systems that can not map them */
+	/* are read in whole instead                                      */
+	if (!FrameWriter::readFile(path, this->buffer))
+	{
+		return false;
+	}
+	this->data = this->buffer.empty() ? NULL : &(this->buffer[0]);
+	this->size = this->buffer.size();
+	return true;
+}
+
+/* Closes the file. The contents are no longer valid. */
+void MappedFile::close()
+{
+	#ifdef _WIN32
+	if (this->mappingHandle != NULL)
+	{
+		UnmapViewOfFile(this->data);
+		CloseHandle(this->mappingHandle);
+		CloseHandle(this->fileHandle);
+		this->mappingHandle = NULL;
+		this->fileHandle = NULL;
+	}
+	#else
+	if (this->fileDescriptor >= 0)
+	{
+		munmap((void*)(this->data), this->size);
+		::close(this->fileDescriptor);
+		this->fileDescriptor = -1;
+	}
+	#endif
+	std::vector<unsigned char>().swap(this->buffer);
+	this->data = NULL;
+	this->size = 0;
+}
+
+/* Returns the contents of the file, NULL if it is empty. */
+const unsigned char* MappedFile::getData() const
+{
+	return this->data;
+}
+
+/* Returns the size of the file in bytes. */
+size_t MappedFile::getSize() const
+{
+	return this->size;
+}
@@ -0,0 +1,62 @@
+/*
+ * MappedFile.h
+ * Created by Zachary Ferguson
+ * Header file for the MappedFile class, a read-only view of a whole file in
+ * memory. The file is memory mapped where the system allows it, so its pages
+ * are only read in when they are used, and otherwise read into a buffer.
+ */
+
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+/* Include necessary types */
+#include <string>
+#include <vector>
+#include <stddef.h> /* Included for size_t */
+
+class MappedFile
+{
+	private:
+
+		/* Start and size in bytes of the file's contents. */
+		const unsigned char* data;
+		size_t size;
+
+		/* Handles of the file and its mapping, NULL or -1 if the file */
+		/* is not mapped.                                              */
+		#ifdef _WIN32
+		void* fileHandle;
+		void* mappingHandle;
+		#else
+		int fileDescriptor;
+		#endif
+
+		/* Contents of the file when it could not be mapped. */
+		std::vector<unsigned char> buffer;
+
+		/* Maps the file at the given path. Returns if it was mapped. */
+		bool map(const std::string& path);
+
+	public:
+
+		/* Constructor for a MappedFile with no file open. */
+		MappedFile();
+
+		/* Destructor for the MappedFile, closes the file. */
+		virtual ~MappedFile();
+
+		/* Opens the file at the given path, closing any file already */
+		/* open. Returns if the file could be opened.                 */
+		bool open(const std::string& path);
+
+		/* Closes the file. The contents are no longer valid. */
+		void close();
+
+		/* Returns the contents of the file, NULL if it is empty. */
+		const unsigned char* getData() const;
+
+		/* Returns the size of the file in bytes. */
+		size_t getSize() const;
+};
+
+#endif
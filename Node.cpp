@@ -5,6 +5,10 @@
  */
 
 #include "Node.h"
+#include <algorithm> /* Included for find */
+
+/* Frames start out as a flip book */
+bool Node::interpolated = false;
 
 /* Constructor for a Node that takes three mat3's for the transformations */
 Node::Node(mat3 scale, mat3 rotation, mat3 translation) :
@@ -22,19 +26,23 @@ Node::Node(mat3 scale, mat3 rotation, mat3 translation, polyline* geometry)
 
 	/* Initialize the parent Node to NULL */
 	this->parent = NULL;	
+
+	this->structureRevision = 0;
+	this->transformRevision = 0;
+	this->subtreeTransformRevision = 0;
 	
-	/* Initialize the transform to the product of the individual */
-	/* transformations.                                          */
-	this->frames = new std::vector<Frame*>();
+	/* Initialize the track with a keyframe of the product of the */
+	/* individual transformations.                                 */
 	if(this->geometry != NULL)
 	{
 		std::vector<float> colors = this->geometry->getColor();
-		this->frames->push_back(new Frame(scale, rotation, translation,
+		this->track = new KeyframeTrack(Frame(scale, rotation, translation,
 			colors[0], colors[1], colors[2], true));
 	}
 	else
 	{
-		this->frames->push_back(new Frame(scale, rotation, translation, true));
+		this->track = new KeyframeTrack(Frame(scale, rotation, translation, 
+			true));
 	}
 }
 
@@ -42,10 +50,8 @@ Node::Node(mat3 scale, mat3 rotation, mat3 translation, polyline* geometry)
 /* Deletes all of the children Nodes. */
 Node::~Node()
 {
-	/* Deletes the contents of the vector of Frames */
-	this->frames->clear();
-	/* Delete the vector of Frames */
-	delete this->frames;
+	/* Delete the track of keyframes */
+	delete this->track;
 	/* Deletes all the children, calling the destructor for each child node. */
 	(this->children)->clear();
 	///* Delete the geometry pointer */
@@ -56,25 +62,11 @@ Node::~Node()
 	}
 }
 
-/* Compares if too given Nodes are equal. Compares by geometry and transform. */
+/* Compares if too given Nodes are equal. Compares by geometry and keyframes. */
 bool operator==(const Node& n1, const Node& n2)
 {
-	/* Compare geometry and transforms vector size */
-	if(n1.geometry != n2.geometry || (n1.frames)->size() != (n2.frames)->size())
-	{
-		return false;
-	}
-
-	/* Compare transform matrices */
-	for (unsigned int i = 0; i < (n1.frames)->size(); i++)
-	{
-		if((*(n1.frames))[i] != (*(n2.frames))[i])
-		{
-			return false;
-		}
-	}
-
-	return true;
+	/* Compare geometry and keyframe tracks */
+	return n1.geometry == n2.geometry && *(n1.track) == *(n2.track);
 }
 
 /* Add the given Node to the list of children */
@@ -84,6 +76,21 @@ void Node::addChild(Node* newNode)
 	{
 		newNode->parent = this;
 		(this->children)->push_back(newNode);
+		this->structureChanged();
+	}
+}
+
+/* Adds the given Node to the list of children before the given child, or */
+/* at the end if nextSibling is NULL.                                     */
+void Node::insertChild(Node* newNode, Node* nextSibling)
+{
+	if (newNode != NULL)
+	{
+		std::list<Node*>::iterator it = std::find(this->children->begin(),
+			this->children->end(), nextSibling);
+		newNode->parent = this;
+		(this->children)->insert(it, newNode);
+		this->structureChanged();
 	}
 }
 
@@ -93,27 +100,60 @@ void Node::removeChild(Node* rNode)
 	for (std::list<Node*>::iterator it = this->children->begin(); it != 
 		this->children->end(); ++it)
 	{
-		if (*(*it) == *rNode)
+		if (*it == rNode)
 		{
 			(this->children)->erase(it);
+			this->structureChanged();
 			return;
 		}
 	}
 }
 
-/* Returns the first transform mat3 */
-const mat3 Node::getTransformation() const
+/* Increments the structure revision of this Node's root. */
+void Node::structureChanged()
+{
+	Node* root = this;
+	while (root->parent != NULL)
+	{
+		root = root->parent;
+	}
+	root->structureRevision++;
+}
+
+/* Increments the transform revision of this Node and the subtree transform */
+/* revision of it and all its ancestors.                                    */
+void Node::transformChanged()
+{
+	this->transformRevision++;
+	for (Node* n = this; n != NULL; n = n->parent)
+	{
+		n->subtreeTransformRevision++;
+	}
+}
+
+/* Returns the first transformation */
+const affine2 Node::getTransformation() const
 {
 	return this->getTransformation(0);
 }
 
-/* Returns the nth transform mat3 */
-const mat3 Node::getTransformation(unsigned int n) const
+/* Returns the nth transformation */
+const affine2 Node::getTransformation(unsigned int n) const
 {
-	/* Check the bounds of the transforms vector */
-	assert(n < this->frames->size());
-	
-	return ((*(this->frames))[n])->getTransformation();
+	return this->track->getFrame(n, Node::interpolated).getTransformation();
+}
+
+/* Returns the nth transformation worked out from the keyframes without */
+/* using the Frame cache, so it is safe to call from several threads at */
+/* once.                                                                */
+const affine2 Node::evaluateTransformation(unsigned int n) const
+{
+	float values[KeyframeTrack::NUM_CHANNELS];
+	this->track->getValues(n, Node::interpolated, values);
+	return affine2::fromValues(values[KeyframeTrack::SCALE_X],
+		values[KeyframeTrack::SCALE_Y], values[KeyframeTrack::ROTATION],
+		values[KeyframeTrack::TRANSLATION_X],
+		values[KeyframeTrack::TRANSLATION_Y]);
 }
 
 /* Sets the first transform mat3 */
@@ -126,17 +166,13 @@ void Node::setTransformation(mat3 scale, mat3 rotation, mat3 translation)
 void Node::setTransformation(mat3 scale, mat3 rotation, mat3 translation, unsigned 
 	int n)
 {
-	/* Check the bounds of the transforms vector */
-	assert(n < this->frames->size());
-
 	std::vector<float> colors = this->getColors(n);
-	Frame* newFrame = new Frame(
+	this->track->setKeyframe(n, Frame(
 		scale, rotation, translation,
 		colors[0], colors[1], colors[2],
 		true
-	);
-
-	(*(this->frames))[n] = newFrame;
+	));
+	this->transformChanged();
 }
 
 /* Returns a constant reference to the the geometry */
@@ -164,8 +200,7 @@ const std::vector<float> Node::getColors() const
 /* Returns a vector of all zeros if geometry == NULL.    */
 const std::vector<float> Node::getColors(unsigned int frameNum) const
 {
-	assert(frameNum < this->frames->size());
-	return this->frames->at(frameNum)->getColors();
+	return this->track->getFrame(frameNum, Node::interpolated).getColors();
 }
 
 /* Sets the geometry color */
@@ -179,24 +214,15 @@ void Node::setGeometryColor(const float newRed, const float newGreen, const
 void Node::setGeometryColor(const float newRed, const float newGreen, const 
 	float newBlue, unsigned int frameNum)
 {
-	assert(frameNum < this->frames->size());
 	if(this->geometry != NULL)
 	{
-		/* Create a copy of the startIndex frame that is not a keyframe */
-		Frame* newFrame = new Frame(
-			mat3::scale2D(this->getScaleX(frameNum), this->getScaleY(frameNum)),
-
-			mat3::rotation2D(this->getRotation(frameNum)),
-
-			mat3::translation2D(this->getTranslationX(frameNum), 
-				this->getTranslationY(frameNum)),
-
-			newRed, newGreen, newBlue,
-
-			true
-		);
-
-		(*(this->frames))[frameNum] = newFrame;
+		/* Key the frame's transformation values with the new color */
+		float values[KeyframeTrack::NUM_CHANNELS];
+		this->track->getValues(frameNum, Node::interpolated, values);
+		values[KeyframeTrack::RED] = newRed;
+		values[KeyframeTrack::GREEN] = newGreen;
+		values[KeyframeTrack::BLUE] = newBlue;
+		this->track->setKeyframe(frameNum, values);
 	}
 }
 
@@ -212,6 +238,28 @@ Node* Node::getParent()
 	return this->parent;
 }
 
+/* Returns the structure revision of this Node, which changes whenever a */
+/* Node is added to or removed from its subtree.                        */
+unsigned int Node::getStructureRevision() const
+{
+	return this->structureRevision;
+}
+
+/* Returns the transform revision of this Node, which changes whenever this */
+/* Node's own transformations change.                                       */
+unsigned int Node::getTransformRevision() const
+{
+	return this->transformRevision;
+}
+
+/* Returns the subtree transform revision of this Node, which changes */
+/* whenever the transformations of this Node or any Node below it     */
+/* change.                                                            */
+unsigned int Node::getSubtreeTransformRevision() const
+{
+	return this->subtreeTransformRevision;
+}
+
 /* Methods for accessing the individual transformation values. */
 /* Default frameNum to 0.                                      */
 const float Node::getScaleX() const
@@ -238,102 +286,93 @@ const float Node::getTranslationY() const
 /* Methods for accessing the individual transformations */
 const float Node::getScaleX(unsigned int  frameNum) const
 {
-	assert(frameNum < this->frames->size());
-	return this->frames->at(frameNum)->getScaleX();
+	return this->track->getFrame(frameNum, Node::interpolated).getScaleX();
 }
 
 const float Node::getScaleY(unsigned int  frameNum) const
 {
-	assert(frameNum < this->frames->size());
-	return this->frames->at(frameNum)->getScaleY();
+	return this->track->getFrame(frameNum, Node::interpolated).getScaleY();
 }
 
 const float Node::getRotation(unsigned int  frameNum) const
 {
-	assert(frameNum < this->frames->size());
-	return this->frames->at(frameNum)->getRotation();
+	return this->track->getFrame(frameNum, Node::interpolated).getRotation();
 }
 
 const float Node::getTranslationX(unsigned int  frameNum) const
 {
-	assert(frameNum < this->frames->size());
-	return this->frames->at(frameNum)->getTranslationX();
+	return this->track->getFrame(frameNum, Node::interpolated).getTranslationX();
 }
 
 const float Node::getTranslationY(unsigned int  frameNum) const
 {
-	assert(frameNum < this->frames->size());
-	return this->frames->at(frameNum)->getTranslationY();
+	return this->track->getFrame(frameNum, Node::interpolated).getTranslationY();
 }
 
 
 
-/* Traverse the scene graph applying transforms and drawing geometry. */
-/* Must give a Node and the accumalated transformation.               */
-void Node::traverseSceneGraph(const Node& n, mat3 transformation)
-{
-	traverseSceneGraph(n, transformation, 0);
-}
-
-/* Traverse the scene graph applying transforms and drawing geometry. */
-/* Must give a Node, the accumalated transformation, and the          */
-/* transformation "frame" number.                                     */
-void Node::traverseSceneGraph(const Node& n, mat3 transformation, unsigned int 
-	transformNum)
+/* Adds this Node's geometry, not its children, to the RenderBatch. Must */
+/* give the accumalated transformation and the transformation "frame"    */
+/* number.                                                               */
+void Node::appendTo(RenderBatch& batch, const affine2& transformation, 
+	unsigned int transformNum) const
 {
-	/* Checks that the given Node is not Null */
-	if(&n != NULL)
+	/* If the Node points to geometry add it in this frame's color */
+	if(this->geometry != NULL)
 	{
-		/* Multiplies the given transform and the Nodes transform mat3 */
-		transformation = transformation * n.getTransformation(transformNum);
-
-		/* If the Node points to geometry draw it */
-		if(n.getGeometry() != NULL)
-		{
-			/* Draw the geometry */
-			std::vector<float> colors = n.getColors(transformNum);
-			n.geometry->setColor(colors[0], colors[1], colors[2]);
-			n.geometry->draw(transformation);
-		}
-
-		/* Iterate over the children Nodes and traverse them */
-		for (std::list<Node*>::const_iterator it = (n.getChildren())->cbegin(); 
-			it != (n.getChildren())->end(); ++it)
-		{
-			/* Recursive call to traverse the child Node */
-			traverseSceneGraph(*(*it), transformation, transformNum);
-		}
+		float values[KeyframeTrack::NUM_CHANNELS];
+		this->track->getValues(transformNum, Node::interpolated, values);
+		this->geometry->appendTo(batch, transformation, 
+			&values[KeyframeTrack::RED]);
 	}
 }
 
-/* Copies the nth transform out to until the transforms vector equals */
-/* the given size. Must send the index of the transform to be copied  */
-/* and the new size of the transforms vector.                         */
-void Node::expandTransforms(unsigned int frameNum, unsigned int size)
+/* Returns the track of this Node's keyframes. */
+const KeyframeTrack* Node::getTrack() const
 {
-	/* Ensure the transformIndex is valid. */
-	assert(frameNum < this->frames->size());
+	return this->track;
+}
 
-	/* Create a copy of the startIndex frame that is not a keyframe */
-	std::vector<float> colors = this->getColors(frameNum);
-	Frame* copy = new Frame(
-		mat3::scale2D(this->getScaleX(frameNum), this->getScaleY(frameNum)),
+/* Stores the given channel values as the keyframe at frameNum of this  */
+/* Node, replacing any keyframe already there.                          */
+void Node::setKeyframe(unsigned int frameNum,
+	const float values[KeyframeTrack::NUM_CHANNELS])
+{
+	this->track->setKeyframe(frameNum, values);
+	this->transformChanged();
+}
 
-		mat3::rotation2D(this->getRotation(frameNum)),
+/* Removes the keyframe at frameNum of this Node, if there is one. See */
+/* KeyframeTrack::removeKeyframe.                                      */
+void Node::removeKeyframe(unsigned int frameNum)
+{
+	this->track->removeKeyframe(frameNum);
+	this->transformChanged();
+}
 
-		mat3::translation2D(this->getTranslationX(frameNum), 
-			this->getTranslationY(frameNum)),
+/* Replaces every keyframe of this Node, not its children, and its number */
+/* of frames. See KeyframeTrack::setKeyframes.                            */
+void Node::setKeyframes(unsigned int size, const unsigned int* times,
+	unsigned int count, const float* const values[KeyframeTrack::NUM_CHANNELS])
+{
+	this->track->setKeyframes(size, times, count, values);
+	this->transformChanged();
+}
 
-		colors[0], colors[1], colors[2]
-	);
+/* Expands the number of frames to the given size. The new frames hold the */
+/* values of the last frame. Must send the index of the last frame and the  */
+/* new number of frames.                                                    */
+void Node::expandTransforms(unsigned int frameNum, unsigned int size)
+{
+	/* Ensure the frameNum is valid. */
+	assert(frameNum < this->track->getLength());
 
-	/* Copy the choosen mat3 to all the new transformations. */
-	for (unsigned int i = this->frames->size()-1; i < size; i++)
-	{
-		this->frames->push_back(copy);
-	}
+	/* Frames after the last keyframe hold its values, so only the length */
+	/* of the track changes.                                              */
+	this->track->setLength(size);
+	this->transformChanged();
 
-	/* Expand children's transforms vector. */
+	/* Expand children's frames. */
 	for (std::list<Node*>::const_iterator it = this->children->cbegin(); 
 			it != this->children->end(); it++)
 	{
@@ -341,17 +380,15 @@ void Node::expandTransforms(unsigned int frameNum, unsigned int size)
 	}
 }
 
-/* Shrinks the transforms vector down to the size given. Must send the */
-/* new size of the transforms vector.                                  */
+/* Shrinks the number of frames down to the size given. Must send the new */
+/* number of frames.                                                      */
 void Node::shrinkTransforms(unsigned int size)
 {
-	/* Remove transform until the sizes are equal */
-	while(this->frames->size() != size)
-	{
-		this->frames->pop_back();
-	}
+	/* Remove the frames and their keyframes past the new size */
+	this->track->setLength(size);
+	this->transformChanged();
 
-	/* Shrink children's transforms vector. */
+	/* Shrink children's frames. */
 	for (std::list<Node*>::const_iterator it = this->children->cbegin(); 
 			it != this->children->end(); it++)
 	{
@@ -359,58 +396,15 @@ void Node::shrinkTransforms(unsigned int size)
 	}
 }
 
-/* Copies the nth transformation up to the next keyframe. Must send the index */
-/* of the starting transform (where to start copying and where to copy from). */
-void Node::copyTransforms(unsigned int startIndex)
-{
-	/* Ensure the transformIndex is valid. */
-	assert(startIndex < this->frames->size());
-
-	
-	/* Create a copy of the startIndex frame that is not a keyframe */
-	std::vector<float> colors = this->getColors(startIndex);
-	Frame* copy = new Frame(
-		mat3::scale2D(this->getScaleX(startIndex), this->getScaleY(startIndex)),
-
-		mat3::rotation2D(this->getRotation(startIndex)),
-
-		mat3::translation2D(this->getTranslationX(startIndex), 
-			this->getTranslationY(startIndex)),
-
-		colors[0], colors[1], colors[2]
-	);
-
-	/* Copy the choosen mat3 to all frames up till the next keyframe. */
-	for (unsigned int i = startIndex+1; i < this->frames->size() && 
-		!(this->frames->at(i)->getIsKeyframe()); i++)
-	{
-		(*(this->frames))[i] = copy;
-	}
-}
-
+/* Makes the given transform a key frame and it children have the same */
+/* keyframe.                                                           */
 void Node::makeKeyframe(unsigned int frameNum)
 {
-	/* Ensure the transformIndex is valid. */
-	assert(frameNum < this->frames->size());
-
-	/* Create a copy of the startIndex frame that is not a keyframe */
-	std::vector<float> colors = this->getColors(frameNum);
-	Frame* frame = new Frame(
-		mat3::scale2D(this->getScaleX(frameNum), this->getScaleY(frameNum)),
-
-		mat3::rotation2D(this->getRotation(frameNum)),
+	/* Key the current values of the frame. The values of every frame */
+	/* stay the same, so the cached world transforms stay valid.      */
+	this->track->makeKeyframe(frameNum, Node::interpolated);
 
-		mat3::translation2D(this->getTranslationX(frameNum), 
-			this->getTranslationY(frameNum)),
-
-		colors[0], colors[1], colors[2],
-
-		true
-	);
-
-	(*(this->frames))[frameNum] = frame;
-
-	/* Expand children's transforms vector. */
+	/* Make children's keyframes. */
 	for (std::list<Node*>::const_iterator it = this->children->cbegin(); 
 			it != this->children->end(); it++)
 	{
@@ -419,100 +413,16 @@ void Node::makeKeyframe(unsigned int frameNum)
 }
 
 
-/* Interpolate frames between key frames */
-void Node::linearlyInterpolate()
+/* Sets if the frames between key frames are linearly interpolated or hold */
+/* the previous key frame (flip book). Frames are worked out when asked    */
+/* for, so nothing is recomputed here.                                     */
+void Node::setInterpolated(bool interpolated)
 {
-	std::vector<int> keyframes = std::vector<int>();
-
-	/* Fill the vector of key frame indeces */
-	for(unsigned int i = 0; i < this->frames->size(); i++)
-	{
-		if(this->frames->at(i)->getIsKeyframe())
-			keyframes.push_back(i);
-	}
-
-	/* Interpolate all the frame values for non keyframes */
-	for(unsigned int k = 0; k < keyframes.size()-1; k++)
-	{
-
-		int i = keyframes[k], f = keyframes[k+1];
-		int indexDifference = f-i;
-		Frame *iframe = this->frames->at(i), *fframe = this->frames->at(f);
-	
-		float scaleXConversionFactor = (fframe->getScaleX()-iframe->getScaleX())/
-			indexDifference;
-		float scaleYConversionFactor = (fframe->getScaleY()-iframe->getScaleY())/
-			indexDifference;
-	
-		float rotationConversionFactor = (fframe->getRotation()-iframe->
-			getRotation())/indexDifference;
-	
-		float translationXConversionFactor = (fframe->getTranslationX()-iframe->
-			getTranslationX())/indexDifference;
-		float translationYConversionFactor = (fframe->getTranslationY()-iframe->
-			getTranslationY())/indexDifference;
-	
-		std::vector<float> icolors = iframe->getColors(), fcolors = fframe->
-			getColors(); 
-	
-		float redConversionFactor = (fcolors[0]-icolors[0])/indexDifference;
-		float greenConversionFactor = (fcolors[1]-icolors[1])/indexDifference;
-		float blueConversionFactor = (fcolors[2]-icolors[2])/indexDifference;
-	
-		for(int n = keyframes[k]+1; n < keyframes[k+1]; n++)
-		{
-			(*(this->frames))[n] = new Frame( 
-				mat3::scale2D
-				(
-					scaleXConversionFactor*(n-i)+iframe->getScaleX(),
-					scaleYConversionFactor*(n-i)+iframe->getScaleY()
-				),
-				mat3::rotation2D
-				(
-					rotationConversionFactor*(n-i)+iframe->getRotation()
-				),
-				mat3::translation2D
-				(
-					translationXConversionFactor*(n-i)+iframe->getTranslationX(),
-					translationYConversionFactor*(n-i)+iframe->getTranslationY()
-				),
-				redConversionFactor*(n-i)+icolors[0],
-				greenConversionFactor*(n-i)+icolors[1],
-				blueConversionFactor*(n-i)+icolors[2]
-			);
-		}
-	}
-
-	/* Interpolate children Nodes. */
-	for (std::list<Node*>::const_iterator it = this->children->cbegin(); 
-			it != this->children->end(); it++)
-	{
-		(*it)->linearlyInterpolate();
-	}
+	Node::interpolated = interpolated;
 }
 
-/* Interpolate frames between key frames */
-void Node::unInterpolate()
+/* Returns if the frames between key frames are interpolated. */
+bool Node::getInterpolated()
 {
-	std::vector<int> keyframes = std::vector<int>();
-
-	/* Fill the vector of key frame indeces */
-	for(unsigned int i = 0; i < this->frames->size(); i++)
-	{
-		if(this->frames->at(i)->getIsKeyframe())
-			keyframes.push_back(i);
-	}
-
-	/* Copy over the keyframes */
-	for(unsigned int k = 0; k < keyframes.size(); k++)
-	{
-		this->copyTransforms(keyframes[k]);
-	}
-
-	/* unInterpolate children Nodes. */
-	for (std::list<Node*>::const_iterator it = this->children->cbegin(); 
-			it != this->children->end(); it++)
-	{
-		(*it)->unInterpolate();
-	}
+	return Node::interpolated;
 }
@@ -12,14 +12,15 @@
 #include <vector>
 #include <assert.h>
 #include "polyline.h"
-#include "frame.h"
+#include "KeyframeTrack.h"
 
 class Node
 {
 	private:
 
-		/* Vector of Transformations matrices for this node. */
-		std::vector<Frame*>* frames;
+		/* Track of the keyframes for this node. In-between frames are */
+		/* worked out from the keyframes on request.                  */
+		KeyframeTrack* track;
 
 		/* List of pointers to Node children */
 		std::list<Node*>* children;
@@ -30,6 +31,29 @@ class Node
 		/* Pointer to the parent of this Node */
 		Node* parent;
 
+		/* Counter incremented whenever a Node is added to or removed */
+		/* from the tree rooted at this Node.                         */
+		unsigned int structureRevision;
+
+		/* Increments the structure revision of this Node's root. */
+		void structureChanged();
+
+		/* Counter incremented whenever this Node's own transformations */
+		/* change.                                                      */
+		unsigned int transformRevision;
+
+		/* Counter incremented whenever the transformations of this Node */
+		/* or any Node below it change.                                  */
+		unsigned int subtreeTransformRevision;
+
+		/* Increments the transform revision of this Node and the subtree */
+		/* transform revision of it and all its ancestors.                */
+		void transformChanged();
+
+		/* Boolean value for if the in-between frames of every Node are */
+		/* linearly interpolated or hold the previous keyframe.         */
+		static bool interpolated;
+
 	public:
 
 		/* Constructor for a Node that takes three mat3's for the */
@@ -49,14 +73,23 @@ class Node
 		/* Add the given Node to the list of children */
 		void addChild(Node* newNode);
 	
+		/* Adds the given Node to the list of children before the given */
+		/* child, or at the end if nextSibling is NULL.                 */
+		void insertChild(Node* newNode, Node* nextSibling);
+
 		/* Removes the given Node from the list of children */
 		void removeChild(Node* rNode);
 	
-		/* Returns the first transform mat3 */
-		const mat3 getTransformation() const;
+		/* Returns the first transformation */
+		const affine2 getTransformation() const;
+
+		/* Returns the nth transformation */
+		const affine2 getTransformation(unsigned int n) const;
 
-		/* Returns the nth transform mat3 */
-		const mat3 getTransformation(unsigned int n) const;
+		/* Returns the nth transformation worked out from the keyframes */
+		/* without using the Frame cache, so it is safe to call from    */
+		/* several threads at once.                                     */
+		const affine2 evaluateTransformation(unsigned int n) const;
 	
 		/* Sets the first transform mat3 */
 		void setTransformation(mat3 scale, mat3 rotation, mat3 translation);
@@ -93,6 +126,19 @@ class Node
 		/* Returns a pointer to the parent Node */
 		Node* getParent();
 
+		/* Returns the structure revision of this Node, which changes */
+		/* whenever a Node is added to or removed from its subtree.   */
+		unsigned int getStructureRevision() const;
+
+		/* Returns the transform revision of this Node, which changes */
+		/* whenever this Node's own transformations change.           */
+		unsigned int getTransformRevision() const;
+
+		/* Returns the subtree transform revision of this Node, which  */
+		/* changes whenever the transformations of this Node or any    */
+		/* Node below it change.                                       */
+		unsigned int getSubtreeTransformRevision() const;
+
 		/** Methods for accessing the individual transformation values. **/
 		/* Default frameNum to 0. */
 		const float getScaleX() const;
@@ -109,38 +155,49 @@ class Node
 
 
 
-		/* Traverse the scene graph applying transforms and drawing geometry. */
-		/* Must give a Node and the accumalated transformation.               */
-		static void traverseSceneGraph(const Node& n, mat3 transformation);
+		/* Adds this Node's geometry, not its children, to the RenderBatch. */
+		/* Must give the accumalated transformation and the transformation */
+		/* "frame" number. Use a FlatSceneGraph for the whole scene graph. */
+		void appendTo(RenderBatch& batch, const affine2& transformation, 
+			unsigned int transformNum) const;
+
+		/* Returns the track of this Node's keyframes. */
+		const KeyframeTrack* getTrack() const;
 
-		/* Traverse the scene graph applying transforms and drawing geometry. */
-		/* Must give a Node, the accumalated transformation, and the          */
-		/* transformation "frame" number.                                     */
-		static void traverseSceneGraph(const Node& n, mat3 transformation, 
-			unsigned int transformNum);
+		/* Stores the given channel values as the keyframe at frameNum */
+		/* of this Node, replacing any keyframe already there.         */
+		void setKeyframe(unsigned int frameNum,
+			const float values[KeyframeTrack::NUM_CHANNELS]);
 
-		/* Copies the nth transform out to until the transforms vector equals */
-		/* the given size. Must send the index of the transform to be copied  */
-		/* and the new size of the transforms vector.                         */
+		/* Removes the keyframe at frameNum of this Node, if there is */
+		/* one. See KeyframeTrack::removeKeyframe.                    */
+		void removeKeyframe(unsigned int frameNum);
+
+		/* Replaces every keyframe of this Node, not its children, and */
+		/* its number of frames. See KeyframeTrack::setKeyframes.      */
+		void setKeyframes(unsigned int size, const unsigned int* times,
+			unsigned int count,
+			const float* const values[KeyframeTrack::NUM_CHANNELS]);
+
+		/* Expands the number of frames to the given size. The new frames */
+		/* hold the values of the last frame. Must send the index of the  */
+		/* last frame and the new number of frames.                       */
 		void expandTransforms(unsigned int frameNum, unsigned int size);
 
-		/* Shrinks the transforms vector down to the size given. Must send the */
-		/* new size of the transforms vector.                                  */
+		/* Shrinks the number of frames down to the size given. Must send */
+		/* the new number of frames.                                      */
 		void shrinkTransforms(unsigned int size);
 
-		/* Copies the nth transformation over till the end of the transforms */
-		/* vector. Must send the index of the starting transform (where to   */
-		/*start copying and where to copy from).                             */
-		void copyTransforms(unsigned int startIndex);
-
 		/* Makes the given transform a key frame and it children have the same */
 		/* keyframe.                                                           */
 		void makeKeyframe(unsigned int frameNum);
 
-		/* Interpolate frames between key frames. */
-		void linearlyInterpolate();
-		/* Reset interpolated frames between key frames. */
-		void unInterpolate();
+		/* Sets if the frames between key frames are linearly interpolated */
+		/* or hold the previous key frame (flip book). Frames are worked  */
+		/* out when asked for, so nothing is recomputed here.             */
+		static void setInterpolated(bool interpolated);
+		/* Returns if the frames between key frames are interpolated. */
+		static bool getInterpolated();
 
 };
 
@@ -0,0 +1,164 @@
+/*
+ * OfflineRenderer.cpp
+ * Created by Zachary Ferguson
+ * Source file for the OfflineRenderer class, a class for rendering the frames
+ * of an animation without a window on a pool of worker threads and writing
+ * them out in order.
+ */
+
+#include "OfflineRenderer.h"
+#include <thread>
+#include <algorithm> /* Included for min, max, and copy */
+#include "FlatSceneGraph.h"
+#include "RenderBatch.h"
+#include "SoftwareRasterizer.h"
+#include "DirtyRectTracker.h"
+
+/* Constructor for an OfflineRenderer that takes the root of the scene graph */
+/* and the size of the frames in pixels.                                     */
+OfflineRenderer::OfflineRenderer(const Node* root, unsigned int width,
+	unsigned int height)
+{
+	this->root = root;
+	this->width = width;
+	this->height = height;
+	this->numThreads = 0;
+	this->pipeline = NULL;
+}
+
+/* Destructor for the OfflineRenderer */
+OfflineRenderer::~OfflineRenderer()
+{
+	delete this->pipeline;
+}
+
+/* Sets the number of worker threads, 0 for one per core. The same number */
+/* of threads encode the frames.                                          */
+void OfflineRenderer::setNumThreads(unsigned int numThreads)
+{
+	this->numThreads = numThreads;
+}
+
+/* Renders the frames of the job, prepared for the open sink, and writes  */
+/* them to the sink. Returns once every frame is written, returning false */
+/* if a frame could not be written.                                       */
+bool OfflineRenderer::render(const RenderJob* job, FrameSink* sink)
+{
+	unsigned int threads = this->numThreads;
+	if (threads == 0)
+	{
+		threads = std::max(std::thread::hardware_concurrency(), 1u);
+	}
+
+	delete this->pipeline;
+	this->pipeline = new FramePipeline(sink, job, this->width, this->height,
+		threads);
+	this->job = job;
+	this->nextIndex = 0;
+	this->failed = false;
+	this->pixelsDrawn = 0.0;
+	this->pixelsTotal = 0.0;
+
+	/* The calling thread works as well */
+	std::vector<std::thread> workers;
+	for (unsigned int i = 1; i < threads; i++)
+	{
+		workers.push_back(std::thread(&OfflineRenderer::work, this));
+	}
+	this->work();
+	for (unsigned int i = 0; i < workers.size(); i++)
+	{
+		workers[i].join();
+	}
+
+	return this->pipeline->finish();
+}
+
+/* Renders frames and hands them to the pipeline until there are none left. */
+/* Run by every worker thread.                                              */
+void OfflineRenderer::work()
+{
+	/* Each worker has its own copy of everything that changes per frame. */
+	/* The scene graph itself is only read.                               */
+	FlatSceneGraph flatSceneGraph;
+	RenderBatch batch;
+	std::vector<unsigned int> firstVertices;
+	SoftwareRasterizer rasterizer(this->width, this->height);
+	DirtyRectTracker dirtyRects(this->width, this->height);
+	std::vector<unsigned char> pixels(3 * this->width * this->height);
+	double pixelsDrawn = 0.0, pixelsTotal = 0.0;
+	flatSceneGraph.sync(this->root);
+
+	unsigned int index = 0, turnEnd = 0;
+	while (true)
+	{
+		/* Take the next few frames in a row */
+		if (index == turnEnd)
+		{
+			std::lock_guard<std::mutex> lock(this->mutex);
+			if (this->failed || this->nextIndex >= this->job->size())
+			{
+				this->pixelsDrawn += pixelsDrawn;
+				this->pixelsTotal += pixelsTotal;
+				return;
+			}
+			index = this->nextIndex;
+			turnEnd = std::min(index + FRAMES_PER_WORKER_TURN,
+				this->job->size());
+			this->nextIndex = turnEnd;
+		}
+
+		bool submitted;
+		if (this->job->isRepeated(index))
+		{
+			submitted = this->pipeline->submitRepeat(index);
+		}
+		else
+		{
+			unsigned int frameNum = this->job->getFrameNum(index);
+			flatSceneGraph.evaluate(frameNum, affine2::identity());
+			batch.clear();
+			flatSceneGraph.appendTo(batch, frameNum, firstVertices);
+
+			/* The rasterizer still holds this worker's last frame, so */
+			/* only redraw the part that changed since                 */
+			SoftwareRasterizer::Rect dirty;
+			if (dirtyRects.update(flatSceneGraph, batch, firstVertices,
+				dirty))
+			{
+				rasterizer.clear(0.0f, 0.0f, 0.0f, dirty);
+				rasterizer.draw(batch, dirty);
+				pixelsDrawn += (double)(dirty.right - dirty.left) *
+					(dirty.top - dirty.bottom);
+			}
+			pixelsTotal += (double)(this->width) * this->height;
+
+			/* The rasterizer keeps drawing while the copy is encoded */
+			const unsigned char* framePixels = rasterizer.getPixels();
+			std::copy(framePixels, framePixels + pixels.size(),
+				pixels.begin());
+			submitted = this->pipeline->submit(index, pixels);
+		}
+		index++;
+
+		if (!submitted)
+		{
+			std::lock_guard<std::mutex> lock(this->mutex);
+			this->failed = true;
+			turnEnd = index;
+		}
+	}
+}
+
+/* Prints the throughput of the last render's stages and how much of each */
+/* frame was redrawn.                                                     */
+void OfflineRenderer::printStats(std::ostream& out) const
+{
+	if (this->pipeline != NULL)
+	{
+		this->pipeline->printStats(out);
+		out << "Redrew " << (int)(100 * this->pixelsDrawn /
+			std::max(this->pixelsTotal, 1.0)) <<
+			"% of the pixels of the rendered frames" << std::endl;
+	}
+}
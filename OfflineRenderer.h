@@ -0,0 +1,81 @@
+/*
+ * OfflineRenderer.h
+ * Created by Zachary Ferguson
+ * Header file for the OfflineRenderer class, a class for rendering the frames
+ * of an animation without a window on a pool of worker threads and writing
+ * them out in order.
+ */
+
+#ifndef OFFLINERENDERER_H
+#define OFFLINERENDERER_H
+
+/* Include necessary types */
+#include <mutex>
+#include <ostream>
+#include <vector>
+#include "Node.h"
+#include "FramePipeline.h"
+#include "RenderJob.h"
+
+/* Number of frames in a row each worker takes at a time. Consecutive */
+/* frames differ the least, so a worker redraws less of each one.     */
+#define FRAMES_PER_WORKER_TURN 4
+
+class OfflineRenderer
+{
+	private:
+
+		/* The root of the scene graph to render. It must not change */
+		/* while rendering.                                          */
+		const Node* root;
+
+		/* Size of the rendered frames in pixels. */
+		unsigned int width, height;
+
+		/* Number of worker threads, 0 for one per core. */
+		unsigned int numThreads;
+
+		/* Encodes and writes the rendered frames. */
+		FramePipeline* pipeline;
+
+		/* The frames being rendered. */
+		const RenderJob* job;
+
+		/** State shared by the workers, guarded by the mutex. **/
+		std::mutex mutex;
+		/* Index in the job of the next frame to hand out. */
+		unsigned int nextIndex;
+		/* If a frame could not be written. */
+		bool failed;
+		/* Pixels redrawn over every frame, and pixels in every frame. */
+		double pixelsDrawn, pixelsTotal;
+
+		/* Renders frames and hands them to the pipeline until there are */
+		/* none left. Run by every worker thread.                        */
+		void work();
+
+	public:
+
+		/* Constructor for an OfflineRenderer that takes the root of the */
+		/* scene graph and the size of the frames in pixels.             */
+		OfflineRenderer(const Node* root, unsigned int width,
+			unsigned int height);
+
+		/* Destructor for the OfflineRenderer */
+		virtual ~OfflineRenderer();
+
+		/* Sets the number of worker threads, 0 for one per core. The */
+		/* same number of threads encode the frames.                  */
+		void setNumThreads(unsigned int numThreads);
+
+		/* Renders the frames of the job, prepared for the open sink,  */
+		/* and writes them to the sink. Returns once every frame is    */
+		/* written, returning false if a frame could not be written.   */
+		bool render(const RenderJob* job, FrameSink* sink);
+
+		/* Prints the throughput of the last render's stages and how much */
+		/* of each frame was redrawn.                                     */
+		void printStats(std::ostream& out) const;
+};
+
+#endif
@@ -0,0 +1,40 @@
+/*
+ * PNGSequenceSink.cpp
+ * Created by Zachary Ferguson
+ * Source file for the PNGSequenceSink class, a FrameSink that writes every
+ * frame to its own numbered PNG file. Lossless, so flat shaded frames stay
+ * free of the ringing JPEG leaves around edges.
+ */
+
+#include "PNGSequenceSink.h"
+#include <sstream> /* Included for building the description */
+#include "FrameWriter.h"
+
+/* Constructor for a PNGSequenceSink that writes frame n to the file prefix */
+/* + n + ".png".                                                            */
+PNGSequenceSink::PNGSequenceSink(const std::string& filenamePrefix) :
+	ImageSequenceSink(filenamePrefix, ".png")
+{
+
+}
+
+/* Destructor for the PNGSequenceSink */
+PNGSequenceSink::~PNGSequenceSink()
+{
+
+}
+
+/* Encodes the frame as a PNG image. */
+void PNGSequenceSink::encode(const unsigned char* pixels, unsigned int width,
+	unsigned int height, std::vector<unsigned char>& bytes) const
+{
+	FrameWriter::encodePNG(pixels, width, height, bytes);
+}
+
+/* Returns the compression level of the frames. */
+std::string PNGSequenceSink::getDescription() const
+{
+	std::stringstream out;
+	out << "PNG frames, compression level " << PNG_COMPRESSION_LEVEL;
+	return out.str();
+}
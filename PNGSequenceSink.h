@@ -0,0 +1,35 @@
+/*
+ * PNGSequenceSink.h
+ * Created by Zachary Ferguson
+ * Header file for the PNGSequenceSink class, a FrameSink that writes every
+ * frame to its own numbered PNG file. Lossless, so flat shaded frames stay
+ * free of the ringing JPEG leaves around edges.
+ */
+
+#ifndef PNGSEQUENCESINK_H
+#define PNGSEQUENCESINK_H
+
+/* Include necessary types */
+#include <string>
+#include "ImageSequenceSink.h"
+
+class PNGSequenceSink : public ImageSequenceSink
+{
+	public:
+
+		/* Constructor for a PNGSequenceSink that writes frame n to the */
+		/* file prefix + n + ".png".                                    */
+		PNGSequenceSink(const std::string& filenamePrefix);
+
+		/* Destructor for the PNGSequenceSink */
+		virtual ~PNGSequenceSink();
+
+		/* Encodes the frame as a PNG image. */
+		virtual void encode(const unsigned char* pixels, unsigned int width,
+			unsigned int height, std::vector<unsigned char>& bytes) const;
+
+		/* Returns the compression level of the frames. */
+		virtual std::string getDescription() const;
+};
+
+#endif
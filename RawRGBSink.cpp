@@ -0,0 +1,49 @@
+/*
+ * RawRGBSink.cpp
+ * Created by Zachary Ferguson
+ * Source file for the RawRGBSink class, a StreamSink that writes the frames
+ * as raw 8-bit RGB images, one after another, starting with the top row.
+ */
+
+#include "RawRGBSink.h"
+#include <algorithm> /* Included for copy */
+
+/* Constructor for a RawRGBSink that writes to the file with the given name, */
+/* or to stdout if it is empty or "-".                                       */
+RawRGBSink::RawRGBSink(const std::string& path) : StreamSink(path)
+{
+
+}
+
+/* Destructor for the RawRGBSink */
+RawRGBSink::~RawRGBSink()
+{
+
+}
+
+/* Returns no header, a raw stream is only frames. */
+std::string RawRGBSink::header(unsigned int width, unsigned int height,
+	double framerate) const
+{
+	return std::string();
+}
+
+/* Copies the frame's rows in top down order. */
+void RawRGBSink::encode(const unsigned char* pixels, unsigned int width,
+	unsigned int height, std::vector<unsigned char>& bytes) const
+{
+	const unsigned int rowStride = 3 * width;
+	bytes.resize(rowStride * height);
+
+	const unsigned char* row = pixels + (height - 1) * rowStride;
+	for (unsigned int y = 0; y < height; y++, row -= rowStride)
+	{
+		std::copy(row, row + rowStride, bytes.begin() + y * rowStride);
+	}
+}
+
+/* Returns the kind of stream. */
+std::string RawRGBSink::getDescription() const
+{
+	return "Raw RGB stream";
+}
@@ -0,0 +1,39 @@
+/*
+ * RawRGBSink.h
+ * Created by Zachary Ferguson
+ * Header file for the RawRGBSink class, a StreamSink that writes the frames
+ * as raw 8-bit RGB images, one after another, starting with the top row.
+ */
+
+#ifndef RAWRGBSINK_H
+#define RAWRGBSINK_H
+
+/* Include necessary types */
+#include "StreamSink.h"
+
+class RawRGBSink : public StreamSink
+{
+	protected:
+
+		/* Returns no header, a raw stream is only frames. */
+		virtual std::string header(unsigned int width, unsigned int height,
+			double framerate) const;
+
+	public:
+
+		/* Constructor for a RawRGBSink that writes to the file with the */
+		/* given name, or to stdout if it is empty or "-".               */
+		RawRGBSink(const std::string& path);
+
+		/* Destructor for the RawRGBSink */
+		virtual ~RawRGBSink();
+
+		/* Copies the frame's rows in top down order. */
+		virtual void encode(const unsigned char* pixels, unsigned int width,
+			unsigned int height, std::vector<unsigned char>& bytes) const;
+
+		/* Returns the kind of stream. */
+		virtual std::string getDescription() const;
+};
+
+#endif
@@ -0,0 +1,165 @@
+/*
+ * RenderBatch.cpp
+ * Created by Zachary Ferguson
+ * Source file for the RenderBatch class, a class for collecting the
+ * transformed and colored vertices of a whole frame into one vertex buffer
+ * and one color buffer per primitive type, and the runs of primitives of one
+ * type in the order they were added, so each run can be drawn with a single
+ * draw call without changing what is drawn over what.
+ */
+
+#include "RenderBatch.h"
+
+/* Constructor for an empty RenderBatch. */
+RenderBatch::RenderBatch()
+{
+	this->clear();
+}
+
+/* Destructor for the RenderBatch */
+RenderBatch::~RenderBatch()
+{
+
+}
+
+/* Removes every vertex, keeping the memory for the next frame. */
+void RenderBatch::clear()
+{
+	for (int type = 0; type < NUM_PRIMITIVE_TYPES; type++)
+	{
+		this->numVertices[type] = 0;
+	}
+	this->runs.clear();
+}
+
+/* Adds count vertices of the given type and color. Returns the positions of */
+/* the new vertices, 2 * count floats to fill in.                            */
+float* RenderBatch::addVertices(PrimitiveType type, unsigned int count,
+	const float color[3])
+{
+	unsigned int first = this->numVertices[type];
+	this->numVertices[type] += count;
+
+	/* Vertices following ones of the same type are drawn in the same call */
+	if (!this->runs.empty() && this->runs.back().type == type)
+	{
+		this->runs.back().count += count;
+	}
+	else
+	{
+		Run run = { type, first, count };
+		this->runs.push_back(run);
+	}
+
+	/* The buffers and runs only ever grow, so after the first few frames */
+	/* nothing is allocated.                                              */
+	std::vector<float>& typePositions = this->positions[type];
+	std::vector<float>& typeColors = this->colors[type];
+	if (typePositions.size() < 2 * this->numVertices[type])
+	{
+		typePositions.resize(2 * this->numVertices[type]);
+		typeColors.resize(3 * this->numVertices[type]);
+	}
+
+	float* vertexColors = &typeColors[3 * first];
+	for (unsigned int i = 0; i < count; i++)
+	{
+		vertexColors[3 * i] = color[0];
+		vertexColors[3 * i + 1] = color[1];
+		vertexColors[3 * i + 2] = color[2];
+	}
+
+	return &typePositions[2 * first];
+}
+
+/* Returns space for count interleaved x, y positions, valid until the next */
+/* call.                                                                    */
+float* RenderBatch::getScratch(unsigned int count)
+{
+	/* Never empty, so there is always a first element to point to */
+	if (this->scratch.size() < 2 * count + 2)
+	{
+		this->scratch.resize(2 * count + 2);
+	}
+	return &(this->scratch[0]);
+}
+
+/* Adds the line segments between each pair of consecutive points. */
+void RenderBatch::addLineStrip(const float* points, unsigned int count,
+	const float color[3])
+{
+	if (count < 2)
+	{
+		return;
+	}
+
+	float* out = this->addVertices(LINES, 2 * (count - 1), color);
+	for (unsigned int i = 0; i + 1 < count; i++)
+	{
+		out[4 * i] = points[2 * i];
+		out[4 * i + 1] = points[2 * i + 1];
+		out[4 * i + 2] = points[2 * i + 2];
+		out[4 * i + 3] = points[2 * i + 3];
+	}
+}
+
+/* Adds the triangles of the convex polygon with the given points. */
+void RenderBatch::addTriangleFan(const float* points, unsigned int count,
+	const float color[3])
+{
+	if (count < 3)
+	{
+		return;
+	}
+
+	float* out = this->addVertices(TRIANGLES, 3 * (count - 2), color);
+	for (unsigned int i = 1; i + 1 < count; i++, out += 6)
+	{
+		out[0] = points[0];
+		out[1] = points[1];
+		out[2] = points[2 * i];
+		out[3] = points[2 * i + 1];
+		out[4] = points[2 * i + 2];
+		out[5] = points[2 * i + 3];
+	}
+}
+
+/* Adds the two triangles of each group of four points. */
+void RenderBatch::addQuads(const float* points, unsigned int count,
+	const float color[3])
+{
+	for (unsigned int i = 0; i + 4 <= count; i += 4)
+	{
+		this->addTriangleFan(points + 2 * i, 4, color);
+	}
+}
+
+/* Returns the number of vertices of the given type. */
+unsigned int RenderBatch::getNumVertices(PrimitiveType type) const
+{
+	return this->numVertices[type];
+}
+
+/* Returns the interleaved x, y positions of the given type. */
+const float* RenderBatch::getPositions(PrimitiveType type) const
+{
+	return this->positions[type].empty() ? NULL : &(this->positions[type][0]);
+}
+
+/* Returns the interleaved r, g, b colors of the given type. */
+const float* RenderBatch::getColors(PrimitiveType type) const
+{
+	return this->colors[type].empty() ? NULL : &(this->colors[type][0]);
+}
+
+/* Returns the number of runs of vertices of one type. */
+unsigned int RenderBatch::getNumRuns() const
+{
+	return (unsigned int)(this->runs.size());
+}
+
+/* Returns the run at the given index, in the order added. */
+const RenderBatch::Run& RenderBatch::getRun(unsigned int index) const
+{
+	return this->runs[index];
+}
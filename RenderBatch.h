@@ -0,0 +1,112 @@
+/*
+ * RenderBatch.h
+ * Created by Zachary Ferguson
+ * Header file for the RenderBatch class, a class for collecting the
+ * transformed and colored vertices of a whole frame into one vertex buffer
+ * and one color buffer per primitive type, and the runs of primitives of one
+ * type in the order they were added, so each run can be drawn with a single
+ * draw call without changing what is drawn over what.
+ */
+
+#ifndef RENDERBATCH_H
+#define RENDERBATCH_H
+
+/* Include necessary types */
+#include <vector>
+#include <stddef.h> /* Included for NULL */
+
+/* The visible area of the scene that is drawn. */
+#define VIEW_LEFT -10.0f
+#define VIEW_RIGHT 10.0f
+#define VIEW_BOTTOM -10.0f
+#define VIEW_TOP 10.0f
+
+class RenderBatch
+{
+	public:
+
+		/* The primitive types geometry is broken down into. */
+		enum PrimitiveType
+		{
+			LINES, TRIANGLES,
+			NUM_PRIMITIVE_TYPES
+		};
+
+		/* Consecutive vertices of one type added one after another, */
+		/* first being the index of the first vertex of that type.   */
+		struct Run
+		{
+			PrimitiveType type;
+			unsigned int first, count;
+		};
+
+	private:
+
+		/* Interleaved x, y positions of the vertices of each type. */
+		std::vector<float> positions[NUM_PRIMITIVE_TYPES];
+
+		/* Interleaved r, g, b colors of the vertices of each type. */
+		std::vector<float> colors[NUM_PRIMITIVE_TYPES];
+
+		/* Number of vertices of each type. */
+		unsigned int numVertices[NUM_PRIMITIVE_TYPES];
+
+		/* The runs of vertices in the order they were added. */
+		std::vector<Run> runs;
+
+		/* Space for transforming one geometry's vertices before they are */
+		/* broken down into primitives.                                   */
+		std::vector<float> scratch;
+
+	public:
+
+		/* Constructor for an empty RenderBatch. */
+		RenderBatch();
+
+		/* Destructor for the RenderBatch */
+		virtual ~RenderBatch();
+
+		/* Removes every vertex, keeping the memory for the next frame. */
+		void clear();
+
+		/* Adds count vertices of the given type and color. Returns the */
+		/* positions of the new vertices, 2 * count floats to fill in.  */
+		float* addVertices(PrimitiveType type, unsigned int count,
+			const float color[3]);
+
+		/* Returns space for count interleaved x, y positions, valid until */
+		/* the next call.                                                  */
+		float* getScratch(unsigned int count);
+
+		/** Methods for adding connected vertices given as interleaved x, **/
+		/** y positions, such as those returned by getScratch.            **/
+
+		/* Adds the line segments between each pair of consecutive points. */
+		void addLineStrip(const float* points, unsigned int count,
+			const float color[3]);
+
+		/* Adds the triangles of the convex polygon with the given points. */
+		void addTriangleFan(const float* points, unsigned int count,
+			const float color[3]);
+
+		/* Adds the two triangles of each group of four points. */
+		void addQuads(const float* points, unsigned int count,
+			const float color[3]);
+
+		/* Returns the number of vertices of the given type. */
+		unsigned int getNumVertices(PrimitiveType type) const;
+
+		/* Returns the interleaved x, y positions of the given type. */
+		const float* getPositions(PrimitiveType type) const;
+
+		/* Returns the interleaved r, g, b colors of the given type. */
+		const float* getColors(PrimitiveType type) const;
+
+		/* Returns the number of runs of vertices of one type. */
+		unsigned int getNumRuns() const;
+
+		/* Returns the run at the given index, in the order added. */
+		const Run& getRun(unsigned int index) const;
+};
+
+#endif
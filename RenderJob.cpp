@@ -0,0 +1,128 @@
+/*
+ * RenderJob.cpp
+ * Created by Zachary Ferguson
+ * Source file for the RenderJob class, the frames a render out has left to
+ * do. A job covers a range of frames with a stride, leaves out the frames a
+ * resumed render already finished, and marks the frames that draw the same as
+ * the one before them.
+ */
+
+#include "RenderJob.h"
+#include "FlatSceneGraph.h"
+
+/* Constructor for a RenderJob of every stride-th frame from first to last, */
+/* inclusive. A stride of 0 is taken as 1.                                  */
+RenderJob::RenderJob(unsigned int first, unsigned int last,
+	unsigned int stride)
+{
+	this->first = first;
+	this->last = last;
+	this->stride = (stride == 0) ? 1 : stride;
+	this->numFinished = 0;
+	this->manifest = NULL;
+}
+
+/* Destructor for the RenderJob, closes the manifest. */
+RenderJob::~RenderJob()
+{
+	delete this->manifest;
+}
+
+/* Finds the frames left to render of the scene graph to the open sink at */
+/* the given size in pixels. When the sink has a manifest, it is opened   */
+/* and the frames it shows are already written out, unchanged, are left   */
+/* out. Returns false if the manifest could not be opened.                */
+bool RenderJob::prepare(const Node* root, const FrameSink& sink,
+	unsigned int width, unsigned int height)
+{
+	this->frameNums.clear();
+	this->frameHashes.clear();
+	this->repeated.clear();
+	this->numFinished = 0;
+
+	FlatSceneGraph flatSceneGraph;
+	flatSceneGraph.sync(root);
+
+	/* The frame hashes only cover what changes from frame to frame, so */
+	/* the manifest also keys on the geometry and shape of the tree     */
+	delete this->manifest;
+	this->manifest = NULL;
+	std::string manifestPath = sink.getManifestPath();
+	if (!manifestPath.empty())
+	{
+		this->manifest = new RenderManifest(manifestPath,
+			flatSceneGraph.hashContent(), width, height,
+			sink.getDescription());
+		if (!(this->manifest->open()))
+		{
+			return false;
+		}
+	}
+
+	for (unsigned int frameNum = this->first; frameNum <= this->last;
+		frameNum += this->stride)
+	{
+		flatSceneGraph.evaluate(frameNum, affine2::identity());
+		unsigned long long hash = flatSceneGraph.hashEvaluated();
+		if (this->manifest != NULL &&
+			this->manifest->isFinished(frameNum, hash, sink))
+		{
+			this->numFinished++;
+		}
+		else
+		{
+			/* Frames that draw the same as the one before them, like the */
+			/* held frames between keyframes when not interpolating, are  */
+			/* written out again from the earlier frame's output.         */
+			this->repeated.push_back(!(this->frameHashes.empty()) &&
+				hash == this->frameHashes.back());
+			this->frameNums.push_back(frameNum);
+			this->frameHashes.push_back(hash);
+		}
+
+		/* Stop before the frame number wraps around */
+		if (this->last - frameNum < this->stride)
+		{
+			break;
+		}
+	}
+	return true;
+}
+
+/* Returns the number of frames left to render. */
+unsigned int RenderJob::size() const
+{
+	return (unsigned int)(this->frameNums.size());
+}
+
+/* Returns the frame number of the i-th frame left to render. */
+unsigned int RenderJob::getFrameNum(unsigned int i) const
+{
+	return this->frameNums[i];
+}
+
+/* Returns the hash of the scene graph at the i-th frame. */
+unsigned long long RenderJob::getFrameHash(unsigned int i) const
+{
+	return this->frameHashes[i];
+}
+
+/* Returns if the i-th frame draws the same as the one before it, so it is */
+/* repeated instead of rendered. Never true for the first frame left.      */
+bool RenderJob::isRepeated(unsigned int i) const
+{
+	return this->repeated[i];
+}
+
+/* Returns the number of frames in the range already finished. */
+unsigned int RenderJob::getNumFinished() const
+{
+	return this->numFinished;
+}
+
+/* Returns the manifest the written frames are recorded in, or NULL if */
+/* there is none.                                                      */
+RenderManifest* RenderJob::getManifest() const
+{
+	return this->manifest;
+}
@@ -0,0 +1,80 @@
+/*
+ * RenderJob.h
+ * Created by Zachary Ferguson
+ * Header file for the RenderJob class, the frames a render out has left to
+ * do. A job covers a range of frames with a stride, leaves out the frames a
+ * resumed render already finished, and marks the frames that draw the same as
+ * the one before them.
+ */
+
+#ifndef RENDERJOB_H
+#define RENDERJOB_H
+
+/* Include necessary types */
+#include <vector>
+#include "Node.h"
+#include "FrameSink.h"
+#include "RenderManifest.h"
+
+class RenderJob
+{
+	private:
+
+		/* The first and last frame of the range and the step between */
+		/* frames.                                                    */
+		unsigned int first, last, stride;
+
+		/* The frames left to render in order, the hash of the scene  */
+		/* graph evaluated at each, and if each draws the same as the */
+		/* frame before it in the job.                                */
+		std::vector<unsigned int> frameNums;
+		std::vector<unsigned long long> frameHashes;
+		std::vector<bool> repeated;
+
+		/* Number of frames in the range already finished. */
+		unsigned int numFinished;
+
+		/* Records the frames written out, NULL if the sink can not */
+		/* resume a render.                                         */
+		RenderManifest* manifest;
+
+	public:
+
+		/* Constructor for a RenderJob of every stride-th frame from first */
+		/* to last, inclusive. A stride of 0 is taken as 1.                */
+		RenderJob(unsigned int first, unsigned int last, unsigned int stride);
+
+		/* Destructor for the RenderJob, closes the manifest. */
+		virtual ~RenderJob();
+
+		/* Finds the frames left to render of the scene graph to the   */
+		/* open sink at the given size in pixels. When the sink has a  */
+		/* manifest, it is opened and the frames it shows are already  */
+		/* written out, unchanged, are left out. Returns false if the  */
+		/* manifest could not be opened.                               */
+		bool prepare(const Node* root, const FrameSink& sink,
+			unsigned int width, unsigned int height);
+
+		/* Returns the number of frames left to render. */
+		unsigned int size() const;
+
+		/* Returns the frame number of the i-th frame left to render. */
+		unsigned int getFrameNum(unsigned int i) const;
+
+		/* Returns the hash of the scene graph at the i-th frame. */
+		unsigned long long getFrameHash(unsigned int i) const;
+
+		/* Returns if the i-th frame draws the same as the one before */
+		/* it, so it is repeated instead of rendered. Never true for  */
+		/* the first frame left.                                      */
+		bool isRepeated(unsigned int i) const;
+
+		/* Returns the number of frames in the range already finished. */
+		unsigned int getNumFinished() const;
+
+		/* Returns the manifest the written frames are recorded in, or */
+		/* NULL if there is none.                                      */
+		RenderManifest* getManifest() const;
+};
+
+#endif
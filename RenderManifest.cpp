@@ -0,0 +1,202 @@
+/*
+ * RenderManifest.cpp
+ * Created by Zachary Ferguson
+ * Source file for the RenderManifest class, a record of the frames of a
+ * render that were written out along with their checksums, so an interrupted
+ * render can skip the frames already done and several processes can render
+ * parts of the same animation.
+ */
+
+/* Allows fopen, fopen_s is only available on Windows */
+#define _CRT_SECURE_NO_WARNINGS
+
+#include "RenderManifest.h"
+#include <cstdio>  /* Included for FILE, sprintf, and sscanf */
+#include <cstring> /* Included for strchr                    */
+#include <zlib/zlib.h>
+#if defined(_WIN32)
+	#include <windows.h> /* Included for CreateFile and WriteFile */
+#else
+	#include <fcntl.h>   /* Included for open                     */
+	#include <unistd.h>  /* Included for write and close          */
+#endif
+
+/* 64-bit FNV-1a, the same hash FlatSceneGraph uses for frames. */
+#define FNV_OFFSET_BASIS 14695981039346656037ULL
+#define FNV_PRIME 1099511628211ULL
+
+/* Longest line of the manifest. */
+#define MANIFEST_LINE_SIZE 128
+
+/* Opens the file at the path for appending, creating it if needed. Every */
+/* write goes to the end of the file in one piece, even with other        */
+/* processes appending to it. Returns -1 if it could not be opened.       */
+static intptr_t openAppending(const std::string& path)
+{
+#if defined(_WIN32)
+	/* Only a handle without FILE_WRITE_DATA appends atomically, the C */
+	/* runtime's append mode seeks to the end and then writes          */
+	return (intptr_t)CreateFileA(path.c_str(), FILE_APPEND_DATA,
+		FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL,
+		OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+#else
+	return open(path.c_str(), O_WRONLY | O_APPEND | O_CREAT, 0666);
+#endif
+}
+
+/* Appends the bytes to the file in one write. Returns if they were all */
+/* written.                                                             */
+static bool append(intptr_t file, const char* bytes, unsigned int count)
+{
+#if defined(_WIN32)
+	DWORD written;
+	return WriteFile((HANDLE)file, bytes, count, &written, NULL) &&
+		written == count;
+#else
+	return write((int)file, bytes, count) == (ssize_t)count;
+#endif
+}
+
+/* Closes the file opened by openAppending. */
+static void closeFile(intptr_t file)
+{
+#if defined(_WIN32)
+	CloseHandle((HANDLE)file);
+#else
+	close((int)file);
+#endif
+}
+
+/* Constructor for a RenderManifest kept in the file at the path for frames */
+/* of the scene with the given content hash, see                            */
+/* FlatSceneGraph::hashContent, of the given size in pixels written to a    */
+/* sink with the given description.                                         */
+RenderManifest::RenderManifest(const std::string& path,
+	unsigned long long sceneHash, unsigned int width, unsigned int height,
+	const std::string& description)
+{
+	this->path = path;
+	this->sceneHash = sceneHash;
+	this->width = width;
+	this->height = height;
+	this->description = description;
+	this->file = -1;
+}
+
+/* Destructor for the RenderManifest, closes the file. */
+RenderManifest::~RenderManifest()
+{
+	if (this->file != -1)
+	{
+		closeFile(this->file);
+	}
+}
+
+/* Returns the key of a frame, the hash of the scene graph evaluated at it */
+/* combined with the scene's content hash, the size, and the sink's        */
+/* description.                                                            */
+unsigned long long RenderManifest::makeKey(unsigned long long frameHash) const
+{
+	unsigned long long values[4] = {frameHash, this->sceneHash, this->width,
+		this->height};
+	unsigned long long hash = FNV_OFFSET_BASIS;
+	const unsigned char* bytes = (const unsigned char*)values;
+	for (unsigned int i = 0; i < sizeof(values); i++)
+	{
+		hash = (hash ^ bytes[i]) * FNV_PRIME;
+	}
+	for (unsigned int i = 0; i < this->description.size(); i++)
+	{
+		hash = (hash ^ (unsigned char)(this->description[i])) * FNV_PRIME;
+	}
+	return hash;
+}
+
+/* Reads the frames already in the file and opens it for appending,       */
+/* creating it if needed. Lines that can not be read, like one cut short  */
+/* by a crash, are ignored. Returns if the file was opened.               */
+bool RenderManifest::open()
+{
+	this->entries.clear();
+	bool endsInNewline = true;
+	FILE* infile = fopen(this->path.c_str(), "r");
+	if (infile)
+	{
+		/* Later lines replace earlier ones for the same frame */
+		char line[MANIFEST_LINE_SIZE];
+		while (fgets(line, sizeof(line), infile))
+		{
+			unsigned int frameNum;
+			Entry entry;
+			char end;
+			endsInNewline = strchr(line, '\n') != NULL;
+			if (sscanf(line, "%u %llx %lx %lu%c", &frameNum, &(entry.key),
+				&(entry.checksum), &(entry.size), &end) == 5 && end == '\n')
+			{
+				this->entries[frameNum] = entry;
+			}
+		}
+		fclose(infile);
+	}
+
+	if (this->file != -1)
+	{
+		closeFile(this->file);
+	}
+	this->file = openAppending(this->path);
+	if (this->file != -1 && !endsInNewline)
+	{
+		/* End the line cut short, so it stays apart from the next one */
+		append(this->file, "\n", 1);
+	}
+	return this->file != -1;
+}
+
+/* Returns if the given frame, with the given hash, is in the manifest and */
+/* the sink reads back the same bytes that were recorded. A frame rendered */
+/* from a different scene or with different settings, or whose output is   */
+/* missing or changed, is not finished.                                    */
+bool RenderManifest::isFinished(unsigned int frameNum,
+	unsigned long long frameHash, const FrameSink& sink) const
+{
+	std::map<unsigned int, Entry>::const_iterator found =
+		this->entries.find(frameNum);
+	if (found == this->entries.end() ||
+		found->second.key != this->makeKey(frameHash))
+	{
+		return false;
+	}
+	std::vector<unsigned char> bytes;
+	return sink.readFrame(frameNum, bytes) &&
+		bytes.size() == found->second.size &&
+		RenderManifest::checksum(bytes) == found->second.checksum;
+}
+
+/* Appends the frame with the given hash and encoded bytes to the file once */
+/* it is written out. Each line is appended in a single write that goes to  */
+/* the end of the file in one piece, so processes sharing the file do not   */
+/* mix their lines. Returns if the line was written.                        */
+bool RenderManifest::record(unsigned int frameNum,
+	unsigned long long frameHash, const std::vector<unsigned char>& bytes)
+{
+	if (this->file == -1)
+	{
+		return false;
+	}
+	char line[MANIFEST_LINE_SIZE];
+	int length = sprintf(line, "%u %016llx %08lx %lu\n", frameNum,
+		this->makeKey(frameHash), RenderManifest::checksum(bytes),
+		(unsigned long)(bytes.size()));
+	return append(this->file, line, length);
+}
+
+/* Returns the CRC-32 of the bytes. */
+unsigned long RenderManifest::checksum(const std::vector<unsigned char>& bytes)
+{
+	unsigned long crc = crc32(0L, Z_NULL, 0);
+	if (!bytes.empty())
+	{
+		crc = crc32(crc, &bytes[0], (uInt)(bytes.size()));
+	}
+	return crc;
+}
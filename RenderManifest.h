@@ -0,0 +1,94 @@
+/*
+ * RenderManifest.h
+ * Created by Zachary Ferguson
+ * Header file for the RenderManifest class, a record of the frames of a
+ * render that were written out along with their checksums, so an interrupted
+ * render can skip the frames already done and several processes can render
+ * parts of the same animation.
+ */
+
+#ifndef RENDERMANIFEST_H
+#define RENDERMANIFEST_H
+
+/* Include necessary types */
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+#include "FrameSink.h"
+
+class RenderManifest
+{
+	private:
+
+		/* A frame written out, keyed by what was rendered, with the */
+		/* checksum and size of its encoded bytes.                   */
+		struct Entry
+		{
+			unsigned long long key;
+			unsigned long checksum;
+			unsigned long size;
+		};
+
+		/* The manifest file, a line per frame written out. */
+		std::string path;
+
+		/* Hash of the scene's content, the size of the frames in   */
+		/* pixels, and the sink's description, which are part of    */
+		/* every key.                                               */
+		unsigned long long sceneHash;
+		unsigned int width, height;
+		std::string description;
+
+		/* The last entry in the file for each frame. */
+		std::map<unsigned int, Entry> entries;
+
+		/* The file opened for appending, a HANDLE on Windows and a file */
+		/* descriptor elsewhere, -1 if it is not open.                   */
+		intptr_t file;
+
+		/* Returns the key of a frame, the hash of the scene graph */
+		/* evaluated at it combined with the scene's content hash, */
+		/* the size, and the sink's description.                   */
+		unsigned long long makeKey(unsigned long long frameHash) const;
+
+	public:
+
+		/* Constructor for a RenderManifest kept in the file at the path */
+		/* for frames of the scene with the given content hash, see      */
+		/* FlatSceneGraph::hashContent, of the given size in pixels      */
+		/* written to a sink with the given description.                 */
+		RenderManifest(const std::string& path,
+			unsigned long long sceneHash, unsigned int width,
+			unsigned int height, const std::string& description);
+
+		/* Destructor for the RenderManifest, closes the file. */
+		virtual ~RenderManifest();
+
+		/* Reads the frames already in the file and opens it for         */
+		/* appending, creating it if needed. Lines that can not be read, */
+		/* like one cut short by a crash, are ignored. Returns if the    */
+		/* file was opened.                                              */
+		bool open();
+
+		/* Returns if the given frame, with the given hash, is in the    */
+		/* manifest and the sink reads back the same bytes that were     */
+		/* recorded. A frame rendered from a different scene or with     */
+		/* different settings, or whose output is missing or changed, is */
+		/* not finished.                                                 */
+		bool isFinished(unsigned int frameNum, unsigned long long frameHash,
+			const FrameSink& sink) const;
+
+		/* Appends the frame with the given hash and encoded bytes to the */
+		/* file once it is written out. Each line is appended in a single */
+		/* write that goes to the end of the file in one piece, so        */
+		/* processes sharing the file do not mix their lines. Returns if  */
+		/* the line was written.                                          */
+		bool record(unsigned int frameNum, unsigned long long frameHash,
+			const std::vector<unsigned char>& bytes);
+
+		/* Returns the CRC-32 of the bytes. */
+		static unsigned long checksum(const std::vector<unsigned char>& bytes);
+};
+
+#endif
@@ -0,0 +1,451 @@
+/*
+ * SceneFile.cpp
+ * Created by Zachary Ferguson
+ * Source file for the SceneFile class, a class for saving and loading scene
+ * graphs and their animation in a versioned binary file. The node hierarchy,
+ * the geometry's vertices and the keyframes are stored as flat, aligned
+ * arrays, so a file is memory mapped and read straight from the mapping
+ * without parsing each node. An open file builds its nodes on request, so a
+ * scene can be loaded a piece at a time.
+ */
+
+#include "SceneFile.h"
+#include <cstdio>  /* Included for remove */
+#include <cstring> /* Included for memcpy, memcmp and memset */
+#include "FlatSceneGraph.h"
+#include "FrameWriter.h"
+#include "triangle.h"
+#include "quad.h"
+
+/* Identifies a scene file, the first eight bytes of every one. */
+#define SCENE_FILE_MAGIC "ASGSCENE"
+
+/* Written as a word so a file saved on a machine of the other byte order */
+/* is recognized.                                                         */
+#define SCENE_FILE_BYTE_ORDER 0x01020304
+
+/* Every array in the file starts on a multiple of this many bytes. */
+#define SECTION_ALIGNMENT 16
+
+static_assert(sizeof(float) == 4 && sizeof(unsigned int) == 4,
+	"Scene files are written with 32-bit words");
+
+/* Returns the offset rounded up to the start of the next section. */
+static unsigned long long alignSection(unsigned long long offset)
+{
+	return (offset + SECTION_ALIGNMENT - 1) &
+		~(unsigned long long)(SECTION_ALIGNMENT - 1);
+}
+
+/* Saves the scene graph and its animation to the file at the given path, */
+/* replacing it. Returns if the file was saved.                           */
+bool SceneFile::save(const Node* root, const std::string& path)
+{
+	std::vector<unsigned char> bytes;
+	return SceneFile::serialize(root, bytes) &&
+		SceneFile::saveBytes(bytes, path);
+}
+
+/* Lays out the scene graph and its animation as the bytes of a scene file. */
+/* Returns false if the scene is too large for one.                         */
+bool SceneFile::serialize(const Node* root, std::vector<unsigned char>& bytes)
+{
+	if (root == NULL)
+	{
+		return false;
+	}
+
+	/* Lay the nodes out in preorder, parents before their children */
+	FlatSceneGraph flatSceneGraph;
+	flatSceneGraph.sync(root);
+	unsigned int numNodes = flatSceneGraph.size();
+	unsigned long long numVertices = 0, numKeyframes = 0;
+	for (unsigned int i = 0; i < numNodes; i++)
+	{
+		const Node* node = flatSceneGraph.getNode(i);
+		if (node->getGeometry() != NULL)
+		{
+			numVertices += node->getGeometry()->getVertices()->size();
+		}
+		numKeyframes += node->getTrack()->getNumKeyframes();
+	}
+
+	/* Place each array after the one before it */
+	Header header;
+	memset(&header, 0, sizeof(header));
+	unsigned long long nodesOffset = alignSection(sizeof(Header));
+	unsigned long long verticesOffset = alignSection(nodesOffset +
+		numNodes * (unsigned long long)sizeof(NodeRecord));
+	unsigned long long timesOffset = alignSection(verticesOffset +
+		numVertices * 3 * sizeof(float));
+	unsigned long long channelsOffset = alignSection(timesOffset +
+		numKeyframes * sizeof(unsigned int));
+	unsigned long long fileSize = alignSection(channelsOffset + numKeyframes *
+		KeyframeTrack::NUM_CHANNELS * sizeof(float));
+	if (fileSize > 0xFFFFFFFFULL)
+	{
+		return false;
+	}
+
+	memcpy(header.magic, SCENE_FILE_MAGIC, sizeof(header.magic));
+	header.byteOrder = SCENE_FILE_BYTE_ORDER;
+	header.version = SCENE_FILE_VERSION;
+	header.headerSize = sizeof(Header);
+	header.fileSize = (unsigned int)fileSize;
+	header.numNodes = numNodes;
+	header.numVertices = (unsigned int)numVertices;
+	header.numKeyframes = (unsigned int)numKeyframes;
+	header.nodesOffset = (unsigned int)nodesOffset;
+	header.verticesOffset = (unsigned int)verticesOffset;
+	header.timesOffset = (unsigned int)timesOffset;
+	header.channelsOffset = (unsigned int)channelsOffset;
+
+	bytes.assign((size_t)fileSize, 0);
+	memcpy(&bytes[0], &header, sizeof(header));
+	NodeRecord* records = (NodeRecord*)(&bytes[0] + header.nodesOffset);
+	float* vertices = (float*)(&bytes[0] + header.verticesOffset);
+	unsigned int* times = (unsigned int*)(&bytes[0] + header.timesOffset);
+	float* channels = (float*)(&bytes[0] + header.channelsOffset);
+
+	/* Copy each node's vertices and keyframes to the end of the arrays */
+	unsigned int vertexCount = 0, keyframeCount = 0;
+	for (unsigned int i = 0; i < numNodes; i++)
+	{
+		const Node* node = flatSceneGraph.getNode(i);
+		const polyline* geometry = node->getGeometry();
+		const KeyframeTrack* track = node->getTrack();
+		NodeRecord& record = records[i];
+
+		record.parent = flatSceneGraph.getParent(i);
+		record.geometryType = SCENE_NO_GEOMETRY;
+		record.firstVertex = vertexCount;
+		if (geometry != NULL)
+		{
+			record.geometryType = (int)(geometry->getType());
+			std::vector<float> color = geometry->getColor();
+			for (int c = 0; c < 3; c++)
+			{
+				record.color[c] = color[c];
+			}
+			const std::list<vec3>* nodeVertices = geometry->getVertices();
+			for (std::list<vec3>::const_iterator it = nodeVertices->begin();
+				it != nodeVertices->end(); ++it)
+			{
+				for (unsigned int j = 0; j < 3; j++)
+				{
+					vertices[3 * vertexCount + j] = (*it)[j];
+				}
+				vertexCount++;
+			}
+		}
+		record.numVertices = vertexCount - record.firstVertex;
+
+		record.firstKeyframe = keyframeCount;
+		record.numKeyframes = track->getNumKeyframes();
+		record.length = track->getLength();
+		const std::vector<unsigned int>& trackTimes =
+			track->getKeyframeTimes();
+		memcpy(times + keyframeCount, &trackTimes[0],
+			record.numKeyframes * sizeof(unsigned int));
+		for (int c = 0; c < KeyframeTrack::NUM_CHANNELS; c++)
+		{
+			const std::vector<float>& values =
+				track->getKeyframeValues((KeyframeTrack::Channel)c);
+			memcpy(channels + c * (size_t)(header.numKeyframes) +
+				keyframeCount, &values[0],
+				record.numKeyframes * sizeof(float));
+		}
+		keyframeCount += record.numKeyframes;
+	}
+	return true;
+}
+
+/* Writes the bytes of a scene file to the given path, replacing the file */
+/* only once the new one is whole. Returns if the file was written.       */
+bool SceneFile::saveBytes(const std::vector<unsigned char>& bytes,
+	const std::string& path)
+{
+	/* Write a new file and then put it in place, so a failed save leaves */
+	/* the old file as it was                                             */
+	std::string newPath = path + ".new";
+	if (!FrameWriter::writeFile(newPath, bytes) ||
+		!FrameWriter::replaceFile(newPath, path))
+	{
+		remove(newPath.c_str());
+		return false;
+	}
+	return true;
+}
+
+/* Returns if an array of count elements of the given size at offset fits */
+/* in a file of the given size.                                           */
+bool SceneFile::fits(size_t fileSize, unsigned int offset,
+	unsigned long long count, unsigned int elementSize)
+{
+	return offset % SECTION_ALIGNMENT == 0 && offset <= fileSize &&
+		count * elementSize <= fileSize - offset;
+}
+
+/* Constructor for a SceneFile with no file open. */
+SceneFile::SceneFile()
+{
+	memset(&(this->header), 0, sizeof(this->header));
+	this->records = NULL;
+	this->vertices = NULL;
+	this->times = NULL;
+	this->channels = NULL;
+}
+
+/* Destructor for the SceneFile, closes the file. */
+SceneFile::~SceneFile()
+{
+	this->close();
+}
+
+/* Returns if the records of the nodes are in preorder and consistent with */
+/* each other and the arrays of vertices and keyframes, working out the    */
+/* size of each subtree.                                                   */
+bool SceneFile::validate()
+{
+	const Header& header = this->header;
+
+	/* The nodes from the root to the last node checked */
+	std::vector<unsigned int> path;
+	for (unsigned int i = 0; i < header.numNodes; i++)
+	{
+		const NodeRecord& record = this->records[i];
+
+		/* Only the first node is the root, and each node's parent is */
+		/* the node before it or one of that node's ancestors         */
+		if (i == 0)
+		{
+			if (record.parent != -1)
+			{
+				return false;
+			}
+		}
+		else
+		{
+			while (!path.empty() && (int)(path.back()) != record.parent)
+			{
+				path.pop_back();
+			}
+			if (path.empty())
+			{
+				return false;
+			}
+		}
+		path.push_back(i);
+
+		/* The geometry must be one that can be made from its vertices */
+		if (record.geometryType < SCENE_NO_GEOMETRY ||
+			record.geometryType >= polyline::NUM_TYPES ||
+			(unsigned long long)(record.firstVertex) + record.numVertices >
+			header.numVertices ||
+			(record.geometryType == SCENE_NO_GEOMETRY &&
+			record.numVertices != 0) ||
+			(record.geometryType == polyline::TRIANGLE &&
+			record.numVertices != 3) ||
+			(record.geometryType == polyline::QUAD && record.numVertices != 4))
+		{
+			return false;
+		}
+
+		/* Every node covers the same frames as the root, no more than a */
+		/* track can, and its keyframes start at frame 0 and increase    */
+		/* within them                                                   */
+		if (record.numKeyframes == 0 || record.length == 0 ||
+			record.length > MAX_TRACK_LENGTH ||
+			record.length != this->records[0].length ||
+			(unsigned long long)(record.firstKeyframe) + record.numKeyframes >
+			header.numKeyframes)
+		{
+			return false;
+		}
+		const unsigned int* nodeTimes = this->times + record.firstKeyframe;
+		if (nodeTimes[0] != 0 ||
+			nodeTimes[record.numKeyframes - 1] >= record.length)
+		{
+			return false;
+		}
+		for (unsigned int k = 1; k < record.numKeyframes; k++)
+		{
+			if (nodeTimes[k] <= nodeTimes[k - 1])
+			{
+				return false;
+			}
+		}
+	}
+
+	/* Add the size of each subtree to its parent's, children first */
+	this->subtreeSizes.assign(header.numNodes, 1);
+	for (unsigned int i = header.numNodes - 1; i > 0; i--)
+	{
+		this->subtreeSizes[this->records[i].parent] += this->subtreeSizes[i];
+	}
+	return true;
+}
+
+/* Maps and checks the scene file at the given path. Returns if the file */
+/* could be read and is a scene file of a version that can be read.      */
+bool SceneFile::open(const std::string& path)
+{
+	this->close();
+	if (!(this->file.open(path)) || this->file.getSize() < sizeof(Header))
+	{
+		this->close();
+		return false;
+	}
+	const unsigned char* data = this->file.getData();
+	size_t size = this->file.getSize();
+
+	/* Check the header and that every array fits in the file */
+	Header& header = this->header;
+	memcpy(&header, data, sizeof(header));
+	if (memcmp(header.magic, SCENE_FILE_MAGIC, sizeof(header.magic)) != 0 ||
+		header.byteOrder != SCENE_FILE_BYTE_ORDER ||
+		header.version != SCENE_FILE_VERSION ||
+		header.headerSize != sizeof(Header) || header.fileSize != size ||
+		header.numNodes == 0 ||
+		!fits(size, header.nodesOffset, header.numNodes, sizeof(NodeRecord)) ||
+		!fits(size, header.verticesOffset, header.numVertices,
+		3 * sizeof(float)) ||
+		!fits(size, header.timesOffset, header.numKeyframes,
+		sizeof(unsigned int)) ||
+		!fits(size, header.channelsOffset, header.numKeyframes,
+		KeyframeTrack::NUM_CHANNELS * sizeof(float)))
+	{
+		this->close();
+		return false;
+	}
+	this->records = (const NodeRecord*)(data + header.nodesOffset);
+	this->vertices = (const float*)(data + header.verticesOffset);
+	this->times = (const unsigned int*)(data + header.timesOffset);
+	this->channels = (const float*)(data + header.channelsOffset);
+	if (!(this->validate()))
+	{
+		this->close();
+		return false;
+	}
+	return true;
+}
+
+/* Closes the file. */
+void SceneFile::close()
+{
+	this->file.close();
+	memset(&(this->header), 0, sizeof(this->header));
+	this->records = NULL;
+	this->vertices = NULL;
+	this->times = NULL;
+	this->channels = NULL;
+	std::vector<unsigned int>().swap(this->subtreeSizes);
+}
+
+/* Returns the number of nodes in the open file. */
+unsigned int SceneFile::getNumNodes() const
+{
+	return this->header.numNodes;
+}
+
+/* Returns the index of the parent of node i, -1 for the root. */
+int SceneFile::getParent(unsigned int i) const
+{
+	return this->records[i].parent;
+}
+
+/* Returns the number of nodes in the subtree of node i. */
+unsigned int SceneFile::getSubtreeSize(unsigned int i) const
+{
+	return this->subtreeSizes[i];
+}
+
+/* Builds a node with the given kind of geometry, or SCENE_NO_GEOMETRY,    */
+/* made from numVertices xyz triples in the given color, and the given     */
+/* keyframes over length frames. See KeyframeTrack::setKeyframes.          */
+Node* SceneFile::buildNode(int geometryType, const float* xyz,
+	unsigned int numVertices, const float color[3], unsigned int length,
+	const unsigned int* times, unsigned int numKeyframes,
+	const float* const values[KeyframeTrack::NUM_CHANNELS])
+{
+	polyline* geometry = NULL;
+	if (geometryType != SCENE_NO_GEOMETRY)
+	{
+		std::list<vec3>* vertices = new std::list<vec3>();
+		for (unsigned int v = 0; v < numVertices; v++)
+		{
+			vertices->push_back(vec3(xyz[3 * v], xyz[3 * v + 1],
+				xyz[3 * v + 2]));
+		}
+		switch (geometryType)
+		{
+			case polyline::POLYGON:
+				geometry = new polygon(vertices, 0, 0, 0);
+				break;
+			case polyline::TRIANGLE:
+				geometry = new triangle(vertices, 0, 0, 0);
+				break;
+			case polyline::QUAD:
+				geometry = new quad(vertices, 0, 0, 0);
+				break;
+			default:
+				geometry = new polyline(vertices, 0, 0, 0);
+				break;
+		}
+
+		/* The constructors take the color in a different order, setColor */
+		/* stores it as getColor returns it                               */
+		geometry->setColor(color[0], color[1], color[2]);
+	}
+	Node* node = new Node(mat3::identity(), mat3::identity(),
+		mat3::identity(), geometry);
+	node->setKeyframes(length, times, numKeyframes, values);
+	return node;
+}
+
+/* Builds node i with its geometry and keyframes but without its children. */
+Node* SceneFile::createNode(unsigned int i) const
+{
+	const NodeRecord& record = this->records[i];
+
+	/* Each channel's keyframes are read straight from the file */
+	const float* values[KeyframeTrack::NUM_CHANNELS];
+	for (int c = 0; c < KeyframeTrack::NUM_CHANNELS; c++)
+	{
+		values[c] = this->channels + c * (size_t)(this->header.numKeyframes) +
+			record.firstKeyframe;
+	}
+	return SceneFile::buildNode(record.geometryType,
+		this->vertices + 3 * (size_t)(record.firstVertex), record.numVertices,
+		record.color, record.length, this->times + record.firstKeyframe,
+		record.numKeyframes, values);
+}
+
+/* Builds node i and every node below it. */
+Node* SceneFile::createSubtree(unsigned int i) const
+{
+	/* Build the nodes in order, adding each to its parent */
+	std::vector<Node*> nodes(this->subtreeSizes[i]);
+	for (unsigned int j = 0; j < nodes.size(); j++)
+	{
+		nodes[j] = this->createNode(i + j);
+		if (j > 0)
+		{
+			nodes[this->records[i + j].parent - i]->addChild(nodes[j]);
+		}
+	}
+	return nodes[0];
+}
+
+/* Loads the scene graph saved in the file at the given path. Returns NULL */
+/* if the file could not be read or is not a scene file of a version that  */
+/* can be read.                                                            */
+Node* SceneFile::load(const std::string& path)
+{
+	SceneFile file;
+	if (!file.open(path))
+	{
+		return NULL;
+	}
+	return file.createSubtree(0);
+}
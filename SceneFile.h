@@ -0,0 +1,154 @@
+/*
+ * SceneFile.h
+ * Created by Zachary Ferguson
+ * Header file for the SceneFile class, a class for saving and loading scene
+ * graphs and their animation in a versioned binary file. The node hierarchy,
+ * the geometry's vertices and the keyframes are stored as flat, aligned
+ * arrays, so a file is memory mapped and read straight from the mapping
+ * without parsing each node. An open file builds its nodes on request, so a
+ * scene can be loaded a piece at a time.
+ */
+
+#ifndef SCENEFILE_H
+#define SCENEFILE_H
+
+/* Include necessary types */
+#include <string>
+#include <vector>
+#include "Node.h"
+#include "MappedFile.h"
+
+/* Version of the scene files written. */
+#define SCENE_FILE_VERSION 1
+
+/* Geometry type of a node without geometry. */
+#define SCENE_NO_GEOMETRY -1
+
+class SceneFile
+{
+	private:
+
+		/* Layout of the start of a scene file. Offsets are in bytes from */
+		/* the start of the file and are multiples of 16.                 */
+		struct Header
+		{
+			char magic[8];
+			unsigned int byteOrder;
+			unsigned int version;
+			unsigned int headerSize;
+			unsigned int fileSize;
+			unsigned int numNodes;
+			unsigned int numVertices;
+			unsigned int numKeyframes;
+			unsigned int reserved0;
+			unsigned int nodesOffset;
+			unsigned int verticesOffset;
+			unsigned int timesOffset;
+			unsigned int channelsOffset;
+			unsigned int reserved1[2];
+		};
+
+		/* Layout of each node in the array of nodes, in preorder so a     */
+		/* node's parent always comes before it. The node's vertices and   */
+		/* keyframes are ranges of the arrays of vertices and keyframes.   */
+		struct NodeRecord
+		{
+			int parent;
+			int geometryType;
+			unsigned int firstVertex;
+			unsigned int numVertices;
+			unsigned int firstKeyframe;
+			unsigned int numKeyframes;
+			unsigned int length;
+			float color[3];
+			unsigned int reserved[2];
+		};
+
+		/* The mapped file and its header. */
+		MappedFile file;
+		Header header;
+
+		/* The arrays of the open file. */
+		const NodeRecord* records;
+		const float* vertices;
+		const unsigned int* times;
+		const float* channels;
+
+		/* Number of nodes in the subtree of each node. The subtree of */
+		/* node i is nodes i to i + subtreeSizes[i] - 1.               */
+		std::vector<unsigned int> subtreeSizes;
+
+		/* Returns if an array of count elements of the given size at */
+		/* offset fits in a file of the given size.                   */
+		static bool fits(size_t fileSize, unsigned int offset,
+			unsigned long long count, unsigned int elementSize);
+
+		/* Returns if the records of the nodes are in preorder and      */
+		/* consistent with each other and the arrays of vertices and    */
+		/* keyframes, working out the size of each subtree.             */
+		bool validate();
+
+	public:
+
+		/* Constructor for a SceneFile with no file open. */
+		SceneFile();
+
+		/* Destructor for the SceneFile, closes the file. */
+		virtual ~SceneFile();
+
+		/* Maps and checks the scene file at the given path. Returns if */
+		/* the file could be read and is a scene file of a version that */
+		/* can be read.                                                 */
+		bool open(const std::string& path);
+
+		/* Closes the file. */
+		void close();
+
+		/* Returns the number of nodes in the open file. */
+		unsigned int getNumNodes() const;
+
+		/* Returns the index of the parent of node i, -1 for the root. */
+		int getParent(unsigned int i) const;
+
+		/* Returns the number of nodes in the subtree of node i. */
+		unsigned int getSubtreeSize(unsigned int i) const;
+
+		/* Builds node i with its geometry and keyframes but without its */
+		/* children.                                                     */
+		Node* createNode(unsigned int i) const;
+
+		/* Builds node i and every node below it. */
+		Node* createSubtree(unsigned int i) const;
+
+		/* Builds a node with the given kind of geometry, or           */
+		/* SCENE_NO_GEOMETRY, made from numVertices xyz triples in the */
+		/* given color, and the given keyframes over length frames.    */
+		/* See KeyframeTrack::setKeyframes.                            */
+		static Node* buildNode(int geometryType, const float* xyz,
+			unsigned int numVertices, const float color[3],
+			unsigned int length, const unsigned int* times,
+			unsigned int numKeyframes,
+			const float* const values[KeyframeTrack::NUM_CHANNELS]);
+
+		/* Lays out the scene graph and its animation as the bytes of a */
+		/* scene file. Returns false if the scene is too large for one. */
+		static bool serialize(const Node* root,
+			std::vector<unsigned char>& bytes);
+
+		/* Writes the bytes of a scene file to the given path, replacing */
+		/* the file only once the new one is whole. Returns if the file  */
+		/* was written.                                                  */
+		static bool saveBytes(const std::vector<unsigned char>& bytes,
+			const std::string& path);
+
+		/* Saves the scene graph and its animation to the file at the */
+		/* given path, replacing it. Returns if the file was saved.   */
+		static bool save(const Node* root, const std::string& path);
+
+		/* Loads the scene graph saved in the file at the given path.  */
+		/* Returns NULL if the file could not be read or is not a      */
+		/* scene file of a version that can be read.                   */
+		static Node* load(const std::string& path);
+};
+
+#endif
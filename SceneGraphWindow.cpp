@@ -13,7 +13,11 @@
 SceneGraphWindow::SceneGraphWindow(int x, int y, int w, int h, const char* c) : 
 	Fl_Window(x, y, w, h, c)
 {
-	this->sceneGraph = createAnimalSceneGraph();
+	this->sceneGraph = SceneLibrary::createAnimalSceneGraph();
+	this->loader = NULL;
+	this->nextLoadedPiece = 0;
+	this->journal = new EditJournal(AUTOSAVE_PATH);
+	this->history = new UndoHistory(UNDO_MEMORY_LIMIT);
 
 	/* Make the original GLWindow */
 	this->glWin = new GLWindow(210, 10, 400, 400, "GLWindow", sceneGraph);
@@ -44,6 +48,26 @@ SceneGraphWindow::SceneGraphWindow(int x, int y, int w, int h, const char* c) :
 	this->removeB->box(FL_PLASTIC_UP_BOX);
 	this->removeB->callback(SceneGraphWindow::removeCB, this);
 
+	/* Save the scene graph and its animation to a file */
+	this->saveB = new Fl_Button(465, h - 149, 70, 20, "Save");
+	this->saveB->box(FL_PLASTIC_UP_BOX);
+	this->saveB->callback(SceneGraphWindow::saveCB, this);
+
+	/* Open a saved scene graph */
+	this->openB = new Fl_Button(540, h - 149, 70, 20, "Open");
+	this->openB->box(FL_PLASTIC_UP_BOX);
+	this->openB->callback(SceneGraphWindow::openCB, this);
+
+	/* Undo and redo the edits to the scene graph */
+	this->undoB = new Fl_Button(315, h - 149, 70, 20, "Undo");
+	this->undoB->box(FL_PLASTIC_UP_BOX);
+	this->undoB->shortcut(FL_CTRL + 'z');
+	this->undoB->callback(SceneGraphWindow::undoCB, this);
+	this->redoB = new Fl_Button(390, h - 149, 70, 20, "Redo");
+	this->redoB->box(FL_PLASTIC_UP_BOX);
+	this->redoB->shortcut(FL_CTRL + 'y');
+	this->redoB->callback(SceneGraphWindow::redoCB, this);
+
 	/* Color Chooser */
 	this->colorChooser = new Fl_Color_Chooser(w-190, h-130, 170, 90, "Color");
 	this->colorChooser->rgb(1.0, 1.0, 1.0); /* Sets initial value */
@@ -72,6 +96,11 @@ SceneGraphWindow::SceneGraphWindow(int x, int y, int w, int h, const char* c) :
 /* Destructor for this SceneGraphWindow */
 SceneGraphWindow::~SceneGraphWindow()
 {
+	/* Stop opening a scene */
+	this->stopLoading();
+	delete this->journal;
+	delete this->history;
+
 	/* Remove all child widgets */
 	delete this->glWin;
 	delete this->sceneGraph;
@@ -81,6 +110,10 @@ SceneGraphWindow::~SceneGraphWindow()
 	delete this->resetB;
 	delete this->removeB;
 	delete this->addB;
+	delete this->saveB;
+	delete this->openB;
+	delete this->undoB;
+	delete this->redoB;
 	delete this->transformationG;
 	delete this->translateXSlider;
 	delete this->translateYSlider;
@@ -92,9 +125,22 @@ SceneGraphWindow::~SceneGraphWindow()
 	delete this->colorChooser;
 }
 
+/* Handles the events of the window. A press ends the open undo step, so a */
+/* new drag never joins the last one, whose release the widgets do not     */
+/* report.                                                                 */
+int SceneGraphWindow::handle(int event)
+{
+	if (event == FL_PUSH)
+	{
+		this->history->endStep();
+	}
+	return Fl_Window::handle(event);
+}
+
 /* Callback function for the exit button */
 void SceneGraphWindow::exitCB(Fl_Widget *w, void *data)
 {
+	((SceneGraphWindow*)data)->discardAutosave();
 	delete data;
 	exit(0);
 }
@@ -105,8 +151,10 @@ void SceneGraphWindow::resetCB(Fl_Widget *w, void *data)
 	SceneGraphWindow* sgWin = (SceneGraphWindow*)data;
 	
 	/* Creates the animal scene graph */
-	sgWin->sceneGraph = createAnimalSceneGraph();
+	sgWin->sceneGraph = SceneLibrary::createAnimalSceneGraph();
 	sgWin->activeNode = sgWin->sceneGraph;
+	sgWin->journal->reset();
+	sgWin->history->clear();
 
 	/* Deletes sgWin->sceneGraph too */
 	sgWin->glWin->setSceneGraph(sgWin->sceneGraph);
@@ -127,6 +175,408 @@ void SceneGraphWindow::resetCB(Fl_Widget *w, void *data)
 	std::cout << "Scene Graph Reset" << std::endl;
 }
 
+/* Callback function for the save scene button */
+void SceneGraphWindow::saveCB(Fl_Widget *w, void *data)
+{
+	SceneGraphWindow* sgWin = (SceneGraphWindow*)data;
+	const char* path = fl_file_chooser("Save Scene", "*.{asg,json}",
+		"scene.asg");
+	if (path == NULL)
+	{
+		return;
+	}
+
+	/* JSON scenes keep the tree labels too */
+	bool saved;
+	if (SceneJSON::isJSONPath(path))
+	{
+		saved = SceneJSON::save(sgWin->sceneGraph, sgWin->getTreeLabels(),
+			path);
+	}
+	else
+	{
+		saved = SceneFile::save(sgWin->sceneGraph, path);
+	}
+	if (saved)
+	{
+		std::cout << "Scene saved to " << path << std::endl;
+	}
+	else
+	{
+		std::cout << "Error saving the scene to " << path << std::endl;
+	}
+}
+
+/* Callback function for the open scene button */
+void SceneGraphWindow::openCB(Fl_Widget *w, void *data)
+{
+	SceneGraphWindow* sgWin = (SceneGraphWindow*)data;
+	const char* path = fl_file_chooser("Open Scene", "*.{asg,json}",
+		NULL);
+	if (path == NULL)
+	{
+		return;
+	}
+
+	/* Load the scene in the background, showing it as it loads */
+	sgWin->stopLoading();
+	sgWin->loader = new SceneLoader(path, SceneGraphWindow::loaderNotify,
+		sgWin);
+	sgWin->setLoading(true);
+	sgWin->loader->start();
+	std::cout << "Opening the scene " << path << std::endl;
+}
+
+/* Callback function for the undo button. */
+void SceneGraphWindow::undoCB(Fl_Widget *w, void *data)
+{
+	((SceneGraphWindow*)data)->stepHistory(false);
+}
+
+/* Callback function for the redo button. */
+void SceneGraphWindow::redoCB(Fl_Widget *w, void *data)
+{
+	((SceneGraphWindow*)data)->stepHistory(true);
+}
+
+/* Called on the loading thread when pieces are waiting. */
+void SceneGraphWindow::loaderNotify(void *data)
+{
+	Fl::awake(SceneGraphWindow::loaderCB, data);
+}
+
+/* Callback function for adding the pieces of a scene being opened. */
+void SceneGraphWindow::loaderCB(void *data)
+{
+	SceneGraphWindow* sgWin = (SceneGraphWindow*)data;
+	if (sgWin->loader == NULL)
+	{
+		return;
+	}
+
+	/* Add the pieces until this frame's time runs out */
+	bool more = sgWin->loader->takePieces(sgWin->loadedPieces);
+	sgWin->loader->takeLabels(sgWin->loadedLabels);
+	std::chrono::steady_clock::time_point start =
+		std::chrono::steady_clock::now();
+	while (sgWin->nextLoadedPiece < sgWin->loadedPieces.size() &&
+		std::chrono::duration<double>(std::chrono::steady_clock::now() -
+		start).count() < LOAD_FRAME_BUDGET)
+	{
+		sgWin->addLoadedPiece(sgWin->loadedPieces[sgWin->nextLoadedPiece++]);
+	}
+	sgWin->treeView->redraw();
+	sgWin->glWin->redraw();
+
+	/* Add the rest after the window is redrawn */
+	if (sgWin->nextLoadedPiece < sgWin->loadedPieces.size())
+	{
+		Fl::awake(SceneGraphWindow::loaderCB, data);
+		return;
+	}
+	sgWin->loadedPieces.clear();
+	sgWin->nextLoadedPiece = 0;
+
+	if (!more)
+	{
+		if (sgWin->loader->getFailed())
+		{
+			std::cout << "Error opening the scene " <<
+				sgWin->loader->getPath() << std::endl;
+			if (!(sgWin->loader->getError().empty()))
+			{
+				std::cout << sgWin->loader->getError() << std::endl;
+			}
+		}
+		else
+		{
+			std::cout << "Opened the scene " << sgWin->loader->getPath() <<
+				std::endl;
+		}
+		sgWin->stopLoading();
+	}
+}
+
+/* Callback function for merging the autosave's journal. */
+void SceneGraphWindow::autosaveCB(void *data)
+{
+	SceneGraphWindow* sgWin = (SceneGraphWindow*)data;
+
+	/* Wait for a scene being opened to finish */
+	if (sgWin->loader == NULL)
+	{
+		sgWin->journal->compact(sgWin->sceneGraph);
+	}
+	Fl::repeat_timeout(AUTOSAVE_INTERVAL, SceneGraphWindow::autosaveCB, data);
+}
+
+/* Offers to recover the autosave left if the editor did not close */
+/* normally, then starts autosaving the scene graph.               */
+void SceneGraphWindow::recoverAutosave()
+{
+	if (EditJournal::hasRecovery(AUTOSAVE_PATH) && fl_choice(
+		"The editor did not close normally. Recover the autosaved scene?",
+		"Discard", "Recover", NULL) == 1)
+	{
+		Node* recovered = EditJournal::recover(AUTOSAVE_PATH);
+		if (recovered != NULL)
+		{
+			this->setSceneGraph(recovered);
+			std::cout << "Recovered the autosaved scene" << std::endl;
+		}
+		else
+		{
+			std::cout << "Error recovering the autosaved scene" << std::endl;
+		}
+	}
+	this->journal->snapshot(this->sceneGraph);
+	Fl::add_timeout(AUTOSAVE_INTERVAL, SceneGraphWindow::autosaveCB, this);
+}
+
+/* Removes the autosave, once the editor closes normally. */
+void SceneGraphWindow::discardAutosave()
+{
+	Fl::remove_timeout(SceneGraphWindow::autosaveCB, this);
+	this->journal->discard();
+}
+
+/* Records the values of the given Node at the given frame in the autosave */
+/* after an edit to its transformation or color.                           */
+void SceneGraphWindow::recordEdit(const Node* node, unsigned int frameNum)
+{
+	/* A scene being opened is saved whole once it is open */
+	if (this->loader == NULL)
+	{
+		this->journal->recordKeyframe(this->sceneGraph, node, frameNum);
+	}
+}
+
+/* Records keying the scene graph at the given frame in the autosave. */
+void SceneGraphWindow::recordMakeKeyframe(unsigned int frameNum)
+{
+	if (this->loader == NULL)
+	{
+		this->journal->recordMakeKeyframe(this->sceneGraph,
+			this->sceneGraph, frameNum);
+	}
+}
+
+/* Records the values of the given Node at the given frame in the undo */
+/* history before the given widget edits them. Edits from one drag of  */
+/* the widget are undone together.                                     */
+void SceneGraphWindow::recordUndo(Node* node, unsigned int frameNum,
+	const Fl_Widget* source)
+{
+	/* A scene being opened can not be undone */
+	if (this->loader == NULL)
+	{
+		this->history->recordKeyframeEdit(node, frameNum, source);
+	}
+}
+
+/* Records the Nodes keyed when the given widget keys the scene graph at */
+/* the given frame in the undo history.                                  */
+void SceneGraphWindow::recordUndoMakeKeyframe(unsigned int frameNum,
+	const Fl_Widget* source)
+{
+	if (this->loader == NULL)
+	{
+		this->history->recordMakeKeyframe(this->sceneGraph, frameNum,
+			source);
+	}
+}
+
+/* Ends the undo step of the widget's edit unless the widget is still being */
+/* dragged.                                                                 */
+void SceneGraphWindow::endUndoStep()
+{
+	if (Fl::event() != FL_PUSH && Fl::event() != FL_DRAG)
+	{
+		this->history->endStep();
+	}
+}
+
+/* Undoes or redoes a step of the undo history, journaling the keyframes it */
+/* changes and rebuilding the tree view if it adds or removes a Node.       */
+void SceneGraphWindow::stepHistory(bool redo)
+{
+	if (this->loader != NULL || this->sceneGraph == NULL)
+	{
+		return;
+	}
+
+	std::vector<UndoHistory::ChangedKeyframe> changed;
+	std::map<const Node*, std::string> labels = this->getTreeLabels();
+	unsigned int structureRevision = this->sceneGraph->getStructureRevision();
+	if (!(redo ? this->history->redo(changed, labels) :
+		this->history->undo(changed, labels)))
+	{
+		return;
+	}
+
+	/* Journal the keyframes changed, unless there are so many that a new */
+	/* snapshot is smaller                                                */
+	if (changed.size() >= JOURNAL_COMPACT_RECORDS)
+	{
+		this->journal->snapshot(this->sceneGraph);
+	}
+	else
+	{
+		for (unsigned int i = 0; i < changed.size(); i++)
+		{
+			if (changed[i].node->getTrack()->getIsKeyframe(
+				changed[i].frameNum))
+			{
+				this->recordEdit(changed[i].node, changed[i].frameNum);
+			}
+			else
+			{
+				this->journal->recordRemoveKeyframe(this->sceneGraph,
+					changed[i].node, changed[i].frameNum);
+			}
+		}
+	}
+
+	/* Rebuild the tree view with the labels the step kept, keeping the */
+	/* active Node selected if it is still in the scene graph           */
+	if (this->sceneGraph->getStructureRevision() != structureRevision)
+	{
+		this->loadedLabels.swap(labels);
+		this->treeView->clear_children(this->treeView->root());
+		this->activeItem = this->addSubtreeToTree(this->treeView->root(),
+			this->sceneGraph);
+		this->loadedLabels.clear();
+		Node* activeNode = this->sceneGraph;
+		for (Fl_Tree_Item* item = this->treeView->first(); item != NULL;
+			item = this->treeView->next(item))
+		{
+			if (item->user_data() == this->activeNode)
+			{
+				this->activeItem = item;
+				activeNode = this->activeNode;
+				break;
+			}
+		}
+		this->activeNode = activeNode;
+		this->activeItem->select(1);
+		this->treeView->redraw();
+	}
+
+	this->setActiveNodeWidgets();
+	this->glWin->redraw();
+	this->redraw();
+	std::cout << (redo ? "Redo" : "Undo") << std::endl;
+}
+
+/* Adds a piece of the scene being opened to the scene graph and the tree */
+/* view.                                                                  */
+void SceneGraphWindow::addLoadedPiece(const SceneLoader::Piece& piece)
+{
+	Fl_Tree_Item* item;
+	if (piece.parent < 0)
+	{
+		/* The root replaces the scene graph */
+		this->setSceneGraph(piece.subtree);
+		item = this->activeItem;
+	}
+	else
+	{
+		/* Match the number of frames of the scene graph */
+		unsigned int size = this->sceneGraph->getTrack()->getLength();
+		unsigned int pieceSize = piece.subtree->getTrack()->getLength();
+		if (pieceSize < size)
+		{
+			piece.subtree->expandTransforms(pieceSize - 1, size);
+		}
+		else if (pieceSize > size)
+		{
+			piece.subtree->shrinkTransforms(size);
+		}
+
+		/* The parent's piece was always added before this one */
+		Fl_Tree_Item* parentItem = this->loadedItems[piece.parent];
+		((Node*)(parentItem->user_data()))->addChild(piece.subtree);
+		item = this->addSubtreeToTree(parentItem, piece.subtree);
+	}
+
+	if (piece.index >= this->loadedItems.size())
+	{
+		this->loadedItems.resize(piece.index + 1, NULL);
+	}
+	this->loadedItems[piece.index] = item;
+}
+
+/* Stops opening a scene, deleting the pieces not yet added. */
+void SceneGraphWindow::stopLoading()
+{
+	if (this->loader == NULL)
+	{
+		return;
+	}
+	delete this->loader;
+	this->loader = NULL;
+	for (unsigned int i = this->nextLoadedPiece;
+		i < this->loadedPieces.size(); i++)
+	{
+		delete this->loadedPieces[i].subtree;
+	}
+	this->loadedPieces.clear();
+	this->nextLoadedPiece = 0;
+	std::vector<Fl_Tree_Item*>().swap(this->loadedItems);
+	this->loadedLabels.clear();
+	this->setLoading(false);
+}
+
+/* Turns the widgets that change the structure of the scene graph off while */
+/* a scene is being opened, and back on after.                              */
+void SceneGraphWindow::setLoading(bool loading)
+{
+	Fl_Widget* widgets[] = {this->addB, this->removeB, this->resetB,
+		this->saveB, this->undoB, this->redoB};
+	for (unsigned int i = 0; i < sizeof(widgets) / sizeof(widgets[0]); i++)
+	{
+		if (loading)
+		{
+			widgets[i]->deactivate();
+		}
+		else
+		{
+			widgets[i]->activate();
+		}
+	}
+}
+
+/* Replaces the scene graph with the given one, deleting the old one, and */
+/* resets the widgets to its root.                                        */
+void SceneGraphWindow::setSceneGraph(Node* newSceneGraph)
+{
+	this->sceneGraph = newSceneGraph;
+	this->journal->reset();
+	this->history->clear();
+
+	/* Deletes the old scene graph too */
+	this->glWin->setSceneGraph(this->sceneGraph);
+
+	/* Rebuild the tree view, naming the nodes after their geometry */
+	this->treeView->clear_children(this->treeView->root());
+	this->activeItem = this->addSubtreeToTree(this->treeView->root(),
+		this->sceneGraph);
+	this->activeItem->select(1);
+	this->activeNode = this->sceneGraph;
+
+	/* Set the transformation widget values */
+	this->transformationG->activate();
+	this->colorChooser->activate();
+	this->itemNameInput->activate();
+	this->setTransformationG();
+	this->setColorChooser();
+	this->setItemNameInput();
+	
+	this->glWin->redraw();
+
+	this->redraw();
+}
+
 /* Callback function for the color chooser */
 void SceneGraphWindow::colorCB(Fl_Widget *w, void *data)
 {
@@ -134,8 +584,11 @@ void SceneGraphWindow::colorCB(Fl_Widget *w, void *data)
 	Fl_Color_Chooser* color = (Fl_Color_Chooser*)w;
 	if(sgWin->activeNode != NULL)
 	{
+		sgWin->recordUndo(sgWin->activeNode, 0, w);
 		sgWin->activeNode->setGeometryColor((float)(color->r()), 
 			(float)(color->g()), (float)(color->b()));
+		sgWin->recordEdit(sgWin->activeNode, 0);
+		sgWin->endUndoStep();
 	}
 	sgWin->glWin->redraw();
 }
@@ -155,6 +608,13 @@ void SceneGraphWindow::removeCB(Fl_Widget *w, void *data)
 		/* Make sure the parent item ans node is not NULL */
 		if(parentItem != NULL)
 		{
+			/* Keep the removed Node to undo its removal */
+			if (parentNode != NULL)
+			{
+				std::map<const Node*, std::string> labels =
+					sgWin->getTreeLabels();
+				sgWin->history->recordRemoveChild(sgWin->activeNode, labels);
+			}
 			sgWin->treeView->remove(sgWin->activeItem);
 			sgWin->activeItem = parentItem;
 			/* If the parent Node is not NULL */
@@ -171,6 +631,7 @@ void SceneGraphWindow::removeCB(Fl_Widget *w, void *data)
 			/* Else if only the parent item is not NULL */
 			else
 			{
+				sgWin->history->clear();
 				sgWin->glWin->setSceneGraph(NULL);
 				sgWin->activeNode = NULL;
 				sgWin->sceneGraph = NULL;
@@ -339,10 +800,12 @@ void SceneGraphWindow::addNode(Node* n, const char* label)
 		/* Add the new node as a child of the active node */
 		this->activeNode->addChild(n);
 		this->activeNode = n;
+		this->history->recordAddChild(n);
 	}
 	else
 	{
 		/* Create a new scene graph with the new node as the root */
+		this->history->clear();
 		this->sceneGraph = n;
 		this->glWin->setSceneGraph(this->sceneGraph);
 		this->activeNode = this->sceneGraph;
@@ -482,7 +945,10 @@ void SceneGraphWindow::transformCB(Fl_Widget *w, void *data)
 		(float)(sgWin->translateXSlider->value()), 
 		(float)(sgWin->translateYSlider->value()));
 	
+	sgWin->recordUndo(sgWin->activeNode, 0, w);
 	sgWin->activeNode->setTransformation(scale, rotate, translate);
+	sgWin->recordEdit(sgWin->activeNode, 0);
+	sgWin->endUndoStep();
 
 	sgWin->glWin->redraw();
 }
@@ -549,6 +1015,55 @@ void SceneGraphWindow::addChildrenToTree()
 	temp->user_data(*it++);
 }
 
+/* Adds the given Node and its children to the tree view under the given */
+/* item, labeled by their geometry unless the scene being opened labels  */
+/* them. Returns the Node's item.                                        */
+Fl_Tree_Item* SceneGraphWindow::addSubtreeToTree(Fl_Tree_Item* parentItem,
+	Node* node)
+{
+	const char* label = "Transform";
+	std::map<const Node*, std::string>::const_iterator loadedLabel =
+		this->loadedLabels.find(node);
+	if(loadedLabel != this->loadedLabels.end())
+	{
+		label = loadedLabel->second.c_str();
+	}
+	else if(node->getGeometry() != NULL)
+	{
+		switch(node->getGeometry()->getType())
+		{
+			case polyline::POLYGON: label = "Polygon"; break;
+			case polyline::TRIANGLE: label = "Triangle"; break;
+			case polyline::QUAD: label = "Quadrilateral"; break;
+			default: label = "Polyline"; break;
+		}
+	}
+	Fl_Tree_Item* item = this->treeView->add(parentItem, label);
+	item->user_data(node);
+
+	for(std::list<Node*>::const_iterator it = node->getChildren()->cbegin();
+		it != node->getChildren()->cend(); ++it)
+	{
+		this->addSubtreeToTree(item, *it);
+	}
+	return item;
+}
+
+/* Returns the tree label of every Node in the tree view. */
+std::map<const Node*, std::string> SceneGraphWindow::getTreeLabels() const
+{
+	std::map<const Node*, std::string> labels;
+	for(Fl_Tree_Item* item = this->treeView->first(); item != NULL;
+		item = this->treeView->next(item))
+	{
+		if(item->user_data() != NULL && item->label() != NULL)
+		{
+			labels[(const Node*)(item->user_data())] = item->label();
+		}
+	}
+	return labels;
+}
+
 /* Callback function for the tree view of the scene graph */
 void SceneGraphWindow::treeCB(Fl_Widget *w, void *data)
 {
@@ -604,6 +1119,15 @@ void SceneGraphWindow::setColorChooser()
 	}
 }
 
+/* Sets the transformation, color, and rename widgets to the active Node's */
+/* values after an undo or redo.                                           */
+void SceneGraphWindow::setActiveNodeWidgets()
+{
+	this->setTransformationG();
+	this->setColorChooser();
+	this->setItemNameInput();
+}
+
 /* Sets the value of the rename item input to the */
 /* active item's label.                           */
 void SceneGraphWindow::setItemNameInput()
@@ -611,175 +1135,3 @@ void SceneGraphWindow::setItemNameInput()
 	this->itemNameInput->activate();
 	this->itemNameInput->value(this->activeItem->label());
 }
-
-/* Creates a scene graph of a kitten */
-Node* SceneGraphWindow::createAnimalSceneGraph()
-{
-	/********************/
-	/********BODY********/
-	/********************/
-
-	std::list<vec3> *bVertices = new std::list<vec3>();
-	bVertices->push_back(vec3(   1,    0, 1));
-	bVertices->push_back(vec3( 0.5,   -1, 1));
-	bVertices->push_back(vec3(-0.5,   -1, 1));
-	bVertices->push_back(vec3(  -1,    0, 1));
-	bVertices->push_back(vec3(-0.5, 0.25, 1));
-	bVertices->push_back(vec3( 0.5, 0.25, 1));
-
-	polygon* body = new polygon(bVertices, 1, 0, 0.647f);
-	/* Root Scale */
-	mat3 bScale = mat3::scale2D(2, 1.65f);
-	/* Root Rotation */
-	mat3 bRotation = mat3::rotation2D(30);
-	/* Root Translate */
-	mat3 bTranslate = mat3::translation2D(-1, 4);
-	Node* root = new Node(bScale, bRotation,
-						  bTranslate, body);
-
-	/********************/
-	/********HEAD********/
-	/********************/
-	std::list<vec3> *hVertices = new std::list<vec3>();
-	hVertices->push_back(vec3(0.5, 0, 1));
-	hVertices->push_back(vec3(  0, 0, 1));
-	hVertices->push_back(vec3(  0, 1, 1));
-
-	triangle* head = new triangle(hVertices, 1.0, 0.0, 1.0);
-
-	/* Head Scale */
-	mat3 hScale = mat3::scale2D(2, .75);
-	/* Head Rotation */
-	mat3 hRotation = mat3::rotation2D(-15);
-	/* Head Translate */
-	mat3 hTranslate = mat3::translation2D(1, 0);
-	Node* hNode = new Node(hScale, hRotation,
-						   hTranslate, head);
-
-
-	/***************************/
-	/********UPPER LIMBS********/
-	/***************************/
-	std::list<vec3>* upperLimb = new std::list<vec3>();
-	upperLimb->push_back(vec3( 0.25,  0, 1));
-	upperLimb->push_back(vec3( 0.25, -1, 1));
-	upperLimb->push_back(vec3(-0.25, -1, 1));
-	upperLimb->push_back(vec3(-0.25,  0, 1));
-
-	/*** Limb 1 Upper ***/
-	quad* limb1upper = new quad(upperLimb, 1.0, 0.0, 0.0);
-	mat3 limb1upperScale = mat3::scale2D(.5, 1);
-	/* Limb 1 Upper Rotation */
-	mat3 limb1upperRotate = mat3::rotation2D(60);
-	mat3 limb1upperTranslate = mat3::translation2D(0.75, -0.5);
-	Node* frontOutterLeg = new Node(limb1upperScale, limb1upperRotate,
-									limb1upperTranslate, limb1upper);
-
-	/*** Limb 2 Upper ***/
-	quad* limb2upper = new quad(upperLimb, 1.0, 0.0, 0.0);
-	mat3 limb2upperScale = mat3::scale2D(.5, 1);
-	/* Limb 2 Upper Rotation */
-	mat3 limb2upperRotate = mat3::rotation2D(-60);
-	mat3 limb2upperTranslate = mat3::translation2D(-0.75, -0.5);
-	Node* backOutterLeg = new Node(limb2upperScale, limb2upperRotate,
-								   limb2upperTranslate, limb2upper);
-
-	/*** Limb 3 Upper ***/
-	quad* limb3upper = new quad(upperLimb, 0.0, 0.0, 1.0);
-	mat3 limb3upperScale = mat3::scale2D(.5, 1);
-	/* Limb 3 Upper Rotation */
-	mat3 limb3upperRotate = mat3::rotation2D(45);
-	mat3 limb3upperTranslate = mat3::translation2D(0.625, -0.625);
-	Node* frontInnerLeg = new Node(limb3upperScale, limb3upperRotate,
-								   limb3upperTranslate, limb3upper);
-
-	/*** Limb 4 Upper ***/
-	quad* limb4upper = new quad(upperLimb, 0.0, 0.0, 1.0);
-	mat3 limb4upperScale = mat3::scale2D(.5, 1);
-	/* Limb 4 Upper Rotation */
-	mat3 limb4upperRotate = mat3::rotation2D(-45);
-	mat3 limb4upperTranslate = mat3::translation2D(-0.625, -0.625);
-	Node* backInnerLeg = new Node(limb4upperScale, limb4upperRotate,
-								  limb4upperTranslate, limb4upper);
-
-
-	/***************************/
-	/********LOWER LIMBS********/
-	/***************************/
-	std::list<vec3>* lowerLimb = new std::list<vec3>();
-	lowerLimb->push_back(vec3( 0.25,    0, 1));
-	lowerLimb->push_back(vec3( 0.25, -0.5, 1));
-	lowerLimb->push_back(vec3(-0.25, -0.5, 1));
-	lowerLimb->push_back(vec3(-0.25,    0, 1));
-
-	/*** Limb 1 Lower ***/
-	quad* limb1lower = new quad(lowerLimb, 1.0, 1.0, 0.0);
-	mat3 limb1lowerScale = mat3::scale2D(.5, 1.5);
-	/* Limb 1 Lower Rotation */
-	mat3 limb1lowerRotate = mat3::rotation2D(60);
-	mat3 limb1lowerTranslate = mat3::translation2D(0, -1);
-	Node* frontOutterFoot = new Node(limb1lowerScale, limb1lowerRotate,
-									 limb1lowerTranslate, limb1lower);
-	(*frontOutterLeg).addChild(frontOutterFoot);
-
-	/*** Limb 2 Lower ***/
-	quad* limb2lower = new quad(lowerLimb, 1.0, 1.0, 0.0);
-	mat3 limb2lowerScale = mat3::scale2D(.5, 2);
-	/* Limb 2 Lower Rotation */
-	mat3 limb2lowerRotate = mat3::rotation2D(90);
-	mat3 limb2lowerTranslate = mat3::translation2D(0, -1);
-	Node* backOutterFoot = new Node(limb2lowerScale, limb2lowerRotate,
-									limb2lowerTranslate, limb2lower);
-	(*backOutterLeg).addChild(backOutterFoot);
-
-	/*** Limb 3 Lower ***/
-	quad* limb3lower = new quad(lowerLimb, 0.0, 1.0, 1.0);
-	mat3 limb3lowerScale = mat3::scale2D(.5, 1.5);
-	/* Limb 3 Lower Rotation */
-	mat3 limb3lowerRotate = mat3::rotation2D(60);
-	mat3 limb3lowerTranslate = mat3::translation2D(0, -1);
-	Node* frontInnerFoot = new Node(limb3lowerScale, limb3lowerRotate,
-									limb3lowerTranslate, limb3lower);
-	(*frontInnerLeg).addChild(frontInnerFoot);
-
-	/*** Limb 4 Lower ***/
-	quad* limb4lower = new quad(lowerLimb, 0.0, 1.0, 1.0);
-	mat3 limb4lowerScale = mat3::scale2D(.5, 2);
-	/* Limb 4 Lower Rotation */
-	mat3 limb4lowerRotate = mat3::rotation2D(90);
-	mat3 limb4lowerTranslate = mat3::translation2D(0, -1);
-	Node* backInnerFoot = new Node(limb4lowerScale, limb4lowerRotate,
-								   limb4lowerTranslate, limb4lower);
-	(*backInnerLeg).addChild(backInnerFoot);
-
-	/********************/
-	/********TAIL********/
-	/********************/
-
-	std::list<vec3>* tVertices = new std::list<vec3>();
-	tVertices->push_back(vec3(   0,   0, 1));
-	tVertices->push_back(vec3(-0.5,   0, 1));
-	tVertices->push_back(vec3(-0.5, 0.5, 1));
-	tVertices->push_back(vec3(  -1, 0.5, 1));
-
-	polyline* tail = new polyline(tVertices, 0.647f, 0.1647f, 0.1647f);
-
-	/* Tail Scale */
-	mat3 tScale = mat3::scale2D(1, 1);
-	/* Tail Rotation */
-	mat3 tRotation = mat3::rotation2D(-30);
-	/* Tail Translate */
-	mat3 tTranslate = mat3::translation2D(-1, 0);
-	Node* tNode = new Node(tScale, tRotation,
-						   tTranslate, tail);
-
-	/* Add parts to the body */
-	(*root).addChild(hNode);
-	(*root).addChild(frontInnerLeg);
-	(*root).addChild(frontOutterLeg);
-	(*root).addChild(backInnerLeg);
-	(*root).addChild(backOutterLeg);
-	(*root).addChild(tNode);
-
-	return root;
-}
\ No newline at end of file
@@ -10,6 +10,10 @@
 #define SCENEGRAPHWINDOW_H
 
 #include <iostream>	
+#include <vector>
+#include <map>
+#include <string>
+#include <chrono>
 #include <FL/Fl.H>
 #include <FL/Fl_Window.H>
 #include <FL/Fl_Button.H>
@@ -19,11 +23,19 @@
 #include <FL/Fl_Value_Slider.H>
 #include <FL/Fl_Tree.H>
 #include <FL/Fl_Input.H>
+#include <FL/Fl_File_Chooser.H>
+#include <FL/fl_ask.H>
 #include "GLWindow.h"
 #include "polyline.h"
 #include "polygon.h"
 #include "quad.h"
 #include "triangle.h"
+#include "SceneLibrary.h"
+#include "SceneFile.h"
+#include "SceneJSON.h"
+#include "SceneLoader.h"
+#include "EditJournal.h"
+#include "UndoHistory.h"
 
 #define TREEVIEWX 10
 #define TREEVIEWY 20
@@ -32,6 +44,14 @@
 #define MINSCALE 0.1
 #define MAXSCALE 5
 
+/* Seconds of each frame spent adding the pieces of a scene being opened. */
+#define LOAD_FRAME_BUDGET 0.01
+
+/* Autosave of the scene being edited, and the seconds between merging its */
+/* journal of edits into it.                                               */
+#define AUTOSAVE_PATH "autosave.asg"
+#define AUTOSAVE_INTERVAL 30.0
+
 class SceneGraphWindow : public Fl_Window
 {
 
@@ -53,6 +73,10 @@ class SceneGraphWindow : public Fl_Window
 		Fl_Button* removeB;
 		/* A Pointer to the add Node button. */
 		Fl_Button* addB;
+		/* Pointers to the save and open scene buttons. */
+		Fl_Button* saveB, *openB;
+		/* Pointers to the undo and redo buttons. */
+		Fl_Button* undoB, *redoB;
 		/* Group of the transformation widgets. */
 		Fl_Group* transformationG;
 		/* Pointers to the translation sliders. */
@@ -68,11 +92,41 @@ class SceneGraphWindow : public Fl_Window
 		/* Input for renaming the active Item */
 		Fl_Input* itemNameInput;
 
+		/* Loads the scene being opened, NULL if none is. */
+		SceneLoader* loader;
+		/* Pieces taken from the loader, and the next one to add. */
+		std::vector<SceneLoader::Piece> loadedPieces;
+		unsigned int nextLoadedPiece;
+		/* Tree item of each piece added, by its index in the file. */
+		std::vector<Fl_Tree_Item*> loadedItems;
+		/* Tree labels of the nodes of the scene being opened. */
+		std::map<const Node*, std::string> loadedLabels;
+
+		/* Autosave of the scene graph, recording each edit. */
+		EditJournal* journal;
+		/* Undo and redo stacks of the edits to the scene graph. */
+		UndoHistory* history;
+
 
 		/* Callback function for the exit button. */
 		static void exitCB(Fl_Widget *w, void *data);
 		/* Callback function for the reset button. */
 		static void resetCB(Fl_Widget *w, void *data);
+		/* Callback function for the save scene button. */
+		static void saveCB(Fl_Widget *w, void *data);
+		/* Callback function for the open scene button. */
+		static void openCB(Fl_Widget *w, void *data);
+		/* Callback function for the undo button. */
+		static void undoCB(Fl_Widget *w, void *data);
+		/* Callback function for the redo button. */
+		static void redoCB(Fl_Widget *w, void *data);
+		/* Called on the loading thread when pieces are waiting. */
+		static void loaderNotify(void *data);
+		/* Callback function for adding the pieces of a scene being */
+		/* opened.                                                  */
+		static void loaderCB(void *data);
+		/* Callback function for merging the autosave's journal. */
+		static void autosaveCB(void *data);
 		/* Callback function for the color chooser. */
 		static void colorCB(Fl_Widget *w, void *data);
 		/* Callback function for the remove node button. */
@@ -99,9 +153,6 @@ class SceneGraphWindow : public Fl_Window
 		/* Calback function for changing the active items label. */
 		static void changeItemLabelCB(Fl_Widget *w, void *data);
 		
-		/* Create the original animal scene graph */
-		static Node* createAnimalSceneGraph();
-
 		/* Creates the FL Group of translation sliders. */
 		Fl_Group* makeTranslationG(const int x, const int y);
 		/* Creates the FL Group of scale sliders. */
@@ -118,16 +169,63 @@ class SceneGraphWindow : public Fl_Window
 		/* Sets the value of the rename item input to the */
 		/* active item's label.                           */
 		void setItemNameInput();
+		/* Sets the transformation, color, and rename widgets to the */
+		/* active Node's values after an undo or redo.               */
+		virtual void setActiveNodeWidgets();
 
 		/* Creates the tree view of the scene graph. */
 		Fl_Tree* makeTree(const int x, const int y);
 		/* Adds the children to the tree view. */
 		void addChildrenToTree();
+		/* Adds the given Node and its children to the tree view under */
+		/* the given item, labeled by their geometry unless the scene  */
+		/* being opened labels them. Returns the Node's item.          */
+		Fl_Tree_Item* addSubtreeToTree(Fl_Tree_Item* parentItem, Node* node);
 
 		/* Adds the given Node to the Scene Graph and tree view with the */
 		/* given label.                                                  */
 		void addNode(Node* n, const char* label);
 
+		/* Replaces the scene graph with the given one, deleting the old */
+		/* one, and resets the widgets to its root.                      */
+		virtual void setSceneGraph(Node* newSceneGraph);
+
+		/* Returns the tree label of every Node in the tree view. */
+		std::map<const Node*, std::string> getTreeLabels() const;
+
+		/* Adds a piece of the scene being opened to the scene graph and */
+		/* the tree view.                                                */
+		void addLoadedPiece(const SceneLoader::Piece& piece);
+		/* Stops opening a scene, deleting the pieces not yet added. */
+		void stopLoading();
+		/* Turns the widgets that change the structure of the scene    */
+		/* graph off while a scene is being opened, and back on after. */
+		virtual void setLoading(bool loading);
+
+		/* Records the values of the given Node at the given frame in */
+		/* the autosave after an edit to its transformation or color. */
+		void recordEdit(const Node* node, unsigned int frameNum);
+		/* Records keying the scene graph at the given frame in the */
+		/* autosave.                                                */
+		void recordMakeKeyframe(unsigned int frameNum);
+
+		/* Records the values of the given Node at the given frame in  */
+		/* the undo history before the given widget edits them. Edits  */
+		/* from one drag of the widget are undone together.            */
+		void recordUndo(Node* node, unsigned int frameNum,
+			const Fl_Widget* source);
+		/* Records the Nodes keyed when the given widget keys the scene */
+		/* graph at the given frame in the undo history.                */
+		void recordUndoMakeKeyframe(unsigned int frameNum,
+			const Fl_Widget* source);
+		/* Ends the undo step of the widget's edit unless the widget is */
+		/* still being dragged.                                         */
+		void endUndoStep();
+		/* Undoes or redoes a step of the undo history, journaling the */
+		/* keyframes it changes and rebuilding the tree view if it     */
+		/* adds or removes a Node.                                     */
+		void stepHistory(bool redo);
+
 	public:
 
 		/* Constructor for a SceneGraphWindow that takes the x,y coordinates, */
@@ -137,6 +235,18 @@ class SceneGraphWindow : public Fl_Window
 		/* Destructor for this SceneGraphWindow. */
 		virtual ~SceneGraphWindow();
 
+		/* Offers to recover the autosave left if the editor did not */
+		/* close normally, then starts autosaving the scene graph.   */
+		void recoverAutosave();
+
+		/* Removes the autosave, once the editor closes normally. */
+		void discardAutosave();
+
+		/* Handles the events of the window. A press ends the open undo */
+		/* step, so a new drag never joins the last one, whose release  */
+		/* the widgets do not report.                                   */
+		virtual int handle(int event);
+
 };
 
 #endif
\ No newline at end of file
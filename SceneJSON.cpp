@@ -0,0 +1,742 @@
+/*
+ * SceneJSON.cpp
+ * Created by Zachary Ferguson
+ * Source file for the SceneJSON class, a class for exporting and importing
+ * scene graphs and their animation as JSON text. The nodes are written as a
+ * flat list in preorder, each with its parent, tree label, geometry and
+ * keyframes. Files are read with a streaming parser, so large scenes are
+ * imported without holding the whole document in memory.
+ */
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include "SceneJSON.h"
+#include <cstdio>  /* Included for fopen, fprintf and sprintf */
+#include <cstdlib> /* Included for strtod */
+#include <cfloat>  /* Included for FLT_MAX */
+#include "FlatSceneGraph.h"
+#include "FrameWriter.h"
+#include "SceneFile.h"
+
+/* Largest number of frames a node may have, the same as in scene files, */
+/* and largest index of a node.                                          */
+#define SCENE_JSON_MAX_FRAMES ((long long)MAX_TRACK_LENGTH)
+#define SCENE_JSON_MAX_NODES 0xFFFFFFFFLL
+
+/* Names of the kinds of geometry, indexed by polyline::Type. */
+static const char* const GEOMETRY_TYPE_NAMES[polyline::NUM_TYPES] =
+{
+	"polyline", "polygon", "triangle", "quad"
+};
+
+/* Returns if the number can be stored in a float without becoming an */
+/* infinity.                                                          */
+static bool fitsFloat(double number)
+{
+	return number >= -FLT_MAX && number <= FLT_MAX;
+}
+
+/* Writes the value as the shortest text that reads back as the same float. */
+/* JSON has no infinities or NaN, so they are written as 0.                 */
+static void writeFloat(FILE* file, float value)
+{
+	if (!(value >= -FLT_MAX && value <= FLT_MAX))
+	{
+		value = 0;
+	}
+	char text[32];
+	for (int precision = 6; precision <= 9; precision++)
+	{
+		sprintf(text, "%.*g", precision, value);
+		if ((float)strtod(text, NULL) == value)
+		{
+			break;
+		}
+	}
+	fputs(text, file);
+}
+
+/* Writes an array of count floats. */
+static void writeFloats(FILE* file, const float* values, unsigned int count)
+{
+	fputc('[', file);
+	for (unsigned int i = 0; i < count; i++)
+	{
+		if (i > 0)
+		{
+			fputs(", ", file);
+		}
+		writeFloat(file, values[i]);
+	}
+	fputc(']', file);
+}
+
+/* Writes the text as a JSON string, escaping quotes, backslashes and */
+/* control characters.                                                */
+static void writeString(FILE* file, const std::string& text)
+{
+	fputc('"', file);
+	for (size_t i = 0; i < text.size(); i++)
+	{
+		unsigned char c = (unsigned char)(text[i]);
+		if (c == '"' || c == '\\')
+		{
+			fputc('\\', file);
+			fputc(c, file);
+		}
+		else if (c < 0x20)
+		{
+			fprintf(file, "\\u%04x", (unsigned int)c);
+		}
+		else
+		{
+			fputc(c, file);
+		}
+	}
+	fputc('"', file);
+}
+
+/* Writes the geometry of a node, or null if it has none. */
+static void writeGeometry(FILE* file, const polyline* geometry)
+{
+	if (geometry == NULL)
+	{
+		fputs("null", file);
+		return;
+	}
+	fputs("{\"type\": ", file);
+	writeString(file, GEOMETRY_TYPE_NAMES[geometry->getType()]);
+	fputs(", \"color\": ", file);
+	std::vector<float> color = geometry->getColor();
+	writeFloats(file, &color[0], 3);
+	fputs(", \"vertices\": [", file);
+	const std::list<vec3>* vertices = geometry->getVertices();
+	for (std::list<vec3>::const_iterator it = vertices->begin();
+		it != vertices->end(); ++it)
+	{
+		if (it != vertices->begin())
+		{
+			fputs(", ", file);
+		}
+		float xyz[3] = {(*it)[0], (*it)[1], (*it)[2]};
+		writeFloats(file, xyz, 3);
+	}
+	fputs("]}", file);
+}
+
+/* Writes the keyframes of a node's track, one to a line. */
+static void writeKeyframes(FILE* file, const KeyframeTrack* track)
+{
+	const std::vector<unsigned int>& times = track->getKeyframeTimes();
+	const std::vector<float>* values[KeyframeTrack::NUM_CHANNELS];
+	for (int c = 0; c < KeyframeTrack::NUM_CHANNELS; c++)
+	{
+		values[c] = &(track->getKeyframeValues((KeyframeTrack::Channel)c));
+	}
+	fputs("[\n", file);
+	for (size_t i = 0; i < times.size(); i++)
+	{
+		float scale[2] = {(*values[KeyframeTrack::SCALE_X])[i],
+			(*values[KeyframeTrack::SCALE_Y])[i]};
+		float translation[2] = {(*values[KeyframeTrack::TRANSLATION_X])[i],
+			(*values[KeyframeTrack::TRANSLATION_Y])[i]};
+		float color[3] = {(*values[KeyframeTrack::RED])[i],
+			(*values[KeyframeTrack::GREEN])[i],
+			(*values[KeyframeTrack::BLUE])[i]};
+
+		fprintf(file, "        {\"frame\": %u, \"scale\": ", times[i]);
+		writeFloats(file, scale, 2);
+		fputs(", \"rotation\": ", file);
+		writeFloat(file, (*values[KeyframeTrack::ROTATION])[i]);
+		fputs(", \"translation\": ", file);
+		writeFloats(file, translation, 2);
+		fputs(", \"color\": ", file);
+		writeFloats(file, color, 3);
+		fputs((i + 1 < times.size()) ? "},\n" : "}\n", file);
+	}
+	fputs("      ]", file);
+}
+
+/* Exports the scene graph and its animation to the file at the given path, */
+/* replacing it. Returns if the file was written.                           */
+bool SceneJSON::save(const Node* root, const std::string& path)
+{
+	return SceneJSON::save(root, std::map<const Node*, std::string>(), path);
+}
+
+/* Exports the scene graph with the given tree labels of its nodes. Returns */
+/* if the file was written.                                                 */
+bool SceneJSON::save(const Node* root,
+	const std::map<const Node*, std::string>& labels, const std::string& path)
+{
+	if (root == NULL)
+	{
+		return false;
+	}
+
+	/* Write the whole file next to the old one before replacing it */
+	std::string newPath = path + ".new";
+	FILE* file = fopen(newPath.c_str(), "wb");
+	if (file == NULL)
+	{
+		return false;
+	}
+
+	/* Lay the nodes out in preorder, parents before their children */
+	FlatSceneGraph flatSceneGraph;
+	flatSceneGraph.sync(root);
+	unsigned int numNodes = flatSceneGraph.size();
+
+	fprintf(file, "{\n  \"format\": \"%s\",\n  \"version\": %d,\n"
+		"  \"nodes\": [\n", SCENE_JSON_FORMAT, SCENE_JSON_VERSION);
+	for (unsigned int i = 0; i < numNodes; i++)
+	{
+		const Node* node = flatSceneGraph.getNode(i);
+		fputs("    {\n", file);
+		std::map<const Node*, std::string>::const_iterator label =
+			labels.find(node);
+		if (label != labels.end())
+		{
+			fputs("      \"label\": ", file);
+			writeString(file, label->second);
+			fputs(",\n", file);
+		}
+		fprintf(file, "      \"parent\": %d,\n      \"length\": %u,\n",
+			flatSceneGraph.getParent(i), node->getTrack()->getLength());
+		fputs("      \"geometry\": ", file);
+		writeGeometry(file, node->getGeometry());
+		fputs(",\n      \"keyframes\": ", file);
+		writeKeyframes(file, node->getTrack());
+		fputs((i + 1 < numNodes) ? "\n    },\n" : "\n    }\n", file);
+	}
+	fputs("  ]\n}\n", file);
+
+	bool written = !ferror(file);
+	if (fclose(file) != 0 || !written ||
+		!FrameWriter::replaceFile(newPath, path))
+	{
+		remove(newPath.c_str());
+		return false;
+	}
+	return true;
+}
+
+/* Returns if the path names a JSON scene file, one ending in .json. */
+bool SceneJSON::isJSONPath(const std::string& path)
+{
+	const std::string extension = ".json";
+	if (path.size() < extension.size())
+	{
+		return false;
+	}
+	for (size_t i = 0; i < extension.size(); i++)
+	{
+		char c = path[path.size() - extension.size() + i];
+		if (c >= 'A' && c <= 'Z')
+		{
+			c = (char)(c - 'A' + 'a');
+		}
+		if (c != extension[i])
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+/* Imports the scene graph in the file at the given path. Returns NULL if it */
+/* could not be read.                                                        */
+Node* SceneJSON::load(const std::string& path)
+{
+	std::map<const Node*, std::string> labels;
+	std::string error;
+	return SceneJSON::load(path, labels, error);
+}
+
+/* Imports the scene graph in the file at the given path, adding the label */
+/* of each labeled node to labels. Returns NULL and sets error to what     */
+/* went wrong if the file could not be read.                               */
+Node* SceneJSON::load(const std::string& path,
+	std::map<const Node*, std::string>& labels, std::string& error)
+{
+	JSONReader reader;
+	if (!reader.open(path))
+	{
+		error = "Could not open " + path;
+		return NULL;
+	}
+
+	/* Nodes in file order, each attached to its parent as it is read */
+	std::vector<Node*> nodes;
+	NodeFields fields;
+	bool ok = true, hasNodes = false;
+	JSONReader::Token token = reader.next();
+	if (token != JSONReader::BEGIN_OBJECT)
+	{
+		ok = SceneJSON::fail(reader, "Expected a scene object", error);
+	}
+	while (ok && (token = reader.next()) == JSONReader::NAME)
+	{
+		const std::string& name = reader.getText();
+		if (name == "format")
+		{
+			ok = reader.next() == JSONReader::STRING &&
+				reader.getText() == SCENE_JSON_FORMAT;
+			if (!ok)
+			{
+				SceneJSON::fail(reader, "Not an animated scene graph", error);
+			}
+		}
+		else if (name == "version")
+		{
+			long long version;
+			ok = SceneJSON::readInteger(reader, 1, SCENE_JSON_VERSION,
+				version);
+			if (!ok)
+			{
+				SceneJSON::fail(reader, "Unsupported version", error);
+			}
+		}
+		else if (name == "nodes")
+		{
+			if (reader.next() != JSONReader::BEGIN_ARRAY)
+			{
+				ok = SceneJSON::fail(reader, "Expected an array of nodes",
+					error);
+				break;
+			}
+			while (ok && (token = reader.next()) == JSONReader::BEGIN_OBJECT)
+			{
+				ok = SceneJSON::readNode(reader, fields, error);
+				if (!ok)
+				{
+					break;
+				}
+
+				/* Parents come before their children, the root first */
+				long long index = (long long)(nodes.size());
+				if ((index == 0) ? (fields.parent != -1) :
+					(fields.parent < 0 || fields.parent >= index))
+				{
+					ok = SceneJSON::fail(reader, "Invalid parent", error);
+					break;
+				}
+
+				/* Every node covers the same frames as the root */
+				if (index > 0 && fields.length !=
+					(long long)(nodes[0]->getTrack()->getLength()))
+				{
+					ok = SceneJSON::fail(reader,
+						"Length differs from the root's", error);
+					break;
+				}
+				const float* values[KeyframeTrack::NUM_CHANNELS];
+				for (int c = 0; c < KeyframeTrack::NUM_CHANNELS; c++)
+				{
+					values[c] = &(fields.values[c][0]);
+				}
+				Node* node = SceneFile::buildNode(fields.geometryType,
+					fields.vertices.empty() ? NULL : &(fields.vertices[0]),
+					(unsigned int)(fields.vertices.size() / 3), fields.color,
+					(unsigned int)(fields.length), &(fields.times[0]),
+					(unsigned int)(fields.times.size()), values);
+				if (index > 0)
+				{
+					nodes[(size_t)(fields.parent)]->addChild(node);
+				}
+				nodes.push_back(node);
+				if (fields.hasLabel)
+				{
+					labels[node] = fields.label;
+				}
+			}
+			if (ok && token != JSONReader::END_ARRAY)
+			{
+				ok = SceneJSON::fail(reader, "Expected a node", error);
+			}
+			hasNodes = true;
+		}
+		else if (!reader.skipValue(reader.next()))
+		{
+			ok = SceneJSON::fail(reader, "Expected a value", error);
+		}
+	}
+	if (ok && token != JSONReader::END_OBJECT)
+	{
+		ok = SceneJSON::fail(reader, "Expected a member name", error);
+	}
+	if (ok && reader.next() != JSONReader::END)
+	{
+		ok = SceneJSON::fail(reader, "Expected the end of the file", error);
+	}
+	if (ok && (!hasNodes || nodes.empty()))
+	{
+		ok = SceneJSON::fail(reader, "The scene has no nodes", error);
+	}
+
+	if (!ok)
+	{
+		for (size_t i = 0; i < nodes.size(); i++)
+		{
+			labels.erase(nodes[i]);
+		}
+		if (!(nodes.empty()))
+		{
+			delete nodes[0];
+		}
+		return NULL;
+	}
+	return nodes[0];
+}
+
+/* Reads the members of a node's object into fields. */
+bool SceneJSON::readNode(JSONReader& reader, NodeFields& fields,
+	std::string& error)
+{
+	fields.hasLabel = false;
+	fields.parent = -2;
+	fields.length = 0;
+	fields.geometryType = SCENE_NO_GEOMETRY;
+	fields.vertices.clear();
+	fields.times.clear();
+	for (int c = 0; c < KeyframeTrack::NUM_CHANNELS; c++)
+	{
+		fields.values[c].clear();
+	}
+	fields.hasColor.clear();
+	for (int c = 0; c < 3; c++)
+	{
+		fields.color[c] = 1;
+	}
+
+	JSONReader::Token token;
+	while ((token = reader.next()) == JSONReader::NAME)
+	{
+		const std::string& name = reader.getText();
+		bool ok = true;
+		if (name == "label")
+		{
+			ok = reader.next() == JSONReader::STRING;
+			if (!ok)
+			{
+				return SceneJSON::fail(reader, "Expected a label", error);
+			}
+			fields.label = reader.getText();
+			fields.hasLabel = true;
+		}
+		else if (name == "parent")
+		{
+			if (!SceneJSON::readInteger(reader, -1, SCENE_JSON_MAX_NODES,
+				fields.parent))
+			{
+				return SceneJSON::fail(reader, "Invalid parent", error);
+			}
+		}
+		else if (name == "length")
+		{
+			if (!SceneJSON::readInteger(reader, 1, SCENE_JSON_MAX_FRAMES,
+				fields.length))
+			{
+				return SceneJSON::fail(reader, "Invalid length", error);
+			}
+		}
+		else if (name == "geometry")
+		{
+			ok = SceneJSON::readGeometry(reader, fields, error);
+		}
+		else if (name == "keyframes")
+		{
+			ok = SceneJSON::readKeyframes(reader, fields, error);
+		}
+		else if (!reader.skipValue(reader.next()))
+		{
+			return SceneJSON::fail(reader, "Expected a value", error);
+		}
+		if (!ok)
+		{
+			return false;
+		}
+	}
+	if (token != JSONReader::END_OBJECT)
+	{
+		return SceneJSON::fail(reader, "Expected a member name", error);
+	}
+
+	if (fields.parent == -2)
+	{
+		return SceneJSON::fail(reader, "Node has no parent", error);
+	}
+	if (fields.length == 0)
+	{
+		return SceneJSON::fail(reader, "Node has no length", error);
+	}
+	if (fields.times.empty() || fields.times[0] != 0 ||
+		fields.times.back() >= fields.length)
+	{
+		return SceneJSON::fail(reader,
+			"Keyframes must start at frame 0 and end before the length",
+			error);
+	}
+
+	/* Keyframes without a color take the color of the geometry */
+	for (size_t i = 0; i < fields.times.size(); i++)
+	{
+		if (!(fields.hasColor[i]))
+		{
+			fields.values[KeyframeTrack::RED][i] = fields.color[0];
+			fields.values[KeyframeTrack::GREEN][i] = fields.color[1];
+			fields.values[KeyframeTrack::BLUE][i] = fields.color[2];
+		}
+	}
+	return true;
+}
+
+/* Reads the geometry object of a node into fields. */
+bool SceneJSON::readGeometry(JSONReader& reader, NodeFields& fields,
+	std::string& error)
+{
+	JSONReader::Token token = reader.next();
+	if (token == JSONReader::NULL_VALUE)
+	{
+		fields.geometryType = SCENE_NO_GEOMETRY;
+		return true;
+	}
+	if (token != JSONReader::BEGIN_OBJECT)
+	{
+		return SceneJSON::fail(reader, "Expected a geometry object", error);
+	}
+
+	int type = SCENE_NO_GEOMETRY;
+	while ((token = reader.next()) == JSONReader::NAME)
+	{
+		const std::string& name = reader.getText();
+		if (name == "type")
+		{
+			if (reader.next() == JSONReader::STRING)
+			{
+				for (int t = 0; t < polyline::NUM_TYPES; t++)
+				{
+					if (reader.getText() == GEOMETRY_TYPE_NAMES[t])
+					{
+						type = t;
+					}
+				}
+			}
+			if (type == SCENE_NO_GEOMETRY)
+			{
+				return SceneJSON::fail(reader, "Unknown geometry type",
+					error);
+			}
+		}
+		else if (name == "color")
+		{
+			if (!SceneJSON::readNumbers(reader, fields.color, 3))
+			{
+				return SceneJSON::fail(reader, "Expected an RGB color",
+					error);
+			}
+		}
+		else if (name == "vertices")
+		{
+			if (reader.next() != JSONReader::BEGIN_ARRAY)
+			{
+				return SceneJSON::fail(reader, "Expected an array of vertices",
+					error);
+			}
+			fields.vertices.clear();
+			while ((token = reader.next()) == JSONReader::BEGIN_ARRAY)
+			{
+				float xyz[3];
+				for (int j = 0; j < 3; j++)
+				{
+					if (reader.next() != JSONReader::NUMBER ||
+						!fitsFloat(reader.getNumber()))
+					{
+						return SceneJSON::fail(reader,
+							"Expected a vertex of three numbers", error);
+					}
+					xyz[j] = (float)(reader.getNumber());
+				}
+				if (reader.next() != JSONReader::END_ARRAY)
+				{
+					return SceneJSON::fail(reader,
+						"Expected a vertex of three numbers", error);
+				}
+				fields.vertices.insert(fields.vertices.end(), xyz, xyz + 3);
+			}
+			if (token != JSONReader::END_ARRAY)
+			{
+				return SceneJSON::fail(reader, "Expected a vertex", error);
+			}
+		}
+		else if (!reader.skipValue(reader.next()))
+		{
+			return SceneJSON::fail(reader, "Expected a value", error);
+		}
+	}
+	if (token != JSONReader::END_OBJECT)
+	{
+		return SceneJSON::fail(reader, "Expected a member name", error);
+	}
+
+	if (type == SCENE_NO_GEOMETRY)
+	{
+		return SceneJSON::fail(reader, "Geometry has no type", error);
+	}
+	size_t numVertices = fields.vertices.size() / 3;
+	if ((type == polyline::TRIANGLE && numVertices != 3) ||
+		(type == polyline::QUAD && numVertices != 4))
+	{
+		return SceneJSON::fail(reader, "Wrong number of vertices", error);
+	}
+	fields.geometryType = type;
+	return true;
+}
+
+/* Reads the array of keyframes of a node into fields. */
+bool SceneJSON::readKeyframes(JSONReader& reader, NodeFields& fields,
+	std::string& error)
+{
+	if (reader.next() != JSONReader::BEGIN_ARRAY)
+	{
+		return SceneJSON::fail(reader, "Expected an array of keyframes",
+			error);
+	}
+	fields.times.clear();
+	for (int c = 0; c < KeyframeTrack::NUM_CHANNELS; c++)
+	{
+		fields.values[c].clear();
+	}
+	fields.hasColor.clear();
+
+	JSONReader::Token token;
+	while ((token = reader.next()) == JSONReader::BEGIN_OBJECT)
+	{
+		/* Channels left out keep the values of a Frame at rest */
+		long long frameNum = -1;
+		float values[KeyframeTrack::NUM_CHANNELS] =
+			{1, 1, 0, 0, 0, 1, 1, 1};
+		bool hasColor = false;
+		while ((token = reader.next()) == JSONReader::NAME)
+		{
+			const std::string& name = reader.getText();
+			bool ok = true;
+			if (name == "frame")
+			{
+				ok = SceneJSON::readInteger(reader, 0,
+					SCENE_JSON_MAX_FRAMES - 1, frameNum);
+			}
+			else if (name == "scale")
+			{
+				ok = SceneJSON::readNumbers(reader,
+					values + KeyframeTrack::SCALE_X, 2);
+			}
+			else if (name == "rotation")
+			{
+				ok = SceneJSON::readNumbers(reader,
+					values + KeyframeTrack::ROTATION, 1);
+			}
+			else if (name == "translation")
+			{
+				ok = SceneJSON::readNumbers(reader,
+					values + KeyframeTrack::TRANSLATION_X, 2);
+			}
+			else if (name == "color")
+			{
+				ok = SceneJSON::readNumbers(reader,
+					values + KeyframeTrack::RED, 3);
+				hasColor = true;
+			}
+			else
+			{
+				ok = reader.skipValue(reader.next());
+			}
+			if (!ok)
+			{
+				return SceneJSON::fail(reader, "Invalid keyframe value",
+					error);
+			}
+		}
+		if (token != JSONReader::END_OBJECT)
+		{
+			return SceneJSON::fail(reader, "Expected a member name", error);
+		}
+		if (frameNum < 0 || (!(fields.times.empty()) &&
+			frameNum <= (long long)(fields.times.back())))
+		{
+			return SceneJSON::fail(reader,
+				"Keyframes need frames in increasing order", error);
+		}
+
+		fields.times.push_back((unsigned int)frameNum);
+		for (int c = 0; c < KeyframeTrack::NUM_CHANNELS; c++)
+		{
+			fields.values[c].push_back(values[c]);
+		}
+		fields.hasColor.push_back(hasColor);
+	}
+	if (token != JSONReader::END_ARRAY)
+	{
+		return SceneJSON::fail(reader, "Expected a keyframe", error);
+	}
+	return true;
+}
+
+/* Reads an array of exactly count numbers into values, or a single number */
+/* when count is 1. Numbers too large for a float are not read.            */
+bool SceneJSON::readNumbers(JSONReader& reader, float* values,
+	unsigned int count)
+{
+	JSONReader::Token token = reader.next();
+	bool single = (count == 1 && token == JSONReader::NUMBER);
+	if (!single && token != JSONReader::BEGIN_ARRAY)
+	{
+		return false;
+	}
+	for (unsigned int i = 0; i < count; i++)
+	{
+		if ((!single && reader.next() != JSONReader::NUMBER) ||
+			!fitsFloat(reader.getNumber()))
+		{
+			return false;
+		}
+		values[i] = (float)(reader.getNumber());
+	}
+	return single || reader.next() == JSONReader::END_ARRAY;
+}
+
+/* Reads a whole number from minimum to maximum into value. */
+bool SceneJSON::readInteger(JSONReader& reader, long long minimum,
+	long long maximum, long long& value)
+{
+	if (reader.next() != JSONReader::NUMBER)
+	{
+		return false;
+	}
+	double number = reader.getNumber();
+	if (!(number >= (double)minimum && number <= (double)maximum) ||
+		number != (double)(long long)number)
+	{
+		return false;
+	}
+	value = (long long)number;
+	return true;
+}
+
+/* Sets error to the given message on the reader's line, or to the reader's */
+/* own error. Returns false.                                                */
+bool SceneJSON::fail(const JSONReader& reader, const char* message,
+	std::string& error)
+{
+	if (!(reader.getError().empty()))
+	{
+		error = reader.getError();
+	}
+	else
+	{
+		char line[32];
+		sprintf(line, "Line %u: ", reader.getLine());
+		error = std::string(line) + message;
+	}
+	return false;
+}
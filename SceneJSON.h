@@ -0,0 +1,98 @@
+/*
+ * SceneJSON.h
+ * Created by Zachary Ferguson
+ * Header file for the SceneJSON class, a class for exporting and importing
+ * scene graphs and their animation as JSON text. The nodes are written as a
+ * flat list in preorder, each with its parent, tree label, geometry and
+ * keyframes. Files are read with a streaming parser, so large scenes are
+ * imported without holding the whole document in memory.
+ */
+
+#ifndef SCENEJSON_H
+#define SCENEJSON_H
+
+/* Include necessary types */
+#include <string>
+#include <map>
+#include <vector>
+#include "Node.h"
+#include "JSONReader.h"
+
+/* Name and version of the JSON scene format written. */
+#define SCENE_JSON_FORMAT "animated-scene-graph"
+#define SCENE_JSON_VERSION 1
+
+class SceneJSON
+{
+	private:
+
+		/* A node being read, reused from one node to the next. */
+		struct NodeFields
+		{
+			std::string label;
+			bool hasLabel;
+			long long parent;
+			long long length;
+			int geometryType;
+			float color[3];
+			std::vector<float> vertices;
+			std::vector<unsigned int> times;
+			std::vector<float> values[KeyframeTrack::NUM_CHANNELS];
+			std::vector<bool> hasColor;
+		};
+
+		/* Reads an array of exactly count numbers into values, or a */
+		/* single number when count is 1. Numbers too large for a    */
+		/* float are not read.                                       */
+		static bool readNumbers(JSONReader& reader, float* values,
+			unsigned int count);
+
+		/* Reads a whole number from minimum to maximum into value. */
+		static bool readInteger(JSONReader& reader, long long minimum,
+			long long maximum, long long& value);
+
+		/* Reads the geometry object of a node into fields. */
+		static bool readGeometry(JSONReader& reader, NodeFields& fields,
+			std::string& error);
+
+		/* Reads the array of keyframes of a node into fields. */
+		static bool readKeyframes(JSONReader& reader, NodeFields& fields,
+			std::string& error);
+
+		/* Reads the members of a node's object into fields. */
+		static bool readNode(JSONReader& reader, NodeFields& fields,
+			std::string& error);
+
+		/* Sets error to the given message on the reader's line, or to */
+		/* the reader's own error. Returns false.                      */
+		static bool fail(const JSONReader& reader, const char* message,
+			std::string& error);
+
+	public:
+
+		/* Exports the scene graph and its animation to the file at the */
+		/* given path, replacing it. Returns if the file was written.   */
+		static bool save(const Node* root, const std::string& path);
+
+		/* Exports the scene graph with the given tree labels of its  */
+		/* nodes. Returns if the file was written.                    */
+		static bool save(const Node* root,
+			const std::map<const Node*, std::string>& labels,
+			const std::string& path);
+
+		/* Returns if the path names a JSON scene file, one ending in */
+		/* .json.                                                     */
+		static bool isJSONPath(const std::string& path);
+
+		/* Imports the scene graph in the file at the given path. */
+		/* Returns NULL if it could not be read.                  */
+		static Node* load(const std::string& path);
+
+		/* Imports the scene graph in the file at the given path, adding   */
+		/* the label of each labeled node to labels. Returns NULL and sets */
+		/* error to what went wrong if the file could not be read.         */
+		static Node* load(const std::string& path,
+			std::map<const Node*, std::string>& labels, std::string& error);
+};
+
+#endif
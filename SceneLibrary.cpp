@@ -0,0 +1,269 @@
+/*
+ * SceneLibrary.cpp
+ * Created by Zachary Ferguson
+ * Source file for the SceneLibrary class, a class for building the scene
+ * graphs that come with the editor, for the windows and the batch renderer.
+ */
+
+#include "SceneLibrary.h"
+#include <list>
+#include <vector>
+#include <algorithm> /* Included for max */
+#include "polyline.h"
+#include "polygon.h"
+#include "quad.h"
+#include "triangle.h"
+
+/* Number of frames per step of the walking animal. */
+#define FRAMES_PER_STEP 5
+
+/* Angle in degrees each leg swings either way while walking. */
+#define LEG_SWING 20
+
+/* Returns the scene graph with the given name, "animal" or "walk",  */
+/* animated over the given number of frames, or NULL if there is no  */
+/* scene graph with that name.                                       */
+Node* SceneLibrary::createSceneGraph(const std::string& name,
+	unsigned int numFrames)
+{
+	Node* root = NULL;
+	if (name == "animal")
+	{
+		root = SceneLibrary::createAnimalSceneGraph();
+		root->expandTransforms(0, numFrames);
+	}
+	else if (name == "walk")
+	{
+		root = SceneLibrary::createWalkingAnimalSceneGraph(numFrames);
+	}
+	return root;
+}
+
+/* Creates a scene graph of a kitten */
+Node* SceneLibrary::createAnimalSceneGraph()
+{
+	/********************/
+	/********BODY********/
+	/********************/
+
+	std::list<vec3> *bVertices = new std::list<vec3>();
+	bVertices->push_back(vec3(   1,    0, 1));
+	bVertices->push_back(vec3( 0.5,   -1, 1));
+	bVertices->push_back(vec3(-0.5,   -1, 1));
+	bVertices->push_back(vec3(  -1,    0, 1));
+	bVertices->push_back(vec3(-0.5, 0.25, 1));
+	bVertices->push_back(vec3( 0.5, 0.25, 1));
+
+	polygon* body = new polygon(bVertices, 1, 0, 0.647f);
+	/* Root Scale */
+	mat3 bScale = mat3::scale2D(2, 1.65f);
+	/* Root Rotation */
+	mat3 bRotation = mat3::rotation2D(30);
+	/* Root Translate */
+	mat3 bTranslate = mat3::translation2D(-1, 4);
+	Node* root = new Node(bScale, bRotation,
+						  bTranslate, body);
+
+	/********************/
+	/********HEAD********/
+	/********************/
+	std::list<vec3> *hVertices = new std::list<vec3>();
+	hVertices->push_back(vec3(0.5, 0, 1));
+	hVertices->push_back(vec3(  0, 0, 1));
+	hVertices->push_back(vec3(  0, 1, 1));
+
+	triangle* head = new triangle(hVertices, 1.0, 0.0, 1.0);
+
+	/* Head Scale */
+	mat3 hScale = mat3::scale2D(2, .75);
+	/* Head Rotation */
+	mat3 hRotation = mat3::rotation2D(-15);
+	/* Head Translate */
+	mat3 hTranslate = mat3::translation2D(1, 0);
+	Node* hNode = new Node(hScale, hRotation,
+						   hTranslate, head);
+
+
+	/***************************/
+	/********UPPER LIMBS********/
+	/***************************/
+	std::list<vec3>* upperLimb = new std::list<vec3>();
+	upperLimb->push_back(vec3( 0.25,  0, 1));
+	upperLimb->push_back(vec3( 0.25, -1, 1));
+	upperLimb->push_back(vec3(-0.25, -1, 1));
+	upperLimb->push_back(vec3(-0.25,  0, 1));
+
+	/*** Limb 1 Upper ***/
+	quad* limb1upper = new quad(upperLimb, 1.0, 0.0, 0.0);
+	mat3 limb1upperScale = mat3::scale2D(.5, 1);
+	/* Limb 1 Upper Rotation */
+	mat3 limb1upperRotate = mat3::rotation2D(60);
+	mat3 limb1upperTranslate = mat3::translation2D(0.75, -0.5);
+	Node* frontOutterLeg = new Node(limb1upperScale, limb1upperRotate,
+									limb1upperTranslate, limb1upper);
+
+	/*** Limb 2 Upper ***/
+	quad* limb2upper = new quad(upperLimb, 1.0, 0.0, 0.0);
+	mat3 limb2upperScale = mat3::scale2D(.5, 1);
+	/* Limb 2 Upper Rotation */
+	mat3 limb2upperRotate = mat3::rotation2D(-60);
+	mat3 limb2upperTranslate = mat3::translation2D(-0.75, -0.5);
+	Node* backOutterLeg = new Node(limb2upperScale, limb2upperRotate,
+								   limb2upperTranslate, limb2upper);
+
+	/*** Limb 3 Upper ***/
+	quad* limb3upper = new quad(upperLimb, 0.0, 0.0, 1.0);
+	mat3 limb3upperScale = mat3::scale2D(.5, 1);
+	/* Limb 3 Upper Rotation */
+	mat3 limb3upperRotate = mat3::rotation2D(45);
+	mat3 limb3upperTranslate = mat3::translation2D(0.625, -0.625);
+	Node* frontInnerLeg = new Node(limb3upperScale, limb3upperRotate,
+								   limb3upperTranslate, limb3upper);
+
+	/*** Limb 4 Upper ***/
+	quad* limb4upper = new quad(upperLimb, 0.0, 0.0, 1.0);
+	mat3 limb4upperScale = mat3::scale2D(.5, 1);
+	/* Limb 4 Upper Rotation */
+	mat3 limb4upperRotate = mat3::rotation2D(-45);
+	mat3 limb4upperTranslate = mat3::translation2D(-0.625, -0.625);
+	Node* backInnerLeg = new Node(limb4upperScale, limb4upperRotate,
+								  limb4upperTranslate, limb4upper);
+
+
+	/***************************/
+	/********LOWER LIMBS********/
+	/***************************/
+	std::list<vec3>* lowerLimb = new std::list<vec3>();
+	lowerLimb->push_back(vec3( 0.25,    0, 1));
+	lowerLimb->push_back(vec3( 0.25, -0.5, 1));
+	lowerLimb->push_back(vec3(-0.25, -0.5, 1));
+	lowerLimb->push_back(vec3(-0.25,    0, 1));
+
+	/*** Limb 1 Lower ***/
+	quad* limb1lower = new quad(lowerLimb, 1.0, 1.0, 0.0);
+	mat3 limb1lowerScale = mat3::scale2D(.5, 1.5);
+	/* Limb 1 Lower Rotation */
+	mat3 limb1lowerRotate = mat3::rotation2D(60);
+	mat3 limb1lowerTranslate = mat3::translation2D(0, -1);
+	Node* frontOutterFoot = new Node(limb1lowerScale, limb1lowerRotate,
+									 limb1lowerTranslate, limb1lower);
+	(*frontOutterLeg).addChild(frontOutterFoot);
+
+	/*** Limb 2 Lower ***/
+	quad* limb2lower = new quad(lowerLimb, 1.0, 1.0, 0.0);
+	mat3 limb2lowerScale = mat3::scale2D(.5, 2);
+	/* Limb 2 Lower Rotation */
+	mat3 limb2lowerRotate = mat3::rotation2D(90);
+	mat3 limb2lowerTranslate = mat3::translation2D(0, -1);
+	Node* backOutterFoot = new Node(limb2lowerScale, limb2lowerRotate,
+									limb2lowerTranslate, limb2lower);
+	(*backOutterLeg).addChild(backOutterFoot);
+
+	/*** Limb 3 Lower ***/
+	quad* limb3lower = new quad(lowerLimb, 0.0, 1.0, 1.0);
+	mat3 limb3lowerScale = mat3::scale2D(.5, 1.5);
+	/* Limb 3 Lower Rotation */
+	mat3 limb3lowerRotate = mat3::rotation2D(60);
+	mat3 limb3lowerTranslate = mat3::translation2D(0, -1);
+	Node* frontInnerFoot = new Node(limb3lowerScale, limb3lowerRotate,
+									limb3lowerTranslate, limb3lower);
+	(*frontInnerLeg).addChild(frontInnerFoot);
+
+	/*** Limb 4 Lower ***/
+	quad* limb4lower = new quad(lowerLimb, 0.0, 1.0, 1.0);
+	mat3 limb4lowerScale = mat3::scale2D(.5, 2);
+	/* Limb 4 Lower Rotation */
+	mat3 limb4lowerRotate = mat3::rotation2D(90);
+	mat3 limb4lowerTranslate = mat3::translation2D(0, -1);
+	Node* backInnerFoot = new Node(limb4lowerScale, limb4lowerRotate,
+								   limb4lowerTranslate, limb4lower);
+	(*backInnerLeg).addChild(backInnerFoot);
+
+	/********************/
+	/********TAIL********/
+	/********************/
+
+	std::list<vec3>* tVertices = new std::list<vec3>();
+	tVertices->push_back(vec3(   0,   0, 1));
+	tVertices->push_back(vec3(-0.5,   0, 1));
+	tVertices->push_back(vec3(-0.5, 0.5, 1));
+	tVertices->push_back(vec3(  -1, 0.5, 1));
+
+	polyline* tail = new polyline(tVertices, 0.647f, 0.1647f, 0.1647f);
+
+	/* Tail Scale */
+	mat3 tScale = mat3::scale2D(1, 1);
+	/* Tail Rotation */
+	mat3 tRotation = mat3::rotation2D(-30);
+	/* Tail Translate */
+	mat3 tTranslate = mat3::translation2D(-1, 0);
+	Node* tNode = new Node(tScale, tRotation,
+						   tTranslate, tail);
+
+	/* Add parts to the body */
+	(*root).addChild(hNode);
+	(*root).addChild(frontInnerLeg);
+	(*root).addChild(frontOutterLeg);
+	(*root).addChild(backInnerLeg);
+	(*root).addChild(backOutterLeg);
+	(*root).addChild(tNode);
+
+	return root;
+}
+
+/* Creates the animal scene graph walking across the view over the given */
+/* number of frames, swinging its legs at every keyframe.                */
+Node* SceneLibrary::createWalkingAnimalSceneGraph(unsigned int numFrames)
+{
+	Node* root = SceneLibrary::createAnimalSceneGraph();
+	root->expandTransforms(0, numFrames);
+	if (numFrames < 2)
+	{
+		return root;
+	}
+
+	/* The upper legs, in the order they were added after the head */
+	std::vector<Node*> legs;
+	const std::list<Node*>* children = root->getChildren();
+	for (std::list<Node*>::const_iterator it = children->cbegin();
+		it != children->cend(); it++)
+	{
+		legs.push_back(*it);
+	}
+	legs.erase(legs.begin());
+	legs.pop_back();
+
+	/* Swing the legs from where they rest, which setting frame 0 changes */
+	std::vector<float> restRotations;
+	for (unsigned int i = 0; i < legs.size(); i++)
+	{
+		restRotations.push_back(legs[i]->getRotation());
+	}
+
+	unsigned int lastFrame = numFrames - 1;
+	unsigned int numSteps = std::max(lastFrame / FRAMES_PER_STEP, 1u);
+	for (unsigned int step = 0; step <= numSteps; step++)
+	{
+		unsigned int frameNum = step * lastFrame / numSteps;
+
+		/* Walk the body from the left of the view to the right */
+		float x = -6.0f + 12.0f * frameNum / lastFrame;
+		root->setTransformation(
+			mat3::scale2D(root->getScaleX(), root->getScaleY()),
+			mat3::rotation2D(root->getRotation()),
+			mat3::translation2D(x, root->getTranslationY()), frameNum);
+
+		/* Swing each pair of opposite legs the other way every step */
+		for (unsigned int i = 0; i < legs.size(); i++)
+		{
+			float swing = ((step + i / 2 + i % 2) % 2 == 0) ? LEG_SWING :
+				-LEG_SWING;
+			legs[i]->setTransformation(
+				mat3::scale2D(legs[i]->getScaleX(), legs[i]->getScaleY()),
+				mat3::rotation2D(restRotations[i] + swing),
+				mat3::translation2D(legs[i]->getTranslationX(),
+				legs[i]->getTranslationY()), frameNum);
+		}
+	}
+	return root;
+}
@@ -0,0 +1,34 @@
+/*
+ * SceneLibrary.h
+ * Created by Zachary Ferguson
+ * Header file for the SceneLibrary class, a class for building the scene
+ * graphs that come with the editor, for the windows and the batch renderer.
+ */
+
+#ifndef SCENELIBRARY_H
+#define SCENELIBRARY_H
+
+/* Include necessary types */
+#include <string>
+#include "Node.h"
+
+class SceneLibrary
+{
+	public:
+
+		/* Returns the scene graph with the given name, "animal" or   */
+		/* "walk", animated over the given number of frames, or NULL  */
+		/* if there is no scene graph with that name.                 */
+		static Node* createSceneGraph(const std::string& name,
+			unsigned int numFrames);
+
+		/* Create the original animal scene graph */
+		static Node* createAnimalSceneGraph();
+
+		/* Creates the animal scene graph walking across the view over */
+		/* the given number of frames, swinging its legs at every      */
+		/* keyframe.                                                   */
+		static Node* createWalkingAnimalSceneGraph(unsigned int numFrames);
+};
+
+#endif
@@ -0,0 +1,205 @@
+/*
+ * SceneLoader.cpp
+ * Created by Zachary Ferguson
+ * Source file for the SceneLoader class, a class for loading a scene file on
+ * a background thread. The scene is built a piece at a time, top levels
+ * first, and each finished subtree is handed to the UI thread to be added to
+ * the scene graph, so a large scene shows up while the rest of it loads.
+ * JSON scenes are read whole and handed over as one piece.
+ */
+
+#include "SceneLoader.h"
+#include <deque>
+#include "SceneJSON.h"
+
+/* Constructor for a SceneLoader of the scene file at the given path. The */
+/* notify function is called with the given data on the loading thread    */
+/* whenever pieces are waiting to be taken, and when loading is over.     */
+SceneLoader::SceneLoader(const std::string& path, void (*notify)(void* data),
+	void* data) : cancelled(false)
+{
+	this->path = path;
+	this->notify = notify;
+	this->notifyData = data;
+	this->notified = false;
+	this->done = false;
+	this->failed = false;
+}
+
+/* Destructor for the SceneLoader, stops loading and deletes the pieces not */
+/* taken.                                                                   */
+SceneLoader::~SceneLoader()
+{
+	this->cancelled = true;
+	if (this->worker.joinable())
+	{
+		this->worker.join();
+	}
+	for (unsigned int i = 0; i < this->finished.size(); i++)
+	{
+		delete this->finished[i].subtree;
+	}
+}
+
+/* Starts loading on a background thread. */
+void SceneLoader::start()
+{
+	this->worker = std::thread(&SceneLoader::load, this);
+}
+
+/* Adds a finished piece, notifying if none were waiting. */
+void SceneLoader::post(const Piece& piece)
+{
+	bool wake;
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		this->finished.push_back(piece);
+		wake = !(this->notified);
+		this->notified = true;
+	}
+	if (wake)
+	{
+		this->notify(this->notifyData);
+	}
+}
+
+/* Marks loading as over, notifying if nothing was waiting. */
+void SceneLoader::finish(bool failed)
+{
+	bool wake;
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		this->done = true;
+		this->failed = failed;
+		wake = !(this->notified);
+		this->notified = true;
+	}
+	if (wake)
+	{
+		this->notify(this->notifyData);
+	}
+}
+
+/* Opens the file and builds its pieces. Run by the loading thread. */
+void SceneLoader::load()
+{
+	if (SceneJSON::isJSONPath(this->path))
+	{
+		this->loadJSON();
+		return;
+	}
+
+	/* Checks every node before any is handed over */
+	if (!(this->file.open(this->path)))
+	{
+		this->finish(true);
+		return;
+	}
+
+	/* Go through the subtrees breadth first so the top levels are shown */
+	/* first. Small subtrees are built whole, large ones are split into  */
+	/* their root and their children's subtrees.                         */
+	std::deque<unsigned int> subtrees(1, 0);
+	while (!subtrees.empty() && !(this->cancelled))
+	{
+		unsigned int i = subtrees.front();
+		subtrees.pop_front();
+		unsigned int size = this->file.getSubtreeSize(i);
+
+		Piece piece;
+		piece.index = i;
+		piece.parent = this->file.getParent(i);
+		if (size <= SCENE_PIECE_SIZE)
+		{
+			piece.subtree = this->file.createSubtree(i);
+		}
+		else
+		{
+			piece.subtree = this->file.createNode(i);
+
+			/* Children follow each other in preorder, each after the */
+			/* whole subtree of the one before it                     */
+			for (unsigned int child = i + 1; child < i + size;
+				child += this->file.getSubtreeSize(child))
+			{
+				subtrees.push_back(child);
+			}
+		}
+		this->post(piece);
+	}
+
+	this->file.close();
+	this->finish(false);
+}
+
+/* Reads a JSON scene and hands it over as one piece. Run by the loading */
+/* thread.                                                               */
+void SceneLoader::loadJSON()
+{
+	/* Text has no index of the nodes to build pieces from */
+	std::map<const Node*, std::string> labels;
+	std::string error;
+	Node* root = SceneJSON::load(this->path, labels, error);
+	if (root == NULL)
+	{
+		{
+			std::lock_guard<std::mutex> lock(this->mutex);
+			this->error = error;
+		}
+		this->finish(true);
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		this->labels.swap(labels);
+	}
+
+	Piece piece;
+	piece.subtree = root;
+	piece.index = 0;
+	piece.parent = -1;
+	this->post(piece);
+	this->finish(false);
+}
+
+/* Moves the pieces finished so far, in order, to the end of pieces. */
+/* Returns if more pieces may still be finished.                     */
+bool SceneLoader::takePieces(std::vector<Piece>& pieces)
+{
+	std::lock_guard<std::mutex> lock(this->mutex);
+	pieces.insert(pieces.end(), this->finished.begin(), this->finished.end());
+	this->finished.clear();
+	this->notified = false;
+	return !(this->done);
+}
+
+/* Returns if the file could not be read. Only valid once takePieces has */
+/* returned false.                                                       */
+bool SceneLoader::getFailed()
+{
+	std::lock_guard<std::mutex> lock(this->mutex);
+	return this->failed;
+}
+
+/* Moves the tree labels of the nodes of the pieces taken so far to labels. */
+/* Only JSON scenes have labels.                                            */
+void SceneLoader::takeLabels(std::map<const Node*, std::string>& labels)
+{
+	std::lock_guard<std::mutex> lock(this->mutex);
+	labels.insert(this->labels.begin(), this->labels.end());
+	this->labels.clear();
+}
+
+/* Returns what went wrong if the file could not be read, or an empty */
+/* string if nothing more is known.                                   */
+std::string SceneLoader::getError()
+{
+	std::lock_guard<std::mutex> lock(this->mutex);
+	return this->error;
+}
+
+/* Returns the path of the scene file. */
+const std::string& SceneLoader::getPath() const
+{
+	return this->path;
+}
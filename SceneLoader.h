@@ -0,0 +1,120 @@
+/*
+ * SceneLoader.h
+ * Created by Zachary Ferguson
+ * Header file for the SceneLoader class, a class for loading a scene file on
+ * a background thread. The scene is built a piece at a time, top levels
+ * first, and each finished subtree is handed to the UI thread to be added to
+ * the scene graph, so a large scene shows up while the rest of it loads.
+ * JSON scenes are read whole and handed over as one piece.
+ */
+
+#ifndef SCENELOADER_H
+#define SCENELOADER_H
+
+/* Include necessary types */
+#include <vector>
+#include <map>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include "SceneFile.h"
+
+/* Largest subtree, in nodes, built and handed over as one piece. Larger */
+/* subtrees are handed over a node at a time down to this size.          */
+#define SCENE_PIECE_SIZE 256
+
+class SceneLoader
+{
+	public:
+
+		/* A finished subtree of the scene, the index of its root in the */
+		/* file, and the index of its parent, -1 for the scene's root.   */
+		/* The parent is always handed over before its children.         */
+		struct Piece
+		{
+			Node* subtree;
+			unsigned int index;
+			int parent;
+		};
+
+	private:
+
+		/* The scene file being loaded. */
+		std::string path;
+		SceneFile file;
+
+		/* Called on the loading thread when pieces are waiting. */
+		void (*notify)(void* data);
+		void* notifyData;
+
+		/* The loading thread. */
+		std::thread worker;
+
+		/* Set to stop loading. */
+		std::atomic<bool> cancelled;
+
+		/** State shared with the loading thread, guarded by the mutex. **/
+		std::mutex mutex;
+		/* Pieces finished but not yet taken. */
+		std::vector<Piece> finished;
+		/* If notify has been called since the pieces were last taken. */
+		bool notified;
+		/* If loading is over, and if the file could not be read. */
+		bool done, failed;
+		/* What went wrong reading a JSON scene. */
+		std::string error;
+		/* Tree labels of the nodes of a JSON scene. */
+		std::map<const Node*, std::string> labels;
+
+		/* Adds a finished piece, notifying if none were waiting. */
+		void post(const Piece& piece);
+
+		/* Marks loading as over, notifying if nothing was waiting. */
+		void finish(bool failed);
+
+		/* Opens the file and builds its pieces. Run by the loading */
+		/* thread.                                                  */
+		void load();
+
+		/* Reads a JSON scene and hands it over as one piece. Run by */
+		/* the loading thread.                                       */
+		void loadJSON();
+
+	public:
+
+		/* Constructor for a SceneLoader of the scene file at the given   */
+		/* path. The notify function is called with the given data on the */
+		/* loading thread whenever pieces are waiting to be taken, and    */
+		/* when loading is over.                                          */
+		SceneLoader(const std::string& path, void (*notify)(void* data),
+			void* data);
+
+		/* Destructor for the SceneLoader, stops loading and deletes the */
+		/* pieces not taken.                                             */
+		virtual ~SceneLoader();
+
+		/* Starts loading on a background thread. */
+		void start();
+
+		/* Moves the pieces finished so far, in order, to the end of */
+		/* pieces. Returns if more pieces may still be finished.     */
+		bool takePieces(std::vector<Piece>& pieces);
+
+		/* Returns if the file could not be read. Only valid once */
+		/* takePieces has returned false.                         */
+		bool getFailed();
+
+		/* Moves the tree labels of the nodes of the pieces taken so  */
+		/* far to labels. Only JSON scenes have labels.               */
+		void takeLabels(std::map<const Node*, std::string>& labels);
+
+		/* Returns what went wrong if the file could not be read, or an */
+		/* empty string if nothing more is known.                       */
+		std::string getError();
+
+		/* Returns the path of the scene file. */
+		const std::string& getPath() const;
+};
+
+#endif
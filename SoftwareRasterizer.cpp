@@ -0,0 +1,330 @@
+/*
+ * SoftwareRasterizer.cpp
+ * Created by Zachary Ferguson
+ * Source file for the SoftwareRasterizer class, a class for drawing a
+ * RenderBatch into an in-memory RGB framebuffer on the CPU, so frames can be
+ * rendered without a window or a GPU.
+ */
+
+#include "SoftwareRasterizer.h"
+#include <algorithm> /* Included for min, max, and swap        */
+#include <cmath>     /* Included for floor, fabs, and isfinite */
+
+/* Converts a color channel from 0-1 to a byte. */
+static unsigned char toByte(float value)
+{
+	value = std::min(std::max(value, 0.0f), 1.0f);
+	return (unsigned char)(value * 255.0f + 0.5f);
+}
+
+/* Returns the column or row a pixel coordinate falls in, clamped to just */
+/* outside a framebuffer side of the given size first, so coordinates far */
+/* off the framebuffer convert to an int safely. Must be finite.          */
+static int toIndex(float coordinate, unsigned int size)
+{
+	coordinate = std::min(std::max(coordinate, -1.0f), (float)size + 1.0f);
+	return (int)floor(coordinate);
+}
+
+/* Constructor for a SoftwareRasterizer with a framebuffer of the given size, */
+/* cleared to black.                                                          */
+SoftwareRasterizer::SoftwareRasterizer(unsigned int width, unsigned int height)
+{
+	this->resize(width, height);
+}
+
+/* Destructor for the SoftwareRasterizer */
+SoftwareRasterizer::~SoftwareRasterizer()
+{
+
+}
+
+/* Changes the size of the framebuffer. The contents are lost. */
+void SoftwareRasterizer::resize(unsigned int width, unsigned int height)
+{
+	this->width = width;
+	this->height = height;
+	this->pixels.assign(3 * width * height, 0);
+	this->clip = this->getBounds();
+}
+
+/* Returns the width of the framebuffer in pixels. */
+unsigned int SoftwareRasterizer::getWidth() const
+{
+	return this->width;
+}
+
+/* Returns the height of the framebuffer in pixels. */
+unsigned int SoftwareRasterizer::getHeight() const
+{
+	return this->height;
+}
+
+/* Returns the rectangle of the whole framebuffer. */
+SoftwareRasterizer::Rect SoftwareRasterizer::getBounds() const
+{
+	Rect bounds = {0, 0, (int)(this->width), (int)(this->height)};
+	return bounds;
+}
+
+/* Sets every pixel to the given color. */
+void SoftwareRasterizer::clear(float red, float green, float blue)
+{
+	this->clear(red, green, blue, this->getBounds());
+}
+
+/* Sets the pixels in the rectangle to the given color. */
+void SoftwareRasterizer::clear(float red, float green, float blue,
+	const Rect& rect)
+{
+	const unsigned char color[3] = {toByte(red), toByte(green), toByte(blue)};
+	int left = std::max(rect.left, 0);
+	int right = std::min(rect.right, (int)(this->width));
+	int bottom = std::max(rect.bottom, 0);
+	int top = std::min(rect.top, (int)(this->height));
+	for (int row = bottom; row < top; row++)
+	{
+		unsigned char* pixel = &(this->pixels[0]) + 3 * (row * this->width +
+			left);
+		for (int column = left; column < right; column++, pixel += 3)
+		{
+			pixel[0] = color[0];
+			pixel[1] = color[1];
+			pixel[2] = color[2];
+		}
+	}
+}
+
+/* Converts scene coordinates to pixel coordinates. */
+void SoftwareRasterizer::toPixel(float x, float y, float& px, float& py) const
+{
+	px = (x - VIEW_LEFT) / (VIEW_RIGHT - VIEW_LEFT) * this->width;
+	py = (y - VIEW_BOTTOM) / (VIEW_TOP - VIEW_BOTTOM) * this->height;
+}
+
+/* Sets the pixel at the given column and row to the color. */
+void SoftwareRasterizer::setPixel(int column, int row,
+	const unsigned char color[3])
+{
+	if (column >= this->clip.left && row >= this->clip.bottom &&
+		column < this->clip.right && row < this->clip.top)
+	{
+		unsigned char* pixel = &(this->pixels[3 * (row * this->width +
+			column)]);
+		pixel[0] = color[0];
+		pixel[1] = color[1];
+		pixel[2] = color[2];
+	}
+}
+
+/* Fills the triangle with the three given points. Pixels whose centers lie */
+/* on an edge shared by two triangles are only filled once.                 */
+void SoftwareRasterizer::fillTriangle(const float* points,
+	const unsigned char color[3])
+{
+	float x[3], y[3];
+	for (int i = 0; i < 3; i++)
+	{
+		this->toPixel(points[2 * i], points[2 * i + 1], x[i], y[i]);
+		if (!std::isfinite(x[i]) || !std::isfinite(y[i]))
+		{
+			return;
+		}
+	}
+
+	/* Make the triangle counter-clockwise so the inside is on the left */
+	/* of every edge.                                                   */
+	float area = (x[1] - x[0]) * (y[2] - y[0]) - (y[1] - y[0]) * (x[2] - x[0]);
+	if (area == 0)
+	{
+		return;
+	}
+	if (area < 0)
+	{
+		std::swap(x[1], x[2]);
+		std::swap(y[1], y[2]);
+	}
+
+	/* Only look at the pixels in the bounding box */
+	int minColumn = std::max(toIndex(std::min(std::min(x[0], x[1]), x[2]),
+		this->width), 0);
+	int maxColumn = std::min(toIndex(std::max(std::max(x[0], x[1]), x[2]),
+		this->width), (int)(this->width) - 1);
+	int minRow = std::max(toIndex(std::min(std::min(y[0], y[1]), y[2]),
+		this->height), 0);
+	int maxRow = std::min(toIndex(std::max(std::max(y[0], y[1]), y[2]),
+		this->height), (int)(this->height) - 1);
+	if (minColumn > maxColumn || minRow > maxRow ||
+		maxColumn < this->clip.left || minColumn >= this->clip.right ||
+		maxRow < this->clip.bottom || minRow >= this->clip.top)
+	{
+		return;
+	}
+
+	/* Set up the edge functions at the first pixel center. Each edge    */
+	/* function is positive on the inside of its edge and changes by a   */
+	/* constant amount per column and per row. Centers exactly on an     */
+	/* edge are only inside for left and top edges, so triangles sharing */
+	/* an edge do not both fill it.                                      */
+	float rowStart[3], stepColumn[3], stepRow[3];
+	bool inclusive[3];
+	float startX = minColumn + 0.5f, startY = minRow + 0.5f;
+	for (int i = 0; i < 3; i++)
+	{
+		int j = (i + 1) % 3;
+		float dx = x[j] - x[i], dy = y[j] - y[i];
+		rowStart[i] = dx * (startY - y[i]) - dy * (startX - x[i]);
+		stepColumn[i] = -dy;
+		stepRow[i] = dx;
+		inclusive[i] = dy < 0 || (dy == 0 && dx < 0);
+	}
+
+	/* The edge functions are still stepped from the first pixel of the */
+	/* bounding box when clipped, so every pixel gets the same values,  */
+	/* and is filled the same, as when the whole triangle is drawn.     */
+	maxColumn = std::min(maxColumn, this->clip.right - 1);
+	maxRow = std::min(maxRow, this->clip.top - 1);
+	for (int row = minRow; row <= maxRow; row++)
+	{
+		if (row < this->clip.bottom)
+		{
+			rowStart[0] += stepRow[0];
+			rowStart[1] += stepRow[1];
+			rowStart[2] += stepRow[2];
+			continue;
+		}
+
+		float e[3] = {rowStart[0], rowStart[1], rowStart[2]};
+		unsigned char* pixel = &(this->pixels[3 * (row * this->width +
+			minColumn)]);
+		for (int column = minColumn; column <= maxColumn; column++, pixel += 3)
+		{
+			if (column >= this->clip.left &&
+				(e[0] > 0 || (e[0] == 0 && inclusive[0])) &&
+				(e[1] > 0 || (e[1] == 0 && inclusive[1])) &&
+				(e[2] > 0 || (e[2] == 0 && inclusive[2])))
+			{
+				pixel[0] = color[0];
+				pixel[1] = color[1];
+				pixel[2] = color[2];
+			}
+			e[0] += stepColumn[0];
+			e[1] += stepColumn[1];
+			e[2] += stepColumn[2];
+		}
+		rowStart[0] += stepRow[0];
+		rowStart[1] += stepRow[1];
+		rowStart[2] += stepRow[2];
+	}
+}
+
+/* Draws a one pixel wide line between the two given points, not including */
+/* the last pixel, so line strips have no overlap.                         */
+void SoftwareRasterizer::drawLine(const float* points,
+	const unsigned char color[3])
+{
+	float x0, y0, x1, y1;
+	this->toPixel(points[0], points[1], x0, y0);
+	this->toPixel(points[2], points[3], x1, y1);
+	if (!std::isfinite(x0) || !std::isfinite(y0) || !std::isfinite(x1) ||
+		!std::isfinite(y1))
+	{
+		return;
+	}
+	float dx = x1 - x0, dy = y1 - y0;
+
+	/* Step one pixel at a time along the longer axis, plotting the pixel */
+	/* the line crosses at each column or row center.                     */
+	if (fabs(dx) >= fabs(dy))
+	{
+		if (dx == 0)
+		{
+			return;
+		}
+		float slope = dy / dx;
+		int first = toIndex(std::min(x0, x1) + 0.5f, this->width);
+		int last = toIndex(std::max(x0, x1) + 0.5f, this->width);
+		first = std::max(first, this->clip.left);
+		last = std::min(last, this->clip.right);
+		for (int column = first; column < last; column++)
+		{
+			float y = y0 + slope * (column + 0.5f - x0);
+			this->setPixel(column, toIndex(y, this->height), color);
+		}
+	}
+	else
+	{
+		float slope = dx / dy;
+		int first = toIndex(std::min(y0, y1) + 0.5f, this->height);
+		int last = toIndex(std::max(y0, y1) + 0.5f, this->height);
+		first = std::max(first, this->clip.bottom);
+		last = std::min(last, this->clip.top);
+		for (int row = first; row < last; row++)
+		{
+			float x = x0 + slope * (row + 0.5f - y0);
+			this->setPixel(toIndex(x, this->width), row, color);
+		}
+	}
+}
+
+/* Draws every primitive in the batch in the order they were added, the  */
+/* same as GLWindow.                                                     */
+void SoftwareRasterizer::draw(const RenderBatch& batch)
+{
+	this->draw(batch, this->getBounds());
+}
+
+/* Draws the part of every primitive in the batch inside the rectangle,    */
+/* leaving the pixels outside alone. The pixels inside come out exactly as */
+/* if the whole batch were drawn, so only the part of a frame that changed */
+/* needs redrawing.                                                        */
+void SoftwareRasterizer::draw(const RenderBatch& batch, const Rect& rect)
+{
+	this->clip.left = std::max(rect.left, 0);
+	this->clip.bottom = std::max(rect.bottom, 0);
+	this->clip.right = std::min(rect.right, (int)(this->width));
+	this->clip.top = std::min(rect.top, (int)(this->height));
+	if (this->clip.left >= this->clip.right ||
+		this->clip.bottom >= this->clip.top)
+	{
+		this->clip = this->getBounds();
+		return;
+	}
+
+	/* Every vertex of a primitive has the same color. Primitives are */
+	/* drawn in the order they were added, the same as GLWindow.      */
+	for (unsigned int r = 0; r < batch.getNumRuns(); r++)
+	{
+		const RenderBatch::Run& run = batch.getRun(r);
+		const float* positions = batch.getPositions(run.type);
+		const float* colors = batch.getColors(run.type);
+		unsigned int perPrimitive = (run.type == RenderBatch::TRIANGLES) ?
+			3 : 2;
+		unsigned int end = run.first + run.count;
+		for (unsigned int v = run.first; v < end; v += perPrimitive)
+		{
+			const float* rgb = colors + 3 * v;
+			const unsigned char color[3] = {
+				toByte(rgb[0]), toByte(rgb[1]), toByte(rgb[2])
+			};
+			if (run.type == RenderBatch::TRIANGLES)
+			{
+				this->fillTriangle(positions + 2 * v, color);
+			}
+			else
+			{
+				this->drawLine(positions + 2 * v, color);
+			}
+		}
+	}
+
+	this->clip = this->getBounds();
+}
+
+/* Returns the RGB bytes of the framebuffer, starting with the bottom row, */
+/* the layout glReadPixels uses with GL_RGB, GL_UNSIGNED_BYTE, and a pack  */
+/* alignment of 1.                                                         */
+const unsigned char* SoftwareRasterizer::getPixels() const
+{
+	return this->pixels.empty() ? NULL : &(this->pixels[0]);
+}
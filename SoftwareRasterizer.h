@@ -0,0 +1,96 @@
+/*
+ * SoftwareRasterizer.h
+ * Created by Zachary Ferguson
+ * Header file for the SoftwareRasterizer class, a class for drawing a
+ * RenderBatch into an in-memory RGB framebuffer on the CPU, so frames can be
+ * rendered without a window or a GPU.
+ */
+
+#ifndef SOFTWARERASTERIZER_H
+#define SOFTWARERASTERIZER_H
+
+/* Include necessary types */
+#include <vector>
+#include "RenderBatch.h"
+
+class SoftwareRasterizer
+{
+	public:
+
+		/* A rectangle of pixels, the columns from left to right - 1 and */
+		/* the rows from bottom to top - 1. Empty if either is empty.    */
+		struct Rect
+		{
+			int left, bottom, right, top;
+		};
+
+	private:
+
+		/* Size of the framebuffer in pixels. */
+		unsigned int width, height;
+
+		/* The pixels being drawn, nothing outside is changed. The whole */
+		/* framebuffer except while drawing part of it.                  */
+		Rect clip;
+
+		/* RGB bytes of each pixel, starting with the bottom row like */
+		/* glReadPixels.                                              */
+		std::vector<unsigned char> pixels;
+
+		/* Converts scene coordinates to pixel coordinates. */
+		void toPixel(float x, float y, float& px, float& py) const;
+
+		/* Sets the pixel at the given column and row to the color. */
+		void setPixel(int column, int row, const unsigned char color[3]);
+
+		/* Fills the triangle with the three given points. Pixels whose */
+		/* centers lie on an edge shared by two triangles are only      */
+		/* filled once.                                                 */
+		void fillTriangle(const float* points, const unsigned char color[3]);
+
+		/* Draws a one pixel wide line between the two given points, not */
+		/* including the last pixel, so line strips have no overlap.     */
+		void drawLine(const float* points, const unsigned char color[3]);
+
+	public:
+
+		/* Constructor for a SoftwareRasterizer with a framebuffer of the */
+		/* given size, cleared to black.                                  */
+		SoftwareRasterizer(unsigned int width, unsigned int height);
+
+		/* Destructor for the SoftwareRasterizer */
+		virtual ~SoftwareRasterizer();
+
+		/* Changes the size of the framebuffer. The contents are lost. */
+		void resize(unsigned int width, unsigned int height);
+
+		/* Returns the size of the framebuffer in pixels. */
+		unsigned int getWidth() const;
+		unsigned int getHeight() const;
+
+		/* Returns the rectangle of the whole framebuffer. */
+		Rect getBounds() const;
+
+		/* Sets every pixel to the given color. */
+		void clear(float red, float green, float blue);
+
+		/* Sets the pixels in the rectangle to the given color. */
+		void clear(float red, float green, float blue, const Rect& rect);
+
+		/* Draws every primitive in the batch in the order they were */
+		/* added, the same as GLWindow.                              */
+		void draw(const RenderBatch& batch);
+
+		/* Draws the part of every primitive in the batch inside the    */
+		/* rectangle, leaving the pixels outside alone. The pixels      */
+		/* inside come out exactly as if the whole batch were drawn, so */
+		/* only the part of a frame that changed needs redrawing.       */
+		void draw(const RenderBatch& batch, const Rect& rect);
+
+		/* Returns the RGB bytes of the framebuffer, starting with the */
+		/* bottom row, the layout glReadPixels uses with GL_RGB,       */
+		/* GL_UNSIGNED_BYTE, and a pack alignment of 1.                */
+		const unsigned char* getPixels() const;
+};
+
+#endif
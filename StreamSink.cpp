@@ -0,0 +1,113 @@
+/*
+ * StreamSink.cpp
+ * Created by Zachary Ferguson
+ * Source file for the StreamSink class, the base class for FrameSinks that
+ * write every frame to one stream, either stdout or a file such as a named
+ * pipe. An external encoder can read the frames as they are written.
+ */
+
+/* Allows fopen, fopen_s is only available on Windows */
+#define _CRT_SECURE_NO_WARNINGS
+
+#include "StreamSink.h"
+#include <iostream> /* Included for flushing cout */
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#else
+#include <unistd.h>
+#include <signal.h>
+#endif
+
+/* If a stream has been written to stdout. Closing the stream closes      */
+/* stdout so the reader sees the end of the stream, which means it can    */
+/* only be streamed to once.                                              */
+static bool stdoutUsed = false;
+
+/* Constructor for a StreamSink that writes to the file with the given name, */
+/* or to stdout if it is empty or "-".                                       */
+StreamSink::StreamSink(const std::string& path)
+{
+	this->path = path;
+	this->stream = NULL;
+	this->toStdout = path.empty() || path == "-";
+}
+
+/* Destructor for the StreamSink, closes the stream. */
+StreamSink::~StreamSink()
+{
+	this->close();
+}
+
+/* Opens the stream and writes the header. Once stdout is streamed to,     */
+/* anything else printed to stdout goes to stderr instead, and it can not  */
+/* be streamed to again. Returns if the stream was opened.                 */
+bool StreamSink::open(unsigned int width, unsigned int height,
+	double framerate)
+{
+	this->close();
+
+#ifndef _WIN32
+	/* Report a reader closing the pipe as a failed write instead of */
+	/* being killed by SIGPIPE                                       */
+	signal(SIGPIPE, SIG_IGN);
+#endif
+
+	if (this->toStdout)
+	{
+		if (stdoutUsed)
+		{
+			return false;
+		}
+		stdoutUsed = true;
+
+		/* Take stdout for the frames and send everything else printed */
+		/* to stdout to stderr from now on                             */
+		std::cout.flush();
+		fflush(stdout);
+#ifdef _WIN32
+		int streamFile = _dup(_fileno(stdout));
+		_dup2(_fileno(stderr), _fileno(stdout));
+		_setmode(streamFile, _O_BINARY);
+		this->stream = _fdopen(streamFile, "wb");
+#else
+		int streamFile = dup(fileno(stdout));
+		dup2(fileno(stderr), fileno(stdout));
+		this->stream = fdopen(streamFile, "wb");
+#endif
+	}
+	else
+	{
+		this->stream = fopen(this->path.c_str(), "wb");
+	}
+	if (this->stream == NULL)
+	{
+		return false;
+	}
+	setvbuf(this->stream, NULL, _IOFBF, STREAM_BUFFER_SIZE);
+
+	std::string bytes = this->header(width, height, framerate);
+	return bytes.empty() ||
+		fwrite(bytes.data(), 1, bytes.size(), this->stream) == bytes.size();
+}
+
+/* Writes the encoded frame to the stream. */
+bool StreamSink::write(unsigned int frameNum,
+	const std::vector<unsigned char>& bytes)
+{
+	return this->stream != NULL && (bytes.empty() ||
+		fwrite(&bytes[0], 1, bytes.size(), this->stream) == bytes.size());
+}
+
+/* Flushes and closes the stream. Returns if everything was written. */
+bool StreamSink::close()
+{
+	if (this->stream == NULL)
+	{
+		return true;
+	}
+
+	bool written = fclose(this->stream) == 0;
+	this->stream = NULL;
+	return written;
+}
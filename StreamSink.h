@@ -0,0 +1,65 @@
+/*
+ * StreamSink.h
+ * Created by Zachary Ferguson
+ * Header file for the StreamSink class, the base class for FrameSinks that
+ * write every frame to one stream, either stdout or a file such as a named
+ * pipe. An external encoder can read the frames as they are written.
+ */
+
+#ifndef STREAMSINK_H
+#define STREAMSINK_H
+
+/* Include necessary types */
+#include <string>
+#include <cstdio> /* Included for FILE */
+#include "FrameSink.h"
+
+/* Size of the buffer in front of the stream. */
+#define STREAM_BUFFER_SIZE (1 << 20)
+
+class StreamSink : public FrameSink
+{
+	private:
+
+		/* Name of the file to write to, empty or "-" for stdout. */
+		std::string path;
+
+		/* The open stream, NULL when closed. */
+		FILE* stream;
+
+		/* If the stream is stdout. */
+		bool toStdout;
+
+	protected:
+
+		/* Returns the bytes written once before the first frame for */
+		/* frames of the given size and frame rate.                  */
+		virtual std::string header(unsigned int width, unsigned int height,
+			double framerate) const = 0;
+
+	public:
+
+		/* Constructor for a StreamSink that writes to the file with the */
+		/* given name, or to stdout if it is empty or "-".               */
+		StreamSink(const std::string& path);
+
+		/* Destructor for the StreamSink, closes the stream. */
+		virtual ~StreamSink();
+
+		/* Opens the stream and writes the header. Once stdout is      */
+		/* streamed to, anything else printed to stdout goes to stderr */
+		/* instead, and it can not be streamed to again. Returns if    */
+		/* the stream was opened.                                      */
+		virtual bool open(unsigned int width, unsigned int height,
+			double framerate);
+
+		/* Writes the encoded frame to the stream. */
+		virtual bool write(unsigned int frameNum,
+			const std::vector<unsigned char>& bytes);
+
+		/* Flushes and closes the stream. Returns if everything was */
+		/* written.                                                 */
+		virtual bool close();
+};
+
+#endif
@@ -0,0 +1,462 @@
+/*
+ * UndoHistory.cpp
+ * Created by Zachary Ferguson
+ * Source file for the UndoHistory class, the undo and redo stacks of the
+ * editor. Each step keeps only what its edit changed: the keyframes edited
+ * with their old values, the Nodes keyed, or the Node added or removed. Undoing
+ * a step never copies the scene graph, and the oldest steps are dropped once
+ * the history uses more memory than its limit.
+ */
+
+#include "UndoHistory.h"
+#include <algorithm> /* Included for find */
+
+/* Constructor for an UndoHistory that may use the given bytes of memory. */
+UndoHistory::UndoHistory(size_t memoryLimit)
+{
+	this->memoryLimit = memoryLimit;
+	this->memoryUsed = 0;
+}
+
+/* Destructor for the UndoHistory, deleting the Nodes out of the scene graph */
+/* that it keeps.                                                            */
+UndoHistory::~UndoHistory()
+{
+	this->clear();
+}
+
+/* Returns the open step of the given source at the given frame, starting a */
+/* new one if there is none.                                                */
+UndoHistory::Step* UndoHistory::openStep(const void* source,
+	unsigned int frameNum)
+{
+	if (source != NULL && !(this->undoSteps.empty()) &&
+		this->redoSteps.empty())
+	{
+		Step* newest = this->undoSteps.back();
+		if (newest->open && newest->source == source &&
+			newest->frameNum == frameNum)
+		{
+			return newest;
+		}
+	}
+
+	Step* step = new Step();
+	step->source = source;
+	step->frameNum = frameNum;
+	step->open = source != NULL;
+	step->keyedInterpolated = false;
+	step->keyedSubtree = false;
+	step->structure = NO_CHANGE;
+	step->parent = NULL;
+	step->child = NULL;
+	step->nextSibling = NULL;
+	step->detached = false;
+	step->bytes = 0;
+	this->pushStep(step);
+	return step;
+}
+
+/* Adds the step to the undo stack, dropping the steps that could be */
+/* redone.                                                           */
+void UndoHistory::pushStep(Step* step)
+{
+	for (unsigned int i = 0; i < this->redoSteps.size(); i++)
+	{
+		this->deleteStep(this->redoSteps[i]);
+	}
+	this->redoSteps.clear();
+	this->endStep();
+	this->undoSteps.push_back(step);
+	this->account(step);
+}
+
+/* Works out the memory the step uses again after it changes. */
+void UndoHistory::account(Step* step)
+{
+	this->memoryUsed -= step->bytes;
+	step->bytes = UndoHistory::stepBytes(step);
+	this->memoryUsed += step->bytes;
+}
+
+/* Drops the oldest steps until the history fits in its memory limit, */
+/* always keeping the newest one.                                     */
+void UndoHistory::evict()
+{
+	while (this->memoryUsed > this->memoryLimit &&
+		this->undoSteps.size() > 1)
+	{
+		this->deleteStep(this->undoSteps.front());
+		this->undoSteps.pop_front();
+	}
+}
+
+/* Deletes the step, and its Node if it is out of the scene graph. */
+void UndoHistory::deleteStep(Step* step)
+{
+	this->memoryUsed -= step->bytes;
+	if (step->detached)
+	{
+		UndoHistory::deleteSubtree(step->child);
+	}
+	delete step;
+}
+
+/* Takes the step's Node out of the scene graph, moving the labels of its */
+/* subtree from the given labels into the step.                           */
+void UndoHistory::detach(Step* step,
+	std::map<const Node*, std::string>& labels)
+{
+	step->nextSibling = UndoHistory::findNextSibling(step->parent,
+		step->child);
+	step->parent->removeChild(step->child);
+	UndoHistory::moveLabels(step->child, labels, step->labels);
+	step->detached = true;
+}
+
+/* Puts the step's Node back in the scene graph, moving the labels of its */
+/* subtree from the step into the given labels.                           */
+void UndoHistory::attach(Step* step,
+	std::map<const Node*, std::string>& labels)
+{
+	step->parent->insertChild(step->child, step->nextSibling);
+	UndoHistory::moveLabels(step->child, step->labels, labels);
+	step->detached = false;
+}
+
+/* Returns the child after the given child of the given parent, NULL if it */
+/* is the last.                                                            */
+Node* UndoHistory::findNextSibling(const Node* parent, const Node* child)
+{
+	const std::list<Node*>* children = parent->getChildren();
+	std::list<Node*>::const_iterator it = std::find(children->cbegin(),
+		children->cend(), child);
+	if (it == children->cend() || ++it == children->cend())
+	{
+		return NULL;
+	}
+	return *it;
+}
+
+/* Adds the Nodes of the given subtree that are not keyed at the given */
+/* frame to keyed.                                                     */
+void UndoHistory::findUnkeyed(Node* node, unsigned int frameNum,
+	std::vector<Node*>& keyed)
+{
+	if (!(node->getTrack()->getIsKeyframe(frameNum)))
+	{
+		keyed.push_back(node);
+	}
+	for (std::list<Node*>::const_iterator it = node->getChildren()->cbegin();
+		it != node->getChildren()->cend(); ++it)
+	{
+		UndoHistory::findUnkeyed(*it, frameNum, keyed);
+	}
+}
+
+/* Returns the bytes of memory the step uses. */
+size_t UndoHistory::stepBytes(const Step* step)
+{
+	size_t bytes = sizeof(Step) +
+		step->changes.capacity() * sizeof(KeyframeChange) +
+		step->keyed.capacity() * sizeof(Node*);
+
+	/* Each label is a node of the map's tree */
+	for (std::map<const Node*, std::string>::const_iterator it =
+		step->labels.cbegin(); it != step->labels.cend(); ++it)
+	{
+		bytes += sizeof(*it) + 4 * sizeof(void*) + it->second.capacity();
+	}
+
+	/* The Node is only the history's while it is out of the scene graph */
+	if (step->detached)
+	{
+		bytes += UndoHistory::subtreeBytes(step->child);
+	}
+	return bytes;
+}
+
+/* Returns the bytes of memory the given Node's subtree uses. */
+size_t UndoHistory::subtreeBytes(const Node* node)
+{
+	size_t bytes = sizeof(Node) + sizeof(KeyframeTrack) +
+		node->getTrack()->getNumKeyframes() * (sizeof(unsigned int) +
+		2 * KeyframeTrack::NUM_CHANNELS * sizeof(float));
+	for (std::list<Node*>::const_iterator it = node->getChildren()->cbegin();
+		it != node->getChildren()->cend(); ++it)
+	{
+		bytes += UndoHistory::subtreeBytes(*it);
+	}
+	return bytes;
+}
+
+/* Moves the labels of the given Node's subtree between the maps. */
+void UndoHistory::moveLabels(const Node* node,
+	std::map<const Node*, std::string>& from,
+	std::map<const Node*, std::string>& to)
+{
+	std::map<const Node*, std::string>::iterator label = from.find(node);
+	if (label != from.end())
+	{
+		to[node].swap(label->second);
+		from.erase(label);
+	}
+	for (std::list<Node*>::const_iterator it = node->getChildren()->cbegin();
+		it != node->getChildren()->cend(); ++it)
+	{
+		UndoHistory::moveLabels(*it, from, to);
+	}
+}
+
+/* Deletes the given Node and its subtree. */
+void UndoHistory::deleteSubtree(Node* node)
+{
+	/* A Node does not delete its children */
+	for (std::list<Node*>::const_iterator it = node->getChildren()->cbegin();
+		it != node->getChildren()->cend(); ++it)
+	{
+		UndoHistory::deleteSubtree(*it);
+	}
+	delete node;
+}
+
+/* Records the keyframe of the given Node at the given frame before the */
+/* given source, usually a widget, edits it.                            */
+void UndoHistory::recordKeyframeEdit(Node* node, unsigned int frameNum,
+	const void* source)
+{
+	Step* step = this->openStep(source, frameNum);
+
+	/* Only the values from before the first edit are undone to */
+	for (unsigned int i = 0; i < step->changes.size(); i++)
+	{
+		if (step->changes[i].node == node &&
+			step->changes[i].frameNum == frameNum)
+		{
+			return;
+		}
+	}
+
+	KeyframeChange change;
+	change.node = node;
+	change.frameNum = frameNum;
+	change.wasKeyframe = node->getTrack()->getIsKeyframe(frameNum);
+	node->getTrack()->getValues(frameNum, Node::getInterpolated(),
+		change.oldValues);
+	step->changes.push_back(change);
+	this->account(step);
+	this->evict();
+}
+
+/* Records the Nodes of the given subtree that are not keyed at the given */
+/* frame before the given source keys the subtree there.                  */
+void UndoHistory::recordMakeKeyframe(Node* root, unsigned int frameNum,
+	const void* source)
+{
+	/* Every Node is keyed after the first time, so there is no need */
+	/* to look again                                                 */
+	Step* step = this->openStep(source, frameNum);
+	if (step->keyedSubtree)
+	{
+		return;
+	}
+	UndoHistory::findUnkeyed(root, frameNum, step->keyed);
+	step->keyedInterpolated = Node::getInterpolated();
+	step->keyedSubtree = true;
+	this->account(step);
+	this->evict();
+}
+
+/* Records adding the given Node to its parent, after it is added. */
+void UndoHistory::recordAddChild(Node* child)
+{
+	if (child->getParent() == NULL)
+	{
+		return;
+	}
+	Step* step = this->openStep(NULL, 0);
+	step->structure = ADD_CHILD;
+	step->parent = child->getParent();
+	step->child = child;
+	this->account(step);
+	this->evict();
+}
+
+/* Records removing the given Node from its parent, before it is removed. */
+/* The labels of its subtree are moved from the given labels. The history */
+/* keeps the Node once it is removed.                                     */
+void UndoHistory::recordRemoveChild(Node* child,
+	std::map<const Node*, std::string>& labels)
+{
+	if (child->getParent() == NULL)
+	{
+		return;
+	}
+	Step* step = this->openStep(NULL, 0);
+	step->structure = REMOVE_CHILD;
+	step->parent = child->getParent();
+	step->child = child;
+	step->nextSibling = UndoHistory::findNextSibling(step->parent, child);
+	UndoHistory::moveLabels(child, labels, step->labels);
+	step->detached = true;
+	this->account(step);
+	this->evict();
+}
+
+/* Ends the open step, so the next edit starts a new one. */
+void UndoHistory::endStep()
+{
+	if (!(this->undoSteps.empty()))
+	{
+		this->undoSteps.back()->open = false;
+	}
+}
+
+/* Undoes the newest step. The keyframes it changes are added to changed, */
+/* and the given tree labels are updated for the Nodes it adds or         */
+/* removes. Returns if there was a step to undo.                          */
+bool UndoHistory::undo(std::vector<ChangedKeyframe>& changed,
+	std::map<const Node*, std::string>& labels)
+{
+	if (this->undoSteps.empty())
+	{
+		return false;
+	}
+	Step* step = this->undoSteps.back();
+	this->undoSteps.pop_back();
+	step->open = false;
+
+	if (step->structure == ADD_CHILD)
+	{
+		this->detach(step, labels);
+	}
+	else if (step->structure == REMOVE_CHILD)
+	{
+		this->attach(step, labels);
+	}
+
+	/* The Nodes were keyed after the edits, so they are unkeyed first */
+	for (unsigned int i = 0; i < step->keyed.size(); i++)
+	{
+		step->keyed[i]->removeKeyframe(step->frameNum);
+		ChangedKeyframe keyframe = {step->keyed[i], step->frameNum};
+		changed.push_back(keyframe);
+	}
+
+	/* Keep the values edited to, to redo them */
+	for (size_t i = step->changes.size(); i > 0; i--)
+	{
+		KeyframeChange& change = step->changes[i - 1];
+		change.node->getTrack()->getValues(change.frameNum,
+			Node::getInterpolated(), change.newValues);
+		if (change.wasKeyframe)
+		{
+			change.node->setKeyframe(change.frameNum, change.oldValues);
+		}
+		else
+		{
+			change.node->removeKeyframe(change.frameNum);
+		}
+		ChangedKeyframe keyframe = {change.node, change.frameNum};
+		changed.push_back(keyframe);
+	}
+
+	this->redoSteps.push_back(step);
+	this->account(step);
+	return true;
+}
+
+/* Redoes the last step undone. The keyframes it changes are added to     */
+/* changed, and the given tree labels are updated for the Nodes it adds   */
+/* or removes. Returns if there was a step to redo.                       */
+bool UndoHistory::redo(std::vector<ChangedKeyframe>& changed,
+	std::map<const Node*, std::string>& labels)
+{
+	if (this->redoSteps.empty())
+	{
+		return false;
+	}
+	Step* step = this->redoSteps.back();
+	this->redoSteps.pop_back();
+
+	for (unsigned int i = 0; i < step->changes.size(); i++)
+	{
+		KeyframeChange& change = step->changes[i];
+		change.node->setKeyframe(change.frameNum, change.newValues);
+		ChangedKeyframe keyframe = {change.node, change.frameNum};
+		changed.push_back(keyframe);
+	}
+
+	/* Key the Nodes again with the interpolation they were keyed with */
+	for (unsigned int i = 0; i < step->keyed.size(); i++)
+	{
+		float values[KeyframeTrack::NUM_CHANNELS];
+		step->keyed[i]->getTrack()->getValues(step->frameNum,
+			step->keyedInterpolated, values);
+		step->keyed[i]->setKeyframe(step->frameNum, values);
+		ChangedKeyframe keyframe = {step->keyed[i], step->frameNum};
+		changed.push_back(keyframe);
+	}
+
+	if (step->structure == ADD_CHILD)
+	{
+		this->attach(step, labels);
+	}
+	else if (step->structure == REMOVE_CHILD)
+	{
+		this->detach(step, labels);
+	}
+
+	this->undoSteps.push_back(step);
+	this->account(step);
+	this->evict();
+	return true;
+}
+
+/* Drops every step. Call when the scene graph is replaced or its number of */
+/* frames changes.                                                          */
+void UndoHistory::clear()
+{
+	for (unsigned int i = 0; i < this->redoSteps.size(); i++)
+	{
+		this->deleteStep(this->redoSteps[i]);
+	}
+	this->redoSteps.clear();
+	while (!(this->undoSteps.empty()))
+	{
+		this->deleteStep(this->undoSteps.back());
+		this->undoSteps.pop_back();
+	}
+}
+
+/* Returns if there is a step to undo. */
+bool UndoHistory::canUndo() const
+{
+	return !(this->undoSteps.empty());
+}
+
+/* Returns if there is a step to redo. */
+bool UndoHistory::canRedo() const
+{
+	return !(this->redoSteps.empty());
+}
+
+/* Sets the bytes of memory the history may use, dropping the oldest steps  */
+/* if it uses more.                                                         */
+void UndoHistory::setMemoryLimit(size_t memoryLimit)
+{
+	this->memoryLimit = memoryLimit;
+	this->evict();
+}
+
+/* Returns the bytes of memory the history may use. */
+size_t UndoHistory::getMemoryLimit() const
+{
+	return this->memoryLimit;
+}
+
+/* Returns the bytes of memory the history uses. */
+size_t UndoHistory::getMemoryUsed() const
+{
+	return this->memoryUsed;
+}
@@ -0,0 +1,197 @@
+/*
+ * UndoHistory.h
+ * Created by Zachary Ferguson
+ * Header file for the UndoHistory class, the undo and redo stacks of the
+ * editor. Each step keeps only what its edit changed: the keyframes edited
+ * with their old values, the Nodes keyed, or the Node added or removed. Undoing
+ * a step never copies the scene graph, and the oldest steps are dropped once
+ * the history uses more memory than its limit.
+ */
+
+#ifndef UNDOHISTORY_H
+#define UNDOHISTORY_H
+
+/* Include necessary types */
+#include <cstddef>
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+#include "Node.h"
+
+/* Bytes of memory the undo history of the editor may use. */
+#define UNDO_MEMORY_LIMIT (32 * 1024 * 1024)
+
+class UndoHistory
+{
+	public:
+
+		/* A keyframe changed by undoing or redoing a step. */
+		struct ChangedKeyframe
+		{
+			const Node* node;
+			unsigned int frameNum;
+		};
+
+	private:
+
+		/* An edit of the keyframe of a Node at a frame. The values before */
+		/* the edit are kept, and the values after it once it is undone.   */
+		struct KeyframeChange
+		{
+			Node* node;
+			unsigned int frameNum;
+			bool wasKeyframe;
+			float oldValues[KeyframeTrack::NUM_CHANNELS];
+			float newValues[KeyframeTrack::NUM_CHANNELS];
+		};
+
+		/* The edits to the structure of the scene graph. */
+		enum StructureChange {NO_CHANGE, ADD_CHILD, REMOVE_CHILD};
+
+		/* One undoable edit. Keyframe edits from the same source at the */
+		/* same frame are added to the step while it is open, so a whole */
+		/* drag of a widget is undone at once. Nodes keyed by the edit   */
+		/* are kept by pointer only, as their values can be worked out   */
+		/* again, and only looked for the first time the step keys the   */
+		/* scene graph. A Node added or removed is kept with the child   */
+		/* before it and the tree labels of its subtree while it is out  */
+		/* of the scene graph.                                           */
+		struct Step
+		{
+			const void* source;
+			unsigned int frameNum;
+			bool open;
+			std::vector<KeyframeChange> changes;
+			std::vector<Node*> keyed;
+			bool keyedInterpolated, keyedSubtree;
+			StructureChange structure;
+			Node* parent, *child, *nextSibling;
+			bool detached;
+			std::map<const Node*, std::string> labels;
+			size_t bytes;
+		};
+
+		/* Steps that can be undone, oldest first, and steps that can be */
+		/* redone, the next one to redo last.                            */
+		std::deque<Step*> undoSteps;
+		std::vector<Step*> redoSteps;
+
+		/* Bytes of memory the steps may use, and use. */
+		size_t memoryLimit, memoryUsed;
+
+		/* Returns the open step of the given source at the given frame, */
+		/* starting a new one if there is none.                          */
+		Step* openStep(const void* source, unsigned int frameNum);
+
+		/* Adds the step to the undo stack, dropping the steps that could */
+		/* be redone.                                                     */
+		void pushStep(Step* step);
+
+		/* Works out the memory the step uses again after it changes. */
+		void account(Step* step);
+
+		/* Drops the oldest steps until the history fits in its memory */
+		/* limit, always keeping the newest one.                       */
+		void evict();
+
+		/* Deletes the step, and its Node if it is out of the scene graph. */
+		void deleteStep(Step* step);
+
+		/* Takes the step's Node out of the scene graph, moving the labels */
+		/* of its subtree from the given labels into the step.             */
+		void detach(Step* step, std::map<const Node*, std::string>& labels);
+
+		/* Puts the step's Node back in the scene graph, moving the labels */
+		/* of its subtree from the step into the given labels.             */
+		void attach(Step* step, std::map<const Node*, std::string>& labels);
+
+		/* Returns the child after the given child of the given parent, */
+		/* NULL if it is the last.                                      */
+		static Node* findNextSibling(const Node* parent, const Node* child);
+
+		/* Adds the Nodes of the given subtree that are not keyed at the */
+		/* given frame to keyed.                                         */
+		static void findUnkeyed(Node* node, unsigned int frameNum,
+			std::vector<Node*>& keyed);
+
+		/* Returns the bytes of memory the step uses. */
+		static size_t stepBytes(const Step* step);
+
+		/* Returns the bytes of memory the given Node's subtree uses. */
+		static size_t subtreeBytes(const Node* node);
+
+		/* Moves the labels of the given Node's subtree between the maps. */
+		static void moveLabels(const Node* node,
+			std::map<const Node*, std::string>& from,
+			std::map<const Node*, std::string>& to);
+
+		/* Deletes the given Node and its subtree. */
+		static void deleteSubtree(Node* node);
+
+	public:
+
+		/* Constructor for an UndoHistory that may use the given bytes of */
+		/* memory.                                                        */
+		UndoHistory(size_t memoryLimit);
+
+		/* Destructor for the UndoHistory, deleting the Nodes out of the */
+		/* scene graph that it keeps.                                    */
+		virtual ~UndoHistory();
+
+		/* Records the keyframe of the given Node at the given frame before */
+		/* the given source, usually a widget, edits it.                    */
+		void recordKeyframeEdit(Node* node, unsigned int frameNum,
+			const void* source);
+
+		/* Records the Nodes of the given subtree that are not keyed at the */
+		/* given frame before the given source keys the subtree there.      */
+		void recordMakeKeyframe(Node* root, unsigned int frameNum,
+			const void* source);
+
+		/* Records adding the given Node to its parent, after it is added. */
+		void recordAddChild(Node* child);
+
+		/* Records removing the given Node from its parent, before it is */
+		/* removed. The labels of its subtree are moved from the given   */
+		/* labels. The history keeps the Node once it is removed.        */
+		void recordRemoveChild(Node* child,
+			std::map<const Node*, std::string>& labels);
+
+		/* Ends the open step, so the next edit starts a new one. */
+		void endStep();
+
+		/* Undoes the newest step. The keyframes it changes are added to  */
+		/* changed, and the given tree labels are updated for the Nodes   */
+		/* it adds or removes. Returns if there was a step to undo.       */
+		bool undo(std::vector<ChangedKeyframe>& changed,
+			std::map<const Node*, std::string>& labels);
+
+		/* Redoes the last step undone. The keyframes it changes are added */
+		/* to changed, and the given tree labels are updated for the Nodes */
+		/* it adds or removes. Returns if there was a step to redo.        */
+		bool redo(std::vector<ChangedKeyframe>& changed,
+			std::map<const Node*, std::string>& labels);
+
+		/* Drops every step. Call when the scene graph is replaced or its */
+		/* number of frames changes.                                      */
+		void clear();
+
+		/* Returns if there is a step to undo. */
+		bool canUndo() const;
+
+		/* Returns if there is a step to redo. */
+		bool canRedo() const;
+
+		/* Sets the bytes of memory the history may use, dropping the */
+		/* oldest steps if it uses more.                              */
+		void setMemoryLimit(size_t memoryLimit);
+
+		/* Returns the bytes of memory the history may use. */
+		size_t getMemoryLimit() const;
+
+		/* Returns the bytes of memory the history uses. */
+		size_t getMemoryUsed() const;
+};
+
+#endif
@@ -0,0 +1,65 @@
+/*
+ * Y4MSink.cpp
+ * Created by Zachary Ferguson
+ * Source file for the Y4MSink class, a StreamSink that writes the frames as a
+ * YUV4MPEG2 stream of 4:2:0 full range YCbCr images.
+ */
+
+#include "Y4MSink.h"
+#include <sstream> /* Included for building the header */
+#include <algorithm> /* Included for copy */
+#include "ColorConverter.h"
+
+/* Marks the start of every frame in the stream. */
+#define Y4M_FRAME_TAG "FRAME\n"
+#define Y4M_FRAME_TAG_SIZE 6
+
+/* Constructor for a Y4MSink that writes to the file with the given name, or */
+/* to stdout if it is empty or "-".                                          */
+Y4MSink::Y4MSink(const std::string& path) : StreamSink(path)
+{
+
+}
+
+/* Destructor for the Y4MSink */
+Y4MSink::~Y4MSink()
+{
+
+}
+
+/* Returns the YUV4MPEG2 stream header. */
+std::string Y4MSink::header(unsigned int width, unsigned int height,
+	double framerate) const
+{
+	/* C420jpeg is full range and sited like JPEG, which encode matches */
+	std::stringstream out;
+	out << "YUV4MPEG2 W" << width << " H" << height << " F" <<
+		(unsigned int)(framerate * 1000 + 0.5) << ":1000 Ip A1:1 C420jpeg\n";
+	return out.str();
+}
+
+/* Converts the frame to YCbCr, with the chroma averaged over every 2x2 */
+/* block of pixels, and puts it in a frame packet.                      */
+void Y4MSink::encode(const unsigned char* pixels, unsigned int width,
+	unsigned int height, std::vector<unsigned char>& bytes) const
+{
+	const unsigned int chromaWidth = (width + 1) / 2;
+	const unsigned int chromaHeight = (height + 1) / 2;
+	bytes.resize(Y4M_FRAME_TAG_SIZE + width * height +
+		2 * chromaWidth * chromaHeight);
+
+	std::copy(Y4M_FRAME_TAG, Y4M_FRAME_TAG + Y4M_FRAME_TAG_SIZE,
+		bytes.begin());
+	unsigned char* luma = &(bytes[Y4M_FRAME_TAG_SIZE]);
+	unsigned char* blue = luma + width * height;
+	unsigned char* red = blue + chromaWidth * chromaHeight;
+
+	ColorConverter::frameToYCbCr(pixels, width, height, 0, height, 2, 2,
+		luma, width, blue, red, chromaWidth);
+}
+
+/* Returns the kind of stream. */
+std::string Y4MSink::getDescription() const
+{
+	return "Y4M stream";
+}
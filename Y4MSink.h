@@ -0,0 +1,40 @@
+/*
+ * Y4MSink.h
+ * Created by Zachary Ferguson
+ * Header file for the Y4MSink class, a StreamSink that writes the frames as a
+ * YUV4MPEG2 stream of 4:2:0 full range YCbCr images.
+ */
+
+#ifndef Y4MSINK_H
+#define Y4MSINK_H
+
+/* Include necessary types */
+#include "StreamSink.h"
+
+class Y4MSink : public StreamSink
+{
+	protected:
+
+		/* Returns the YUV4MPEG2 stream header. */
+		virtual std::string header(unsigned int width, unsigned int height,
+			double framerate) const;
+
+	public:
+
+		/* Constructor for a Y4MSink that writes to the file with the */
+		/* given name, or to stdout if it is empty or "-".            */
+		Y4MSink(const std::string& path);
+
+		/* Destructor for the Y4MSink */
+		virtual ~Y4MSink();
+
+		/* Converts the frame to YCbCr, with the chroma averaged over   */
+		/* every 2x2 block of pixels, and puts it in a frame packet.    */
+		virtual void encode(const unsigned char* pixels, unsigned int width,
+			unsigned int height, std::vector<unsigned char>& bytes) const;
+
+		/* Returns the kind of stream. */
+		virtual std::string getDescription() const;
+};
+
+#endif
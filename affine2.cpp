@@ -0,0 +1,287 @@
+/*
+ * affine2.cpp
+ * Created by Zachary Ferguson
+ * Definition for the 2D affine transformation class, stored as the top two
+ * rows of a 3x3 matrix.
+ */
+
+#include <iostream> /* Included for output to stdout.              */
+#include <cmath>    /* Included for sin and cos.                   */
+#include <assert.h> /* Included to assert if arguments are valid.  */
+#include "affine2.h" /* Class and function prototypes.             */
+
+#ifdef AFFINE2_SSE
+#include <xmmintrin.h>
+#endif
+#ifdef AFFINE2_AVX
+#include <immintrin.h>
+#endif
+
+#define PI 3.1415926535897 /* Math constant for angle conversions. */
+
+/* Creates the identity transformation. */
+affine2::affine2()
+{
+	data[0] = 1; data[1] = 0; data[2] = 0; data[3] = 0;
+	data[4] = 0; data[5] = 1; data[6] = 0; data[7] = 0;
+}
+
+/* Constructs a transformation from the given top two rows. */
+affine2::affine2(float a, float b, float tx, float c, float d, float ty)
+{
+	data[0] = a; data[1] = b; data[2] = tx; data[3] = 0;
+	data[4] = c; data[5] = d; data[6] = ty; data[7] = 0;
+}
+
+/* Constructs a transformation from the top two rows of the mat3. */
+affine2::affine2(const mat3& m)
+{
+	vec3 row0 = m[0], row1 = m[1];
+	data[0] = row0[0]; data[1] = row0[1]; data[2] = row0[2]; data[3] = 0;
+	data[4] = row1[0]; data[5] = row1[1]; data[6] = row1[2]; data[7] = 0;
+}
+
+/* Returns the value at the given row and column. */
+float affine2::operator()(unsigned int row, unsigned int column) const
+{
+	/* Check indices are in bounds */
+	assert(row < 3 && column < 3);
+	/* The bottom row is always (0, 0, 1) */
+	if (row == 2)
+	{
+		return column == 2 ? 1.0f : 0.0f;
+	}
+	return data[4 * row + column];
+}
+
+/* Returns this transformation as a full mat3. */
+mat3 affine2::toMat3() const
+{
+	return mat3(vec3(data[0], data[1], data[2]),
+				vec3(data[4], data[5], data[6]),
+				vec3(0, 0, 1));
+}
+
+/* Nicely prints out this matrix. */
+void affine2::print() const
+{
+	this->toMat3().print();
+}
+
+/* Transforms count points given as separate x and y arrays into the output */
+/* x and y arrays. The output may be the same as the input.                 */
+void affine2::transformPoints(const float* x, const float* y, float* outX,
+	float* outY, unsigned int count) const
+{
+	unsigned int i = 0;
+
+	/* Loads are unaligned, the arrays are not required to be aligned. */
+#ifdef AFFINE2_AVX
+	{
+		const __m256 a = _mm256_set1_ps(data[0]), b = _mm256_set1_ps(data[1]);
+		const __m256 tx = _mm256_set1_ps(data[2]);
+		const __m256 c = _mm256_set1_ps(data[4]), d = _mm256_set1_ps(data[5]);
+		const __m256 ty = _mm256_set1_ps(data[6]);
+		for (; i + 8 <= count; i += 8)
+		{
+			__m256 px = _mm256_loadu_ps(x + i), py = _mm256_loadu_ps(y + i);
+			_mm256_storeu_ps(outX + i, _mm256_add_ps(_mm256_add_ps(
+				_mm256_mul_ps(a, px), _mm256_mul_ps(b, py)), tx));
+			_mm256_storeu_ps(outY + i, _mm256_add_ps(_mm256_add_ps(
+				_mm256_mul_ps(c, px), _mm256_mul_ps(d, py)), ty));
+		}
+	}
+#endif
+#ifdef AFFINE2_SSE
+	{
+		const __m128 a = _mm_set1_ps(data[0]), b = _mm_set1_ps(data[1]);
+		const __m128 tx = _mm_set1_ps(data[2]);
+		const __m128 c = _mm_set1_ps(data[4]), d = _mm_set1_ps(data[5]);
+		const __m128 ty = _mm_set1_ps(data[6]);
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128 px = _mm_loadu_ps(x + i), py = _mm_loadu_ps(y + i);
+			_mm_storeu_ps(outX + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(a, px),
+				_mm_mul_ps(b, py)), tx));
+			_mm_storeu_ps(outY + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(c, px),
+				_mm_mul_ps(d, py)), ty));
+		}
+	}
+#endif
+
+	/* Transform the remaining points one at a time */
+	for (; i < count; i++)
+	{
+		float px = x[i], py = y[i];
+		outX[i] = data[0] * px + data[1] * py + data[2];
+		outY[i] = data[4] * px + data[5] * py + data[6];
+	}
+}
+
+/* Transforms count points given as separate x and y arrays into one */
+/* interleaved output array of x, y pairs, ready for a vertex array.  */
+void affine2::transformPoints(const float* x, const float* y, float* outXY,
+	unsigned int count) const
+{
+	unsigned int i = 0;
+
+	/* Loads are unaligned, the arrays are not required to be aligned. */
+#ifdef AFFINE2_AVX
+	{
+		const __m256 a = _mm256_set1_ps(data[0]), b = _mm256_set1_ps(data[1]);
+		const __m256 tx = _mm256_set1_ps(data[2]);
+		const __m256 c = _mm256_set1_ps(data[4]), d = _mm256_set1_ps(data[5]);
+		const __m256 ty = _mm256_set1_ps(data[6]);
+		for (; i + 8 <= count; i += 8)
+		{
+			__m256 px = _mm256_loadu_ps(x + i), py = _mm256_loadu_ps(y + i);
+			__m256 ox = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(a, px),
+				_mm256_mul_ps(b, py)), tx);
+			__m256 oy = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(c, px),
+				_mm256_mul_ps(d, py)), ty);
+			/* Unpacking interleaves within each 128-bit lane, so swap the */
+			/* middle halves to put the pairs back in order.               */
+			__m256 low = _mm256_unpacklo_ps(ox, oy);
+			__m256 high = _mm256_unpackhi_ps(ox, oy);
+			_mm256_storeu_ps(outXY + 2 * i,
+				_mm256_permute2f128_ps(low, high, 0x20));
+			_mm256_storeu_ps(outXY + 2 * i + 8,
+				_mm256_permute2f128_ps(low, high, 0x31));
+		}
+	}
+#endif
+#ifdef AFFINE2_SSE
+	{
+		const __m128 a = _mm_set1_ps(data[0]), b = _mm_set1_ps(data[1]);
+		const __m128 tx = _mm_set1_ps(data[2]);
+		const __m128 c = _mm_set1_ps(data[4]), d = _mm_set1_ps(data[5]);
+		const __m128 ty = _mm_set1_ps(data[6]);
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128 px = _mm_loadu_ps(x + i), py = _mm_loadu_ps(y + i);
+			__m128 ox = _mm_add_ps(_mm_add_ps(_mm_mul_ps(a, px),
+				_mm_mul_ps(b, py)), tx);
+			__m128 oy = _mm_add_ps(_mm_add_ps(_mm_mul_ps(c, px),
+				_mm_mul_ps(d, py)), ty);
+			_mm_storeu_ps(outXY + 2 * i, _mm_unpacklo_ps(ox, oy));
+			_mm_storeu_ps(outXY + 2 * i + 4, _mm_unpackhi_ps(ox, oy));
+		}
+	}
+#endif
+
+	/* Transform the remaining points one at a time */
+	for (; i < count; i++)
+	{
+		float px = x[i], py = y[i];
+		outXY[2 * i] = data[0] * px + data[1] * py + data[2];
+		outXY[2 * i + 1] = data[4] * px + data[5] * py + data[6];
+	}
+}
+
+/* Given a angle in degrees for rotation returns a rotation transformation. */
+affine2 affine2::rotation2D(float angle)
+{
+	/* Convert to radians and create the rotation transformation */
+	float cosine = (float)cos((PI*angle) / 180);
+	float sine = (float)sin((PI*angle) / 180);
+	return affine2(cosine, -sine, 0,
+				   sine, cosine, 0);
+}
+
+/* Given a x and y translation value returns a translation transformation. */
+affine2 affine2::translation2D(float x, float y)
+{
+	return affine2(1, 0, x,
+				   0, 1, y);
+}
+
+/* Given a x and y scaling value returns a scaling transformation. */
+affine2 affine2::scale2D(float x, float y)
+{
+	return affine2(x, 0, 0,
+				   0, y, 0);
+}
+
+/* Returns the identity transformation. */
+affine2 affine2::identity()
+{
+	return affine2();
+}
+
+/* Builds translation * rotation * scale directly from the values. Takes the */
+/* rotation angle in degrees.                                               */
+affine2 affine2::fromValues(float scaleX, float scaleY, float rotationAngle,
+	float translationX, float translationY)
+{
+	float cosine = (float)cos((PI*rotationAngle) / 180);
+	float sine = (float)sin((PI*rotationAngle) / 180);
+	return affine2(scaleX * cosine, -scaleY * sine,   translationX,
+				   scaleX * sine,    scaleY * cosine, translationY);
+}
+
+/* Returns a boolean for if the transformations are equal to each other. */
+bool operator==(const affine2& m1, const affine2& m2)
+{
+	/* Compare the top two rows, ignoring the padding */
+	return m1.data[0] == m2.data[0] && m1.data[1] == m2.data[1] &&
+		   m1.data[2] == m2.data[2] && m1.data[4] == m2.data[4] &&
+		   m1.data[5] == m2.data[5] && m1.data[6] == m2.data[6];
+}
+
+/* Returns a boolean for if the transformations are not equal to each other. */
+bool operator!=(const affine2& m1, const affine2& m2)
+{
+	return !(m1 == m2);
+}
+
+/* Returns the composition of the given transformations, m2 then m1. Each  */
+/* row of the result is a combination of the rows of m2, with the implied */
+/* bottom row (0, 0, 1) of m2 adding m1's translation.                    */
+affine2 operator* (const affine2& m1, const affine2& m2)
+{
+	affine2 result;
+#if defined(AFFINE2_AVX)
+	/* Both rows at once, one per 128-bit lane */
+	__m256 a = _mm256_loadu_ps(m1.data);
+	__m256 row0 = _mm256_broadcast_ps((const __m128*)(m2.data));
+	__m256 row1 = _mm256_broadcast_ps((const __m128*)(m2.data + 4));
+	__m256 row2 = _mm256_set_ps(0, 1, 0, 0, 0, 1, 0, 0);
+	__m256 r = _mm256_add_ps(_mm256_add_ps(
+		_mm256_mul_ps(_mm256_permute_ps(a, 0x00), row0),
+		_mm256_mul_ps(_mm256_permute_ps(a, 0x55), row1)),
+		_mm256_mul_ps(_mm256_permute_ps(a, 0xAA), row2));
+	_mm256_storeu_ps(result.data, r);
+#elif defined(AFFINE2_SSE)
+	__m128 row0 = _mm_loadu_ps(m2.data);
+	__m128 row1 = _mm_loadu_ps(m2.data + 4);
+	__m128 row2 = _mm_set_ps(0, 1, 0, 0);
+	for (int i = 0; i < 8; i += 4)
+	{
+		__m128 r = _mm_add_ps(_mm_add_ps(
+			_mm_mul_ps(_mm_set1_ps(m1.data[i]), row0),
+			_mm_mul_ps(_mm_set1_ps(m1.data[i + 1]), row1)),
+			_mm_mul_ps(_mm_set1_ps(m1.data[i + 2]), row2));
+		_mm_storeu_ps(result.data + i, r);
+	}
+#else
+	for (int i = 0; i < 8; i += 4)
+	{
+		for (int j = 0; j < 3; j++)
+		{
+			result.data[i + j] = m1.data[i] * m2.data[j] +
+				m1.data[i + 1] * m2.data[4 + j];
+		}
+		result.data[i + 2] += m1.data[i + 2];
+	}
+#endif
+	return result;
+}
+
+/* Returns the vector transformed by the given transformation (m * v), */
+/* treating z as the homogeneous coordinate.                           */
+vec3 operator* (const affine2& m, const vec3& v)
+{
+	return vec3(m.data[0] * v[0] + m.data[1] * v[1] + m.data[2] * v[2],
+				m.data[4] * v[0] + m.data[5] * v[1] + m.data[6] * v[2],
+				v[2]);
+}
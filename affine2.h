@@ -0,0 +1,112 @@
+/*
+ *  affine2.h
+ *  Created by Zachary Ferguson
+ *  Definition for a 2D affine transformation, a 3x3 matrix whose bottom row
+ *  is always (0, 0, 1), stored as only its top two rows.
+ */
+
+#ifndef AFFINE2_H
+#define AFFINE2_H
+
+#include "vec3.h"
+#include "mat3.h"
+
+/* Use the SSE kernels when compiling for SSE and the AVX kernels when */
+/* compiling for AVX, otherwise fall back to scalar code.              */
+#if defined(__SSE__) || defined(_M_X64) || \
+	(defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+	#define AFFINE2_SSE
+#endif
+#if defined(__AVX__)
+	#define AFFINE2_AVX
+#endif
+
+/* Aligns a type to 16 bytes. */
+#if defined(_MSC_VER)
+	#define ALIGN16 __declspec(align(16))
+#else
+	#define ALIGN16 __attribute__((aligned(16)))
+#endif
+
+/* Always pass by reference, 32-bit MSVC can not pass aligned types by value */
+class ALIGN16 affine2{
+private:
+	/// The top two rows of the matrix, (a, b, tx, 0) and (c, d, ty, 0).
+	/// Each row is padded to four floats so it fills one SSE register.
+	float data[8];
+public:
+	///----------------------------------------------------------------------
+	/// Constructors
+	///----------------------------------------------------------------------
+	/// Default Constructor. Initialize to the identity transformation.
+	affine2();
+
+	/// Initializes the transformation with the given top two rows
+	affine2(float a, float b, float tx, float c, float d, float ty);
+
+	/// Initializes the transformation with the top two rows of the mat3
+	explicit affine2(const mat3& m);
+
+	///----------------------------------------------------------------------
+	/// Getters
+	///----------------------------------------------------------------------
+	/// Returns the value at the row and column, the bottom row is (0, 0, 1)
+	float operator()(unsigned int row, unsigned int column) const;
+
+	/// Returns the transformation as a full mat3
+	mat3 toMat3() const;
+
+	/// Prints the matrix to standard output in a nice format
+	void print() const;
+
+	///----------------------------------------------------------------------
+	/// Point Transformations
+	///----------------------------------------------------------------------
+	/// Transforms count points given as separate x and y arrays into the
+	/// output x and y arrays. The output may be the same as the input.
+	void transformPoints(const float* x, const float* y, float* outX,
+		float* outY, unsigned int count) const;
+
+	/// Transforms count points given as separate x and y arrays into one
+	/// interleaved output array of x, y pairs, ready for a vertex array.
+	void transformPoints(const float* x, const float* y, float* outXY,
+		unsigned int count) const;
+
+	///----------------------------------------------------------------------
+	/// Static Initializers
+	///----------------------------------------------------------------------
+	/// Takes an angle in degrees and outputs a rotation transformation
+	static affine2 rotation2D(float angle);
+
+	/// Takes an x and y displacement and outputs a translation transformation
+	static affine2 translation2D(float x, float y);
+
+	/// Takes an x and y scale and outputs a scale transformation
+	static affine2 scale2D(float x, float y);
+
+	/// Generates the identity transformation
+	static affine2 identity();
+
+	/// Builds translation * rotation * scale directly from the values.
+	/// Takes the rotation angle in degrees.
+	static affine2 fromValues(float scaleX, float scaleY, float rotationAngle,
+		float translationX, float translationY);
+
+	///----------------------------------------------------------------------
+	/// Friend Functions
+	///----------------------------------------------------------------------
+	/// Checks if m1 == m2
+	friend bool operator==(const affine2& m1, const affine2& m2);
+
+	/// Checks if m1 != m2
+	friend bool operator!=(const affine2& m1, const affine2& m2);
+
+	/// Transformation composition (m1 * m2), applies m2 then m1
+	friend affine2 operator* (const affine2& m1, const affine2& m2);
+
+	/// Transformation/vector multiplication (m * v)
+	/// Assume v is a column vector with z as the homogeneous coordinate
+	friend vec3 operator* (const affine2& m, const vec3& v);
+};
+
+#endif
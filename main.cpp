@@ -11,9 +11,17 @@ int main(int argc, char* const argv[])
 {
 	/***Draw the Animated Scene Graph***/
 
+	/* Lets the scene loader's thread wake up this one */
+	Fl::lock();
+
 	AnimatedSGWindow *aSGWin = new AnimatedSGWindow(200, 50, 1000, 560, "Animated \
 		Scene Graph Editor - Zachary Ferguson, zfergus2");
 	aSGWin->show();
-	return Fl::run();
+
+	/* Offer to recover the scene if the editor crashed last time */
+	aSGWin->recoverAutosave();
+	int result = Fl::run();
+	aSGWin->discardAutosave();
+	return result;
 
 }
\ No newline at end of file
@@ -17,24 +17,25 @@ polygon::~polygon()
 	this->vertices = NULL;
 }
 
-/* Draws this polygon */
-void polygon::draw(mat3 transformation) const
+/* Adds this polygon's vertices, transformed by the given         */
+/* transformation and in the given color, to the RenderBatch as a */
+/* fan of triangles.                                              */
+void polygon::appendTo(RenderBatch& batch, const affine2& transformation, 
+	const float color[3]) const
 {
-	/* Set the color */
-	glColor3f((this->color)[0], (this->color)[1], (this->color)[2]);
-	/* Draw the vertices */
-	glBegin(GL_POLYGON);
-	for (std::list<vec3>::const_iterator it = (this->vertices)->begin(); it != 
-		(this->vertices)->end(); ++it)
-	{
-		vec3 vertex = transformation * (*it);
-		glVertex2f(vertex[0], vertex[1]);
-	}
-	glEnd();
+	float* points = batch.getScratch(this->numVertices);
+	this->transformVertices(transformation, points);
+	batch.addTriangleFan(points, this->numVertices, color);
+}
+
+/* Returns what kind of geometry this is. */
+polyline::Type polygon::getType() const
+{
+	return polyline::POLYGON;
 }
 
 /* Sets the list of vertices to the new one */
 void polygon::setVertices(std::list<vec3>* newVertices)
 {
-	this->vertices = newVertices;
+	polyline::setVertices(newVertices);
 }
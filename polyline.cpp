@@ -7,12 +7,49 @@
 
 /* Include necessary types */
 #include "polyline.h"
+#include <stdlib.h> /* Included for posix_memalign and free */
+#if defined(_MSC_VER)
+#include <malloc.h> /* Included for _aligned_malloc and _aligned_free */
+#endif
+
+/* Allocates an array of count floats aligned to 16 bytes. */
+static float* allocateAligned(unsigned int count)
+{
+	if (count == 0)
+	{
+		return NULL;
+	}
+#if defined(_MSC_VER)
+	return (float*)_aligned_malloc(count * sizeof(float), 16);
+#else
+	void* memory = NULL;
+	if (posix_memalign(&memory, 16, count * sizeof(float)) != 0)
+	{
+		return NULL;
+	}
+	return (float*)memory;
+#endif
+}
+
+/* Frees an array allocated with allocateAligned. */
+static void freeAligned(float* memory)
+{
+#if defined(_MSC_VER)
+	_aligned_free(memory);
+#else
+	free(memory);
+#endif
+}
 
 /* Constructor that takes a list of vectors for the vertices and the color */
 polyline::polyline(std::list<vec3>* vertices, float red, float blue, 
 	float green)
 {
 	this->vertices = vertices;
+	this->vertexX = NULL;
+	this->vertexY = NULL;
+	this->numVertices = 0;
+	this->packVertices();
 	(this->color)[0] = red;
 	(this->color)[1] = green;
 	(this->color)[2] = blue;
@@ -23,6 +60,32 @@ polyline::~polyline()
 {
 	delete this->vertices;
 	this->vertices = NULL;
+	freeAligned(this->vertexX);
+	freeAligned(this->vertexY);
+}
+
+/* Rebuilds the x and y arrays from the list of vertices. */
+void polyline::packVertices()
+{
+	freeAligned(this->vertexX);
+	freeAligned(this->vertexY);
+	this->numVertices = this->vertices != NULL ? 
+		(unsigned int)(this->vertices->size()) : 0;
+	this->vertexX = allocateAligned(this->numVertices);
+	this->vertexY = allocateAligned(this->numVertices);
+
+	if (this->numVertices == 0)
+	{
+		return;
+	}
+
+	unsigned int i = 0;
+	for (std::list<vec3>::const_iterator it = (this->vertices)->cbegin(); it !=
+		(this->vertices)->end(); ++it, i++)
+	{
+		this->vertexX[i] = (*it)[0];
+		this->vertexY[i] = (*it)[1];
+	}
 }
 
 /* Compares if too given polylines are equal */
@@ -66,20 +129,20 @@ const std::vector<float> polyline::getColor() const
 	return {this->color[0], this->color[1], this->color[2]};
 }
 
-/* Draws this polyline */
-void polyline::draw(mat3 transformation) const
+/* Adds this polyline's vertices, transformed by the given transformation */
+/* and in the given color, to the RenderBatch as line segments.          */
+void polyline::appendTo(RenderBatch& batch, const affine2& transformation, 
+	const float color[3]) const
 {
-	/* Set the color */
-	glColor3f((this->color)[0], (this->color)[1], (this->color)[2]);
-	/* Draw the vertices */
-	glBegin(GL_LINE_STRIP);
-	for (std::list<vec3>::const_iterator it = (this->vertices)->cbegin(); it !=
-		(this->vertices)->end(); ++it)
-	{
-		vec3 vertex = transformation * (*it);
-		glVertex2f(vertex[0], vertex[1]);
-	}
-	glEnd();
+	float* points = batch.getScratch(this->numVertices);
+	this->transformVertices(transformation, points);
+	batch.addLineStrip(points, this->numVertices, color);
+}
+
+/* Returns what kind of geometry this is. */
+polyline::Type polyline::getType() const
+{
+	return polyline::POLYLINE;
 }
 
 /* Returns the list of vertices */
@@ -92,4 +155,33 @@ const std::list<vec3>* polyline::getVertices() const
 void polyline::setVertices(std::list<vec3>* newVertices)
 {
 	this->vertices = newVertices;
+	this->packVertices();
+}
+
+/* Returns the number of vertices */
+unsigned int polyline::getNumVertices() const
+{
+	return this->numVertices;
+}
+
+/* Returns the aligned array of the vertices' x values */
+const float* polyline::getVertexX() const
+{
+	return this->vertexX;
+}
+
+/* Returns the aligned array of the vertices' y values */
+const float* polyline::getVertexY() const
+{
+	return this->vertexY;
+}
+
+/* Transforms every vertex by the given transformation into outXY as */
+/* interleaved x, y pairs. outXY must hold 2 * getNumVertices()      */
+/* floats.                                                           */
+void polyline::transformVertices(const affine2& transformation, float* outXY)
+	const
+{
+	transformation.transformPoints(this->vertexX, this->vertexY, outXY,
+		this->numVertices);
 }
\ No newline at end of file
@@ -11,18 +11,31 @@
 /* Include necessary types */
 #include <list>
 #include <vector>
+#include <stddef.h> /* Included for NULL */
 #include "vec3.h"
-#include "mat3.h"
-#include <FL/Fl.H>
-#include <FL/Gl.H>
-#include <Fl/Fl_Gl_Window.H>
+#include "affine2.h"
+#include "RenderBatch.h"
 
 class polyline
 {
+	public:
+
+		/* The kinds of geometry, so a saved scene knows what to make. */
+		enum Type {POLYLINE, POLYGON, TRIANGLE, QUAD, NUM_TYPES};
+
 	protected:
 		
 		/* List of the polygon's vertices */
 		std::list<vec3> *vertices;
+
+		/* Contiguous 16-byte aligned copies of the vertices' x and y  */
+		/* values, rebuilt whenever the list of vertices is set.       */
+		float* vertexX;
+		float* vertexY;
+		unsigned int numVertices;
+
+		/* Rebuilds the x and y arrays from the list of vertices. */
+		void packVertices();
 		
 		/* Array of float values for RGB color of the polyline */
 		float color[3];
@@ -49,11 +62,29 @@ class polyline
 		/* Returns the RGB color value of this geometry as a vector of floats */
 		const std::vector<float> getColor() const;
 		
-		/* Draws this polyline */
-		virtual void draw(mat3 transformation) const;
+		/* Adds this polyline's vertices, transformed by the given    */
+		/* transformation and in the given color, to the RenderBatch. */
+		virtual void appendTo(RenderBatch& batch, 
+			const affine2& transformation, const float color[3]) const;
 		
+		/* Returns what kind of geometry this is. */
+		virtual Type getType() const;
+
 		/* Returns the list of vertices */
 		const std::list<vec3>* getVertices() const;
+
+		/* Returns the number of vertices */
+		unsigned int getNumVertices() const;
+
+		/* Returns the aligned arrays of the vertices' x and y values */
+		const float* getVertexX() const;
+		const float* getVertexY() const;
+
+		/* Transforms every vertex by the given transformation into outXY  */
+		/* as interleaved x, y pairs. outXY must hold 2 * getNumVertices() */
+		/* floats.                                                         */
+		void transformVertices(const affine2& transformation, float* outXY)
+			const;
 		
 		/* Sets the list of vertices to the new one */
 		virtual void setVertices(std::list<vec3>* newVertices);
@@ -21,25 +21,26 @@ quad::~quad()
 	this->vertices = NULL;
 }
 
-/* Draws this polyline */
-void quad::draw(mat3 transformation) const
+/* Adds this quad's vertices, transformed by the given              */
+/* transformation and in the given color, to the RenderBatch as two */
+/* triangles.                                                       */
+void quad::appendTo(RenderBatch& batch, const affine2& transformation, 
+	const float color[3]) const
 {
-	/* Set the color */
-	glColor3f((polyline::color)[0], (this->color)[1], (this->color)[2]);
-	/* Draw the vertices */
-	glBegin(GL_QUADS);
-	for (std::list<vec3>::const_iterator it = (this->vertices)->begin(); it != 
-		(this->vertices)->end(); ++it)
-	{
-		vec3 vertex = transformation * (*it);
-		glVertex2f(vertex[0], vertex[1]);
-	}
-	glEnd();
+	float* points = batch.getScratch(this->numVertices);
+	this->transformVertices(transformation, points);
+	batch.addQuads(points, this->numVertices, color);
+}
+
+/* Returns what kind of geometry this is. */
+polyline::Type quad::getType() const
+{
+	return polyline::QUAD;
 }
 
 /* Sets the list of vertices to the new one */
 void quad::setVertices(std::list<vec3>* newVertices)
 {
 	assert(newVertices->size() == 4);
-	this->vertices = newVertices;
+	polyline::setVertices(newVertices);
 }
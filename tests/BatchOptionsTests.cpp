@@ -0,0 +1,127 @@
+/*
+ * BatchOptionsTests.cpp
+ * Created by Zachary Ferguson
+ * Tests of the BatchOptions class, reading the batch renderer's command line
+ * and making its output, without rendering anything.
+ */
+
+#include "BatchOptions.h"
+#include "FrameWriter.h"
+#include "Tests.h"
+
+/* Most arguments parsed in a test, after the program name. */
+#define MAX_ARGUMENTS 31
+
+/* Returns what parsing the given arguments, after the program name, gives */
+/* when starting from the default options.                                 */
+static BatchOptions::Result parseArguments(int count,
+	const char* const arguments[], BatchOptions& options)
+{
+	const char* argv[MAX_ARGUMENTS + 1] = {"BatchRender"};
+	for (int i = 0; i < count && i < MAX_ARGUMENTS; i++)
+	{
+		argv[i + 1] = arguments[i];
+	}
+	std::string error;
+	options = BatchOptions();
+	BatchOptions::Result result = options.parse(count + 1, argv, error);
+	CHECK((result == BatchOptions::PARSED || result == BatchOptions::HELP) ==
+		error.empty());
+	return result;
+}
+
+/* Returns if the single option with the given value is rejected as an */
+/* invalid value.                                                      */
+static bool rejects(const char* option, const char* value)
+{
+	const char* arguments[] = {option, value};
+	BatchOptions options;
+	return parseArguments(2, arguments, options) ==
+		BatchOptions::INVALID_VALUE;
+}
+
+/* Returns the description of the sink made for the format, or "none" if */
+/* there is no such format.                                              */
+static std::string sinkFor(const char* format)
+{
+	const char* arguments[] = {"--format", format, "--quality", "90"};
+	BatchOptions options;
+	parseArguments(4, arguments, options);
+	FrameSink* sink = options.makeFrameSink();
+	std::string description = sink == NULL ? "none" : sink->getDescription();
+	delete sink;
+	return description;
+}
+
+/* Test the BatchOptions class */
+void testBatchOptions()
+{
+	/* Nothing given renders the walking animal with the defaults */
+	BatchOptions options;
+	CHECK(parseArguments(0, NULL, options) == BatchOptions::PARSED);
+	CHECK(options.sceneName == "walk" && options.format == "jpeg");
+	CHECK(options.numFrames == DEFAULT_NUM_FRAMES && !options.hasFrames);
+	CHECK(options.first == 0 && !options.hasLast && options.stride == 1);
+	CHECK(options.width == DEFAULT_WIDTH && options.height == DEFAULT_HEIGHT);
+	CHECK(options.quality == JPEG_QUALITY);
+	CHECK(options.framerate == DEFAULT_FRAMERATE);
+	CHECK(options.numThreads == 0 && !options.interpolate);
+	CHECK(options.exportPath.empty() && !options.hasOutput);
+
+	/* Every option is read */
+	const char* every[] = {"--scene", "animal", "--frames", "30",
+		"--first", "2", "--last", "25", "--stride", "3", "--width", "640",
+		"--height", "480", "--format", "png", "--quality", "90",
+		"--framerate", "24", "--output", "out_", "--threads", "4",
+		"--interpolate", "--export", "scene.json"};
+	CHECK(parseArguments(27, every, options) == BatchOptions::PARSED);
+	CHECK(options.sceneName == "animal" && options.format == "png");
+	CHECK(options.numFrames == 30 && options.hasFrames);
+	CHECK(options.first == 2 && options.last == 25 && options.hasLast);
+	CHECK(options.stride == 3);
+	CHECK(options.width == 640 && options.height == 480);
+	CHECK(options.quality == 90 && options.framerate == 24);
+	CHECK(options.output == "out_" && options.hasOutput);
+	CHECK(options.numThreads == 4 && options.interpolate);
+	CHECK(options.exportPath == "scene.json");
+
+	/* --help stops reading, and unknown options and missing values are */
+	/* told apart from invalid values                                   */
+	const char* help[] = {"--width", "0", "--help"};
+	CHECK(parseArguments(3, help, options) == BatchOptions::INVALID_VALUE);
+	CHECK(parseArguments(1, help + 2, options) == BatchOptions::HELP);
+	const char* unknown[] = {"--colour", "red"};
+	CHECK(parseArguments(2, unknown, options) ==
+		BatchOptions::UNKNOWN_OPTION);
+	const char* missing[] = {"--width"};
+	CHECK(parseArguments(1, missing, options) ==
+		BatchOptions::UNKNOWN_OPTION);
+
+	/* Numbers must be whole, in range, and nothing else */
+	CHECK(rejects("--width", "0"));
+	CHECK(rejects("--width", "16385"));
+	CHECK(!rejects("--width", "16384"));
+	CHECK(rejects("--height", "12x"));
+	CHECK(rejects("--frames", "0"));
+	CHECK(rejects("--stride", "0"));
+	CHECK(rejects("--first", "-1"));
+	CHECK(rejects("--first", " 1"));
+	CHECK(rejects("--last", ""));
+	CHECK(rejects("--threads", "4294967296"));
+	CHECK(!rejects("--threads", "4294967295"));
+	CHECK(rejects("--quality", "0"));
+	CHECK(rejects("--quality", "101"));
+	CHECK(rejects("--framerate", "0"));
+
+	/* Each format makes its sink, and image frames default to frame_ */
+	CHECK(sinkFor("jpeg") == "JPEG frames, quality 90, 4:2:0");
+	CHECK(sinkFor("jpeg444") == "JPEG frames, quality 90, 4:4:4");
+	CHECK(sinkFor("png").compare(0, 10, "PNG frames") == 0);
+	CHECK(sinkFor("y4m") == "Y4M stream");
+	CHECK(sinkFor("rgb") == "Raw RGB stream");
+	CHECK(sinkFor("gif") == "none");
+	options = BatchOptions();
+	FrameSink* sink = options.makeFrameSink();
+	CHECK(sink->getManifestPath() == "frame_manifest.txt");
+	delete sink;
+}
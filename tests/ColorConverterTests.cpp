@@ -0,0 +1,219 @@
+/*
+ * ColorConverterTests.cpp
+ * Created by Zachary Ferguson
+ * Tests of the ColorConverter class against a pixel at a time copy of its
+ * fixed point formula and against BT.601 in floating point, and a benchmark of
+ * its conversion against the copy. The kernel tested is the one this project
+ * is compiled for, so build it with /arch:IA32 and /arch:SSE2 to check both.
+ */
+
+#include <algorithm>  /* Included for min */
+#include <cmath>
+#include <cstdlib>  /* Included for rand */
+#include <iostream>
+#include <vector>
+#include "ColorConverter.h"
+#include "Tests.h"
+
+/* Size of the frames converted, odd and wider than the chunks converted */
+/* at a time.                                                            */
+#define TEST_WIDTH 131
+#define TEST_HEIGHT 37
+
+/* Size of the frames timed, and number of times each benchmark is run. */
+#define BENCH_WIDTH 800
+#define BENCH_HEIGHT 600
+#define BENCH_RUNS 100
+
+/* Converts an RGB pixel to Y, Cb, and Cr one value at a time, with the */
+/* coefficients ColorConverter uses.                                    */
+static void referenceYCbCr(const unsigned char* rgb, unsigned char& luma,
+	unsigned char& blue, unsigned char& red)
+{
+	int r = rgb[0], g = rgb[1], b = rgb[2];
+	int y = (9798 * r + 19235 * g + 3735 * b + 256 * 64) >> 15;
+	int cb = (-5529 * r - 10855 * g + 16384 * b + 256 * 16448) >> 15;
+	int cr = (16384 * r - 13720 * g - 2664 * b + 256 * 16448) >> 15;
+	luma = (unsigned char)y;
+	blue = (unsigned char)std::min(cb, 255);
+	red = (unsigned char)std::min(cr, 255);
+}
+
+/* Returns how far the value is from the full range BT.601 value, rounded. */
+static double distance(unsigned char value, double exact)
+{
+	exact = std::floor(std::min(std::max(exact, 0.0), 255.0) + 0.5);
+	return std::fabs(value - exact);
+}
+
+/* Fills the pixels with random RGB values. */
+static void randomPixels(std::vector<unsigned char>& pixels)
+{
+	for (unsigned int i = 0; i < pixels.size(); i++)
+	{
+		pixels[i] = (unsigned char)(rand() % 256);
+	}
+}
+
+/* Returns if frameToYCbCr converts the frame in bands of rows as the      */
+/* JPEG encoder does, averaging the chroma of each block and repeating     */
+/* the last row and column past the edge, as computed one value at a time. */
+static bool convertsFrame(const std::vector<unsigned char>& pixels,
+	unsigned int subsampleX, unsigned int subsampleY)
+{
+	const unsigned int chromaWidth = (TEST_WIDTH + subsampleX - 1) /
+		subsampleX;
+	const unsigned int lumaStride = TEST_WIDTH + 5;
+	const unsigned int chromaStride = chromaWidth + 3;
+	const unsigned int bandRows = 8 * subsampleY;
+	std::vector<unsigned char> luma(lumaStride * bandRows);
+	std::vector<unsigned char> blue(chromaStride * 8), red(chromaStride * 8);
+
+	bool same = true;
+	for (unsigned int firstRow = 0; firstRow < TEST_HEIGHT;
+		firstRow += bandRows)
+	{
+		ColorConverter::frameToYCbCr(&pixels[0], TEST_WIDTH, TEST_HEIGHT,
+			firstRow, bandRows, subsampleX, subsampleY, &luma[0], lumaStride,
+			&blue[0], &red[0], chromaStride);
+
+		/* The pixels start with the bottom row, the planes with the top */
+		for (unsigned int y = 0; y < bandRows; y++)
+		{
+			unsigned int sourceY = std::min(firstRow + y, TEST_HEIGHT - 1u);
+			const unsigned char* row = &pixels[3 * TEST_WIDTH *
+				(TEST_HEIGHT - 1 - sourceY)];
+			for (unsigned int x = 0; x < lumaStride; x++)
+			{
+				unsigned char expected, unusedBlue, unusedRed;
+				referenceYCbCr(row + 3 * std::min(x, TEST_WIDTH - 1u),
+					expected, unusedBlue, unusedRed);
+				same = same && luma[y * lumaStride + x] == expected;
+			}
+		}
+
+		/* Each block sums four values, repeating them when it is one */
+		/* pixel wide or tall                                         */
+		for (unsigned int y = 0; y < 8; y++)
+		{
+			for (unsigned int x = 0; x < chromaStride; x++)
+			{
+				unsigned int left = std::min(x, chromaWidth - 1) * subsampleX;
+				unsigned int top = firstRow + y * subsampleY;
+				int blueSum = 2, redSum = 2;
+				for (unsigned int i = 0; i < 4; i++)
+				{
+					unsigned int pixelX = std::min(left + (i % 2) *
+						(subsampleX - 1), TEST_WIDTH - 1u);
+					unsigned int pixelY = std::min(top + (i / 2) *
+						(subsampleY - 1), TEST_HEIGHT - 1u);
+					unsigned char unusedLuma, b, r;
+					referenceYCbCr(&pixels[3 * (TEST_WIDTH * (TEST_HEIGHT -
+						1 - pixelY) + pixelX)], unusedLuma, b, r);
+					blueSum += b;
+					redSum += r;
+				}
+				same = same && blue[y * chromaStride + x] == blueSum >> 2 &&
+					red[y * chromaStride + x] == redSum >> 2;
+			}
+		}
+	}
+	return same;
+}
+
+/* Test the ColorConverter class */
+void testColorConverter()
+{
+#ifdef COLORCONVERTER_SSE2
+	std::cout << "  checking the SSE2 kernel" << std::endl;
+#else
+	std::cout << "  checking the scalar kernel" << std::endl;
+#endif
+
+	/* Every count of pixels converts exactly as one at a time, including */
+	/* the pixels left over after the vector kernel                       */
+	srand(16);
+	std::vector<unsigned char> pixels(3 * TEST_WIDTH * TEST_HEIGHT);
+	randomPixels(pixels);
+	std::vector<unsigned char> luma(TEST_WIDTH), blue(TEST_WIDTH),
+		red(TEST_WIDTH);
+	unsigned int sameCounts = 0;
+	for (unsigned int count = 1; count <= TEST_WIDTH; count++)
+	{
+		ColorConverter::rgbToYCbCr(&pixels[3 * count], count, &luma[0],
+			&blue[0], &red[0]);
+		bool same = true;
+		for (unsigned int i = 0; i < count; i++)
+		{
+			unsigned char y, cb, cr;
+			referenceYCbCr(&pixels[3 * (count + i)], y, cb, cr);
+			same = same && luma[i] == y && blue[i] == cb && red[i] == cr;
+		}
+		sameCounts += same;
+	}
+	CHECK(sameCounts == TEST_WIDTH);
+
+	/* Every color is within one of BT.601, including the colors whose */
+	/* chroma rounds up to 256                                         */
+	double worst = 0;
+	unsigned char rgb[3 * 256];
+	luma.resize(256);
+	blue.resize(256);
+	red.resize(256);
+	for (unsigned int color = 0; color < 256 * 256 * 256; color += 256)
+	{
+		for (unsigned int i = 0; i < 256; i++)
+		{
+			rgb[3 * i] = (unsigned char)(color >> 16);
+			rgb[3 * i + 1] = (unsigned char)(color >> 8);
+			rgb[3 * i + 2] = (unsigned char)i;
+		}
+		ColorConverter::rgbToYCbCr(rgb, 256, &luma[0], &blue[0], &red[0]);
+		for (unsigned int i = 0; i < 256; i++)
+		{
+			double r = rgb[3 * i], g = rgb[3 * i + 1], b = rgb[3 * i + 2];
+			worst = std::max(worst, distance(luma[i],
+				0.299 * r + 0.587 * g + 0.114 * b));
+			worst = std::max(worst, distance(blue[i],
+				128 - 0.168736 * r - 0.331264 * g + 0.5 * b));
+			worst = std::max(worst, distance(red[i],
+				128 + 0.5 * r - 0.418688 * g - 0.081312 * b));
+		}
+	}
+	CHECK(worst <= 1);
+
+	/* Frames convert and subsample as one value at a time */
+	CHECK(convertsFrame(pixels, 1, 1));
+	CHECK(convertsFrame(pixels, 2, 1));
+	CHECK(convertsFrame(pixels, 2, 2));
+}
+
+/* Time the ColorConverter class against converting a pixel at a time */
+void benchColorConverter()
+{
+	srand(16);
+	std::vector<unsigned char> pixels(3 * BENCH_WIDTH * BENCH_HEIGHT);
+	randomPixels(pixels);
+	const unsigned int count = BENCH_WIDTH * BENCH_HEIGHT;
+	std::vector<unsigned char> luma(count), blue(count), red(count);
+
+	std::chrono::steady_clock::time_point start = Tests::now();
+	for (unsigned int r = 0; r < BENCH_RUNS; r++)
+	{
+		for (unsigned int i = 0; i < count; i++)
+		{
+			referenceYCbCr(&pixels[3 * i], luma[i], blue[i], red[i]);
+		}
+	}
+	Tests::report("convert 800x600, a pixel at a time", start, BENCH_RUNS);
+	std::vector<unsigned char> expected(luma);
+
+	start = Tests::now();
+	for (unsigned int r = 0; r < BENCH_RUNS; r++)
+	{
+		ColorConverter::rgbToYCbCr(&pixels[0], count, &luma[0], &blue[0],
+			&red[0]);
+	}
+	Tests::report("convert 800x600, ColorConverter", start, BENCH_RUNS);
+	CHECK(luma == expected);
+}
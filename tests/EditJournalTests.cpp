@@ -0,0 +1,177 @@
+/*
+ * EditJournalTests.cpp
+ * Created by Zachary Ferguson
+ * Tests of the EditJournal class, recovering a scene after random edits, with
+ * the last record of the journal cut short, and after a crash while the
+ * journal was being compacted into a new snapshot.
+ */
+
+#include <cstdio>   /* Included for remove */
+#include "EditJournal.h"
+#include "FrameWriter.h"
+#include "SceneFile.h"
+#include "TestScenes.h"
+#include "Tests.h"
+
+/* Nodes and frames of the scene edited. */
+#define TEST_NUM_NODES 60
+#define TEST_NUM_FRAMES 30
+
+/* Number of edits made before and after compacting by hand, and enough */
+/* edits for the journal to compact itself.                             */
+#define TEST_NUM_EDITS 500
+#define TEST_NUM_COMPACTING_EDITS (JOURNAL_COMPACT_RECORDS + 1000)
+
+/* The snapshot and journals of the autosave. */
+#define TEST_FILENAME "test_autosave.asg"
+#define TEST_JOURNAL TEST_FILENAME ".journal"
+#define TEST_OLD_JOURNAL TEST_FILENAME ".journal.old"
+
+/* Makes numEdits random edits to the Nodes of the scene graph as the     */
+/* editor does, changing keyframes' values, keying subtrees and removing  */
+/* keyframes, and records each in the journal.                            */
+static void editRandomly(EditJournal& journal, Node* root,
+	const std::vector<Node*>& nodes, unsigned int& state,
+	unsigned int numEdits)
+{
+	bool interpolated = Node::getInterpolated();
+	float values[KeyframeTrack::NUM_CHANNELS];
+	for (unsigned int i = 0; i < numEdits; i++)
+	{
+		Node* node = nodes[TestScenes::nextRandom(state) % nodes.size()];
+		unsigned int frameNum = TestScenes::nextRandom(state) %
+			TEST_NUM_FRAMES;
+		switch (TestScenes::nextRandom(state) % 4)
+		{
+			case 0:
+			case 1:
+				TestScenes::randomValues(state, values);
+				node->setKeyframe(frameNum, values);
+				journal.recordKeyframe(root, node, frameNum);
+				break;
+			case 2:
+				Node::setInterpolated(TestScenes::nextRandom(state) % 2 == 0);
+				node->makeKeyframe(frameNum);
+				journal.recordMakeKeyframe(root, node, frameNum);
+				break;
+			default:
+				if (frameNum > 0)
+				{
+					node->removeKeyframe(frameNum);
+					journal.recordRemoveKeyframe(root, node, frameNum);
+				}
+				break;
+		}
+	}
+	Node::setInterpolated(interpolated);
+}
+
+/* Returns the bytes of the scene graph as a scene file, which are the same */
+/* only for the same scene.                                                 */
+static std::vector<unsigned char> sceneBytes(const Node* root)
+{
+	std::vector<unsigned char> bytes;
+	if (root != NULL)
+	{
+		SceneFile::serialize(root, bytes);
+	}
+	return bytes;
+}
+
+/* Returns the bytes of the scene recovered from the autosave. */
+static std::vector<unsigned char> recoveredBytes()
+{
+	Node* recovered = EditJournal::recover(TEST_FILENAME);
+	std::vector<unsigned char> bytes = sceneBytes(recovered);
+	if (recovered != NULL)
+	{
+		TestScenes::deleteScene(recovered);
+	}
+	return bytes;
+}
+
+/* Test the EditJournal class */
+void testEditJournal()
+{
+	Node* root = TestScenes::randomScene(3, TEST_NUM_NODES, TEST_NUM_FRAMES);
+	std::vector<Node*> nodes;
+	TestScenes::getNodes(root, nodes);
+	unsigned int state = 11;
+
+	/* The scene after random edits is recovered, including after the */
+	/* journal compacted itself into a new snapshot                   */
+	EditJournal* journal = new EditJournal(TEST_FILENAME);
+	CHECK(journal->snapshot(root) && EditJournal::hasRecovery(TEST_FILENAME));
+	CHECK(recoveredBytes() == sceneBytes(root));
+	editRandomly(*journal, root, nodes, state, TEST_NUM_EDITS);
+	CHECK(recoveredBytes() == sceneBytes(root));
+	editRandomly(*journal, root, nodes, state, TEST_NUM_COMPACTING_EDITS);
+	delete journal;
+	Node* recovered = EditJournal::recover(TEST_FILENAME);
+	CHECK(recovered != NULL && TestScenes::sameScene(root, recovered) &&
+		TestScenes::sameFrames(root, recovered));
+	if (recovered != NULL)
+	{
+		TestScenes::deleteScene(recovered);
+	}
+
+	/* A last record cut short by a crash, or changed, is not replayed */
+	journal = new EditJournal(TEST_FILENAME);
+	CHECK(journal->snapshot(root));
+	editRandomly(*journal, root, nodes, state, TEST_NUM_EDITS);
+	std::vector<unsigned char> before = sceneBytes(root);
+	float values[KeyframeTrack::NUM_CHANNELS];
+	TestScenes::randomValues(state, values);
+	nodes.back()->setKeyframe(1, values);
+	journal->recordKeyframe(root, nodes.back(), 1);
+	delete journal;
+	std::vector<unsigned char> journalBytes;
+	CHECK(FrameWriter::readFile(TEST_JOURNAL, journalBytes));
+	CHECK(recoveredBytes() == sceneBytes(root));
+	for (unsigned int cut = 1; cut < 20; cut += 6)
+	{
+		FrameWriter::writeFile(TEST_JOURNAL, std::vector<unsigned char>(
+			journalBytes.begin(), journalBytes.end() - cut));
+		CHECK(recoveredBytes() == before);
+	}
+	std::vector<unsigned char> changed(journalBytes);
+	changed[changed.size() - 30] ^= 1;
+	FrameWriter::writeFile(TEST_JOURNAL, changed);
+	CHECK(recoveredBytes() == before);
+
+	/* A crash while compacting leaves the old snapshot and the journal */
+	/* being compacted, which the journal started after it follows on   */
+	/* from                                                             */
+	journal = new EditJournal(TEST_FILENAME);
+	CHECK(journal->snapshot(root));
+	editRandomly(*journal, root, nodes, state, TEST_NUM_EDITS);
+	std::vector<unsigned char> oldSnapshot, oldJournal, newSnapshot;
+	CHECK(FrameWriter::readFile(TEST_FILENAME, oldSnapshot));
+	CHECK(FrameWriter::readFile(TEST_JOURNAL, oldJournal));
+	journal->compact(root);
+	editRandomly(*journal, root, nodes, state, TEST_NUM_EDITS);
+	delete journal;
+	CHECK(FrameWriter::readFile(TEST_FILENAME, newSnapshot));
+	CHECK(newSnapshot != oldSnapshot);
+	CHECK(recoveredBytes() == sceneBytes(root));
+
+	/* Whether the crash came before the new snapshot was written or after */
+	CHECK(FrameWriter::writeFile(TEST_OLD_JOURNAL, oldJournal));
+	CHECK(recoveredBytes() == sceneBytes(root));
+	CHECK(FrameWriter::writeFile(TEST_FILENAME, oldSnapshot));
+	CHECK(recoveredBytes() == sceneBytes(root));
+
+	/* A journal of another snapshot is not replayed over this one */
+	remove(TEST_OLD_JOURNAL);
+	CHECK(recoveredBytes() == oldSnapshot);
+
+	/* Discarding the autosave leaves nothing to recover */
+	journal = new EditJournal(TEST_FILENAME);
+	CHECK(journal->snapshot(root));
+	journal->discard();
+	delete journal;
+	CHECK(!EditJournal::hasRecovery(TEST_FILENAME));
+	CHECK(EditJournal::recover(TEST_FILENAME) == NULL);
+
+	TestScenes::deleteScene(root);
+}
@@ -0,0 +1,89 @@
+/*
+ * FramePipelineTests.cpp
+ * Created by Zachary Ferguson
+ * Tests that the FramePipeline captures and writes frames into buffers that
+ * already exist, counting the allocations made while rendering more and more
+ * frames. Replaces the global operator new of the Tests project to count them.
+ */
+
+#include <atomic>
+#include <cstdlib>  /* Included for malloc and free */
+#include <new>
+#include "JPEGSequenceSink.h"
+#include "OfflineRenderer.h"
+#include "SceneLibrary.h"
+#include "Tests.h"
+
+/* Size and most frames of the renders tested. */
+#define TEST_WIDTH 320
+#define TEST_HEIGHT 240
+#define TEST_NUM_FRAMES 120
+
+/* Most allocations a render may make for every frame it renders past the */
+/* first quarter. An allocation made for every frame would make at least  */
+/* one, the encoded frame buffers growing to fit a larger frame only make */
+/* a few over the whole render.                                           */
+#define MAX_ALLOCATIONS_PER_FRAME 0.75
+
+/* Number of times operator new was called. */
+static std::atomic<unsigned long> numAllocations(0);
+
+/* Counts every allocation made with new. */
+void* operator new(size_t size)
+{
+	numAllocations++;
+	void* memory = malloc(size == 0 ? 1 : size);
+	if (memory == NULL)
+	{
+		throw std::bad_alloc();
+	}
+	return memory;
+}
+
+/* Frees the memory of operator new. */
+void operator delete(void* memory) throw()
+{
+	free(memory);
+}
+
+/* Returns the number of allocations made rendering the first numFrames */
+/* frames of the scene graph to a JPEG sequence.                        */
+static unsigned long countAllocations(const Node* root,
+	unsigned int numFrames, unsigned int numThreads)
+{
+	JPEGSequenceSink sink("test_pipeline_", JPEG_QUALITY,
+		FrameWriter::SUBSAMPLE_420);
+	sink.open(TEST_WIDTH, TEST_HEIGHT, 10);
+	RenderJob job(0, numFrames - 1, 1);
+	job.prepare(root, sink, TEST_WIDTH, TEST_HEIGHT);
+	OfflineRenderer renderer(root, TEST_WIDTH, TEST_HEIGHT);
+	renderer.setNumThreads(numThreads);
+	unsigned long before = numAllocations;
+	CHECK(renderer.render(&job, &sink));
+	unsigned long allocations = numAllocations - before;
+	sink.close();
+	Tests::removeFrameFiles("test_pipeline_", numFrames, ".jpg");
+	return allocations;
+}
+
+/* Test the FramePipeline class */
+void testFramePipeline()
+{
+	bool interpolated = Node::getInterpolated();
+	Node::setInterpolated(true);
+	Node* root = SceneLibrary::createSceneGraph("walk", TEST_NUM_FRAMES);
+
+	/* Rendering more frames allocates no more, past setting up */
+	for (unsigned int numThreads = 1; numThreads <= 4; numThreads += 3)
+	{
+		unsigned long few = countAllocations(root, TEST_NUM_FRAMES / 4,
+			numThreads);
+		unsigned long many = countAllocations(root, TEST_NUM_FRAMES,
+			numThreads);
+		CHECK(many <= few + (unsigned long)(MAX_ALLOCATIONS_PER_FRAME *
+			(TEST_NUM_FRAMES - TEST_NUM_FRAMES / 4)));
+	}
+
+	delete root;
+	Node::setInterpolated(interpolated);
+}
@@ -0,0 +1,106 @@
+/*
+ * FrameReadbackTests.cpp
+ * Created by Zachary Ferguson
+ * Tests of the FrameReadback class against reading each frame directly with
+ * glReadPixels, in an OpenGL window the size of an odd number of pixels.
+ */
+
+#include <iostream>
+#include <vector>
+#include <FL/Fl.H>
+#include <FL/Fl_Gl_Window.H>
+#include "FrameReadback.h"
+#include "Tests.h"
+
+/* Size of the window, a width that does not fill whole words. */
+#define TEST_WIDTH 321
+#define TEST_HEIGHT 200
+
+/* Number of frames read back, more than there are buffers. */
+#define TEST_NUM_FRAMES 20
+
+/* An OpenGL window the frames are drawn in by the test, not by draw. */
+class ReadbackWindow : public Fl_Gl_Window
+{
+	public:
+
+		/* Constructor for a ReadbackWindow of the test size. */
+		ReadbackWindow() : Fl_Gl_Window(0, 0, TEST_WIDTH, TEST_HEIGHT,
+			"FrameReadback test")
+		{
+		}
+
+		/* Draws nothing, the test draws the frames itself. */
+		virtual void draw()
+		{
+		}
+};
+
+/* Draws a frame that differs from the frames around it. */
+static void drawFrame(unsigned int frameNum)
+{
+	glViewport(0, 0, TEST_WIDTH, TEST_HEIGHT);
+	glClearColor((frameNum % 7) / 7.0f, (frameNum % 5) / 5.0f,
+		(frameNum % 3) / 3.0f, 1.0f);
+	glClear(GL_COLOR_BUFFER_BIT);
+	glBegin(GL_TRIANGLES);
+	glColor3f(1.0f, 1.0f, 1.0f);
+	glVertex2f(-1.0f + frameNum * 0.05f, -1.0f);
+	glVertex2f(1.0f, -1.0f);
+	glVertex2f(0.0f, 1.0f);
+	glEnd();
+	glFinish();
+}
+
+/* Test the FrameReadback class */
+void testFrameReadback()
+{
+	ReadbackWindow window;
+	window.show();
+	Fl::check();
+	if (!window.shown())
+	{
+		std::cout << "  skipped, no window could be shown" << std::endl;
+		return;
+	}
+	window.make_current();
+
+	/* Read every frame directly, waiting on each one */
+	std::vector<std::vector<unsigned char> > expected(TEST_NUM_FRAMES,
+		std::vector<unsigned char>(3 * TEST_WIDTH * TEST_HEIGHT));
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+	for (unsigned int i = 0; i < TEST_NUM_FRAMES; i++)
+	{
+		drawFrame(i);
+		glReadPixels(0, 0, TEST_WIDTH, TEST_HEIGHT, GL_RGB, GL_UNSIGNED_BYTE,
+			&expected[i][0]);
+	}
+
+	/* Read the same frames through the ring, taking a frame only when */
+	/* the ring is full, and the rest at the end                       */
+	FrameReadback readback(TEST_WIDTH, TEST_HEIGHT);
+	std::cout << "  checking the " << (readback.isAsync() ?
+		"pixel buffer object" : "glReadPixels") << " path" << std::endl;
+	std::vector<unsigned char> pixels;
+	unsigned int taken = 0, same = 0;
+	for (unsigned int i = 0; i < TEST_NUM_FRAMES; i++)
+	{
+		drawFrame(i);
+		readback.readFrame();
+		if (!readback.canRead() && readback.takeFrame(pixels))
+		{
+			same += taken < TEST_NUM_FRAMES && pixels == expected[taken];
+			taken++;
+		}
+	}
+	while (readback.takeFrame(pixels))
+	{
+		same += taken < TEST_NUM_FRAMES && pixels == expected[taken];
+		taken++;
+	}
+	CHECK(taken == TEST_NUM_FRAMES);
+	CHECK(same == TEST_NUM_FRAMES);
+	CHECK(!readback.takeFrame(pixels));
+
+	window.hide();
+}
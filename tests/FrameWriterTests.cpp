@@ -0,0 +1,275 @@
+/*
+ * FrameWriterTests.cpp
+ * Created by Zachary Ferguson
+ * Tests of the FrameWriter class, decoding the PNG and JPEG images it encodes
+ * and comparing them with the frames encoded and moving files over each other,
+ * and a benchmark of its encoders against the JPEG encoder it replaced, which
+ * handed libjpeg RGB rows.
+ */
+
+#include <cmath>
+#include <cstdio>   /* Included for FILE, used by jpeglib.h, and remove */
+#include <cstdlib>  /* Included for rand and free */
+#include <vector>
+#include <jpeg/jpeglib.h>
+#include "FrameWriter.h"
+#include "TestImages.h"
+#include "Tests.h"
+
+/* Size of the noise encoded, odd so rows do not fill whole blocks. */
+#define TEST_WIDTH 203
+#define TEST_HEIGHT 151
+
+/* Least peak signal to noise ratio, in decibels, of the walking animal */
+/* encoded at the default quality.                                      */
+#define MIN_PSNR 30.0
+
+/* Files moved over each other, and a path no file can be moved to. */
+#define TEST_FILENAME "test_replaced.bin"
+#define TEST_NEW_FILENAME TEST_FILENAME ".new"
+#define TEST_MISSING_PATH "missing_directory/" TEST_FILENAME
+
+/* Size of the frames timed, and number of times each benchmark is run. */
+#define BENCH_WIDTH 800
+#define BENCH_HEIGHT 600
+#define BENCH_RUNS 20
+
+/* Decodes a JPEG image into RGB pixels starting with the bottom row, like */
+/* glReadPixels. Sets subsampling to how its chroma was subsampled.        */
+static void decodeJPEG(const std::vector<unsigned char>& jpeg,
+	unsigned int& width, unsigned int& height,
+	std::vector<unsigned char>& pixels, FrameWriter::Subsampling& subsampling)
+{
+	struct jpeg_decompress_struct cinfo;
+	struct jpeg_error_mgr jerr;
+	cinfo.err = jpeg_std_error(&jerr);
+	jpeg_create_decompress(&cinfo);
+	jpeg_mem_src(&cinfo, (unsigned char*)&jpeg[0], (unsigned long)jpeg.size());
+	jpeg_read_header(&cinfo, TRUE);
+	subsampling = cinfo.comp_info[0].h_samp_factor == 1 ?
+		FrameWriter::SUBSAMPLE_444 : cinfo.comp_info[0].v_samp_factor == 1 ?
+		FrameWriter::SUBSAMPLE_422 : FrameWriter::SUBSAMPLE_420;
+	jpeg_start_decompress(&cinfo);
+
+	width = cinfo.output_width;
+	height = cinfo.output_height;
+	pixels.resize(3 * width * height);
+	while (cinfo.output_scanline < height)
+	{
+		JSAMPROW row = &pixels[3 * width * (height - 1 -
+			cinfo.output_scanline)];
+		jpeg_read_scanlines(&cinfo, &row, 1);
+	}
+	jpeg_finish_decompress(&cinfo);
+	jpeg_destroy_decompress(&cinfo);
+}
+
+/* Returns the peak signal to noise ratio of the decoded pixels, in */
+/* decibels.                                                        */
+static double psnr(const std::vector<unsigned char>& pixels,
+	const std::vector<unsigned char>& decoded)
+{
+	double squaredError = 0;
+	for (unsigned int i = 0; i < pixels.size(); i++)
+	{
+		double difference = (double)pixels[i] - decoded[i];
+		squaredError += difference * difference;
+	}
+	return 10 * log10(255.0 * 255.0 * pixels.size() / squaredError);
+}
+
+/* Encodes the pixels as a JPEG image with the given quality and chroma */
+/* subsampling, and decodes it again. Sets size to the size of the      */
+/* image. Returns its peak signal to noise ratio, or 0 if the image     */
+/* decoded to the wrong size or subsampling.                            */
+static double encodeJPEG(const std::vector<unsigned char>& pixels,
+	unsigned int width, unsigned int height, int quality,
+	FrameWriter::Subsampling subsampling, size_t& size)
+{
+	std::vector<unsigned char> jpeg, decoded;
+	FrameWriter::encodeJPEG(&pixels[0], width, height, quality, subsampling,
+		jpeg);
+	size = jpeg.size();
+
+	unsigned int decodedWidth, decodedHeight;
+	FrameWriter::Subsampling decodedSubsampling;
+	decodeJPEG(jpeg, decodedWidth, decodedHeight, decoded,
+		decodedSubsampling);
+	if (decodedWidth != width || decodedHeight != height ||
+		decodedSubsampling != subsampling)
+	{
+		return 0;
+	}
+	return psnr(pixels, decoded);
+}
+
+/* Returns if the PNG encoding of the pixels decodes to the same pixels. */
+static bool roundTripsPNG(const std::vector<unsigned char>& pixels,
+	unsigned int width, unsigned int height)
+{
+	std::vector<unsigned char> png, decoded;
+	FrameWriter::encodePNG(&pixels[0], width, height, png);
+	unsigned int decodedWidth, decodedHeight;
+	return TestImages::decodePNG(png, decodedWidth, decodedHeight, decoded) &&
+		decodedWidth == width && decodedHeight == height &&
+		decoded == pixels;
+}
+
+/* Encodes the pixels as a JPEG image as FrameWriter did before it had a */
+/* quality or subsampling, handing libjpeg RGB rows to convert.          */
+static void encodeRGBRows(const unsigned char* pixels, unsigned int width,
+	unsigned int height, std::vector<unsigned char>& jpeg)
+{
+	struct jpeg_compress_struct cinfo;
+	struct jpeg_error_mgr jerr;
+	unsigned char* buffer = NULL;
+	unsigned long size = 0;
+	cinfo.err = jpeg_std_error(&jerr);
+	jpeg_create_compress(&cinfo);
+	jpeg_mem_dest(&cinfo, &buffer, &size);
+
+	cinfo.image_width = width;
+	cinfo.image_height = height;
+	cinfo.input_components = 3;
+	cinfo.in_color_space = JCS_RGB;
+	jpeg_set_defaults(&cinfo);
+	jpeg_set_quality(&cinfo, JPEG_QUALITY, TRUE);
+	jpeg_start_compress(&cinfo, TRUE);
+
+	const unsigned int rowStride = 3 * width;
+	JSAMPROW row_pointer[1];
+	row_pointer[0] = (JSAMPROW)(pixels + (height - 1) * rowStride);
+	while (cinfo.next_scanline < cinfo.image_height)
+	{
+		jpeg_write_scanlines(&cinfo, row_pointer, 1);
+		row_pointer[0] -= rowStride;
+	}
+
+	jpeg_finish_compress(&cinfo);
+	jpeg_destroy_compress(&cinfo);
+	jpeg.assign(buffer, buffer + size);
+	free(buffer);
+}
+
+/* Test the FrameWriter class */
+void testFrameWriter()
+{
+	unsigned int width, height;
+	std::vector<unsigned char> walk;
+	if (!CHECK(TestImages::readPNG(REFERENCE_DIRECTORY "walk_005.png", width,
+		height, walk)))
+	{
+		return;
+	}
+	srand(16);
+	std::vector<unsigned char> noise(3 * TEST_WIDTH * TEST_HEIGHT);
+	for (unsigned int i = 0; i < noise.size(); i++)
+	{
+		noise[i] = (unsigned char)(rand() % 256);
+	}
+
+	/* PNG images decode to exactly the frames encoded */
+	CHECK(roundTripsPNG(walk, width, height));
+	CHECK(roundTripsPNG(noise, TEST_WIDTH, TEST_HEIGHT));
+
+	/* JPEG images decode to the size and subsampling encoded, close to */
+	/* the frame, and closer and larger with a higher quality or less   */
+	/* subsampling                                                      */
+	static const FrameWriter::Subsampling subsamplings[] =
+	{
+		FrameWriter::SUBSAMPLE_444,
+		FrameWriter::SUBSAMPLE_422,
+		FrameWriter::SUBSAMPLE_420
+	};
+	double previous = 0;
+	size_t previousSize = 0;
+	for (unsigned int i = 0; i < 3; i++)
+	{
+		size_t low, high, unusedSize;
+		double lowPSNR = encodeJPEG(walk, width, height, 50, subsamplings[i],
+			low);
+		double highPSNR = encodeJPEG(walk, width, height, 95,
+			subsamplings[i], high);
+		double defaultPSNR = encodeJPEG(walk, width, height, JPEG_QUALITY,
+			subsamplings[i], unusedSize);
+		CHECK(defaultPSNR > MIN_PSNR);
+		CHECK(highPSNR > defaultPSNR && defaultPSNR > lowPSNR);
+		CHECK(high > low);
+		CHECK(encodeJPEG(noise, TEST_WIDTH, TEST_HEIGHT, JPEG_QUALITY,
+			subsamplings[i], unusedSize) > 0);
+		if (i > 0)
+		{
+			CHECK(highPSNR < previous && high < previousSize);
+		}
+		previous = highPSNR;
+		previousSize = high;
+	}
+
+	/* Moving a file over another replaces it, and a failed move leaves */
+	/* the new file where it was                                        */
+	std::vector<unsigned char> oldBytes(10, 1), newBytes(20, 2), bytes;
+	CHECK(FrameWriter::writeFile(TEST_FILENAME, oldBytes) &&
+		FrameWriter::writeFile(TEST_NEW_FILENAME, newBytes));
+	CHECK(FrameWriter::replaceFile(TEST_NEW_FILENAME, TEST_FILENAME));
+	CHECK(FrameWriter::readFile(TEST_FILENAME, bytes) && bytes == newBytes);
+	CHECK(!FrameWriter::readFile(TEST_NEW_FILENAME, bytes));
+	CHECK(FrameWriter::writeFile(TEST_NEW_FILENAME, oldBytes));
+	CHECK(!FrameWriter::replaceFile(TEST_NEW_FILENAME, TEST_MISSING_PATH));
+	CHECK(FrameWriter::readFile(TEST_NEW_FILENAME, bytes) &&
+		bytes == oldBytes);
+	remove(TEST_NEW_FILENAME);
+	remove(TEST_FILENAME);
+}
+
+/* Time the FrameWriter class against its old JPEG encoder */
+void benchFrameWriter()
+{
+	/* Tile the walking animal out to the size of a larger frame */
+	unsigned int width, height;
+	std::vector<unsigned char> walk;
+	if (!CHECK(TestImages::readPNG(REFERENCE_DIRECTORY "walk_005.png", width,
+		height, walk)))
+	{
+		return;
+	}
+	std::vector<unsigned char> pixels(3 * BENCH_WIDTH * BENCH_HEIGHT);
+	for (unsigned int y = 0; y < BENCH_HEIGHT; y++)
+	{
+		for (unsigned int x = 0; x < 3 * BENCH_WIDTH; x++)
+		{
+			pixels[3 * BENCH_WIDTH * y + x] = walk[3 * width * (y % height) +
+				x % (3 * width)];
+		}
+	}
+
+	std::vector<unsigned char> bytes;
+	std::chrono::steady_clock::time_point start = Tests::now();
+	for (unsigned int r = 0; r < BENCH_RUNS; r++)
+	{
+		encodeRGBRows(&pixels[0], BENCH_WIDTH, BENCH_HEIGHT, bytes);
+	}
+	Tests::report("JPEG 800x600, RGB rows", start, BENCH_RUNS);
+
+	start = Tests::now();
+	for (unsigned int r = 0; r < BENCH_RUNS; r++)
+	{
+		FrameWriter::encodeJPEG(&pixels[0], BENCH_WIDTH, BENCH_HEIGHT,
+			JPEG_QUALITY, FrameWriter::SUBSAMPLE_420, bytes);
+	}
+	Tests::report("JPEG 800x600, FrameWriter 4:2:0", start, BENCH_RUNS);
+
+	start = Tests::now();
+	for (unsigned int r = 0; r < BENCH_RUNS; r++)
+	{
+		FrameWriter::encodeJPEG(&pixels[0], BENCH_WIDTH, BENCH_HEIGHT,
+			JPEG_QUALITY, FrameWriter::SUBSAMPLE_444, bytes);
+	}
+	Tests::report("JPEG 800x600, FrameWriter 4:4:4", start, BENCH_RUNS);
+
+	start = Tests::now();
+	for (unsigned int r = 0; r < BENCH_RUNS; r++)
+	{
+		FrameWriter::encodePNG(&pixels[0], BENCH_WIDTH, BENCH_HEIGHT, bytes);
+	}
+	Tests::report("PNG 800x600, FrameWriter", start, BENCH_RUNS);
+}
@@ -0,0 +1,215 @@
+/*
+ * JSONReaderTests.cpp
+ * Created by Zachary Ferguson
+ * Tests of the JSONReader class, reading the tokens, strings and numbers of
+ * small documents, values split across the blocks read, and malformed or
+ * truncated text, and a benchmark of reading a large scene.
+ */
+
+#include <cstdio>   /* Included for remove */
+#include <cstdlib>  /* Included for strtod */
+#include <iostream>
+#include "FrameWriter.h"
+#include "JSONReader.h"
+#include "SceneJSON.h"
+#include "TestScenes.h"
+#include "Tests.h"
+
+/* File the documents are written to. */
+#define TEST_FILENAME "test_reader.json"
+
+/* Nodes and frames of the scene read by the benchmark, and times it is */
+/* read.                                                                */
+#define BENCH_NUM_NODES 20000
+#define BENCH_NUM_FRAMES 30
+#define BENCH_RUNS 5
+
+/* Character standing for each kind of token, in the order of the enum. */
+static const char TOKEN_CODES[] = "{}[]:s#tfn.!";
+
+/* Writes the text to the test file. Returns if it was written. */
+static bool writeText(const std::string& text)
+{
+	return FrameWriter::writeFile(TEST_FILENAME,
+		std::vector<unsigned char>(text.begin(), text.end()));
+}
+
+/* Returns the tokens of the text, a character for each, up to the end of */
+/* the file or the first error.                                           */
+static std::string tokensOf(const std::string& text)
+{
+	JSONReader reader;
+	if (!writeText(text) || !reader.open(TEST_FILENAME))
+	{
+		return "";
+	}
+	std::string tokens;
+	JSONReader::Token token;
+	do
+	{
+		token = reader.next();
+		tokens += TOKEN_CODES[token];
+	} while (token != JSONReader::END && token != JSONReader::ERROR);
+	return tokens;
+}
+
+/* Returns if the text reads as the single string expected. */
+static bool readsString(const std::string& text, const std::string& expected)
+{
+	JSONReader reader;
+	return writeText(text) && reader.open(TEST_FILENAME) &&
+		reader.next() == JSONReader::STRING &&
+		reader.getText() == expected && reader.next() == JSONReader::END;
+}
+
+/* Returns if the text reads as a single number equal to the closest */
+/* double to it.                                                     */
+static bool readsNumber(const char* text)
+{
+	JSONReader reader;
+	return writeText(text) && reader.open(TEST_FILENAME) &&
+		reader.next() == JSONReader::NUMBER &&
+		reader.getNumber() == strtod(text, NULL) &&
+		reader.next() == JSONReader::END;
+}
+
+/* Test the JSONReader class */
+void testJSONReader()
+{
+	/* The tokens of a document, with the names, strings and numbers */
+	CHECK(tokensOf("{\"a\": [1, -2.5e3, true, false, null, \"x\"], "
+		"\"b\": {}, \"c\": [[]]}") == "{:[##tfns]:{}:[[]]}.");
+	CHECK(tokensOf(" \r\n\t7 ") == "#.");
+	CHECK(tokensOf("\"\"") == "s.");
+	JSONReader reader;
+	CHECK(writeText("{\"name\":\n\n\"value\" , \"n\" : 12.75}") &&
+		reader.open(TEST_FILENAME));
+	CHECK(reader.next() == JSONReader::BEGIN_OBJECT);
+	CHECK(reader.next() == JSONReader::NAME && reader.getText() == "name");
+	CHECK(reader.next() == JSONReader::STRING &&
+		reader.getText() == "value" && reader.getLine() == 3);
+	CHECK(reader.next() == JSONReader::NAME && reader.getText() == "n");
+	CHECK(reader.next() == JSONReader::NUMBER && reader.getNumber() == 12.75);
+	CHECK(reader.next() == JSONReader::END_OBJECT);
+	CHECK(reader.next() == JSONReader::END);
+	reader.close();
+
+	/* Escapes, including code points outside the basic plane */
+	CHECK(readsString("\"a\\\"b\\\\c\\/d\"", "a\"b\\c/d"));
+	CHECK(readsString("\"\\b\\f\\n\\r\\t\"", "\b\f\n\r\t"));
+	CHECK(readsString("\"\\u0041\\u00e9\\u20AC\\ud83d\\ude00\"",
+		"A\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80"));
+
+	/* Numbers read as the closest double, by the fast path or strtod */
+	const char* numbers[] = {"0", "-0", "1", "-17", "0.1", "3.14159",
+		"1e-7", "2.5E+3", "123456789012", "9007199254740993",
+		"0.30000000000000004", "1.7976931348623157e308", "4.9e-324",
+		"123456789012345678901234567890", "0.000000000000000000001", "1e39"};
+	unsigned int numNumbers = sizeof(numbers) / sizeof(numbers[0]);
+	unsigned int readNumbers = 0;
+	for (unsigned int i = 0; i < numNumbers; i++)
+	{
+		readNumbers += readsNumber(numbers[i]);
+	}
+	CHECK(readNumbers == numNumbers);
+
+	/* Strings and numbers split across the blocks read */
+	std::string longString(JSON_READ_BLOCK_SIZE * 2 + 17, 'q');
+	CHECK(readsString("\"" + longString + "\"", longString));
+	std::string padded(JSON_READ_BLOCK_SIZE - 3, ' ');
+	CHECK(writeText(padded + "[12345.5, \"\\u00e9\"]") &&
+		reader.open(TEST_FILENAME));
+	CHECK(reader.next() == JSONReader::BEGIN_ARRAY);
+	CHECK(reader.next() == JSONReader::NUMBER &&
+		reader.getNumber() == 12345.5);
+	CHECK(reader.next() == JSONReader::STRING &&
+		reader.getText() == "\xc3\xa9");
+	CHECK(reader.next() == JSONReader::END_ARRAY);
+	CHECK(reader.next() == JSONReader::END);
+	reader.close();
+
+	/* Nesting is allowed as deep as the limit and no deeper */
+	std::string deepest = std::string(JSON_MAX_DEPTH, '[') +
+		std::string(JSON_MAX_DEPTH, ']');
+	CHECK(tokensOf(deepest)[2 * JSON_MAX_DEPTH] == '.');
+	std::string tooDeep = "[" + deepest + "]";
+	CHECK(tokensOf(tooDeep).find('!') != std::string::npos);
+
+	/* Malformed documents stop at an error, which every later token is */
+	const char* malformed[] = {"", " ", "{", "[1,]", "[,1]", "{\"a\" 1}",
+		"{\"a\":}", "{\"a\":1,}", "{a:1}", "{1:1}", "[1 2]", "{} {}",
+		"[01]", "[1.]", "[.5]", "[1e]", "[+1]", "[--1]", "[1.5.5]", "tru",
+		"nul", "True", "\"abc", "[\"\\x\"]", "[\"\\u12\"]", "[\"\\ud800\"]",
+		"[\"\\udc00\"]", "[\"a\tb\"]", "[\"a\nb\"]", "]", "[}", "{]",
+		"[1]]", "\"a\" \"b\"", "[1e400]", "[-1e400]"};
+	unsigned int numMalformed = sizeof(malformed) / sizeof(malformed[0]);
+	unsigned int rejected = 0;
+	for (unsigned int i = 0; i < numMalformed; i++)
+	{
+		std::string tokens = tokensOf(malformed[i]);
+		rejected += (tokens.find('.') == std::string::npos);
+	}
+	CHECK(rejected == numMalformed);
+	CHECK(writeText("[1, ?]") && reader.open(TEST_FILENAME));
+	reader.next();
+	reader.next();
+	CHECK(reader.next() == JSONReader::ERROR && !reader.getError().empty());
+	CHECK(reader.next() == JSONReader::ERROR);
+	reader.close();
+
+	/* A document cut short anywhere is an error */
+	std::string document = "{\"a\": [1.5, \"\\u00e9x\", {\"b\": null}], "
+		"\"c\": true}";
+	CHECK(tokensOf(document) == "{:[#s{:n}]:t}.");
+	unsigned int truncated = 0;
+	for (size_t size = 0; size < document.size(); size++)
+	{
+		truncated += (tokensOf(document.substr(0, size)).find('.') ==
+			std::string::npos);
+	}
+	CHECK(truncated == document.size());
+
+	/* Skipping a value skips all of it */
+	CHECK(writeText("[{\"a\": [1, {\"b\": []}]}, 2]") &&
+		reader.open(TEST_FILENAME));
+	CHECK(reader.next() == JSONReader::BEGIN_ARRAY);
+	CHECK(reader.skipValue(reader.next()));
+	CHECK(reader.next() == JSONReader::NUMBER && reader.getNumber() == 2);
+	CHECK(reader.next() == JSONReader::END_ARRAY);
+	reader.close();
+	CHECK(!reader.open("missing_" TEST_FILENAME));
+
+	remove(TEST_FILENAME);
+}
+
+/* Time reading the tokens of a large scene */
+void benchJSONReader()
+{
+	Node* scene = TestScenes::randomScene(1, BENCH_NUM_NODES,
+		BENCH_NUM_FRAMES);
+	bool saved = SceneJSON::save(scene, TEST_FILENAME);
+	TestScenes::deleteScene(scene);
+	if (!CHECK(saved))
+	{
+		return;
+	}
+
+	unsigned long long numBytes = 0;
+	std::chrono::steady_clock::time_point start = Tests::now();
+	for (unsigned int r = 0; r < BENCH_RUNS; r++)
+	{
+		JSONReader reader;
+		reader.open(TEST_FILENAME);
+		JSONReader::Token token;
+		do
+		{
+			token = reader.next();
+		} while (token != JSONReader::END && token != JSONReader::ERROR);
+		CHECK(token == JSONReader::END);
+		numBytes = reader.getBytesRead();
+	}
+	std::cout << "  Scene of " << BENCH_NUM_NODES << " Nodes, " <<
+		numBytes / 1e6 << " MB" << std::endl;
+	Tests::report("JSONReader, every token", start, BENCH_RUNS);
+	remove(TEST_FILENAME);
+}
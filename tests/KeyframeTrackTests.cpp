@@ -0,0 +1,339 @@
+/*
+ * KeyframeTrackTests.cpp
+ * Created by Zachary Ferguson
+ * Tests of the KeyframeTrack class, and a benchmark of it against the layout
+ * it replaced, a Frame allocated for every frame of the timeline.
+ */
+
+#include <algorithm>  /* Included for max */
+#include <cmath>
+#include <cstdlib>  /* Included for rand */
+#include <iostream>
+#include <map>
+#include <vector>
+#include "KeyframeTrack.h"
+#include "Tests.h"
+
+/* Number of frames and keyframes of the tracks tested and timed. */
+#define TEST_LENGTH 1000
+#define TEST_NUM_KEYFRAMES 60
+
+/* Number of times each benchmark is run. */
+#define BENCH_RUNS 200
+
+/* The layout of a Node's animation before KeyframeTrack, a Frame for every */
+/* frame of the timeline, each allocated on its own. In-between frames      */
+/* copy the previous keyframe, or are filled in by linearlyInterpolate.     */
+class FrameVectorTrack
+{
+	private:
+
+		/* A Frame for every frame of the timeline. */
+		std::vector<Frame*> frames;
+
+		/* Replaces the Frame at frameNum with a new one of the given values. */
+		void setFrame(unsigned int frameNum, const float values[8],
+			bool isKeyframe)
+		{
+			delete this->frames[frameNum];
+			this->frames[frameNum] = new Frame(
+				mat3::scale2D(values[0], values[1]),
+				mat3::rotation2D(values[2]),
+				mat3::translation2D(values[3], values[4]),
+				values[5], values[6], values[7], isKeyframe);
+		}
+
+		/* Fills values with the channels of the Frame at frameNum. */
+		void getFrame(unsigned int frameNum, float values[8]) const
+		{
+			const Frame* frame = this->frames[frameNum];
+			std::vector<float> colors = frame->getColors();
+			values[0] = frame->getScaleX();
+			values[1] = frame->getScaleY();
+			values[2] = frame->getRotation();
+			values[3] = frame->getTranslationX();
+			values[4] = frame->getTranslationY();
+			values[5] = colors[0];
+			values[6] = colors[1];
+			values[7] = colors[2];
+		}
+
+	public:
+
+		/* Constructor for a track of the given length, all holding the */
+		/* given keyframe at frame 0.                                   */
+		FrameVectorTrack(unsigned int length, const float first[8])
+			: frames(length, (Frame*)NULL)
+		{
+			for (unsigned int i = 0; i < length; i++)
+			{
+				this->setFrame(i, first, i == 0);
+			}
+		}
+
+		/* Destructor for the track, deleting every Frame. */
+		~FrameVectorTrack()
+		{
+			for (unsigned int i = 0; i < this->frames.size(); i++)
+			{
+				delete this->frames[i];
+			}
+		}
+
+		/* Stores the given values as a keyframe, copying it to the frames */
+		/* up to the next keyframe as copyTransforms did.                  */
+		void setKeyframe(unsigned int frameNum, const float values[8])
+		{
+			this->setFrame(frameNum, values, true);
+			for (unsigned int i = frameNum + 1; i < this->frames.size() &&
+				!this->frames[i]->getIsKeyframe(); i++)
+			{
+				this->setFrame(i, values, false);
+			}
+		}
+
+		/* Fills in every frame between keyframes, as linearlyInterpolate */
+		/* did.                                                           */
+		void linearlyInterpolate()
+		{
+			std::vector<unsigned int> keyframes;
+			for (unsigned int i = 0; i < this->frames.size(); i++)
+			{
+				if (this->frames[i]->getIsKeyframe())
+				{
+					keyframes.push_back(i);
+				}
+			}
+
+			for (unsigned int k = 0; k + 1 < keyframes.size(); k++)
+			{
+				unsigned int i = keyframes[k], f = keyframes[k + 1];
+				float initial[8], final[8], values[8];
+				this->getFrame(i, initial);
+				this->getFrame(f, final);
+				for (unsigned int n = i + 1; n < f; n++)
+				{
+					for (int c = 0; c < 8; c++)
+					{
+						values[c] = (final[c] - initial[c]) / (f - i) *
+							(n - i) + initial[c];
+					}
+					this->setFrame(n, values, false);
+				}
+			}
+		}
+
+		/* Samples count frames starting at first into one array per */
+		/* channel, reading each Frame.                              */
+		void sampleRange(unsigned int first, unsigned int count,
+			float* const out[8]) const
+		{
+			float values[8];
+			for (unsigned int n = 0; n < count; n++)
+			{
+				this->getFrame(first + n, values);
+				for (int c = 0; c < 8; c++)
+				{
+					out[c][n] = values[c];
+				}
+			}
+		}
+};
+
+/* Fills values with random channel values, rotations kept within a half */
+/* turn so they read back from a rotation matrix unchanged.              */
+static void randomValues(float values[KeyframeTrack::NUM_CHANNELS])
+{
+	values[KeyframeTrack::SCALE_X] = 0.5f + (rand() % 100) / 50.0f;
+	values[KeyframeTrack::SCALE_Y] = 0.5f + (rand() % 100) / 50.0f;
+	values[KeyframeTrack::ROTATION] = (float)(rand() % 340 - 170);
+	values[KeyframeTrack::TRANSLATION_X] = (rand() % 200 - 100) / 100.0f;
+	values[KeyframeTrack::TRANSLATION_Y] = (rand() % 200 - 100) / 100.0f;
+	values[KeyframeTrack::RED] = (rand() % 256) / 255.0f;
+	values[KeyframeTrack::GREEN] = (rand() % 256) / 255.0f;
+	values[KeyframeTrack::BLUE] = (rand() % 256) / 255.0f;
+}
+
+/* Fills the track with random keyframes, also keeping them in keys. */
+static void randomKeyframes(KeyframeTrack& track, unsigned int numKeyframes,
+	std::map<unsigned int, std::vector<float> >& keys)
+{
+	float values[KeyframeTrack::NUM_CHANNELS];
+	track.getValues(0, false, values);
+	keys[0] = std::vector<float>(values, values + KeyframeTrack::NUM_CHANNELS);
+	for (unsigned int i = 0; i < numKeyframes; i++)
+	{
+		unsigned int frameNum = rand() % track.getLength();
+		randomValues(values);
+		track.setKeyframe(frameNum, values);
+		keys[frameNum] =
+			std::vector<float>(values, values + KeyframeTrack::NUM_CHANNELS);
+	}
+}
+
+/* Returns the value of channel c at frameNum worked out directly from the */
+/* keyframes.                                                              */
+static float expectedValue(const std::map<unsigned int,
+	std::vector<float> >& keys, unsigned int c, unsigned int frameNum,
+	bool interpolated)
+{
+	std::map<unsigned int, std::vector<float> >::const_iterator next =
+		keys.upper_bound(frameNum), previous = next;
+	previous--;
+	if (!interpolated || next == keys.end())
+	{
+		return previous->second[c];
+	}
+	return previous->second[c] + (next->second[c] - previous->second[c]) *
+		(frameNum - previous->first) / (next->first - previous->first);
+}
+
+/* Test the KeyframeTrack class */
+void testKeyframeTrack()
+{
+	srand(2);
+	KeyframeTrack track(Frame(1, 1, 0, 0, 0, 1, 1, 1, true));
+	track.setLength(TEST_LENGTH);
+	std::map<unsigned int, std::vector<float> > keys;
+	randomKeyframes(track, TEST_NUM_KEYFRAMES, keys);
+	CHECK(track.getNumKeyframes() == keys.size());
+
+	/* Frames are worked out from the keyframes in both modes */
+	std::vector<float> samples[KeyframeTrack::NUM_CHANNELS];
+	float* out[KeyframeTrack::NUM_CHANNELS];
+	for (int c = 0; c < KeyframeTrack::NUM_CHANNELS; c++)
+	{
+		samples[c].resize(TEST_LENGTH);
+		out[c] = &samples[c][0];
+	}
+	for (int mode = 0; mode < 2; mode++)
+	{
+		bool interpolated = mode == 1;
+		float worst = 0, sampledWorst = 0;
+		track.sampleRange(0, TEST_LENGTH, interpolated, out);
+		for (unsigned int n = 0; n < TEST_LENGTH; n++)
+		{
+			CHECK(track.getIsKeyframe(n) == (keys.count(n) == 1));
+			for (int c = 0; c < KeyframeTrack::NUM_CHANNELS; c++)
+			{
+				float value = track.getValue((KeyframeTrack::Channel)c, n,
+					interpolated);
+				worst = std::max(worst, std::fabs(value -
+					expectedValue(keys, c, n, interpolated)));
+				sampledWorst = std::max(sampledWorst,
+					std::fabs(samples[c][n] - value));
+			}
+		}
+		CHECK(worst < 1e-3f);
+		CHECK(sampledWorst == 0);
+	}
+
+	/* Removing a keyframe re-interpolates across it */
+	unsigned int removed = (++keys.begin())->first;
+	track.removeKeyframe(removed);
+	keys.erase(removed);
+	CHECK(!track.getIsKeyframe(removed));
+	CHECK(track.getNumKeyframes() == keys.size());
+	for (unsigned int n = 0; n < TEST_LENGTH; n++)
+	{
+		CHECK(std::fabs(track.getValue(KeyframeTrack::TRANSLATION_X, n,
+			true) - expectedValue(keys, KeyframeTrack::TRANSLATION_X, n,
+			true)) < 1e-3f);
+	}
+
+	/* Shortening the track drops the keyframes past its end */
+	track.setLength(TEST_LENGTH / 2);
+	while (keys.rbegin()->first >= TEST_LENGTH / 2)
+	{
+		keys.erase(keys.rbegin()->first);
+	}
+	CHECK(track.getNumKeyframes() == keys.size());
+	track.setLength(TEST_LENGTH);
+	for (unsigned int n = TEST_LENGTH / 2; n < TEST_LENGTH; n++)
+	{
+		CHECK(!track.getIsKeyframe(n));
+	}
+
+	/* The Frames given match the values */
+	const Frame& frame = track.getFrame(TEST_LENGTH / 3, true);
+	CHECK(std::fabs(frame.getTranslationY() - track.getValue(
+		KeyframeTrack::TRANSLATION_Y, TEST_LENGTH / 3, true)) < 1e-6f);
+}
+
+/* Time the KeyframeTrack class against a Frame for every frame */
+void benchKeyframeTrack()
+{
+	srand(2);
+	KeyframeTrack track(Frame(1, 1, 0, 0, 0, 1, 1, 1, true));
+	track.setLength(TEST_LENGTH);
+	std::map<unsigned int, std::vector<float> > keys;
+	randomKeyframes(track, TEST_NUM_KEYFRAMES, keys);
+
+	FrameVectorTrack frames(TEST_LENGTH, &keys[0][0]);
+	for (std::map<unsigned int, std::vector<float> >::const_iterator it =
+		keys.begin(); it != keys.end(); it++)
+	{
+		frames.setKeyframe(it->first, &it->second[0]);
+	}
+
+	std::vector<float> samples[KeyframeTrack::NUM_CHANNELS];
+	float* out[KeyframeTrack::NUM_CHANNELS];
+	for (int c = 0; c < KeyframeTrack::NUM_CHANNELS; c++)
+	{
+		samples[c].resize(TEST_LENGTH);
+		out[c] = &samples[c][0];
+	}
+
+	/* The old layout interpolated every frame up front, the track only */
+	/* works out the slopes of the segments next to each keyframe.      */
+	std::chrono::steady_clock::time_point start = Tests::now();
+	for (unsigned int r = 0; r < BENCH_RUNS; r++)
+	{
+		frames.linearlyInterpolate();
+	}
+	Tests::report("interpolate, Frame per frame", start, BENCH_RUNS);
+
+	start = Tests::now();
+	for (unsigned int r = 0; r < BENCH_RUNS; r++)
+	{
+		track.setKeyframe(keys.rbegin()->first, &keys.rbegin()->second[0]);
+	}
+	Tests::report("interpolate, KeyframeTrack edit", start, BENCH_RUNS);
+
+	start = Tests::now();
+	for (unsigned int r = 0; r < BENCH_RUNS; r++)
+	{
+		float values[KeyframeTrack::NUM_CHANNELS];
+		for (unsigned int n = 0; n < TEST_LENGTH; n++)
+		{
+			track.getValues(n, true, values);
+		}
+	}
+	Tests::report("getValues of every frame, KeyframeTrack", start,
+		BENCH_RUNS);
+
+	start = Tests::now();
+	for (unsigned int r = 0; r < BENCH_RUNS; r++)
+	{
+		frames.sampleRange(0, TEST_LENGTH, out);
+	}
+	Tests::report("sampleRange, Frame per frame", start, BENCH_RUNS);
+
+	start = Tests::now();
+	for (unsigned int r = 0; r < BENCH_RUNS; r++)
+	{
+		track.sampleRange(0, TEST_LENGTH, true, out);
+	}
+	Tests::report("sampleRange, KeyframeTrack", start, BENCH_RUNS);
+
+	/* Both layouts give the same frames */
+	std::vector<float> trackSamples = samples[KeyframeTrack::TRANSLATION_X];
+	frames.sampleRange(0, TEST_LENGTH, out);
+	float worst = 0;
+	for (unsigned int n = 0; n < TEST_LENGTH; n++)
+	{
+		worst = std::max(worst, std::fabs(trackSamples[n] -
+			samples[KeyframeTrack::TRANSLATION_X][n]));
+	}
+	CHECK(worst < 1e-3f);
+}
@@ -0,0 +1,212 @@
+/*
+ * OfflineRendererTests.cpp
+ * Created by Zachary Ferguson
+ * Tests of the OfflineRenderer class and the FramePipeline it writes frames
+ * out through, rendering the walking animal with different numbers of threads
+ * and with a Node thrown far off the frame or to where it can not be drawn.
+ */
+
+#include <climits>  /* Included for UINT_MAX */
+#include <cstring>  /* Included for memcmp */
+#include <limits>
+#include "FlatSceneGraph.h"
+#include "FrameWriter.h"
+#include "JPEGSequenceSink.h"
+#include "OfflineRenderer.h"
+#include "SceneLibrary.h"
+#include "SoftwareRasterizer.h"
+#include "Tests.h"
+
+/* Size and number of frames of the renders tested. */
+#define TEST_WIDTH 160
+#define TEST_HEIGHT 120
+#define TEST_NUM_FRAMES 20
+
+/* A FrameSink that keeps the pixels of every frame written to it, in the */
+/* order they are written, and can fail to write a given frame.           */
+class RecordingSink : public FrameSink
+{
+	public:
+
+		/* Frame numbers and pixels of the frames written, in order. */
+		std::vector<unsigned int> frameNums;
+		std::vector<std::vector<unsigned char> > frames;
+
+		/* Frame to fail to write, UINT_MAX for none. */
+		unsigned int failFrameNum;
+
+		/* Constructor for a RecordingSink that fails to write the given */
+		/* frame, UINT_MAX for none.                                     */
+		RecordingSink(unsigned int failFrameNum)
+		{
+			this->failFrameNum = failFrameNum;
+		}
+
+		/* Opens the sink, there is nothing to open. */
+		virtual bool open(unsigned int width, unsigned int height,
+			double framerate)
+		{
+			return true;
+		}
+
+		/* Keeps the pixels as they are. */
+		virtual void encode(const unsigned char* pixels, unsigned int width,
+			unsigned int height, std::vector<unsigned char>& bytes) const
+		{
+			bytes.assign(pixels, pixels + 3 * width * height);
+		}
+
+		/* Records the frame, unless it is the frame to fail. */
+		virtual bool write(unsigned int frameNum,
+			const std::vector<unsigned char>& bytes)
+		{
+			if (frameNum == this->failFrameNum)
+			{
+				return false;
+			}
+			this->frameNums.push_back(frameNum);
+			this->frames.push_back(bytes);
+			return true;
+		}
+
+		/* Closes the sink, there is nothing to close. */
+		virtual bool close()
+		{
+			return true;
+		}
+
+		/* Returns a short description of the sink. */
+		virtual std::string getDescription() const
+		{
+			return "memory";
+		}
+};
+
+/* Renders the frames of the scene graph to the sink with the given number */
+/* of threads. Returns if every frame was written.                         */
+static bool renderFrames(const Node* root, FrameSink& sink,
+	unsigned int numThreads)
+{
+	sink.open(TEST_WIDTH, TEST_HEIGHT, 10);
+	RenderJob job(0, TEST_NUM_FRAMES - 1, 1);
+	if (!job.prepare(root, sink, TEST_WIDTH, TEST_HEIGHT))
+	{
+		return false;
+	}
+	OfflineRenderer renderer(root, TEST_WIDTH, TEST_HEIGHT);
+	renderer.setNumThreads(numThreads);
+	bool rendered = renderer.render(&job, &sink);
+	return sink.close() && rendered;
+}
+
+/* Returns the number of frames written to the sink that are the same as */
+/* the frames of the scene graph drawn whole.                            */
+static unsigned int countWholeFrames(const Node* root,
+	const RecordingSink& sink)
+{
+	FlatSceneGraph flatSceneGraph;
+	RenderBatch batch;
+	SoftwareRasterizer rasterizer(TEST_WIDTH, TEST_HEIGHT);
+	flatSceneGraph.sync(root);
+	unsigned int same = 0;
+	for (unsigned int i = 0; i < sink.frames.size(); i++)
+	{
+		flatSceneGraph.evaluate(i, affine2::identity());
+		batch.clear();
+		flatSceneGraph.appendTo(batch, i);
+		rasterizer.clear(0.0f, 0.0f, 0.0f);
+		rasterizer.draw(batch);
+		same += memcmp(rasterizer.getPixels(), &sink.frames[i][0],
+			3 * TEST_WIDTH * TEST_HEIGHT) == 0;
+	}
+	return same;
+}
+
+/* Test the OfflineRenderer class */
+void testOfflineRenderer()
+{
+	bool interpolated = Node::getInterpolated();
+	Node* root = SceneLibrary::createSceneGraph("walk", TEST_NUM_FRAMES);
+	for (int mode = 0; mode < 2; mode++)
+	{
+		Node::setInterpolated(mode == 1);
+
+		/* Every frame is written once, in order, and the same with any */
+		/* number of threads                                            */
+		RecordingSink oneThread(UINT_MAX), fourThreads(UINT_MAX);
+		CHECK(renderFrames(root, oneThread, 1));
+		CHECK(renderFrames(root, fourThreads, 4));
+		CHECK(oneThread.frames == fourThreads.frames);
+		CHECK(oneThread.frameNums.size() == TEST_NUM_FRAMES);
+		for (unsigned int i = 0; i < oneThread.frameNums.size(); i++)
+		{
+			CHECK(oneThread.frameNums[i] == i);
+			CHECK(fourThreads.frameNums[i] == i);
+		}
+
+		/* Redrawing only the changed part of each frame, and repeating */
+		/* frames that did not change, draws the same as drawing every  */
+		/* frame whole                                                  */
+		CHECK(countWholeFrames(root, oneThread) == TEST_NUM_FRAMES);
+	}
+
+
+	/* JPEG files are byte for byte the same with any number of threads */
+	JPEGSequenceSink oneThreadJPEG("test_offline_1_", JPEG_QUALITY,
+		FrameWriter::SUBSAMPLE_420);
+	JPEGSequenceSink fourThreadsJPEG("test_offline_4_", JPEG_QUALITY,
+		FrameWriter::SUBSAMPLE_420);
+	CHECK(renderFrames(root, oneThreadJPEG, 1));
+	CHECK(renderFrames(root, fourThreadsJPEG, 4));
+	unsigned int sameFiles = 0;
+	for (unsigned int i = 0; i < TEST_NUM_FRAMES; i++)
+	{
+		std::vector<unsigned char> oneThreadBytes, fourThreadsBytes;
+		sameFiles += oneThreadJPEG.readFrame(i, oneThreadBytes) &&
+			fourThreadsJPEG.readFrame(i, fourThreadsBytes) &&
+			!oneThreadBytes.empty() && oneThreadBytes == fourThreadsBytes;
+	}
+	CHECK(sameFiles == TEST_NUM_FRAMES);
+	Tests::removeFrameFiles("test_offline_1_", TEST_NUM_FRAMES, ".jpg");
+	Tests::removeFrameFiles("test_offline_4_", TEST_NUM_FRAMES, ".jpg");
+
+	/* A frame that fails to write stops the render, and the frames */
+	/* before it are still written in order                         */
+	for (unsigned int numThreads = 1; numThreads <= 4; numThreads += 3)
+	{
+		RecordingSink failing(TEST_NUM_FRAMES / 2);
+		CHECK(!renderFrames(root, failing, numThreads));
+		CHECK(failing.frameNums.size() == TEST_NUM_FRAMES / 2);
+	}
+
+	/* Redrawing only the changed part of each frame draws the same as  */
+	/* drawing every frame whole with a Node thrown far off the frame,  */
+	/* to infinity, or to where it is not a number, and back            */
+	Node::setInterpolated(false);
+	Node* thrown = SceneLibrary::createSceneGraph("walk", TEST_NUM_FRAMES);
+	Node* node = *(thrown->getChildren()->cbegin());
+	const float distances[] = {1e30f, -1e30f,
+		std::numeric_limits<float>::infinity(),
+		std::numeric_limits<float>::quiet_NaN()};
+	unsigned int numDistances = sizeof(distances) / sizeof(distances[0]);
+	float values[KeyframeTrack::NUM_CHANNELS];
+	for (unsigned int i = 0; i <= numDistances; i++)
+	{
+		unsigned int frameNum = 3 * (i + 1);
+		node->getTrack()->getValues(0, false, values);
+		if (i < numDistances)
+		{
+			values[KeyframeTrack::TRANSLATION_X] = distances[i];
+			values[KeyframeTrack::TRANSLATION_Y] =
+				distances[numDistances - 1 - i];
+		}
+		node->setKeyframe(frameNum, values);
+	}
+	RecordingSink thrownFrames(UINT_MAX);
+	CHECK(renderFrames(thrown, thrownFrames, 1));
+	CHECK(countWholeFrames(thrown, thrownFrames) == TEST_NUM_FRAMES);
+	delete thrown;
+
+	delete root;
+	Node::setInterpolated(interpolated);
+}
@@ -0,0 +1,199 @@
+/*
+ * RenderJobTests.cpp
+ * Created by Zachary Ferguson
+ * Tests of resuming a render with the RenderJob class and its RenderManifest,
+ * rendering the walking animal to PNG files and then breaking some of them,
+ * or the scene, before rendering it again.
+ */
+
+#include <cstdio>   /* Included for remove */
+#include "FlatSceneGraph.h"
+#include "FrameWriter.h"
+#include "OfflineRenderer.h"
+#include "PNGSequenceSink.h"
+#include "RenderManifest.h"
+#include "SceneLibrary.h"
+#include "polygon.h"
+#include "Tests.h"
+
+/* Size and number of frames of the renders tested. */
+#define TEST_WIDTH 160
+#define TEST_HEIGHT 120
+#define TEST_NUM_FRAMES 20
+
+/* File name prefix of the frames rendered, and a manifest shared by two */
+/* renders.                                                              */
+#define TEST_PREFIX "test_resume_"
+#define TEST_SHARED_MANIFEST TEST_PREFIX "shared_manifest.txt"
+
+/* Prepares a job of every frame of the scene graph to the sink, and  */
+/* renders the frames it has left. Returns the number of frames left. */
+static unsigned int renderLeft(const Node* root, FrameSink& sink)
+{
+	sink.open(TEST_WIDTH, TEST_HEIGHT, 10);
+	RenderJob job(0, TEST_NUM_FRAMES - 1, 1);
+	if (!CHECK(job.prepare(root, sink, TEST_WIDTH, TEST_HEIGHT)))
+	{
+		return TEST_NUM_FRAMES + 1;
+	}
+	CHECK(job.size() + job.getNumFinished() == TEST_NUM_FRAMES);
+	unsigned int left = job.size();
+	if (left > 0)
+	{
+		OfflineRenderer renderer(root, TEST_WIDTH, TEST_HEIGHT);
+		CHECK(renderer.render(&job, &sink));
+	}
+	CHECK(sink.close());
+	return left;
+}
+
+/* Returns the frames left to render, without rendering them. */
+static std::vector<unsigned int> framesLeft(const Node* root,
+	const FrameSink& sink)
+{
+	RenderJob job(0, TEST_NUM_FRAMES - 1, 1);
+	CHECK(job.prepare(root, sink, TEST_WIDTH, TEST_HEIGHT));
+	std::vector<unsigned int> frameNums;
+	for (unsigned int i = 0; i < job.size(); i++)
+	{
+		frameNums.push_back(job.getFrameNum(i));
+	}
+	return frameNums;
+}
+
+/* Returns the content hash of the scene graph. */
+static unsigned long long hashContent(const Node* root)
+{
+	FlatSceneGraph flatSceneGraph;
+	flatSceneGraph.sync(root);
+	return flatSceneGraph.hashContent();
+}
+
+/* Test the RenderJob class */
+void testRenderJob()
+{
+	bool interpolated = Node::getInterpolated();
+	Node::setInterpolated(true);
+	Node* root = SceneLibrary::createSceneGraph("walk", TEST_NUM_FRAMES);
+	Tests::removeFrameFiles(TEST_PREFIX, TEST_NUM_FRAMES, ".png");
+	PNGSequenceSink sink(TEST_PREFIX);
+
+	/* A rerun of a finished render skips every frame */
+	CHECK(renderLeft(root, sink) == TEST_NUM_FRAMES);
+	CHECK(renderLeft(root, sink) == 0);
+
+	/* Deleted, changed, and cut short frames are rendered again */
+	std::string filename;
+	std::vector<unsigned char> bytes;
+	FrameWriter::frameFilename(TEST_PREFIX, 3, ".png", filename);
+	remove(filename.c_str());
+	FrameWriter::frameFilename(TEST_PREFIX, 7, ".png", filename);
+	FrameWriter::readFile(filename, bytes);
+	bytes[bytes.size() / 2] ^= 1;
+	FrameWriter::writeFile(filename, bytes);
+	FrameWriter::frameFilename(TEST_PREFIX, 11, ".png", filename);
+	FrameWriter::readFile(filename, bytes);
+	bytes.resize(bytes.size() / 2);
+	FrameWriter::writeFile(filename, bytes);
+	std::vector<unsigned int> left = framesLeft(root, sink);
+	CHECK(left.size() == 3 && left[0] == 3 && left[1] == 7 &&
+		left[2] == 11);
+	CHECK(renderLeft(root, sink) == 3);
+	CHECK(renderLeft(root, sink) == 0);
+
+	/* A manifest line cut short by a crash is ignored, and the next */
+	/* line still starts on a line of its own                        */
+	FrameWriter::readFile(TEST_PREFIX "manifest.txt", bytes);
+	std::string torn = "3 0123";
+	bytes.insert(bytes.end(), torn.begin(), torn.end());
+	FrameWriter::writeFile(TEST_PREFIX "manifest.txt", bytes);
+	FrameWriter::frameFilename(TEST_PREFIX, 3, ".png", filename);
+	remove(filename.c_str());
+	CHECK(renderLeft(root, sink) == 1);
+	CHECK(renderLeft(root, sink) == 0);
+
+	/* Renders sharing a manifest each append whole lines, and the frames */
+	/* of both are found finished                                         */
+	remove(TEST_SHARED_MANIFEST);
+	{
+		RenderManifest first(TEST_SHARED_MANIFEST, 1, TEST_WIDTH,
+			TEST_HEIGHT, sink.getDescription());
+		RenderManifest second(TEST_SHARED_MANIFEST, 1, TEST_WIDTH,
+			TEST_HEIGHT, sink.getDescription());
+		CHECK(first.open() && second.open());
+		unsigned int recorded = 0;
+		for (unsigned int i = 0; i < TEST_NUM_FRAMES; i++)
+		{
+			recorded += sink.readFrame(i, bytes) &&
+				(i % 2 == 0 ? first : second).record(i, i, bytes);
+		}
+		CHECK(recorded == TEST_NUM_FRAMES);
+		RenderManifest shared(TEST_SHARED_MANIFEST, 1, TEST_WIDTH,
+			TEST_HEIGHT, sink.getDescription());
+		CHECK(shared.open());
+		unsigned int finished = 0;
+		for (unsigned int i = 0; i < TEST_NUM_FRAMES; i++)
+		{
+			finished += shared.isFinished(i, i, sink);
+		}
+		CHECK(finished == TEST_NUM_FRAMES);
+	}
+	remove(TEST_SHARED_MANIFEST);
+
+	/* Moving a vertex renders every frame again, and moving it back */
+	/* finds them finished                                           */
+	const polyline* body = root->getGeometry();
+	std::vector<float> color = body->getColor();
+	std::list<vec3>* movedVertices = new std::list<vec3>(
+		*(body->getVertices()));
+	movedVertices->front() = vec3(0.75, 0, 1);
+	polygon* moved = new polygon(movedVertices, color[0], color[1],
+		color[2]);
+	unsigned long long originalHash = hashContent(root);
+	root->setGeometry(moved);
+	CHECK(hashContent(root) != originalHash);
+	CHECK(framesLeft(root, sink).size() == TEST_NUM_FRAMES);
+	polygon* restored = new polygon(new std::list<vec3>(
+		*(body->getVertices())), color[0], color[1], color[2]);
+	root->setGeometry(restored);
+	CHECK(hashContent(root) == originalHash);
+	CHECK(framesLeft(root, sink).empty());
+	delete moved;
+
+	/* The same vertices as another kind of geometry differ too */
+	polyline* outline = new polyline(new std::list<vec3>(
+		*(body->getVertices())), color[0], color[1], color[2]);
+	root->setGeometry(outline);
+	CHECK(hashContent(root) != originalHash);
+	CHECK(framesLeft(root, sink).size() == TEST_NUM_FRAMES);
+	root->setGeometry(restored);
+	delete outline;
+
+	/* Moving a Node to another parent renders every frame again */
+	Node* parent = NULL;
+	for (std::list<Node*>::const_iterator it =
+		root->getChildren()->begin(); it != root->getChildren()->end(); ++it)
+	{
+		if (!((*it)->getChildren()->empty()))
+		{
+			parent = *it;
+		}
+	}
+	if (CHECK(parent != NULL))
+	{
+		Node* child = parent->getChildren()->front();
+		parent->removeChild(child);
+		root->addChild(child);
+		CHECK(hashContent(root) != originalHash);
+		CHECK(framesLeft(root, sink).size() == TEST_NUM_FRAMES);
+		root->removeChild(child);
+		parent->insertChild(child, parent->getChildren()->empty() ? NULL :
+			parent->getChildren()->front());
+		CHECK(hashContent(root) == originalHash);
+	}
+
+	delete body;
+	delete root;
+	Tests::removeFrameFiles(TEST_PREFIX, TEST_NUM_FRAMES, ".png");
+	Node::setInterpolated(interpolated);
+}
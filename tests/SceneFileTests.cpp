@@ -0,0 +1,190 @@
+/*
+ * SceneFileTests.cpp
+ * Created by Zachary Ferguson
+ * Tests of the SceneFile class, saving the walking animal and random scene
+ * graphs and loading them back, and opening files that were cut short or
+ * changed so they no longer hold a scene.
+ */
+
+#include <cstdio>   /* Included for remove */
+#include <cstring>  /* Included for memcpy */
+#include "SceneFile.h"
+#include "SceneLibrary.h"
+#include "TestScenes.h"
+#include "Tests.h"
+
+/* Number of frames of the walking animal, and number of random scenes. */
+#define TEST_NUM_FRAMES 20
+#define TEST_NUM_SCENES 40
+
+/* File the scenes are saved to. */
+#define TEST_FILENAME "test_scene.asg"
+
+/* Byte offsets of fields of the file's header and of its first Node's */
+/* record, from the layout in SceneFile.h.                             */
+#define VERSION_OFFSET 12
+#define FILE_SIZE_OFFSET 20
+#define NUM_NODES_OFFSET 24
+#define NODES_OFFSET_OFFSET 40
+#define VERTICES_OFFSET_OFFSET 44
+#define RECORD_SIZE 48
+#define RECORD_GEOMETRY_TYPE 4
+#define RECORD_LENGTH 24
+
+/* Returns the bytes with the length of every Node's record set to length. */
+static std::vector<unsigned char> withLengths(
+	const std::vector<unsigned char>& bytes, unsigned int nodesOffset,
+	unsigned int numNodes, unsigned int length)
+{
+	std::vector<unsigned char> changed(bytes);
+	for (unsigned int i = 0; i < numNodes; i++)
+	{
+		memcpy(&changed[nodesOffset + i * RECORD_SIZE + RECORD_LENGTH],
+			&length, sizeof(length));
+	}
+	return changed;
+}
+
+/* Returns if the bytes saved as a scene file open as one. */
+static bool opens(const std::vector<unsigned char>& bytes)
+{
+	SceneFile file;
+	return SceneFile::saveBytes(bytes, TEST_FILENAME) &&
+		file.open(TEST_FILENAME);
+}
+
+/* Returns the bytes with the 32-bit word at offset replaced by value. */
+static std::vector<unsigned char> withWord(
+	const std::vector<unsigned char>& bytes, unsigned int offset, int value)
+{
+	std::vector<unsigned char> changed(bytes);
+	memcpy(&changed[offset], &value, sizeof(value));
+	return changed;
+}
+
+/* Returns the 32-bit word at offset of the bytes. */
+static int wordAt(const std::vector<unsigned char>& bytes,
+	unsigned int offset)
+{
+	int value;
+	memcpy(&value, &bytes[offset], sizeof(value));
+	return value;
+}
+
+/* Saves the scene graph, loads it back, and checks the scene loaded is  */
+/* the same and saves to the same bytes. Returns if it all matched.      */
+static bool roundTrips(const Node* root)
+{
+	std::vector<unsigned char> bytes, loadedBytes;
+	if (!SceneFile::serialize(root, bytes) ||
+		!SceneFile::saveBytes(bytes, TEST_FILENAME))
+	{
+		return false;
+	}
+	Node* loaded = SceneFile::load(TEST_FILENAME);
+	if (loaded == NULL)
+	{
+		return false;
+	}
+	bool same = TestScenes::sameScene(root, loaded) &&
+		TestScenes::sameFrames(root, loaded) &&
+		SceneFile::serialize(loaded, loadedBytes) && loadedBytes == bytes;
+	TestScenes::deleteScene(loaded);
+	return same;
+}
+
+/* Test the SceneFile class */
+void testSceneFile()
+{
+	/* The walking animal and random scenes load as they were saved */
+	Node* root = SceneLibrary::createSceneGraph("walk", TEST_NUM_FRAMES);
+	CHECK(roundTrips(root));
+	unsigned int sameScenes = 0;
+	for (unsigned int seed = 0; seed < TEST_NUM_SCENES; seed++)
+	{
+		Node* scene = TestScenes::randomScene(seed, 1 + seed * 3,
+			1 + seed % 30);
+		sameScenes += roundTrips(scene);
+		TestScenes::deleteScene(scene);
+	}
+	CHECK(sameScenes == TEST_NUM_SCENES);
+
+	std::vector<unsigned char> bytes;
+	CHECK(SceneFile::serialize(root, bytes));
+	CHECK(opens(bytes));
+
+	/* A file cut short anywhere does not open */
+	unsigned int opened = 0;
+	for (size_t size = 0; size < bytes.size(); size++)
+	{
+		opened += opens(std::vector<unsigned char>(bytes.begin(),
+			bytes.begin() + size));
+	}
+	CHECK(opened == 0);
+
+	/* Nor does a file of another version, or the wrong size */
+	CHECK(!opens(withWord(bytes, VERSION_OFFSET, SCENE_FILE_VERSION + 1)));
+	std::vector<unsigned char> longer(bytes);
+	longer.resize(bytes.size() + 16);
+	CHECK(!opens(longer));
+
+	/* Nor one with an array that does not start on a section */
+	unsigned int nodesOffset = wordAt(bytes, NODES_OFFSET_OFFSET);
+	unsigned int verticesOffset = wordAt(bytes, VERTICES_OFFSET_OFFSET);
+	CHECK(!opens(withWord(bytes, NODES_OFFSET_OFFSET, nodesOffset + 4)));
+	CHECK(!opens(withWord(bytes, VERTICES_OFFSET_OFFSET,
+		verticesOffset - 4)));
+	CHECK(!opens(withWord(bytes, VERTICES_OFFSET_OFFSET,
+		wordAt(bytes, FILE_SIZE_OFFSET))));
+
+	/* Nor one whose Nodes are not in preorder: the root with a parent, */
+	/* another Node without one or that is its own parent, or the last  */
+	/* Node with a parent that is not the Node before it or one of that */
+	/* Node's ancestors                                                 */
+	unsigned int numNodes = wordAt(bytes, NUM_NODES_OFFSET);
+	unsigned int last = numNodes - 1;
+	CHECK(!opens(withWord(bytes, nodesOffset, 0)));
+	CHECK(!opens(withWord(bytes, nodesOffset + last * RECORD_SIZE, -1)));
+	CHECK(!opens(withWord(bytes, nodesOffset + last * RECORD_SIZE, last)));
+	CHECK(!opens(withWord(bytes, nodesOffset + last * RECORD_SIZE,
+		numNodes)));
+	std::vector<bool> onPath(numNodes, false);
+	for (int node = last - 1; node >= 0;
+		node = wordAt(bytes, nodesOffset + node * RECORD_SIZE))
+	{
+		onPath[node] = true;
+	}
+	unsigned int rightParents = 0;
+	for (unsigned int parent = 0; parent < last; parent++)
+	{
+		rightParents += opens(withWord(bytes,
+			nodesOffset + last * RECORD_SIZE, parent)) == onPath[parent];
+	}
+	CHECK(rightParents == last);
+
+	/* Nor one with geometry of an unknown kind */
+	CHECK(!opens(withWord(bytes, nodesOffset + RECORD_GEOMETRY_TYPE,
+		polyline::NUM_TYPES)));
+	CHECK(!opens(withWord(bytes, nodesOffset + RECORD_GEOMETRY_TYPE, -2)));
+
+	/* Nor one whose Nodes cover more frames than a track can, or whose */
+	/* Nodes do not all cover the same frames                           */
+	CHECK(opens(withLengths(bytes, nodesOffset, numNodes,
+		MAX_TRACK_LENGTH)));
+	CHECK(!opens(withLengths(bytes, nodesOffset, numNodes,
+		MAX_TRACK_LENGTH + 1)));
+	CHECK(!opens(withLengths(bytes, nodesOffset, numNodes, 0xFFFFFFFF)));
+	CHECK(!opens(withWord(bytes, nodesOffset + RECORD_LENGTH, -1)));
+	CHECK(!opens(withWord(bytes, nodesOffset + last * RECORD_SIZE +
+		RECORD_LENGTH, TEST_NUM_FRAMES + 1)));
+	CHECK(!opens(withWord(bytes, nodesOffset + last * RECORD_SIZE +
+		RECORD_LENGTH, TEST_NUM_FRAMES - 1)));
+
+	/* Loading a file that does not open gives no scene */
+	SceneFile::saveBytes(std::vector<unsigned char>(bytes.begin(),
+		bytes.begin() + bytes.size() / 2), TEST_FILENAME);
+	CHECK(SceneFile::load(TEST_FILENAME) == NULL);
+	remove(TEST_FILENAME);
+
+	delete root;
+}
@@ -0,0 +1,273 @@
+/*
+ * SceneJSONTests.cpp
+ * Created by Zachary Ferguson
+ * Tests of the SceneJSON class, exporting the walking animal and random scene
+ * graphs with labels and importing them back, and importing scenes that are
+ * malformed or cut short, and a benchmark of importing a large scene.
+ */
+
+#include <cstdio>   /* Included for remove */
+#include <iostream>
+#include "FlatSceneGraph.h"
+#include "FrameWriter.h"
+#include "SceneJSON.h"
+#include "SceneLibrary.h"
+#include "TestScenes.h"
+#include "Tests.h"
+
+/* Number of frames of the walking animal, and number of random scenes. */
+#define TEST_NUM_FRAMES 20
+#define TEST_NUM_SCENES 30
+
+/* Files the scenes are exported to. */
+#define TEST_FILENAME "test_scene.json"
+#define TEST_RESAVED_FILENAME "test_resaved.json"
+
+/* Nodes and frames of the scene imported by the benchmark, and times it is */
+/* imported.                                                                */
+#define BENCH_NUM_NODES 20000
+#define BENCH_NUM_FRAMES 30
+#define BENCH_RUNS 5
+
+/* A small scene using every kind of member, with members it does not know. */
+static const char SMALL_SCENE[] =
+	"{\"format\": \"animated-scene-graph\", \"version\": 1,\n"
+	" \"comment\": {\"skipped\": [1, {\"x\": null}]},\n"
+	" \"nodes\": [\n"
+	"  {\"label\": \"root\", \"parent\": -1, \"length\": 4,\n"
+	"   \"geometry\": {\"type\": \"triangle\", \"color\": [1, 0, 0],\n"
+	"    \"vertices\": [[0, 0, 1], [1, 0, 1], [0, 1, 1]]},\n"
+	"   \"keyframes\": [{\"frame\": 0, \"scale\": [1, 1], \"rotation\": 0,\n"
+	"    \"translation\": [0, 0], \"color\": [1, 0, 0]}]},\n"
+	"  {\"parent\": 0, \"length\": 4, \"geometry\": null, \"extra\": true,\n"
+	"   \"keyframes\": [{\"frame\": 0, \"scale\": [1, 1], \"rotation\": 0,\n"
+	"    \"translation\": [0, 0]}, {\"frame\": 2, \"scale\": [2, 2],\n"
+	"    \"rotation\": 90, \"translation\": [1, 1]}]}\n"
+	" ]}\n";
+
+/* Returns the text with the first match of what replaced by with. */
+static std::string replaced(const std::string& text, const char* what,
+	const char* with)
+{
+	std::string changed(text);
+	size_t position = changed.find(what);
+	if (position != std::string::npos)
+	{
+		changed.replace(position, std::string(what).size(), with);
+	}
+	return changed;
+}
+
+/* Returns if the text imports as a scene, setting error if it does not. */
+static bool imports(const std::string& text, std::string& error)
+{
+	error.clear();
+	std::map<const Node*, std::string> labels;
+	if (!FrameWriter::writeFile(TEST_FILENAME,
+		std::vector<unsigned char>(text.begin(), text.end())))
+	{
+		return false;
+	}
+	Node* root = SceneJSON::load(TEST_FILENAME, labels, error);
+	if (root == NULL)
+	{
+		return false;
+	}
+	TestScenes::deleteScene(root);
+	return true;
+}
+
+/* Exports the scene graph with the labels, imports it back, and checks the */
+/* scene and labels imported are the same and export to the same text.      */
+/* Returns if it all matched.                                               */
+static bool roundTrips(const Node* root,
+	const std::map<const Node*, std::string>& labels)
+{
+	std::map<const Node*, std::string> loadedLabels;
+	std::string error;
+	if (!SceneJSON::save(root, labels, TEST_FILENAME))
+	{
+		return false;
+	}
+	Node* loaded = SceneJSON::load(TEST_FILENAME, loadedLabels, error);
+	if (loaded == NULL)
+	{
+		return false;
+	}
+
+	/* Each Node has the label of the Node in the same place */
+	FlatSceneGraph flat, loadedFlat;
+	flat.sync(root);
+	loadedFlat.sync(loaded);
+	bool same = TestScenes::sameScene(root, loaded) &&
+		TestScenes::sameFrames(root, loaded) &&
+		loadedLabels.size() == labels.size();
+	for (unsigned int i = 0; same && i < flat.size(); i++)
+	{
+		std::map<const Node*, std::string>::const_iterator label =
+			labels.find(flat.getNode(i));
+		std::map<const Node*, std::string>::const_iterator loadedLabel =
+			loadedLabels.find(loadedFlat.getNode(i));
+		same = (label == labels.end()) ?
+			(loadedLabel == loadedLabels.end()) :
+			(loadedLabel != loadedLabels.end() &&
+			loadedLabel->second == label->second);
+	}
+
+	std::vector<unsigned char> bytes, resavedBytes;
+	same = same && SceneJSON::save(loaded, loadedLabels,
+		TEST_RESAVED_FILENAME) && FrameWriter::readFile(TEST_FILENAME,
+		bytes) && FrameWriter::readFile(TEST_RESAVED_FILENAME,
+		resavedBytes) && bytes == resavedBytes;
+	remove(TEST_RESAVED_FILENAME);
+	TestScenes::deleteScene(loaded);
+	return same;
+}
+
+/* Returns labels for every other Node of the scene graph, with quotes,   */
+/* backslashes, control characters and UTF-8 in them, and a nul byte in   */
+/* the root's.                                                            */
+static std::map<const Node*, std::string> makeLabels(const Node* root)
+{
+	static const char* const LABELS[] = {"plain", "\"quoted\"",
+		"back\\slash", "tab\tnew\nline", "\x01\x1f control",
+		"caf\xc3\xa9 \xf0\x9f\x98\x80", ""};
+	unsigned int numLabels = sizeof(LABELS) / sizeof(LABELS[0]);
+	std::map<const Node*, std::string> labels;
+	FlatSceneGraph flatSceneGraph;
+	flatSceneGraph.sync(root);
+	for (unsigned int i = 0; i < flatSceneGraph.size(); i += 2)
+	{
+		labels[flatSceneGraph.getNode(i)] = LABELS[(i / 2) % numLabels];
+	}
+	labels[flatSceneGraph.getNode(0)] = std::string("nul\0byte", 8);
+	return labels;
+}
+
+/* Test the SceneJSON class */
+void testSceneJSON()
+{
+	/* The walking animal and random scenes import as they were exported, */
+	/* with their labels                                                  */
+	Node* root = SceneLibrary::createSceneGraph("walk", TEST_NUM_FRAMES);
+	CHECK(roundTrips(root, std::map<const Node*, std::string>()));
+	CHECK(roundTrips(root, makeLabels(root)));
+	delete root;
+	unsigned int sameScenes = 0;
+	for (unsigned int seed = 0; seed < TEST_NUM_SCENES; seed++)
+	{
+		Node* scene = TestScenes::randomScene(seed, 1 + seed * 3,
+			1 + seed % 30);
+		sameScenes += roundTrips(scene, makeLabels(scene));
+		TestScenes::deleteScene(scene);
+	}
+	CHECK(sameScenes == TEST_NUM_SCENES);
+
+	/* A scene written by hand imports, skipping members it does not know */
+	std::string error;
+	std::string scene = SMALL_SCENE;
+	CHECK(imports(scene, error) && error.empty());
+	std::map<const Node*, std::string> labels;
+	Node* small = SceneJSON::load(TEST_FILENAME, labels, error);
+	CHECK(small != NULL && small->getChildren()->size() == 1 &&
+		labels.size() == 1 && labels[small] == "root");
+	if (small != NULL)
+	{
+		TestScenes::deleteScene(small);
+	}
+
+	/* Scenes that are not right are rejected, saying why */
+	const char* const changes[][2] = {
+		{"animated-scene-graph", "other"},
+		{"\"version\": 1", "\"version\": 2"},
+		{"\"parent\": -1", "\"parent\": 0"},
+		{"\"parent\": 0,", "\"parent\": 1,"},
+		{"\"parent\": 0,", "\"parent\": 0.5,"},
+		{"\"parent\": 0,", ""},
+		{"\"length\": 4", "\"length\": 0"},
+		{"\"length\": 4", "\"length\": -4"},
+		{"\"length\": 4", "\"length\": 16777217"},
+		{"\"length\": 4", "\"length\": 4294967295"},
+		{"\"parent\": 0, \"length\": 4", "\"parent\": 0, \"length\": 5"},
+		{"\"frame\": 2", "\"frame\": 4000000000"},
+		{"[1, 0, 1]", "[1e39, 0, 1]"},
+		{"\"rotation\": 90", "\"rotation\": -1e39"},
+		{"\"scale\": [2, 2]", "\"scale\": [2, 1e39]"},
+		{"\"color\": [1, 0, 0],\n", "\"color\": [1, 0, 1e300],\n"},
+		{"\"translation\": [1, 1]", "\"translation\": [1e400, 1]"},
+		{"\"triangle\"", "\"hexagon\""},
+		{"[1, 0, 1], ", ""},
+		{"[0, 0, 1]", "[0, 0]"},
+		{"\"color\": [1, 0, 0],\n", "\"color\": [1, 0],\n"},
+		{"\"frame\": 0", "\"frame\": 1"},
+		{"\"frame\": 2", "\"frame\": 0"},
+		{"\"frame\": 2", "\"frame\": 4"},
+		{"\"scale\": [1, 1]", "\"scale\": [1]"},
+		{"\"rotation\": 0", "\"rotation\": \"0\""},
+		{"\"keyframes\": [", "\"keyframes\": [], \"x\": ["},
+		{"\"nodes\": [", "\"nodes\": {"},
+		{"{\"label\"", "[{\"label\""},
+		{"\"label\": \"root\"", "\"label\": 7"},
+		{" ]}\n", " ]}\n{}"},
+		{" ]}\n", " ]\n"}};
+	unsigned int numChanges = sizeof(changes) / sizeof(changes[0]);
+	unsigned int rejected = 0;
+	for (unsigned int i = 0; i < numChanges; i++)
+	{
+		std::string changed = replaced(scene, changes[i][0], changes[i][1]);
+		rejected += (changed != scene && !imports(changed, error) &&
+			!error.empty());
+	}
+	CHECK(rejected == numChanges);
+	CHECK(!imports("{\"format\": \"animated-scene-graph\", \"version\": 1, "
+		"\"nodes\": []}", error));
+	CHECK(!imports("{\"format\": \"animated-scene-graph\", \"version\": 1}",
+		error));
+	CHECK(!imports("[]", error));
+
+	/* Nodes may cover as many frames as a scene file allows */
+	std::string longest = replaced(replaced(scene, "\"length\": 4",
+		"\"length\": 16777216"), "\"length\": 4", "\"length\": 16777216");
+	CHECK(imports(longest, error));
+
+	/* Nor does a scene cut short anywhere */
+	unsigned int truncated = 0;
+	for (size_t size = 0; size < scene.size() - 1; size++)
+	{
+		truncated += !imports(scene.substr(0, size), error);
+	}
+	CHECK(truncated == scene.size() - 1);
+
+	remove(TEST_FILENAME);
+	CHECK(SceneJSON::load(TEST_FILENAME) == NULL);
+}
+
+/* Time exporting and importing a large scene */
+void benchSceneJSON()
+{
+	Node* scene = TestScenes::randomScene(1, BENCH_NUM_NODES,
+		BENCH_NUM_FRAMES);
+	std::chrono::steady_clock::time_point start = Tests::now();
+	for (unsigned int r = 0; r < BENCH_RUNS; r++)
+	{
+		CHECK(SceneJSON::save(scene, TEST_FILENAME));
+	}
+	Tests::report("SceneJSON::save", start, BENCH_RUNS);
+	TestScenes::deleteScene(scene);
+
+	std::vector<unsigned char> bytes;
+	FrameWriter::readFile(TEST_FILENAME, bytes);
+	std::cout << "  Scene of " << BENCH_NUM_NODES << " Nodes, " <<
+		bytes.size() / 1e6 << " MB" << std::endl;
+	start = Tests::now();
+	for (unsigned int r = 0; r < BENCH_RUNS; r++)
+	{
+		Node* loaded = SceneJSON::load(TEST_FILENAME);
+		if (CHECK(loaded != NULL))
+		{
+			TestScenes::deleteScene(loaded);
+		}
+	}
+	Tests::report("SceneJSON::load", start, BENCH_RUNS);
+	remove(TEST_FILENAME);
+}
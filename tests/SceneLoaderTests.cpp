@@ -0,0 +1,162 @@
+/*
+ * SceneLoaderTests.cpp
+ * Created by Zachary Ferguson
+ * Tests of the SceneLoader class, loading a scene large enough to be handed
+ * over in many pieces and putting it back together, cancelling a load part
+ * way, and loading files that are not scenes.
+ */
+
+#include <cstdio>   /* Included for remove */
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "SceneLoader.h"
+#include "TestScenes.h"
+#include "Tests.h"
+
+/* Number of Nodes and frames of the scene loaded, enough Nodes for it to */
+/* be split into many pieces.                                             */
+#define TEST_NUM_NODES 3000
+#define TEST_NUM_FRAMES 10
+
+/* File the scene is saved to. */
+#define TEST_FILENAME "test_loader.asg"
+
+/* What the notify functions of a test see. */
+struct LoadState
+{
+	SceneLoader* loader;
+	std::vector<SceneLoader::Piece> pieces;
+	std::atomic<unsigned int> numNotified;
+	std::atomic<bool> released;
+};
+
+/* Counts the times the loader notifies. */
+static void countNotified(void* data)
+{
+	((LoadState*)data)->numNotified++;
+}
+
+/* Takes the pieces waiting on the loading thread, and the first time */
+/* waits there until released, so the load can be cancelled part way.  */
+static void takeAndWait(void* data)
+{
+	LoadState* state = (LoadState*)data;
+	state->loader->takePieces(state->pieces);
+	if (state->numNotified++ == 0)
+	{
+		while (!(state->released))
+		{
+			std::this_thread::yield();
+		}
+	}
+}
+
+/* Releases the loading thread a while after the load is cancelled. */
+static void releaseLater(LoadState* state)
+{
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	state->released = true;
+}
+
+/* Loads the file, waiting for every piece. Returns if it failed. */
+static bool loadAll(const char* path, LoadState& state)
+{
+	SceneLoader loader(path, countNotified, &state);
+	state.loader = &loader;
+	state.numNotified = 0;
+	loader.start();
+	while (loader.takePieces(state.pieces))
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	return loader.getFailed();
+}
+
+/* Puts the pieces together as the window does, each added to its parent's */
+/* piece. Returns the root, or NULL if a piece came before its parent.     */
+static Node* assemble(const std::vector<SceneLoader::Piece>& pieces)
+{
+	std::vector<Node*> nodes;
+	Node* root = NULL;
+	for (unsigned int i = 0; i < pieces.size(); i++)
+	{
+		const SceneLoader::Piece& piece = pieces[i];
+		if (piece.parent < 0)
+		{
+			root = piece.subtree;
+		}
+		else if ((unsigned int)(piece.parent) < nodes.size() &&
+			nodes[piece.parent] != NULL)
+		{
+			nodes[piece.parent]->addChild(piece.subtree);
+		}
+		else
+		{
+			return NULL;
+		}
+		if (piece.index >= nodes.size())
+		{
+			nodes.resize(piece.index + 1, NULL);
+		}
+		nodes[piece.index] = piece.subtree;
+	}
+	return root;
+}
+
+/* Test the SceneLoader class */
+void testSceneLoader()
+{
+	/* The pieces of a large scene put back together are the scene saved */
+	Node* scene = TestScenes::randomScene(7, TEST_NUM_NODES,
+		TEST_NUM_FRAMES);
+	CHECK(SceneFile::save(scene, TEST_FILENAME));
+	LoadState state;
+	CHECK(!loadAll(TEST_FILENAME, state));
+	CHECK(state.pieces.size() > 1 && state.pieces[0].parent == -1);
+	CHECK(state.numNotified > 0 &&
+		state.numNotified <= state.pieces.size() + 1);
+	Node* loaded = assemble(state.pieces);
+	CHECK(loaded != NULL && TestScenes::sameScene(scene, loaded) &&
+		TestScenes::sameFrames(scene, loaded));
+	if (loaded != NULL)
+	{
+		TestScenes::deleteScene(loaded);
+	}
+	unsigned int numPieces = (unsigned int)(state.pieces.size());
+
+	/* Cancelling part way stops handing over pieces, and deletes those */
+	/* not taken                                                        */
+	LoadState cancelled;
+	cancelled.numNotified = 0;
+	cancelled.released = false;
+	SceneLoader* loader = new SceneLoader(TEST_FILENAME, takeAndWait,
+		&cancelled);
+	cancelled.loader = loader;
+	loader->start();
+	while (cancelled.numNotified == 0)
+	{
+		std::this_thread::yield();
+	}
+	std::thread release(releaseLater, &cancelled);
+	delete loader;
+	release.join();
+	CHECK(cancelled.pieces.size() >= 1 &&
+		cancelled.pieces.size() < numPieces);
+	for (unsigned int i = 0; i < cancelled.pieces.size(); i++)
+	{
+		TestScenes::deleteScene(cancelled.pieces[i].subtree);
+	}
+
+	/* A file that is not a scene, or is missing, fails with no pieces */
+	std::vector<unsigned char> text(100, 'x');
+	CHECK(SceneFile::saveBytes(text, TEST_FILENAME));
+	LoadState notScene;
+	CHECK(loadAll(TEST_FILENAME, notScene) && notScene.pieces.empty());
+	remove(TEST_FILENAME);
+	LoadState missing;
+	CHECK(loadAll(TEST_FILENAME, missing) && missing.pieces.empty());
+	CHECK(missing.numNotified == 1);
+
+	TestScenes::deleteScene(scene);
+}
@@ -0,0 +1,197 @@
+/*
+ * SoftwareRasterizerTests.cpp
+ * Created by Zachary Ferguson
+ * Tests of the SoftwareRasterizer class against reference images of the
+ * walking animal scene graph drawn by OpenGL. The reference images are the
+ * frames GLWindow draws, read back with glReadPixels. Also draws primitives
+ * far off the framebuffer or with coordinates that are not finite, and lines
+ * and triangles over each other.
+ */
+
+/* Allows sprintf, sprintf_s is only available on Windows */
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <cstdio>   /* Included for sprintf */
+#include <cstring>  /* Included for memcmp */
+#include <limits>
+#include "FlatSceneGraph.h"
+#include "SceneLibrary.h"
+#include "SoftwareRasterizer.h"
+#include "TestImages.h"
+#include "Tests.h"
+
+/* Size of the reference images, the size of the GLWindow. */
+#define REFERENCE_WIDTH 400
+#define REFERENCE_HEIGHT 400
+
+/* Number of frames of the walking animal in the reference images. */
+#define REFERENCE_NUM_FRAMES 20
+
+/* Most pixels that may differ from the reference images. OpenGL and the */
+/* rasterizer may end a line a pixel apart, so a differing pixel must    */
+/* match one of the pixels next to it in the reference image.            */
+#define MAX_DIFFERING_PIXELS 16
+
+/* Size of the framebuffer primitives far off it are drawn into. */
+#define TEST_SIZE 32
+
+/* Returns if the pixel at the column and row matches the pixel there or */
+/* next to it in the reference image.                                    */
+static bool matchesNearby(const unsigned char* pixels,
+	const std::vector<unsigned char>& reference, int column, int row)
+{
+	for (int y = row - 1; y <= row + 1; y++)
+	{
+		for (int x = column - 1; x <= column + 1; x++)
+		{
+			if (x >= 0 && x < REFERENCE_WIDTH && y >= 0 &&
+				y < REFERENCE_HEIGHT && memcmp(&reference[3 *
+				(y * REFERENCE_WIDTH + x)], pixels + 3 * (row *
+				REFERENCE_WIDTH + column), 3) == 0)
+			{
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+/* Returns the number of pixels of the rasterizer that are not black. */
+static unsigned int countLit(const SoftwareRasterizer& rasterizer)
+{
+	const unsigned char* pixels = rasterizer.getPixels();
+	unsigned int lit = 0;
+	for (unsigned int i = 0; i < TEST_SIZE * TEST_SIZE; i++)
+	{
+		lit += (pixels[3 * i] | pixels[3 * i + 1] | pixels[3 * i + 2]) != 0;
+	}
+	return lit;
+}
+
+/* Returns the number of pixels of the rasterizer with the given color. */
+static unsigned int countColored(const SoftwareRasterizer& rasterizer,
+	const unsigned char color[3])
+{
+	const unsigned char* pixels = rasterizer.getPixels();
+	unsigned int colored = 0;
+	for (unsigned int i = 0; i < TEST_SIZE * TEST_SIZE; i++)
+	{
+		colored += memcmp(pixels + 3 * i, color, 3) == 0;
+	}
+	return colored;
+}
+
+/* Test the SoftwareRasterizer class */
+void testSoftwareRasterizer()
+{
+	static const unsigned int frameNums[] = {0, 5, 13};
+
+	bool interpolated = Node::getInterpolated();
+	Node::setInterpolated(true);
+	Node* root = SceneLibrary::createSceneGraph("walk", REFERENCE_NUM_FRAMES);
+
+	FlatSceneGraph flatSceneGraph;
+	RenderBatch batch;
+	SoftwareRasterizer rasterizer(REFERENCE_WIDTH, REFERENCE_HEIGHT);
+	flatSceneGraph.sync(root);
+	for (unsigned int i = 0; i < sizeof(frameNums) / sizeof(frameNums[0]);
+		i++)
+	{
+		/* Draw the frame as OfflineRenderer does */
+		flatSceneGraph.evaluate(frameNums[i], affine2::identity());
+		batch.clear();
+		flatSceneGraph.appendTo(batch, frameNums[i]);
+		rasterizer.clear(0.0f, 0.0f, 0.0f);
+		rasterizer.draw(batch);
+
+		char filename[64];
+		sprintf(filename, REFERENCE_DIRECTORY "walk_%03u.png", frameNums[i]);
+		unsigned int width, height;
+		std::vector<unsigned char> reference;
+		if (!CHECK(TestImages::readPNG(filename, width, height, reference)) ||
+			!CHECK(width == REFERENCE_WIDTH && height == REFERENCE_HEIGHT))
+		{
+			continue;
+		}
+
+		const unsigned char* pixels = rasterizer.getPixels();
+		unsigned int differing = 0, unmatched = 0;
+		for (int row = 0; row < REFERENCE_HEIGHT; row++)
+		{
+			for (int column = 0; column < REFERENCE_WIDTH; column++)
+			{
+				unsigned int at = 3 * (row * REFERENCE_WIDTH + column);
+				if (memcmp(pixels + at, &reference[at], 3) != 0)
+				{
+					differing++;
+					unmatched += !matchesNearby(pixels, reference, column,
+						row);
+				}
+			}
+		}
+		CHECK(differing <= MAX_DIFFERING_PIXELS);
+		CHECK(unmatched == 0);
+	}
+
+	/* A triangle around the whole view, with corners too far off to be a */
+	/* pixel number, fills every pixel, and a line across it too far off  */
+	/* to be one fills a whole row                                        */
+	static const float white[3] = {1.0f, 1.0f, 1.0f};
+	SoftwareRasterizer small(TEST_SIZE, TEST_SIZE);
+	const float far = 1e9f, farther = 1e30f;
+	const float around[] = {-far, -far, far, -far, 0.0f, far};
+	batch.clear();
+	batch.addTriangleFan(around, 3, white);
+	small.draw(batch);
+	CHECK(countLit(small) == TEST_SIZE * TEST_SIZE);
+	const float across[] = {-farther, 0.0f, farther, 0.0f};
+	batch.clear();
+	batch.addLineStrip(across, 2, white);
+	small.clear(0.0f, 0.0f, 0.0f);
+	small.draw(batch);
+	CHECK(countLit(small) == TEST_SIZE);
+
+	/* Primitives with a corner off to infinity, or that is not a number, */
+	/* or that are far off the view, draw nothing                         */
+	const float infinity = std::numeric_limits<float>::infinity();
+	const float notNumber = std::numeric_limits<float>::quiet_NaN();
+	const float notDrawn[][6] = {
+		{0.0f, 0.0f, 1.0f, 0.0f, 0.0f, infinity},
+		{0.0f, 0.0f, notNumber, 0.0f, 0.0f, 1.0f},
+		{-infinity, 0.0f, infinity, 0.0f, 0.0f, 1.0f},
+		{farther, farther, farther + far, farther, farther, -farther}
+	};
+	unsigned int numNotDrawn = sizeof(notDrawn) / sizeof(notDrawn[0]);
+	unsigned int blank = 0;
+	for (unsigned int i = 0; i < numNotDrawn; i++)
+	{
+		batch.clear();
+		batch.addTriangleFan(notDrawn[i], 3, white);
+		batch.addLineStrip(notDrawn[i] + 2, 2, white);
+		small.clear(0.0f, 0.0f, 0.0f);
+		small.draw(batch);
+		blank += countLit(small) == 0;
+	}
+	CHECK(blank == numNotDrawn);
+
+	/* Each primitive is drawn over the ones added before it, whatever its */
+	/* type, so a line added before a triangle is hidden and one added     */
+	/* after shows                                                         */
+	static const float red[3] = {1.0f, 0.0f, 0.0f};
+	static const float green[3] = {0.0f, 1.0f, 0.0f};
+	static const unsigned char redBytes[3] = {255, 0, 0};
+	static const unsigned char greenBytes[3] = {0, 255, 0};
+	const float below[] = {-farther, -5.0f, farther, -5.0f};
+	batch.clear();
+	batch.addLineStrip(below, 2, green);
+	batch.addTriangleFan(around, 3, red);
+	batch.addLineStrip(across, 2, green);
+	small.clear(0.0f, 0.0f, 0.0f);
+	small.draw(batch);
+	CHECK(countColored(small, greenBytes) == TEST_SIZE);
+	CHECK(countColored(small, redBytes) == TEST_SIZE * (TEST_SIZE - 1));
+	CHECK(batch.getNumRuns() == 3);
+
+	delete root;
+	Node::setInterpolated(interpolated);
+}
@@ -0,0 +1,150 @@
+/*
+ * TestImages.cpp
+ * Created by Zachary Ferguson
+ * Class for reading the images the tests compare frames against.
+ */
+
+#include <cstdlib>  /* Included for abs */
+#include <cstring>  /* Included for memcmp */
+#include <zlib/zlib.h>
+#include "FrameWriter.h"
+#include "TestImages.h"
+
+/* Returns the big-endian 32-bit number at the given bytes. */
+static unsigned int readUInt32(const unsigned char* bytes)
+{
+	return ((unsigned int)bytes[0] << 24) | ((unsigned int)bytes[1] << 16) |
+		((unsigned int)bytes[2] << 8) | (unsigned int)bytes[3];
+}
+
+/* Returns the Paeth predictor of the bytes to the left, above, and above */
+/* and to the left.                                                       */
+static unsigned char paeth(int left, int above, int aboveLeft)
+{
+	int estimate = left + above - aboveLeft;
+	int toLeft = abs(estimate - left), toAbove = abs(estimate - above);
+	int toAboveLeft = abs(estimate - aboveLeft);
+	if (toLeft <= toAbove && toLeft <= toAboveLeft)
+	{
+		return (unsigned char)left;
+	}
+	return (unsigned char)(toAbove <= toAboveLeft ? above : aboveLeft);
+}
+
+/* Decodes an 8-bit RGB PNG image without interlacing, the kind FrameWriter */
+/* encodes, into pixels starting with the bottom row like glReadPixels.     */
+/* Returns if it could be decoded.                                          */
+bool TestImages::decodePNG(const std::vector<unsigned char>& png,
+	unsigned int& width, unsigned int& height,
+	std::vector<unsigned char>& pixels)
+{
+	static const unsigned char signature[8] = {137, 80, 78, 71, 13, 10, 26,
+		10};
+	if (png.size() < 8 || memcmp(&png[0], signature, 8) != 0)
+	{
+		return false;
+	}
+
+	/* Gather the header and the compressed data, checking every CRC */
+	width = height = 0;
+	std::vector<unsigned char> compressed;
+	bool ended = false;
+	for (size_t at = 8; !ended; )
+	{
+		if (png.size() - at < 12)
+		{
+			return false;
+		}
+		unsigned int length = readUInt32(&png[at]);
+		if (length > png.size() - at - 12)
+		{
+			return false;
+		}
+		const unsigned char* type = &png[at + 4];
+		const unsigned char* data = type + 4;
+		if (crc32(crc32(0L, Z_NULL, 0), type, length + 4) !=
+			readUInt32(data + length))
+		{
+			return false;
+		}
+		if (memcmp(type, "IHDR", 4) == 0)
+		{
+			/* Only 8-bit RGB without interlacing */
+			if (length != 13 || data[8] != 8 || data[9] != 2 ||
+				data[10] != 0 || data[11] != 0 || data[12] != 0)
+			{
+				return false;
+			}
+			width = readUInt32(data);
+			height = readUInt32(data + 4);
+		}
+		else if (memcmp(type, "IDAT", 4) == 0)
+		{
+			compressed.insert(compressed.end(), data, data + length);
+		}
+		ended = memcmp(type, "IEND", 4) == 0;
+		at += 12 + length;
+	}
+	if (width == 0 || height == 0 || compressed.empty())
+	{
+		return false;
+	}
+
+	/* Every row starts with the type of filter used on it */
+	const unsigned int rowStride = 3 * width;
+	std::vector<unsigned char> filtered((1 + rowStride) * height);
+	uLongf size = (uLongf)filtered.size();
+	if (uncompress(&filtered[0], &size, &compressed[0],
+		(uLong)compressed.size()) != Z_OK || size != filtered.size())
+	{
+		return false;
+	}
+
+	/* Undo the filters top down, storing the rows bottom up */
+	pixels.resize(rowStride * height);
+	for (unsigned int y = 0; y < height; y++)
+	{
+		const unsigned char* in = &filtered[y * (1 + rowStride)];
+		unsigned char* row = &pixels[(height - 1 - y) * rowStride];
+		const unsigned char* above = (y == 0) ? NULL : row + rowStride;
+		for (unsigned int i = 0; i < rowStride; i++)
+		{
+			int left = (i < 3) ? 0 : row[i - 3];
+			int up = above ? above[i] : 0;
+			int upLeft = (above && i >= 3) ? above[i - 3] : 0;
+			unsigned char value = in[1 + i];
+			/* None, Sub, Up, Average, and Paeth filters */
+			switch (in[0])
+			{
+				case 0:
+					break;
+				case 1:
+					value += left;
+					break;
+				case 2:
+					value += up;
+					break;
+				case 3:
+					value += (left + up) / 2;
+					break;
+				case 4:
+					value += paeth(left, up, upLeft);
+					break;
+				default:
+					return false;
+			}
+			row[i] = value;
+		}
+	}
+	return true;
+}
+
+/* Reads the PNG image in the given file like decodePNG. Returns if it */
+/* could be read.                                                      */
+bool TestImages::readPNG(const std::string& filename, unsigned int& width,
+	unsigned int& height, std::vector<unsigned char>& pixels)
+{
+	std::vector<unsigned char> png;
+	return FrameWriter::readFile(filename, png) &&
+		TestImages::decodePNG(png, width, height, pixels);
+}
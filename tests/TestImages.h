@@ -0,0 +1,32 @@
+/*
+ * TestImages.h
+ * Created by Zachary Ferguson
+ * Header file for the TestImages class, a class for reading the images the
+ * tests compare frames against.
+ */
+
+#ifndef TESTIMAGES_H
+#define TESTIMAGES_H
+
+/* Include necessary types */
+#include <string>
+#include <vector>
+
+class TestImages
+{
+	public:
+
+		/* Decodes an 8-bit RGB PNG image without interlacing, the kind  */
+		/* FrameWriter encodes, into pixels starting with the bottom row */
+		/* like glReadPixels. Returns if it could be decoded.            */
+		static bool decodePNG(const std::vector<unsigned char>& png,
+			unsigned int& width, unsigned int& height,
+			std::vector<unsigned char>& pixels);
+
+		/* Reads the PNG image in the given file like decodePNG. Returns */
+		/* if it could be read.                                          */
+		static bool readPNG(const std::string& filename, unsigned int& width,
+			unsigned int& height, std::vector<unsigned char>& pixels);
+};
+
+#endif
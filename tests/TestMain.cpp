@@ -0,0 +1,151 @@
+/*
+ * TestMain.cpp
+ * Created by Zachary Ferguson
+ * Main file for running the tests of the scene graph, and its benchmarks
+ * when asked to. Run from the project directory, as some tests read files
+ * from tests/, and write their own files to the working directory.
+ */
+
+#include <cstdio>   /* Included for remove */
+#include <cstring>  /* Included for strcmp */
+#include <iostream>
+#include "FrameWriter.h"
+#include "Tests.h"
+
+/* A part of the scene graph with its tests and benchmark, if any. */
+struct TestCase
+{
+	const char* name;
+	void (*test)();
+	void (*bench)();
+};
+
+/* Every part that is tested, in the order to run them. */
+static const TestCase TEST_CASES[] =
+{
+	{"KeyframeTrack", testKeyframeTrack, benchKeyframeTrack},
+	{"affine2", testAffine2, benchAffine2},
+	{"SoftwareRasterizer", testSoftwareRasterizer, NULL},
+	{"OfflineRenderer", testOfflineRenderer, NULL},
+	{"FramePipeline", testFramePipeline, NULL},
+	{"FrameReadback", testFrameReadback, NULL},
+	{"ColorConverter", testColorConverter, benchColorConverter},
+	{"FrameWriter", testFrameWriter, benchFrameWriter},
+	{"RenderJob", testRenderJob, NULL},
+	{"BatchOptions", testBatchOptions, NULL},
+	{"SceneFile", testSceneFile, NULL},
+	{"SceneLoader", testSceneLoader, NULL},
+	{"JSONReader", testJSONReader, benchJSONReader},
+	{"SceneJSON", testSceneJSON, benchSceneJSON},
+	{"EditJournal", testEditJournal, NULL},
+	{"UndoHistory", testUndoHistory, NULL}
+};
+
+#define NUM_TEST_CASES (sizeof(TEST_CASES) / sizeof(TEST_CASES[0]))
+
+unsigned int Tests::numChecks = 0;
+unsigned int Tests::numFailed = 0;
+
+/* Counts the result of a check, printing the condition and where it is if */
+/* it failed. Returns if it passed.                                        */
+bool Tests::check(bool passed, const char* condition, const char* file,
+	int line)
+{
+	Tests::numChecks++;
+	if (!passed)
+	{
+		Tests::numFailed++;
+		std::cerr << file << "(" << line << "): check failed: " <<
+			condition << std::endl;
+	}
+	return passed;
+}
+
+/* Returns the number of checks made. */
+unsigned int Tests::getNumChecks()
+{
+	return Tests::numChecks;
+}
+
+/* Returns the number of checks that failed. */
+unsigned int Tests::getNumFailed()
+{
+	return Tests::numFailed;
+}
+
+/* Deletes the numbered frame files and the manifest a render to an image  */
+/* sequence with the given prefix wrote.                                   */
+void Tests::removeFrameFiles(const std::string& prefix,
+	unsigned int numFrames, const char* extension)
+{
+	std::string filename;
+	for (unsigned int i = 0; i < numFrames; i++)
+	{
+		FrameWriter::frameFilename(prefix, i, extension, filename);
+		remove(filename.c_str());
+	}
+	remove((prefix + "manifest.txt").c_str());
+}
+
+/* Returns the time to measure benchmarks from. */
+std::chrono::steady_clock::time_point Tests::now()
+{
+	return std::chrono::steady_clock::now();
+}
+
+/* Prints the time taken since start by a benchmark, divided by the given */
+/* number of times it was run.                                            */
+void Tests::report(const char* name,
+	std::chrono::steady_clock::time_point start, unsigned int runs)
+{
+	double seconds = std::chrono::duration<double>(
+		std::chrono::steady_clock::now() - start).count();
+	std::cout << "  " << name << ": " << seconds * 1e6 / runs << " us" <<
+		std::endl;
+}
+
+/* Run the tests, and the benchmarks if --bench is given. Only the parts */
+/* named on the command line are run, if any are.                        */
+int main(int argc, char* const argv[])
+{
+	bool bench = false;
+	int numNames = 0;
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--bench") == 0)
+		{
+			bench = true;
+		}
+		else
+		{
+			numNames++;
+		}
+	}
+
+	for (unsigned int t = 0; t < NUM_TEST_CASES; t++)
+	{
+		const TestCase& testCase = TEST_CASES[t];
+		bool named = numNames == 0;
+		for (int i = 1; i < argc; i++)
+		{
+			named = named || strcmp(argv[i], testCase.name) == 0;
+		}
+		if (!named)
+		{
+			continue;
+		}
+
+		unsigned int failed = Tests::getNumFailed();
+		testCase.test();
+		std::cout << testCase.name << ": " << (Tests::getNumFailed() ==
+			failed ? "passed" : "FAILED") << std::endl;
+		if (bench && testCase.bench != NULL)
+		{
+			testCase.bench();
+		}
+	}
+
+	std::cout << Tests::getNumChecks() << " checks, " <<
+		Tests::getNumFailed() << " failed." << std::endl;
+	return Tests::getNumFailed() == 0 ? 0 : 1;
+}
@@ -0,0 +1,205 @@
+/*
+ * TestScenes.cpp
+ * Created by Zachary Ferguson
+ * Source file for the TestScenes class, a class for making random scene
+ * graphs for the tests of saving and loading scenes, and comparing the scenes
+ * loaded with the ones saved.
+ */
+
+#include "TestScenes.h"
+#include <algorithm>  /* Included for sort and unique */
+#include <vector>
+#include "FlatSceneGraph.h"
+#include "SceneFile.h"
+
+/* Most vertices of random geometry that is not a triangle or a quad, and */
+/* most keyframes of a random Node.                                       */
+#define MAX_RANDOM_VERTICES 8
+#define MAX_RANDOM_KEYFRAMES 6
+
+/* Returns the next number of a linear congruential generator, the same on */
+/* every machine, unlike rand.                                             */
+unsigned int TestScenes::nextRandom(unsigned int& state)
+{
+	state = state * 1664525u + 1013904223u;
+	return state >> 8;
+}
+
+/* Returns a random number from low to high. */
+float TestScenes::randomNumber(unsigned int& state, float low, float high)
+{
+	return low + (high - low) * (nextRandom(state) % 10001) / 10000.0f;
+}
+
+/* Sets values to a random scale, rotation, translation and color. */
+void TestScenes::randomValues(unsigned int& state,
+	float values[KeyframeTrack::NUM_CHANNELS])
+{
+	static const float low[KeyframeTrack::NUM_CHANNELS] =
+		{0.5f, 0.5f, -180, -5, -5, 0, 0, 0};
+	static const float high[KeyframeTrack::NUM_CHANNELS] =
+		{2, 2, 180, 5, 5, 1, 1, 1};
+	for (int c = 0; c < KeyframeTrack::NUM_CHANNELS; c++)
+	{
+		values[c] = randomNumber(state, low[c], high[c]);
+	}
+}
+
+/* Makes a scene graph of numNodes Nodes, each added to a random earlier  */
+/* Node, with random geometry, or none, and random keyframes over length  */
+/* frames. The same seed makes the same scene on every machine.           */
+Node* TestScenes::randomScene(unsigned int seed, unsigned int numNodes,
+	unsigned int length)
+{
+	unsigned int state = seed;
+	std::vector<Node*> nodes;
+	for (unsigned int i = 0; i < numNodes; i++)
+	{
+		/* Geometry of a random kind, triangles and quads with the number */
+		/* of vertices they need                                          */
+		int geometryType = (int)(nextRandom(state) %
+			(polyline::NUM_TYPES + 1)) - 1;
+		unsigned int numVertices = 0;
+		if (geometryType == polyline::TRIANGLE)
+		{
+			numVertices = 3;
+		}
+		else if (geometryType == polyline::QUAD)
+		{
+			numVertices = 4;
+		}
+		else if (geometryType != SCENE_NO_GEOMETRY)
+		{
+			numVertices = 1 + nextRandom(state) % MAX_RANDOM_VERTICES;
+		}
+		std::vector<float> xyz;
+		for (unsigned int v = 0; v < numVertices; v++)
+		{
+			xyz.push_back(randomNumber(state, -2, 2));
+			xyz.push_back(randomNumber(state, -2, 2));
+			xyz.push_back(1);
+		}
+		float color[3];
+		for (int c = 0; c < 3; c++)
+		{
+			color[c] = randomNumber(state, 0, 1);
+		}
+
+		/* Keyframes at frame 0 and a few random later frames */
+		std::vector<unsigned int> times(1, 0);
+		unsigned int numKeyframes = nextRandom(state) % MAX_RANDOM_KEYFRAMES;
+		for (unsigned int k = 0; k < numKeyframes; k++)
+		{
+			times.push_back(nextRandom(state) % length);
+		}
+		std::sort(times.begin(), times.end());
+		times.erase(std::unique(times.begin(), times.end()), times.end());
+		std::vector<float> channels[KeyframeTrack::NUM_CHANNELS];
+		for (unsigned int k = 0; k < times.size(); k++)
+		{
+			float keyframe[KeyframeTrack::NUM_CHANNELS];
+			randomValues(state, keyframe);
+			for (int c = 0; c < KeyframeTrack::NUM_CHANNELS; c++)
+			{
+				channels[c].push_back(keyframe[c]);
+			}
+		}
+		const float* values[KeyframeTrack::NUM_CHANNELS];
+		for (int c = 0; c < KeyframeTrack::NUM_CHANNELS; c++)
+		{
+			values[c] = &channels[c][0];
+		}
+
+		nodes.push_back(SceneFile::buildNode(geometryType,
+			xyz.empty() ? NULL : &xyz[0], numVertices, color, length,
+			&times[0], (unsigned int)(times.size()), values));
+		if (i > 0)
+		{
+			nodes[nextRandom(state) % i]->addChild(nodes[i]);
+		}
+	}
+	return nodes.empty() ? NULL : nodes[0];
+}
+
+/* Returns if the scene graphs have the same tree, geometry, colors, and */
+/* keyframes, Node for Node.                                             */
+bool TestScenes::sameScene(const Node* root1, const Node* root2)
+{
+	FlatSceneGraph flat1, flat2;
+	flat1.sync(root1);
+	flat2.sync(root2);
+	if (flat1.size() != flat2.size())
+	{
+		return false;
+	}
+	for (unsigned int i = 0; i < flat1.size(); i++)
+	{
+		const Node* node1 = flat1.getNode(i);
+		const Node* node2 = flat2.getNode(i);
+		const polyline* geometry1 = node1->getGeometry();
+		const polyline* geometry2 = node2->getGeometry();
+		if (flat1.getParent(i) != flat2.getParent(i) ||
+			!(*(node1->getTrack()) == *(node2->getTrack())) ||
+			(geometry1 == NULL) != (geometry2 == NULL))
+		{
+			return false;
+		}
+		if (geometry1 != NULL && (geometry1->getType() !=
+			geometry2->getType() || *geometry1 != *geometry2 ||
+			geometry1->getColor() != geometry2->getColor()))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+/* Returns if the scene graphs evaluate to the same hash at every frame of */
+/* the first, both interpolated and not.                                   */
+bool TestScenes::sameFrames(const Node* root1, const Node* root2)
+{
+	bool interpolated = Node::getInterpolated();
+	bool same = true;
+	FlatSceneGraph flat1, flat2;
+	flat1.sync(root1);
+	flat2.sync(root2);
+	for (int mode = 0; mode < 2; mode++)
+	{
+		Node::setInterpolated(mode == 1);
+		for (unsigned int frameNum = 0;
+			frameNum < root1->getTrack()->getLength(); frameNum++)
+		{
+			flat1.evaluate(frameNum, affine2::identity());
+			flat2.evaluate(frameNum, affine2::identity());
+			same = same && flat1.hashEvaluated() == flat2.hashEvaluated();
+		}
+	}
+	Node::setInterpolated(interpolated);
+	return same;
+}
+
+/* Sets nodes to the Nodes of the scene graph in preorder, to be changed by */
+/* the tests.                                                               */
+void TestScenes::getNodes(Node* root, std::vector<Node*>& nodes)
+{
+	FlatSceneGraph flatSceneGraph;
+	flatSceneGraph.sync(root);
+	nodes.resize(flatSceneGraph.size());
+	for (unsigned int i = 0; i < flatSceneGraph.size(); i++)
+	{
+		nodes[i] = const_cast<Node*>(flatSceneGraph.getNode(i));
+	}
+}
+
+/* Deletes every Node of the scene graph, which deleting the root alone */
+/* does not.                                                            */
+void TestScenes::deleteScene(Node* root)
+{
+	/* Children come after their parents, so delete from the end */
+	std::vector<Node*> nodes;
+	TestScenes::getNodes(root, nodes);
+	for (unsigned int i = (unsigned int)(nodes.size()); i > 0; i--)
+	{
+		delete nodes[i - 1];
+	}
+}
@@ -0,0 +1,57 @@
+/*
+ * TestScenes.h
+ * Created by Zachary Ferguson
+ * Header file for the TestScenes class, a class for making random scene
+ * graphs for the tests of saving and loading scenes, and comparing the scenes
+ * loaded with the ones saved.
+ */
+
+#ifndef TESTSCENES_H
+#define TESTSCENES_H
+
+/* Include necessary types */
+#include <vector>
+#include "Node.h"
+
+class TestScenes
+{
+	public:
+
+		/* Returns the next number of a linear congruential generator,  */
+		/* the same on every machine, unlike rand.                      */
+		static unsigned int nextRandom(unsigned int& state);
+
+		/* Returns a random number from low to high. */
+		static float randomNumber(unsigned int& state, float low,
+			float high);
+
+		/* Sets values to a random scale, rotation, translation and */
+		/* color.                                                   */
+		static void randomValues(unsigned int& state,
+			float values[KeyframeTrack::NUM_CHANNELS]);
+
+		/* Makes a scene graph of numNodes Nodes, each added to a random  */
+		/* earlier Node, with random geometry, or none, and random        */
+		/* keyframes over length frames. The same seed makes the same     */
+		/* scene on every machine.                                        */
+		static Node* randomScene(unsigned int seed, unsigned int numNodes,
+			unsigned int length);
+
+		/* Returns if the scene graphs have the same tree, geometry,  */
+		/* colors, and keyframes, Node for Node.                      */
+		static bool sameScene(const Node* root1, const Node* root2);
+
+		/* Returns if the scene graphs evaluate to the same hash at every */
+		/* frame of the first, both interpolated and not.                 */
+		static bool sameFrames(const Node* root1, const Node* root2);
+
+		/* Sets nodes to the Nodes of the scene graph in preorder, to be */
+		/* changed by the tests.                                         */
+		static void getNodes(Node* root, std::vector<Node*>& nodes);
+
+		/* Deletes every Node of the scene graph, which deleting the root */
+		/* alone does not.                                                */
+		static void deleteScene(Node* root);
+};
+
+#endif
@@ -0,0 +1,87 @@
+/*
+ * Tests.h
+ * Created by Zachary Ferguson
+ * Header file for the tests and benchmarks of the scene graph, run by the
+ * Tests project. Each part has a function that checks its results with CHECK,
+ * and the parts that were made faster have a function that times them against
+ * what they replaced.
+ */
+
+#ifndef TESTS_H
+#define TESTS_H
+
+/* Include necessary types */
+#include <chrono>
+#include <string>
+
+/* Directory of the images the tests compare frames against, from the  */
+/* project directory.                                                  */
+#define REFERENCE_DIRECTORY "tests/reference/"
+
+/* Checks that the given condition is true, printing it if it is not. */
+#define CHECK(condition) \
+	Tests::check((condition), #condition, __FILE__, __LINE__)
+
+class Tests
+{
+	private:
+
+		/* Number of checks made, and of checks that failed. */
+		static unsigned int numChecks, numFailed;
+
+	public:
+
+		/* Counts the result of a check, printing the condition and where */
+		/* it is if it failed. Returns if it passed.                      */
+		static bool check(bool passed, const char* condition,
+			const char* file, int line);
+
+		/* Returns the number of checks made. */
+		static unsigned int getNumChecks();
+
+		/* Returns the number of checks that failed. */
+		static unsigned int getNumFailed();
+
+		/* Deletes the numbered frame files and the manifest a render to */
+		/* an image sequence with the given prefix wrote.                */
+		static void removeFrameFiles(const std::string& prefix,
+			unsigned int numFrames, const char* extension);
+
+		/* Returns the time to measure benchmarks from. */
+		static std::chrono::steady_clock::time_point now();
+
+		/* Prints the time taken since start by a benchmark, divided by the */
+		/* given number of times it was run.                                */
+		static void report(const char* name,
+			std::chrono::steady_clock::time_point start, unsigned int runs);
+};
+
+/** Tests of each part, defined in the file named after the part. **/
+
+void testKeyframeTrack();
+void testAffine2();
+void testSoftwareRasterizer();
+void testOfflineRenderer();
+void testFramePipeline();
+void testFrameReadback();
+void testColorConverter();
+void testFrameWriter();
+void testRenderJob();
+void testBatchOptions();
+void testSceneFile();
+void testSceneLoader();
+void testJSONReader();
+void testSceneJSON();
+void testEditJournal();
+void testUndoHistory();
+
+/** Benchmarks of each part, defined with its tests. **/
+
+void benchKeyframeTrack();
+void benchAffine2();
+void benchColorConverter();
+void benchFrameWriter();
+void benchJSONReader();
+void benchSceneJSON();
+
+#endif
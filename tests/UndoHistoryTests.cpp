@@ -0,0 +1,321 @@
+/*
+ * UndoHistoryTests.cpp
+ * Created by Zachary Ferguson
+ * Tests of the UndoHistory class, undoing and redoing random edits with and
+ * without interpolation, keying the scene graph, adding and removing Nodes,
+ * and dropping the oldest steps once the history is over its memory limit.
+ */
+
+#include <sstream>  /* Included for building the labels */
+#include "SceneFile.h"
+#include "TestScenes.h"
+#include "Tests.h"
+#include "UndoHistory.h"
+
+/* Nodes and frames of the scene edited, and number of steps undone. */
+#define TEST_NUM_NODES 40
+#define TEST_NUM_FRAMES 20
+#define TEST_NUM_EDITS 200
+
+/* Number of steps the memory limit of the eviction test is set to hold, */
+/* and number of steps made under it.                                    */
+#define TEST_NUM_KEPT 10
+#define TEST_NUM_EVICTING_EDITS 100
+
+/* Number of edits in a drag of a widget, which are undone at once. */
+#define TEST_DRAG_EDITS 3
+
+/* A Node that counts the Nodes of its kind deleted. */
+class CountedNode : public Node
+{
+	public:
+
+		static unsigned int numDeleted;
+
+		CountedNode() : Node(mat3::identity(), mat3::identity(),
+			mat3::identity()){}
+
+		virtual ~CountedNode()
+		{
+			numDeleted++;
+		}
+};
+
+unsigned int CountedNode::numDeleted = 0;
+
+/* Number of CountedNodes in the subtree made by countedSubtree. */
+#define COUNTED_SUBTREE_SIZE 3
+
+/* Returns a subtree of CountedNodes, a Node with a child and a grandchild. */
+static Node* countedSubtree()
+{
+	Node* node = new CountedNode();
+	Node* child = new CountedNode();
+	child->addChild(new CountedNode());
+	node->addChild(child);
+	return node;
+}
+
+/* Returns the bytes of the scene graph as a scene file, which are the same */
+/* only for the same scene.                                                 */
+static std::vector<unsigned char> sceneBytes(const Node* root)
+{
+	std::vector<unsigned char> bytes;
+	SceneFile::serialize(root, bytes);
+	return bytes;
+}
+
+/* Makes numEdits random edits to the Nodes of the scene graph as the      */
+/* editor does, each its own step, and adds the bytes of the scene after   */
+/* each to states. A step is either a drag of a widget editing a keyframe, */
+/* or a keyframe edited and the scene graph keyed at its frame.            */
+static void editRandomly(UndoHistory& history, Node* root,
+	const std::vector<Node*>& nodes, unsigned int& state,
+	unsigned int numEdits, std::vector<std::vector<unsigned char> >& states)
+{
+	float values[KeyframeTrack::NUM_CHANNELS];
+	for (unsigned int i = 0; i < numEdits; i++)
+	{
+		Node* node = nodes[TestScenes::nextRandom(state) % nodes.size()];
+		unsigned int frameNum = TestScenes::nextRandom(state) %
+			TEST_NUM_FRAMES;
+		if (TestScenes::nextRandom(state) % 2 == 0)
+		{
+			for (unsigned int d = 0; d < TEST_DRAG_EDITS; d++)
+			{
+				history.recordKeyframeEdit(node, frameNum, &history);
+				TestScenes::randomValues(state, values);
+				node->setKeyframe(frameNum, values);
+			}
+		}
+		else
+		{
+			history.recordKeyframeEdit(node, frameNum, root);
+			TestScenes::randomValues(state, values);
+			node->setKeyframe(frameNum, values);
+			history.recordMakeKeyframe(root, frameNum, root);
+			root->makeKeyframe(frameNum);
+		}
+		history.endStep();
+		states.push_back(sceneBytes(root));
+	}
+}
+
+/* Undoes every step of the history, and checks the scene graph is as it */
+/* was before each. Returns the number of steps undone.                  */
+static unsigned int undoAll(UndoHistory& history, const Node* root,
+	const std::vector<std::vector<unsigned char> >& states)
+{
+	std::vector<UndoHistory::ChangedKeyframe> changed;
+	std::map<const Node*, std::string> labels;
+	unsigned int numUndone = 0;
+	while (history.undo(changed, labels))
+	{
+		numUndone++;
+		CHECK(numUndone < states.size() &&
+			sceneBytes(root) == states[states.size() - 1 - numUndone]);
+	}
+	return numUndone;
+}
+
+/* Returns the children of the Node in order. */
+static std::vector<Node*> childrenOf(const Node* node)
+{
+	return std::vector<Node*>(node->getChildren()->cbegin(),
+		node->getChildren()->cend());
+}
+
+/* Test the UndoHistory class */
+void testUndoHistory()
+{
+	bool interpolated = Node::getInterpolated();
+	std::vector<UndoHistory::ChangedKeyframe> changed;
+	std::map<const Node*, std::string> labels;
+
+	/* Random edits undo back through every earlier state of the scene and */
+	/* redo forward through them again, with and without interpolation     */
+	for (int mode = 0; mode < 2; mode++)
+	{
+		Node::setInterpolated(mode == 1);
+		Node* root = TestScenes::randomScene(5 + mode, TEST_NUM_NODES,
+			TEST_NUM_FRAMES);
+		std::vector<Node*> nodes;
+		TestScenes::getNodes(root, nodes);
+		unsigned int state = 17 + mode;
+		std::vector<std::vector<unsigned char> > states(1, sceneBytes(root));
+		UndoHistory history(UNDO_MEMORY_LIMIT);
+		editRandomly(history, root, nodes, state, TEST_NUM_EDITS, states);
+		CHECK(undoAll(history, root, states) == TEST_NUM_EDITS);
+		CHECK(!history.canUndo() && history.canRedo());
+		unsigned int redone = 0;
+		for (unsigned int i = 1; history.redo(changed, labels); i++)
+		{
+			redone += (i < states.size() && sceneBytes(root) == states[i]);
+		}
+		CHECK(redone == TEST_NUM_EDITS && !history.canRedo());
+		TestScenes::deleteScene(root);
+	}
+
+	/* Keying the scene graph is undone by unkeying only the Nodes it  */
+	/* keyed, and redone with the interpolation it was keyed with      */
+	{
+		Node::setInterpolated(true);
+		Node* root = TestScenes::randomScene(9, TEST_NUM_NODES,
+			TEST_NUM_FRAMES);
+		std::vector<Node*> nodes;
+		TestScenes::getNodes(root, nodes);
+		unsigned int frameNum = TEST_NUM_FRAMES / 2;
+		float values[KeyframeTrack::NUM_CHANNELS];
+		unsigned int state = 23;
+		TestScenes::randomValues(state, values);
+		nodes[1]->setKeyframe(frameNum, values);
+		std::vector<unsigned char> before = sceneBytes(root);
+		UndoHistory history(UNDO_MEMORY_LIMIT);
+		history.recordMakeKeyframe(root, frameNum, &history);
+		root->makeKeyframe(frameNum);
+		history.endStep();
+		std::vector<unsigned char> keyed = sceneBytes(root);
+		CHECK(keyed != before);
+		Node::setInterpolated(false);
+		CHECK(history.undo(changed, labels) && sceneBytes(root) == before);
+		CHECK(nodes[1]->getTrack()->getIsKeyframe(frameNum));
+		CHECK(history.redo(changed, labels) && sceneBytes(root) == keyed);
+		TestScenes::deleteScene(root);
+	}
+
+	/* A Node removed comes back in the same place among its siblings with */
+	/* the labels of its subtree, and a Node added goes and comes back     */
+	{
+		Node* root = TestScenes::randomScene(4, TEST_NUM_NODES,
+			TEST_NUM_FRAMES);
+		std::vector<Node*> nodes;
+		TestScenes::getNodes(root, nodes);
+		std::map<const Node*, std::string> allLabels;
+		for (unsigned int i = 0; i < nodes.size(); i++)
+		{
+			std::stringstream label;
+			label << "Node " << i;
+			allLabels[nodes[i]] = label.str();
+		}
+		Node* parent = root;
+		for (unsigned int i = 0; i < nodes.size() &&
+			parent->getChildren()->size() < 3; i++)
+		{
+			parent = nodes[i];
+		}
+		std::vector<Node*> siblings = childrenOf(parent);
+		if (CHECK(siblings.size() >= 3))
+		{
+			Node* removed = siblings[1];
+			std::vector<Node*> subtree;
+			TestScenes::getNodes(removed, subtree);
+			UndoHistory history(UNDO_MEMORY_LIMIT);
+			labels = allLabels;
+			history.recordRemoveChild(removed, labels);
+			parent->removeChild(removed);
+			std::map<const Node*, std::string> removedLabels = labels;
+			CHECK(labels.size() == allLabels.size() - subtree.size() &&
+				labels.find(subtree.back()) == labels.end());
+			CHECK(history.undo(changed, labels) &&
+				childrenOf(parent) == siblings && labels == allLabels);
+			CHECK(history.redo(changed, labels) &&
+				childrenOf(parent).size() == siblings.size() - 1 &&
+				labels == removedLabels);
+			CHECK(history.undo(changed, labels) &&
+				childrenOf(parent) == siblings && labels == allLabels);
+
+			Node* added = new Node(mat3::identity(), mat3::identity(),
+				mat3::identity());
+			nodes[2]->addChild(added);
+			history.recordAddChild(added);
+			labels[added] = "Added";
+			std::vector<Node*> withAdded = childrenOf(nodes[2]);
+			CHECK(history.undo(changed, labels) &&
+				childrenOf(nodes[2]).size() == withAdded.size() - 1 &&
+				labels == allLabels);
+			CHECK(history.redo(changed, labels) &&
+				childrenOf(nodes[2]) == withAdded && labels[added] == "Added");
+		}
+		TestScenes::deleteScene(root);
+	}
+
+	/* Over its memory limit, the history drops the oldest steps and the */
+	/* steps left still undo to the states before them                   */
+	{
+		Node* root = TestScenes::randomScene(6, TEST_NUM_NODES,
+			TEST_NUM_FRAMES);
+		std::vector<Node*> nodes;
+		TestScenes::getNodes(root, nodes);
+		unsigned int state = 29;
+		std::vector<std::vector<unsigned char> > states(1, sceneBytes(root));
+		UndoHistory history(UNDO_MEMORY_LIMIT);
+		editRandomly(history, root, nodes, state, TEST_NUM_KEPT, states);
+		size_t limit = history.getMemoryUsed();
+		history.setMemoryLimit(limit);
+		editRandomly(history, root, nodes, state, TEST_NUM_EVICTING_EDITS,
+			states);
+		CHECK(history.getMemoryUsed() <= limit);
+		unsigned int numUndone = undoAll(history, root, states);
+		CHECK(numUndone > 0 && numUndone < TEST_NUM_KEPT * 2);
+		TestScenes::deleteScene(root);
+	}
+
+	/* A Node removed is deleted once, when the step keeping it out of the */
+	/* scene graph is dropped, and never while it is back in the scene     */
+	{
+		Node* root = new Node(mat3::identity(), mat3::identity(),
+			mat3::identity());
+		UndoHistory* history = new UndoHistory(UNDO_MEMORY_LIMIT);
+
+		/* Dropped as the oldest step */
+		Node* subtree = countedSubtree();
+		root->addChild(subtree);
+		history->recordRemoveChild(subtree, labels);
+		root->removeChild(subtree);
+		CountedNode::numDeleted = 0;
+		history->recordKeyframeEdit(root, 0, NULL);
+		history->setMemoryLimit(1);
+		CHECK(CountedNode::numDeleted == COUNTED_SUBTREE_SIZE);
+		history->clear();
+		CHECK(CountedNode::numDeleted == COUNTED_SUBTREE_SIZE);
+		history->setMemoryLimit(UNDO_MEMORY_LIMIT);
+
+		/* Dropped by clearing the history */
+		subtree = countedSubtree();
+		root->addChild(subtree);
+		history->recordRemoveChild(subtree, labels);
+		root->removeChild(subtree);
+		CountedNode::numDeleted = 0;
+		history->clear();
+		CHECK(CountedNode::numDeleted == COUNTED_SUBTREE_SIZE);
+
+		/* Added, undone, and dropped by a new edit */
+		subtree = countedSubtree();
+		root->addChild(subtree);
+		history->recordAddChild(subtree);
+		CHECK(history->undo(changed, labels) && root->getChildren()->empty());
+		CountedNode::numDeleted = 0;
+		history->recordKeyframeEdit(root, 0, NULL);
+		CHECK(CountedNode::numDeleted == COUNTED_SUBTREE_SIZE);
+
+		/* Removed and undone, so back in the scene graph, then dropped */
+		subtree = countedSubtree();
+		root->addChild(subtree);
+		history->recordRemoveChild(subtree, labels);
+		root->removeChild(subtree);
+		CHECK(history->undo(changed, labels) &&
+			root->getChildren()->size() == 1);
+		CountedNode::numDeleted = 0;
+		history->clear();
+		CHECK(CountedNode::numDeleted == 0);
+
+		/* Removed, and dropped with the history */
+		history->recordRemoveChild(subtree, labels);
+		root->removeChild(subtree);
+		delete history;
+		CHECK(CountedNode::numDeleted == COUNTED_SUBTREE_SIZE);
+		TestScenes::deleteScene(root);
+	}
+
+	Node::setInterpolated(interpolated);
+}
@@ -0,0 +1,204 @@
+/*
+ * affine2Tests.cpp
+ * Created by Zachary Ferguson
+ * Tests of the affine2 class against mat3, and benchmarks of its composition
+ * and point transforms against mat3. The kernels tested are the ones this
+ * project is compiled for, so build it with /arch:IA32, /arch:SSE2 and
+ * /arch:AVX to check the scalar, SSE, and AVX kernels.
+ */
+
+#include <algorithm>  /* Included for max */
+#include <cstdlib>  /* Included for rand */
+#include <iostream>
+#include <vector>
+#include "affine2.h"
+#include "Tests.h"
+
+/* Number of random transformations tested, and of points timed. */
+#define TEST_NUM_TRANSFORMS 10000
+#define BENCH_NUM_POINTS 4096
+
+/* Depth of the chains of transformations composed, as down a path of  */
+/* the scene graph.                                                    */
+#define BENCH_DEPTH 16
+
+/* Number of times each benchmark is run. */
+#define BENCH_RUNS 1000
+
+/* Returns a random number from -10 to 10 in steps of 0.01. */
+static float randomNumber()
+{
+	return (rand() % 2001 - 1000) / 100.0f;
+}
+
+/* Returns a random affine transformation as a mat3. */
+static mat3 randomMat3()
+{
+	return mat3(vec3(randomNumber(), randomNumber(), randomNumber()),
+		vec3(randomNumber(), randomNumber(), randomNumber()), vec3(0, 0, 1));
+}
+
+/* Returns if the affine2 has exactly the values of the mat3. */
+static bool sameValues(const affine2& a, const mat3& m)
+{
+	for (unsigned int row = 0; row < 3; row++)
+	{
+		for (unsigned int column = 0; column < 3; column++)
+		{
+			if (a(row, column) != m[row][column])
+			{
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+/* Test the affine2 class */
+void testAffine2()
+{
+#if defined(AFFINE2_AVX)
+	std::cout << "  checking the AVX kernels" << std::endl;
+#elif defined(AFFINE2_SSE)
+	std::cout << "  checking the SSE kernels" << std::endl;
+#else
+	std::cout << "  checking the scalar kernels" << std::endl;
+#endif
+
+	srand(7);
+	unsigned int compositions = 0, points = 0, interleaved = 0, inPlace = 0;
+	float x[19], y[19], outX[19], outY[19], outXY[38];
+	for (unsigned int t = 0; t < TEST_NUM_TRANSFORMS; t++)
+	{
+		/* Composition gives exactly the mat3 product */
+		mat3 m1 = randomMat3(), m2 = randomMat3();
+		affine2 a = affine2(m1) * affine2(m2);
+		mat3 m = m1 * m2;
+		compositions += sameValues(a, m);
+
+		/* Point transforms give exactly the mat3 product, for every count */
+		/* of points left over after the vector kernels                    */
+		unsigned int count = t % 19 + 1;
+		for (unsigned int i = 0; i < count; i++)
+		{
+			x[i] = randomNumber();
+			y[i] = randomNumber();
+		}
+		a.transformPoints(x, y, outX, outY, count);
+		a.transformPoints(x, y, outXY, count);
+		bool pointsSame = true, interleavedSame = true;
+		for (unsigned int i = 0; i < count; i++)
+		{
+			vec3 p = m * vec3(x[i], y[i], 1);
+			pointsSame = pointsSame && outX[i] == p[0] && outY[i] == p[1];
+			interleavedSame = interleavedSame && outXY[2 * i] == p[0] &&
+				outXY[2 * i + 1] == p[1];
+		}
+		points += pointsSame;
+		interleaved += interleavedSame;
+
+		/* Transforming in place gives the same points */
+		a.transformPoints(x, y, x, y, count);
+		bool inPlaceSame = true;
+		for (unsigned int i = 0; i < count; i++)
+		{
+			inPlaceSame = inPlaceSame && x[i] == outX[i] && y[i] == outY[i];
+		}
+		inPlace += inPlaceSame;
+	}
+	CHECK(compositions == TEST_NUM_TRANSFORMS);
+	CHECK(points == TEST_NUM_TRANSFORMS);
+	CHECK(interleaved == TEST_NUM_TRANSFORMS);
+	CHECK(inPlace == TEST_NUM_TRANSFORMS);
+
+	/* The static initializers match mat3's */
+	CHECK(sameValues(affine2::rotation2D(30), mat3::rotation2D(30)));
+	CHECK(sameValues(affine2::translation2D(4, 5),
+		mat3::translation2D(4, 5)));
+	CHECK(sameValues(affine2::scale2D(2, 3), mat3::scale2D(2, 3)));
+	CHECK(affine2::identity() == affine2(mat3::identity()));
+	CHECK(affine2(mat3::translation2D(4, 5)).toMat3() ==
+		mat3::translation2D(4, 5));
+
+	/* fromValues is translation * rotation * scale, to rounding */
+	affine2 built = affine2::fromValues(2, 3, 30, 4, 5);
+	mat3 product = mat3::translation2D(4, 5) * mat3::rotation2D(30) *
+		mat3::scale2D(2, 3);
+	float worst = 0;
+	for (unsigned int row = 0; row < 3; row++)
+	{
+		for (unsigned int column = 0; column < 3; column++)
+		{
+			float difference = built(row, column) - product[row][column];
+			worst = std::max(worst, difference < 0 ? -difference : difference);
+		}
+	}
+	CHECK(worst < 1e-5f);
+}
+
+/* Time the affine2 class against mat3 */
+void benchAffine2()
+{
+	srand(7);
+	std::vector<mat3> mats;
+	std::vector<affine2> affines;
+	for (unsigned int i = 0; i < BENCH_NUM_POINTS; i++)
+	{
+		mats.push_back(randomMat3());
+		affines.push_back(affine2(mats.back()));
+	}
+
+	/* Compose chains of transformations, as down the paths of the tree */
+	std::chrono::steady_clock::time_point start = Tests::now();
+	mat3 m;
+	for (unsigned int r = 0; r < BENCH_RUNS; r++)
+	{
+		for (unsigned int i = 0; i < BENCH_NUM_POINTS; i++)
+		{
+			m = i % BENCH_DEPTH == 0 ? mats[i] : mats[i] * m;
+		}
+	}
+	Tests::report("compose 4096, mat3", start, BENCH_RUNS);
+
+	start = Tests::now();
+	affine2 a;
+	for (unsigned int r = 0; r < BENCH_RUNS; r++)
+	{
+		for (unsigned int i = 0; i < BENCH_NUM_POINTS; i++)
+		{
+			a = i % BENCH_DEPTH == 0 ? affines[i] : affines[i] * a;
+		}
+	}
+	Tests::report("compose 4096, affine2", start, BENCH_RUNS);
+	CHECK(sameValues(a, m));
+
+	/* Transform the points of a vertex array */
+	std::vector<float> x(BENCH_NUM_POINTS), y(BENCH_NUM_POINTS);
+	std::vector<float> outXY(2 * BENCH_NUM_POINTS);
+	for (unsigned int i = 0; i < BENCH_NUM_POINTS; i++)
+	{
+		x[i] = randomNumber();
+		y[i] = randomNumber();
+	}
+	start = Tests::now();
+	for (unsigned int r = 0; r < BENCH_RUNS; r++)
+	{
+		for (unsigned int i = 0; i < BENCH_NUM_POINTS; i++)
+		{
+			vec3 p = mats[r] * vec3(x[i], y[i], 1);
+			outXY[2 * i] = p[0];
+			outXY[2 * i + 1] = p[1];
+		}
+	}
+	Tests::report("transform 4096 points, mat3", start, BENCH_RUNS);
+	float last = outXY[2 * BENCH_NUM_POINTS - 1];
+
+	start = Tests::now();
+	for (unsigned int r = 0; r < BENCH_RUNS; r++)
+	{
+		affines[r].transformPoints(&x[0], &y[0], &outXY[0],
+			BENCH_NUM_POINTS);
+	}
+	Tests::report("transform 4096 points, affine2", start, BENCH_RUNS);
+	CHECK(outXY[2 * BENCH_NUM_POINTS - 1] == last);
+}
@@ -21,25 +21,25 @@ triangle::~triangle()
 	this->vertices = NULL;
 }
 
-/* Draws this polyline */
-void triangle::draw(mat3 transformation) const
+/* Adds this triangle's vertices, transformed by the given    */
+/* transformation and in the given color, to the RenderBatch. */
+void triangle::appendTo(RenderBatch& batch, const affine2& transformation, 
+	const float color[3]) const
 {
-	/* Set the color */
-	glColor3f((polyline::color)[0], (this->color)[1], (this->color)[2]);
-	/* Draw the vertices */
-	glBegin(GL_TRIANGLES);
-	for (std::list<vec3>::const_iterator it = (this->vertices)->begin(); it != 
-		(this->vertices)->end(); ++it)
-	{
-		vec3 vertex = transformation * (*it);
-		glVertex2f(vertex[0], vertex[1]);
-	}
-	glEnd();
+	/* Already triangles, so transform straight into the batch */
+	this->transformVertices(transformation, batch.addVertices(
+		RenderBatch::TRIANGLES, this->numVertices, color));
+}
+
+/* Returns what kind of geometry this is. */
+polyline::Type triangle::getType() const
+{
+	return polyline::TRIANGLE;
 }
 
 /* Sets the list of vertices to the new one */
 void triangle::setVertices(std::list<vec3>* newVertices)
 {
 	assert(newVertices->size() == 3);
-	this->vertices = newVertices;
+	polyline::setVertices(newVertices);
 }
@@ -23,9 +23,14 @@ class triangle : public polygon
 		/* Destructor for polylines */
 		virtual ~triangle();
 		
-		/* Draws this polyline */
-		virtual void draw(mat3 transformation) const;
+		/* Adds this triangle's vertices, transformed by the given    */
+		/* transformation and in the given color, to the RenderBatch. */
+		virtual void appendTo(RenderBatch& batch, 
+			const affine2& transformation, const float color[3]) const;
 		
+		/* Returns what kind of geometry this is. */
+		virtual Type getType() const;
+
 		/* Sets the list of vertices to the new one */
 		virtual void setVertices(std::list<vec3>* newVertices);
 